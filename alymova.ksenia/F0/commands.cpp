@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <list>
 #include <numeric>
 #include "dict-utils.hpp"
 
@@ -17,10 +18,6 @@ namespace
   {
     return std::find(list.begin(), list.end(), word);
   }
-  bool hasSubword(const std::string& word, const std::string& subword)
-  {
-    return word.find(subword) != std::string::npos;
-  }
   bool hasWord(const WordSet& list, const std::string& word)
   {
     return std::find(list.begin(), list.end(), word) != list.end();
@@ -33,7 +30,7 @@ namespace
   {
     return dict.find(key) != dict.end();
   }
-  bool compareKeys(const std::pair< std::string, WordSet>& pair1, const std::pair< std::string, WordSet>& pair2)
+  bool compareKeys(const Dictionary::value_type& pair1, const Dictionary::value_type& pair2)
   {
     return pair1.first < pair2.first;
   }
@@ -50,24 +47,22 @@ namespace
   {
     return dict.at(word);
   }
-  ContentDict insertByFirstLetter(const ContentDict& map, const std::string& word)
+  void insertByFirstLetter(ContentDict& map, const Dictionary::value_type& pair)
   {
-    ContentDict copy(map);
-    copy[word[0]].push_back(word);
-    return copy;
+    map[pair.first[0]].push_back(pair.first);
   }
   WordSet unionLists(WordSet& list1, WordSet& list2)
   {
-    list1.sort();
-    list2.sort();
+    std::sort(list1.begin(), list1.end());
+    std::sort(list2.begin(), list2.end());
     WordSet res;
     std::set_union(list1.begin(), list1.end(), list2.begin(), list2.end(), std::back_inserter(res));
     return res;
   }
   WordSet intersectLists(WordSet& list1, WordSet& list2)
   {
-    list1.sort();
-    list2.sort();
+    std::sort(list1.begin(), list1.end());
+    std::sort(list2.begin(), list2.end());
     WordSet res;
     std::set_intersection(list1.begin(), list1.end(), list2.begin(), list2.end(), std::back_inserter(res));
     return res;
@@ -185,7 +180,8 @@ void alymova::fixWord(std::istream& in, std::ostream& out, DictSet& set)
     throw std::logic_error("<INVALID COMMAND>");
   }
   Dictionary& dict = set.at(name);
-  dict[new_word] = dict.at(word);
+  WordSet translates = dict.at(word);
+  dict[new_word] = translates;
   dict.erase(word);
   out << "<SUCCESSFULLY FIXED>";
 }
@@ -211,9 +207,7 @@ void alymova::containSubword(std::istream& in, std::ostream& out, const DictSet&
     throw std::logic_error("<INVALID COMMAND>");
   }
   const Dictionary& dict = set.at(name);
-  WordSet words, suitable;
-  std::transform(dict.begin(), dict.end(), std::back_inserter(words), returnName< WordSet >);
-  std::copy_if(words.begin(), words.end(), std::back_inserter(suitable), std::bind(hasSubword, _1, subword));
+  WordSet suitable = dict.withSubword(subword);
   if (suitable.empty())
   {
     out << "<NOT FOUND>";
@@ -311,10 +305,8 @@ void alymova::printContent(std::istream& in, std::ostream& out, const DictSet& s
   {
     return;
   }
-  WordSet words;
-  std::transform(dict.begin(), dict.end(), std::back_inserter(words), returnName< WordSet >);
   ContentDict word_letters;
-  word_letters = std::accumulate(words.begin(), words.end(), word_letters, insertByFirstLetter);
+  std::for_each(dict.begin(), dict.end(), std::bind(insertByFirstLetter, std::ref(word_letters), _1));
   out << word_letters;
 }
 
@@ -366,8 +358,10 @@ void alymova::unionDicts(std::istream& in, std::ostream& out, DictSet& set)
   std::set_intersection(dict1.begin(), dict1.end(), dict2.begin(), dict2.end(), d_first, compareKeys);
   std::transform(tmp.begin(), tmp.end(), std::inserter(unioned, unioned.end()), std::bind(unionListDict, _1, dict2));
 
-  unioned.insert(difference.begin(), difference.end());
-  set[newname] = unioned;
+  Dictionary merged;
+  auto d_first_merged = std::inserter(merged, merged.end());
+  std::merge(unioned.begin(), unioned.end(), difference.begin(), difference.end(), d_first_merged, compareKeys);
+  set[newname] = merged;
   out << "<SUCCESSFULLY INTERSECTED>";
 }
 
@@ -409,8 +403,7 @@ void alymova::printDayWord(std::istream& in, std::ostream& out, const DictSet& s
   }
   std::srand(std::time(nullptr));
   int random_num = std::rand() % dict.size();
-  auto it_word = dict.begin();
-  for (int i = 0; i < random_num; i++, it_word++);
+  auto it_word = dict.select(random_num);
   out << "Have a good day with word:\n";
   out << it_word->first << ' ' << it_word->second;
 }
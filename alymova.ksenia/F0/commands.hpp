@@ -2,16 +2,14 @@
 #define COMMANDS_HPP
 #include <iostream>
 #include <functional>
-#include <list>
 #include <map>
+#include "dictionary.hpp"
 
 namespace alymova
 {
   using namespace std::placeholders;
-  using WordSet = std::list< std::string >;
-  using Dictionary = std::map< std::string, WordSet >;
   using DictSet = std::map< std::string, Dictionary >;
-  using ContentDict = std::map< char, std::list< std::string > >;
+  using ContentDict = std::map< char, WordSet >;
 
   void create(std::istream& in, std::ostream& out, DictSet& set);
   void dicts(std::ostream& out, const DictSet& set);
@@ -1,12 +1,14 @@
 #include <algorithm>
 #include <iterator>
+#include <list>
+#include <vector>
 #include "dict-utils.hpp"
 
 namespace
 {
   using namespace alymova;
 
-  std::pair< std::string, std::list< std::string > > returnDictPair(DictPairWrapper pair)
+  Dictionary::value_type returnDictPair(DictPairWrapper pair)
   {
     return pair.p;
   }
@@ -14,7 +16,7 @@ namespace
   {
     return pair.p;
   }
-  DictPairWrapper returnDictPairWrapper(std::pair< std::string, std::list< std::string > > pair)
+  DictPairWrapper returnDictPairWrapper(Dictionary::value_type pair)
   {
     return DictPairWrapper{pair};
   }
@@ -22,12 +24,12 @@ namespace
   {
     return DictSetPairWrapper{pair};
   }
-  ContentPairWrapper returnContentPairWrapper(std::pair< char, std::list< std::string > > pair)
+  ContentPairWrapper returnContentPairWrapper(std::pair< char, WordSet > pair)
   {
     return ContentPairWrapper{pair};
   }
 }
-std::istream& alymova::operator>>(std::istream& in, std::list< std::string >& list)
+std::istream& alymova::operator>>(std::istream& in, WordSet& list)
 {
   std::istream::sentry s(in);
   if (!s)
@@ -40,7 +42,7 @@ std::istream& alymova::operator>>(std::istream& in, std::list< std::string >& li
   {
     return in;
   }
-  std::list< std::string > tested;
+  WordSet tested;
   auto begin = std::istream_iterator< std::string >(in);
   auto end = std::istream_iterator< std::string >();
   std::copy_n(begin, size, std::back_inserter(tested));
@@ -54,7 +56,7 @@ std::istream& alymova::operator>>(std::istream& in, std::list< std::string >& li
   }
   if (in && tested.size() == size)
   {
-    list = tested;
+    list = std::move(tested);
   }
   return in;
 }
@@ -79,7 +81,10 @@ std::istream& alymova::operator>>(std::istream& in, Dictionary& dict)
   std::copy_n(begin, size, std::back_inserter(tested_list));
   if (in && tested_list.size() == size)
   {
-    std::transform(tested_list.begin(), tested_list.end(), std::inserter(dict, dict.end()), returnDictPair);
+    std::vector< Dictionary::value_type > entries;
+    entries.reserve(size);
+    std::transform(tested_list.begin(), tested_list.end(), std::back_inserter(entries), returnDictPair);
+    dict = Dictionary(std::move(entries));
   }
   return in;
 }
@@ -131,15 +136,15 @@ std::istream& alymova::operator>>(std::istream& in, DictSetPairWrapper& pair)
   }
   return in;
 }
-std::ostream& alymova::operator<<(std::ostream& out, const std::list< std::string >& list)
+std::ostream& alymova::operator<<(std::ostream& out, const WordSet& list)
 {
   std::ostream::sentry s(out);
   if (!s || list.empty())
   {
     return out;
   }
-  std::list< std::string > copy(list);
-  copy.sort();
+  WordSet copy(list);
+  std::sort(copy.begin(), copy.end());
   std::copy(copy.begin(), --copy.end(), std::ostream_iterator< std::string >(out, " "));
   out << *(--copy.end());
   return out;
@@ -0,0 +1,214 @@
+#include "dictionary.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+  using namespace alymova;
+  using namespace std::placeholders;
+
+  bool compareEntryWord(const Dictionary::value_type& entry, const std::string& word)
+  {
+    return entry.first < word;
+  }
+  bool compareEntries(const Dictionary::value_type& entry1, const Dictionary::value_type& entry2)
+  {
+    return entry1.first < entry2.first;
+  }
+  bool equalEntries(const Dictionary::value_type& entry1, const Dictionary::value_type& entry2)
+  {
+    return entry1.first == entry2.first;
+  }
+  bool compareSuffixes(const std::vector< Dictionary::value_type >& entries, const std::pair< size_t, size_t >& suffix1,
+    const std::pair< size_t, size_t >& suffix2)
+  {
+    const std::string& word = entries[suffix2.first].first;
+    return entries[suffix1.first].first.compare(suffix1.second, std::string::npos, word, suffix2.second) < 0;
+  }
+  bool compareSuffixWord(const std::vector< Dictionary::value_type >& entries,
+    const std::pair< size_t, size_t >& suffix, const std::string& word)
+  {
+    return entries[suffix.first].first.compare(suffix.second, std::string::npos, word) < 0;
+  }
+  bool hasPrefix(const std::vector< Dictionary::value_type >& entries, const std::pair< size_t, size_t >& suffix,
+    const std::string& prefix)
+  {
+    return entries[suffix.first].first.compare(suffix.second, prefix.size(), prefix) == 0;
+  }
+}
+
+alymova::Dictionary::Dictionary():
+  entries_(),
+  suffixes_(),
+  indexed_(false)
+{}
+
+alymova::Dictionary::Dictionary(std::vector< value_type > entries):
+  entries_(std::move(entries)),
+  suffixes_(),
+  indexed_(false)
+{
+  std::stable_sort(entries_.begin(), entries_.end(), compareEntries);
+  entries_.erase(std::unique(entries_.begin(), entries_.end(), equalEntries), entries_.end());
+}
+
+size_t alymova::Dictionary::size() const
+{
+  return entries_.size();
+}
+
+bool alymova::Dictionary::empty() const
+{
+  return entries_.empty();
+}
+
+alymova::Dictionary::iterator alymova::Dictionary::begin()
+{
+  return entries_.begin();
+}
+
+alymova::Dictionary::iterator alymova::Dictionary::end()
+{
+  return entries_.end();
+}
+
+alymova::Dictionary::const_iterator alymova::Dictionary::begin() const
+{
+  return entries_.begin();
+}
+
+alymova::Dictionary::const_iterator alymova::Dictionary::end() const
+{
+  return entries_.end();
+}
+
+alymova::Dictionary::iterator alymova::Dictionary::lowerBound(const std::string& word)
+{
+  return std::lower_bound(entries_.begin(), entries_.end(), word, compareEntryWord);
+}
+
+alymova::Dictionary::iterator alymova::Dictionary::find(const std::string& word)
+{
+  auto it = lowerBound(word);
+  if (it == entries_.end() || it->first != word)
+  {
+    return entries_.end();
+  }
+  return it;
+}
+
+alymova::Dictionary::const_iterator alymova::Dictionary::find(const std::string& word) const
+{
+  auto it = std::lower_bound(entries_.begin(), entries_.end(), word, compareEntryWord);
+  if (it == entries_.end() || it->first != word)
+  {
+    return entries_.end();
+  }
+  return it;
+}
+
+alymova::WordSet& alymova::Dictionary::at(const std::string& word)
+{
+  auto it = find(word);
+  if (it == entries_.end())
+  {
+    throw std::out_of_range("<WORD NOT FOUND>");
+  }
+  return it->second;
+}
+
+const alymova::WordSet& alymova::Dictionary::at(const std::string& word) const
+{
+  auto it = find(word);
+  if (it == entries_.end())
+  {
+    throw std::out_of_range("<WORD NOT FOUND>");
+  }
+  return it->second;
+}
+
+alymova::WordSet& alymova::Dictionary::operator[](const std::string& word)
+{
+  return emplace(word, WordSet()).first->second;
+}
+
+alymova::Dictionary::const_iterator alymova::Dictionary::select(size_t rank) const
+{
+  return entries_.begin() + rank;
+}
+
+std::pair< alymova::Dictionary::iterator, bool > alymova::Dictionary::emplace(const std::string& word,
+  const WordSet& translates)
+{
+  auto it = lowerBound(word);
+  if (it != entries_.end() && it->first == word)
+  {
+    return {it, false};
+  }
+  indexed_ = false;
+  return {entries_.insert(it, {word, translates}), true};
+}
+
+alymova::Dictionary::iterator alymova::Dictionary::insert(const_iterator hint, const value_type& entry)
+{
+  bool after_prev = hint == entries_.begin() || std::prev(hint)->first < entry.first;
+  bool before_hint = hint == entries_.end() || entry.first < hint->first;
+  if (after_prev && before_hint)
+  {
+    indexed_ = false;
+    return entries_.insert(hint, entry);
+  }
+  return emplace(entry.first, entry.second).first;
+}
+
+void alymova::Dictionary::erase(const std::string& word)
+{
+  auto it = find(word);
+  if (it != entries_.end())
+  {
+    entries_.erase(it);
+    indexed_ = false;
+  }
+}
+
+const std::vector< alymova::Dictionary::Suffix >& alymova::Dictionary::suffixes() const
+{
+  if (indexed_)
+  {
+    return suffixes_;
+  }
+  suffixes_.clear();
+  for (size_t rank = 0; rank < entries_.size(); rank++)
+  {
+    for (size_t offset = 0; offset < entries_[rank].first.size(); offset++)
+    {
+      suffixes_.emplace_back(rank, offset);
+    }
+  }
+  std::sort(suffixes_.begin(), suffixes_.end(), std::bind(compareSuffixes, std::cref(entries_), _1, _2));
+  indexed_ = true;
+  return suffixes_;
+}
+
+alymova::WordSet alymova::Dictionary::withSubword(const std::string& subword) const
+{
+  const std::vector< Suffix >& all = suffixes();
+  auto less = std::bind(compareSuffixWord, std::cref(entries_), _1, _2);
+  auto it = std::lower_bound(all.begin(), all.end(), subword, less);
+  std::vector< size_t > ranks;
+  for (; it != all.end() && hasPrefix(entries_, *it, subword); it++)
+  {
+    ranks.push_back(it->first);
+  }
+  std::sort(ranks.begin(), ranks.end());
+  ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+  WordSet words;
+  words.reserve(ranks.size());
+  for (size_t rank: ranks)
+  {
+    words.push_back(entries_[rank].first);
+  }
+  return words;
+}
@@ -0,0 +1,53 @@
+#ifndef DICTIONARY_HPP
+#define DICTIONARY_HPP
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace alymova
+{
+  using WordSet = std::vector< std::string >;
+
+  // words kept sorted in one array: rank lookups are index arithmetic, key lookups binary searches
+  class Dictionary
+  {
+  public:
+    using value_type = std::pair< std::string, WordSet >;
+    using iterator = std::vector< value_type >::iterator;
+    using const_iterator = std::vector< value_type >::const_iterator;
+
+    Dictionary();
+    explicit Dictionary(std::vector< value_type > entries);
+
+    size_t size() const;
+    bool empty() const;
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    iterator find(const std::string& word);
+    const_iterator find(const std::string& word) const;
+    WordSet& at(const std::string& word);
+    const WordSet& at(const std::string& word) const;
+    WordSet& operator[](const std::string& word);
+    const_iterator select(size_t rank) const;
+
+    std::pair< iterator, bool > emplace(const std::string& word, const WordSet& translates);
+    iterator insert(const_iterator hint, const value_type& entry);
+    void erase(const std::string& word);
+
+    WordSet withSubword(const std::string& subword) const;
+
+  private:
+    using Suffix = std::pair< size_t, size_t >;
+
+    std::vector< value_type > entries_;
+    mutable std::vector< Suffix > suffixes_;
+    mutable bool indexed_;
+
+    iterator lowerBound(const std::string& word);
+    const std::vector< Suffix >& suffixes() const;
+  };
+}
+#endif
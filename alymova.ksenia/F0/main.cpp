@@ -9,9 +9,6 @@
 int main(int argc, char** argv)
 {
   using namespace alymova;
-  using WordSet = std::list< std::string >;
-  using Dictionary = std::map< std::string, WordSet >;
-  using DictSet = std::map< std::string, Dictionary >;
   using CommandSet = std::map< std::string, std::function< void() > >;
   std::setlocale(LC_CTYPE, "rus");
 
@@ -117,7 +117,8 @@ void averenkov::printHelp(std::ostream& out)
   out << "  bruteforce <kit> <result_name>  - Brute-force solution\n";
   out << "  dynamic_prog <kit> <result_name> - Dynamic programming\n";
   out << "  backtracking <kit> <result_name> - Backtracking method\n";
-  out << "  branch_and_bound <kit> <result_name> - Branch and bound\n\n";
+  out << "  branch_and_bound <kit> <result_name> - Branch and bound\n";
+  out << "  bench <items> <capacity> [seed] - Compare solvers on a random instance\n\n";
 
   out << "Utility Commands:\n";
   out << "  stats                           - Show all database contents\n";
@@ -0,0 +1,516 @@
+#include "engine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+  using averenkov::PlainItem;
+  using averenkov::Solution;
+
+  const size_t maxGrayItems = 62;
+  const size_t bruteforceItemLimit = 20;
+  const unsigned long long dpByteBudget = 1ull << 27;
+
+  struct Reduced
+  {
+    std::vector< size_t > index;
+    std::vector< PlainItem > items;
+    long long capacity;
+    Solution base;
+  };
+
+  Reduced reduce(const std::vector< PlainItem >& items, int capacity)
+  {
+    Reduced result{ {}, {}, capacity, Solution{ 0, 0, {} } };
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      if (items[i].weight <= 0 && items[i].value >= 0)
+      {
+        result.base.chosen.push_back(i);
+        result.base.value += items[i].value;
+        result.base.weight += items[i].weight;
+        result.capacity -= items[i].weight;
+      }
+      else if (items[i].weight > 0 && items[i].value > 0 && items[i].weight <= result.capacity)
+      {
+        result.index.push_back(i);
+        result.items.push_back(items[i]);
+      }
+    }
+    return result;
+  }
+
+  // the row never has to reach past the weight of all remaining items together
+  size_t dpCapacity(const Reduced& reduced)
+  {
+    long long total = 0;
+    for (size_t i = 0; i < reduced.items.size(); ++i)
+    {
+      total += reduced.items[i].weight;
+    }
+    return static_cast< size_t >(std::min(reduced.capacity, total));
+  }
+
+  // the keep bits of every item plus the rolling row of values
+  unsigned long long dpBytes(size_t itemCount, size_t capacity)
+  {
+    unsigned long long words = capacity / 64 + 1;
+    return sizeof(std::uint64_t) * itemCount * words + sizeof(long long) * (capacity + 1ull);
+  }
+
+  Solution expand(const Reduced& reduced, const Solution& partial)
+  {
+    long long value = 0;
+    long long weight = 0;
+    for (size_t i = 0; i < partial.chosen.size(); ++i)
+    {
+      value += reduced.items[partial.chosen[i]].value;
+      weight += reduced.items[partial.chosen[i]].weight;
+    }
+    if (value != partial.value || weight != partial.weight)
+    {
+      throw std::logic_error("Solver kit does not match its reported totals");
+    }
+    Solution result = reduced.base;
+    result.value += partial.value;
+    result.weight += partial.weight;
+    for (size_t i = 0; i < partial.chosen.size(); ++i)
+    {
+      result.chosen.push_back(reduced.index[partial.chosen[i]]);
+    }
+    std::sort(result.chosen.begin(), result.chosen.end());
+    return result;
+  }
+
+  unsigned lowestBit(unsigned long long value)
+  {
+    unsigned bit = 0;
+    while (!(value & 1ull))
+    {
+      value >>= 1;
+      ++bit;
+    }
+    return bit;
+  }
+
+  struct BacktrackSearch
+  {
+    const std::vector< PlainItem >& items;
+    long long capacity;
+    std::vector< bool > taken;
+    long long weight;
+    long long value;
+    Solution best;
+
+    void operator()(size_t index)
+    {
+      if (index == items.size())
+      {
+        if (value > best.value || (value == best.value && weight < best.weight))
+        {
+          best.value = value;
+          best.weight = weight;
+          best.chosen.clear();
+          for (size_t i = 0; i < taken.size(); ++i)
+          {
+            if (taken[i])
+            {
+              best.chosen.push_back(i);
+            }
+          }
+        }
+        return;
+      }
+      (*this)(index + 1);
+      if (weight + items[index].weight <= capacity)
+      {
+        taken[index] = true;
+        weight += items[index].weight;
+        value += items[index].value;
+        (*this)(index + 1);
+        taken[index] = false;
+        weight -= items[index].weight;
+        value -= items[index].value;
+      }
+    }
+  };
+
+  struct RatioGreater
+  {
+    const std::vector< PlainItem >& items;
+    bool operator()(size_t a, size_t b) const
+    {
+      long long lhs = static_cast< long long >(items[a].value) * items[b].weight;
+      long long rhs = static_cast< long long >(items[b].value) * items[a].weight;
+      return lhs > rhs;
+    }
+  };
+
+  struct BBNode
+  {
+    size_t level;
+    long long weight;
+    long long value;
+    std::vector< bool > taken;
+  };
+
+  struct BBShared
+  {
+    std::vector< PlainItem > sorted;
+    std::vector< long long > prefixWeight;
+    std::vector< long long > prefixValue;
+    long long capacity;
+
+    std::vector< std::deque< BBNode > > queues;
+    std::vector< std::mutex > locks;
+    std::atomic< size_t > pending;
+    std::atomic< long long > bestValue;
+    std::mutex bestLock;
+    std::vector< bool > bestTaken;
+    long long bestWeight;
+
+    BBShared(std::vector< PlainItem > items, long long cap, size_t workers):
+      sorted(std::move(items)),
+      prefixWeight(sorted.size() + 1, 0),
+      prefixValue(sorted.size() + 1, 0),
+      capacity(cap),
+      queues(workers),
+      locks(workers),
+      pending(0),
+      bestValue(0),
+      bestTaken(sorted.size(), false),
+      bestWeight(0)
+    {
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        prefixWeight[i + 1] = prefixWeight[i] + sorted[i].weight;
+        prefixValue[i + 1] = prefixValue[i] + sorted[i].value;
+      }
+    }
+
+    double bound(size_t level, long long weight, long long value) const
+    {
+      long long room = capacity - weight;
+      auto begin = prefixWeight.begin() + level;
+      size_t last = std::upper_bound(begin, prefixWeight.end(), prefixWeight[level] + room) - prefixWeight.begin() - 1;
+      double result = value + prefixValue[last] - prefixValue[level];
+      if (last < sorted.size())
+      {
+        long long left = room - (prefixWeight[last] - prefixWeight[level]);
+        result += static_cast< double >(left) * sorted[last].value / sorted[last].weight;
+      }
+      return result;
+    }
+
+    void offer(const BBNode& node)
+    {
+      if (node.value <= bestValue.load())
+      {
+        return;
+      }
+      std::lock_guard< std::mutex > guard(bestLock);
+      if (node.value > bestValue.load())
+      {
+        bestValue.store(node.value);
+        bestWeight = node.weight;
+        bestTaken = node.taken;
+        std::fill(bestTaken.begin() + node.level, bestTaken.end(), false);
+      }
+    }
+
+    void push(size_t worker, BBNode&& node)
+    {
+      pending.fetch_add(1);
+      std::lock_guard< std::mutex > guard(locks[worker]);
+      queues[worker].push_back(std::move(node));
+    }
+
+    bool take(size_t worker, BBNode& node)
+    {
+      {
+        std::lock_guard< std::mutex > guard(locks[worker]);
+        if (!queues[worker].empty())
+        {
+          node = std::move(queues[worker].back());
+          queues[worker].pop_back();
+          return true;
+        }
+      }
+      for (size_t i = 1; i < queues.size(); ++i)
+      {
+        size_t victim = (worker + i) % queues.size();
+        std::lock_guard< std::mutex > guard(locks[victim]);
+        if (!queues[victim].empty())
+        {
+          node = std::move(queues[victim].front());
+          queues[victim].pop_front();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void branch(size_t worker, BBNode& node)
+    {
+      if (node.level >= sorted.size() || bound(node.level, node.weight, node.value) <= bestValue.load())
+      {
+        return;
+      }
+      const PlainItem& item = sorted[node.level];
+      BBNode without{ node.level + 1, node.weight, node.value, node.taken };
+      if (bound(without.level, without.weight, without.value) > bestValue.load())
+      {
+        push(worker, std::move(without));
+      }
+      if (node.weight + item.weight <= capacity)
+      {
+        BBNode with{ node.level + 1, node.weight + item.weight, node.value + item.value, std::move(node.taken) };
+        with.taken[node.level] = true;
+        offer(with);
+        if (bound(with.level, with.weight, with.value) > bestValue.load())
+        {
+          push(worker, std::move(with));
+        }
+      }
+    }
+  };
+
+  struct BBWorker
+  {
+    BBShared& shared;
+    size_t id;
+
+    void operator()() const
+    {
+      BBNode node;
+      while (true)
+      {
+        if (!shared.take(id, node))
+        {
+          if (shared.pending.load() == 0)
+          {
+            return;
+          }
+          std::this_thread::yield();
+          continue;
+        }
+        shared.branch(id, node);
+        shared.pending.fetch_sub(1);
+      }
+    }
+  };
+}
+
+bool averenkov::dynamicFits(const std::vector< PlainItem >& items, int capacity)
+{
+  if (capacity < 0)
+  {
+    return true;
+  }
+  Reduced reduced = reduce(items, capacity);
+  return dpBytes(reduced.items.size(), dpCapacity(reduced)) <= dpByteBudget;
+}
+
+averenkov::Algorithm averenkov::chooseAlgorithm(const std::vector< PlainItem >& items, int capacity)
+{
+  if (items.size() <= bruteforceItemLimit)
+  {
+    return Algorithm::BRUTEFORCE;
+  }
+  if (dynamicFits(items, capacity))
+  {
+    return Algorithm::DYNAMIC;
+  }
+  return Algorithm::BRANCH_AND_BOUND;
+}
+
+std::string averenkov::algorithmName(Algorithm algorithm)
+{
+  switch (algorithm)
+  {
+  case Algorithm::BRUTEFORCE:
+    return "bruteforce";
+  case Algorithm::DYNAMIC:
+    return "dynamic_prog";
+  case Algorithm::BACKTRACKING:
+    return "backtracking";
+  case Algorithm::BRANCH_AND_BOUND:
+    return "branch_and_bound";
+  }
+  return "unknown";
+}
+
+averenkov::Solution averenkov::solveGrayCode(const std::vector< PlainItem >& items, int capacity)
+{
+  if (items.size() > maxGrayItems)
+  {
+    throw std::invalid_argument("Too many items for bruteforce");
+  }
+  Solution best{ 0, 0, {} };
+  if (capacity < 0)
+  {
+    return best;
+  }
+  unsigned long long mask = 0;
+  unsigned long long bestMask = 0;
+  long long weight = 0;
+  long long value = 0;
+  unsigned long long total = 1ull << items.size();
+  for (unsigned long long step = 1; step < total; ++step)
+  {
+    unsigned bit = lowestBit(step);
+    unsigned long long flip = 1ull << bit;
+    mask ^= flip;
+    int sign = (mask & flip) ? 1 : -1;
+    weight += sign * items[bit].weight;
+    value += sign * items[bit].value;
+    if (weight <= capacity && (value > best.value || (value == best.value && weight < best.weight)))
+    {
+      best.value = value;
+      best.weight = weight;
+      bestMask = mask;
+    }
+  }
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    if (bestMask & (1ull << i))
+    {
+      best.chosen.push_back(i);
+    }
+  }
+  return best;
+}
+
+averenkov::Solution averenkov::solveRollingDP(const std::vector< PlainItem >& items, int capacity)
+{
+  if (capacity < 0)
+  {
+    return Solution{ 0, 0, {} };
+  }
+  Reduced reduced = reduce(items, capacity);
+  const std::vector< PlainItem >& plain = reduced.items;
+  size_t cap = dpCapacity(reduced);
+  size_t words = cap / 64 + 1;
+
+  std::vector< long long > row(cap + 1, 0);
+  std::vector< std::uint64_t > keep(plain.size() * words, 0);
+  for (size_t i = 0; i < plain.size(); ++i)
+  {
+    size_t weight = static_cast< size_t >(plain[i].weight);
+    std::uint64_t* bits = keep.data() + i * words;
+    for (size_t c = cap; c >= weight; --c)
+    {
+      long long candidate = row[c - weight] + plain[i].value;
+      if (candidate > row[c])
+      {
+        row[c] = candidate;
+        bits[c / 64] |= 1ull << (c % 64);
+      }
+      if (c == 0)
+      {
+        break;
+      }
+    }
+  }
+
+  size_t c = std::find(row.begin(), row.end(), row[cap]) - row.begin();
+  Solution partial{ row[cap], 0, {} };
+  for (size_t i = plain.size(); i-- > 0;)
+  {
+    if (keep[i * words + c / 64] & (1ull << (c % 64)))
+    {
+      partial.chosen.push_back(i);
+      partial.weight += plain[i].weight;
+      c -= plain[i].weight;
+    }
+  }
+  return expand(reduced, partial);
+}
+
+averenkov::Solution averenkov::solveBacktracking(const std::vector< PlainItem >& items, int capacity)
+{
+  if (capacity < 0)
+  {
+    return Solution{ 0, 0, {} };
+  }
+  Reduced reduced = reduce(items, capacity);
+  BacktrackSearch search{ reduced.items, reduced.capacity, std::vector< bool >(reduced.items.size(), false), 0, 0,
+    Solution{ 0, 0, {} } };
+  search(0);
+  return expand(reduced, search.best);
+}
+
+averenkov::Solution averenkov::solveParallelBB(const std::vector< PlainItem >& items, int capacity, unsigned threads)
+{
+  if (capacity < 0)
+  {
+    return Solution{ 0, 0, {} };
+  }
+  Reduced reduced = reduce(items, capacity);
+  std::vector< size_t > order(reduced.items.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), RatioGreater{ reduced.items });
+  std::vector< PlainItem > sorted;
+  sorted.reserve(order.size());
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    sorted.push_back(reduced.items[order[i]]);
+  }
+
+  size_t workers = std::max(1u, threads);
+  BBShared shared(std::move(sorted), reduced.capacity, workers);
+
+  BBNode greedy{ order.size(), 0, 0, std::vector< bool >(order.size(), false) };
+  for (size_t i = 0; i < shared.sorted.size(); ++i)
+  {
+    if (greedy.weight + shared.sorted[i].weight <= shared.capacity)
+    {
+      greedy.weight += shared.sorted[i].weight;
+      greedy.value += shared.sorted[i].value;
+      greedy.taken[i] = true;
+    }
+  }
+  shared.offer(greedy);
+  shared.push(0, BBNode{ 0, 0, 0, std::vector< bool >(order.size(), false) });
+
+  std::vector< std::thread > pool;
+  for (size_t i = 1; i < workers; ++i)
+  {
+    pool.emplace_back(BBWorker{ shared, i });
+  }
+  BBWorker{ shared, 0 }();
+  std::for_each(pool.begin(), pool.end(), std::mem_fn(&std::thread::join));
+
+  Solution partial{ shared.bestValue.load(), shared.bestWeight, {} };
+  for (size_t i = 0; i < shared.bestTaken.size(); ++i)
+  {
+    if (shared.bestTaken[i])
+    {
+      partial.chosen.push_back(order[i]);
+    }
+  }
+  return expand(reduced, partial);
+}
+
+averenkov::Solution averenkov::solveWith(Algorithm algorithm, const std::vector< PlainItem >& items, int capacity)
+{
+  switch (algorithm)
+  {
+  case Algorithm::BRUTEFORCE:
+    return solveGrayCode(items, capacity);
+  case Algorithm::DYNAMIC:
+    return solveRollingDP(items, capacity);
+  case Algorithm::BACKTRACKING:
+    return solveBacktracking(items, capacity);
+  case Algorithm::BRANCH_AND_BOUND:
+    return solveParallelBB(items, capacity, std::thread::hardware_concurrency());
+  }
+  throw std::invalid_argument("Unknown algorithm");
+}
@@ -0,0 +1,40 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+#include <vector>
+#include <string>
+
+namespace averenkov
+{
+  struct PlainItem
+  {
+    int weight;
+    int value;
+  };
+
+  struct Solution
+  {
+    long long value;
+    long long weight;
+    std::vector< size_t > chosen;
+  };
+
+  enum class Algorithm
+  {
+    BRUTEFORCE,
+    DYNAMIC,
+    BACKTRACKING,
+    BRANCH_AND_BOUND
+  };
+
+  bool dynamicFits(const std::vector< PlainItem >& items, int capacity);
+  Algorithm chooseAlgorithm(const std::vector< PlainItem >& items, int capacity);
+  std::string algorithmName(Algorithm algorithm);
+
+  Solution solveGrayCode(const std::vector< PlainItem >& items, int capacity);
+  Solution solveRollingDP(const std::vector< PlainItem >& items, int capacity);
+  Solution solveBacktracking(const std::vector< PlainItem >& items, int capacity);
+  Solution solveParallelBB(const std::vector< PlainItem >& items, int capacity, unsigned threads);
+  Solution solveWith(Algorithm algorithm, const std::vector< PlainItem >& items, int capacity);
+}
+
+#endif
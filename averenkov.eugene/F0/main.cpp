@@ -26,6 +26,7 @@ int main(int argc, char* argv[])
   commands["dynamic_prog"] = averenkov::dynamicProgrammingSolve;
   commands["backtracking"] = averenkov::backtrackingSolve;
   commands["branch_and_bound"] = averenkov::branchAndBoundSolve;
+  commands["bench"] = averenkov::bench;
   commands["save"] = averenkov::saveToFile;
   commands["load"] = averenkov::loadFromFile;
 
@@ -1,289 +1,62 @@
-#include <numeric>
 #include "solves.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
 #include "commands.hpp"
 
-averenkov::vecs_it averenkov::sharingVec(vec_it weak_items)
-{
-  vecs_it items;
-  for (size_t i = 0; i < weak_items.size(); i++)
-  {
-    if (auto shared_item = weak_items[i].lock())
-    {
-      items.push_back(shared_item);
-    }
-  }
-  return items;
-}
-
-void averenkov::CombinationBuilder::operator()(int pos) const
-{
-  if (MaskChecker(pos)(pos))
-  {
-    current.push_back(items[pos]);
-  }
-}
-
-averenkov::CombinationEvaluator::CombinationEvaluator(int cap, vec_it& best, int& maxVal, int& bestWgt):
-  capacity(cap),
-  bestCombination(best),
-  maxValue(maxVal),
-  bestWeight(bestWgt)
-{}
-
-void averenkov::CombinationEvaluator::operator()(const vec_it& combination)
+namespace
 {
-  int totalWeight = calculateTotalWeight(combination);
-  int totalValue = calculateTotalValue(combination);
+  const size_t benchBruteforceLimit = 24;
+  const size_t benchBacktrackingLimit = 26;
 
-  if (totalWeight <= capacity && (totalValue > maxValue || (totalValue == maxValue && totalWeight < bestWeight)))
+  struct BenchResult
   {
-    bestCombination = combination;
-    maxValue = totalValue;
-    bestWeight = totalWeight;
-  }
-}
+    averenkov::Solution solution;
+    double millis;
+  };
 
-void averenkov::DPTableInitializer::operator()(std::vector<int>& row) const
-{
-  row.resize(capacity + 1);
-  std::fill(row.begin(), row.end(), 0);
-}
-
-void averenkov::DPRowFiller::operator()()
-{
-  auto items = sharingVec(weak_items);
-  if (current_weight > 0)
-  {
-    if (items[current_index-1]->getWeight() <= current_weight)
-    {
-      auto te = dp[current_index-1][current_weight];
-      auto tu = dp[current_index-1][current_weight - items[current_index-1]->getWeight()];
-      dp[current_index][current_weight] = std::max( te, tu + items[current_index-1]->getValue());
-    }
-    else
-    {
-      dp[current_index][current_weight] = dp[current_index-1][current_weight];
-    }
-    DPRowFiller next{weak_items, dp, current_index, current_weight - 1};
-    next();
-  }
-}
-
-void averenkov::DPRowProcessor::operator()()
-{
-  if (current_index <= items.size())
+  BenchResult timeSolver(averenkov::Algorithm algorithm, const std::vector< averenkov::PlainItem >& items, int capacity)
   {
-    int last_weight = dp[current_index].empty() ? 0 : dp[current_index].size() - 1;
-    DPRowFiller filler{items, dp, current_index, last_weight};
-    filler();
-    DPRowProcessor next{items, dp, current_index + 1};
-    next();
+    auto start = std::chrono::steady_clock::now();
+    averenkov::Solution solution = averenkov::solveWith(algorithm, items, capacity);
+    auto finish = std::chrono::steady_clock::now();
+    return BenchResult{ solution, std::chrono::duration< double, std::milli >(finish - start).count() };
   }
 }
 
-void averenkov::DPSolutionBuilder::operator()()
+averenkov::vecs_it averenkov::sharingVec(vec_it weak_items)
 {
-  auto items = sharingVec(weak_items);
-  if (current_index > 0 && remaining_weight > 0)
+  vecs_it items;
+  for (size_t i = 0; i < weak_items.size(); i++)
   {
-    if (dp[current_index][remaining_weight] != dp[current_index-1][remaining_weight])
+    if (auto shared_item = weak_items[i].lock())
     {
-      result.push_back(items[current_index-1]);
-      remaining_weight -= items[current_index-1]->getWeight();
+      items.push_back(shared_item);
     }
-    DPSolutionBuilder next{weak_items, dp, result, remaining_weight, current_index - 1};
-    next();
-  }
-}
-
-void averenkov::generateCombinations(const vec_it& items, std::vector< vec_it >& allCom, vec_it curCom, size_t index)
-{
-  if (index == items.size())
-  {
-    allCom.push_back(curCom);
-    return;
-  }
-  generateCombinations(items, allCom, curCom, index + 1);
-
-  curCom.push_back(items[index]);
-  generateCombinations(items, allCom, curCom, index + 1);
-}
-
-int averenkov::calculateTotalWeight(const vec_it& combination)
-{
-  return std::accumulate(combination.begin(), combination.end(), 0, WeakWeightCalculator());
-}
-
-int averenkov::calculateTotalValue(const vec_it& combination)
-{
-  return std::accumulate(combination.begin(), combination.end(), 0, WeakValueCalculator());
-}
-
-averenkov::ItemCollector::ItemCollector(vec_it& r, const std::vector< bool >& inc, const vec_it& it):
-  result(r),
-  included(inc),
-  items(it),
-  current_index(0)
-{}
-
-void averenkov::ItemCollector::operator()(bool is_included)
-{
-  if (is_included)
-  {
-    result.push_back(items[current_index]);
-  }
-  current_index++;
-}
-
-void averenkov::BestSolutionUpdater::operator()()
-{
-  auto items = sharingVec(state.weak_items);
-  int best_weight = 0;
-  WeakWeightCalculator calc;
-  best_weight = std::accumulate(state.best_items.begin(), state.best_items.end(), 0, calc);
-  auto cond = (state.current_value == state.best_value && state.current_weight < best_weight);
-  if (state.current_value > state.best_value || cond)
-  {
-    state.best_value = state.current_value;
-    state.best_items.clear();
-    ItemCollector collector(state.best_items, state.included, state.weak_items);
-    std::for_each(state.included.begin(), state.included.end(), collector);
-  }
-}
-
-void averenkov::BacktrackStep::operator()()
-{
-  auto items = sharingVec(state.weak_items);
-  if (state.index >= items.size())
-  {
-    BestSolutionUpdater updater{state};
-    updater();
-    return;
-  }
-  state.included[state.index] = false;
-  BacktrackState next_state = state;
-  next_state.index++;
-  BacktrackStep step{next_state};
-  step();
-  if (state.current_weight + items[state.index]->getWeight() <= state.capacity)
-  {
-    state.included[state.index] = true;
-    state.current_weight += items[state.index]->getWeight();
-    state.current_value += items[state.index]->getValue();
-    BacktrackState include_state = state;
-    include_state.index++;
-    BacktrackStep include_step{include_state};
-    include_step();
-    state.included[state.index] = false;
-    state.current_weight -= items[state.index]->getWeight();
-    state.current_value -= items[state.index]->getValue();
   }
+  return items;
 }
 
-bool averenkov::ItemSorter::operator()(std::weak_ptr < const Item > shared_a, std::weak_ptr< const Item > shared_b) const
+averenkov::PlainItem averenkov::PlainItemMaker::operator()(const std::shared_ptr< const Item >& item) const
 {
-  auto a = shared_a.lock();
-  auto b = shared_b.lock();
-  return a->getValue() * b->getWeight() > b->getValue() * a->getWeight();
+  return PlainItem{ item->getWeight(), item->getValue() };
 }
 
-int averenkov::BoundCalculator::operator()(const Node* node) const
+void averenkov::ChosenItemAdder::operator()(size_t index) const
 {
-  auto items = sharingVec(weak_items);
-
-  if (node->weight >= capacity)
-  {
-    return 0;
-  }
-
-  auto cond = (node->level == 0 && node->weight == 0 && node->value == 0);
-  size_t start_level = cond ? 0 : node->level + 1;
-  BoundCalculatorHelper helper{ items, capacity, node->value, node->weight, start_level };
-  helper();
-  return helper.bound;
+  kit.addItem(items[index]);
 }
 
-void averenkov::BoundCalculatorHelper::operator()()
+void averenkov::solveKit(Base& base, const Kit& sourceKit, const std::string& resultKitName, Algorithm algorithm)
 {
-  if (j < items.size() && total_weight + items[j]->getWeight() <= capacity)
-  {
-    total_weight += items[j]->getWeight();
-    bound += items[j]->getValue();
-    j++;
-    (*this)();
-  }
-  else if (j < items.size())
-  {
-    bound += (capacity - total_weight) * items[j]->getValue() / items[j]->getWeight();
-  }
-}
-
-void averenkov::NodeExpander::operator()(Node* node) const
-{
-  auto items = sharingVec(weak_items);
-
-  if (node->bound > max_value)
-  {
-    auto w = node->weight + items[node->level]->getWeight();
-    auto v = node->value + items[node->level]->getValue();
-    Node* left = new Node{ node->level + 1, w, v, 0, node->included };
-    left->included[node->level] = true;
-    left->bound = BoundCalculator{weak_items, capacity}(left);
-
-    if (left->weight <= capacity && left->value > max_value)
-    {
-      max_value = left->value;
-      best_included = left->included;
-    }
+  vecs_it items = sharingVec(sourceKit.getItems());
+  std::vector< PlainItem > plain(items.size());
+  std::transform(items.begin(), items.end(), plain.begin(), PlainItemMaker{});
 
-    if (left->bound > max_value)
-    {
-      queue.push(left);
-    }
-    else
-    {
-      delete left;
-    }
-    Node* right = new Node{ node->level + 1, node->weight, node->value, 0, node->included };
-    right->bound = BoundCalculator{weak_items, capacity}(right);
-    if (right->bound > max_value)
-    {
-      queue.push(right);
-    }
-    else
-    {
-      delete right;
-    }
-  }
-  delete node;
-}
-
-void averenkov::QueueProcessor::operator()() const
-{
-  if (!queue.empty())
-  {
-    Node* node = queue.front();
-    queue.pop();
-    expander(node);
-    QueueProcessor next{queue, expander};
-    next();
-  }
-}
+  Solution solution = solveWith(algorithm, plain, base.current_knapsack.getCapacity());
 
-void averenkov::BBSolutionBuilder::operator()() const
-{
-  if (current_index < items.size())
-  {
-    if (included[current_index])
-    {
-      if (auto shared_item = items[current_index].lock())
-      {
-        resultKit.addItem(shared_item);
-      }
-    }
-    BBSolutionBuilder next{items, included, resultKit, current_index + 1};
-    next();
-  }
+  Kit& resultKit = base.kits.emplace(resultKitName, Kit(resultKitName)).first->second;
+  std::for_each(solution.chosen.begin(), solution.chosen.end(), ChosenItemAdder{ items, resultKit });
 }
 
 void averenkov::solve(Base& base, vec_st args)
@@ -293,15 +66,26 @@ void averenkov::solve(Base& base, vec_st args)
   {
     throw std::invalid_argument("Source kit not found");
   }
-  if (kitIt->second.getItems().size() < 4)
+  vecs_it items = sharingVec(kitIt->second.getItems());
+  std::vector< PlainItem > plain(items.size());
+  std::transform(items.begin(), items.end(), plain.begin(), PlainItemMaker{});
+  switch (chooseAlgorithm(plain, base.current_knapsack.getCapacity()))
   {
+  case Algorithm::BRUTEFORCE:
     bruteforce(base, args);
-    return;
+    break;
+  case Algorithm::DYNAMIC:
+    dynamicProgrammingSolve(base, args);
+    break;
+  case Algorithm::BACKTRACKING:
+    backtrackingSolve(base, args);
+    break;
+  case Algorithm::BRANCH_AND_BOUND:
+    branchAndBoundSolve(base, args);
+    break;
   }
-  branchAndBoundSolve(base, args);
 }
 
-
 void averenkov::bruteforce(Base& base, vec_st args)
 {
   if (args.size() < 3)
@@ -318,28 +102,12 @@ void averenkov::bruteforce(Base& base, vec_st args)
     throw std::invalid_argument("Source kit not found");
   }
 
-  const Kit& sourceKit = kitIt->second;
-  int capacity = base.current_knapsack.getCapacity();
-  const auto& items = sourceKit.getItems();
-
-  std::vector< std::vector< std::weak_ptr < const Item > > > allCombinations;
-  generateCombinations(items, allCombinations, {}, 0);
-
-  std::vector< std::weak_ptr < const Item > > bestCombination;
-  int maxValue = 0;
-  int bestWeight = 0;
-  CombinationEvaluator evaluator(capacity, bestCombination, maxValue, bestWeight);
-  std::for_each(allCombinations.begin(), allCombinations.end(), evaluator);
-
   if (base.kits.find(resultKitName) != base.kits.end())
   {
     throw std::invalid_argument("Kit already exists");
   }
-  auto emplaceResult = base.kits.emplace(resultKitName, Kit(resultKitName));
-  Kit& resultKit = emplaceResult.first->second;
 
-  WeakItemAdder adder(resultKit);
-  std::for_each(bestCombination.begin(), bestCombination.end(), adder);
+  solveKit(base, kitIt->second, resultKitName, Algorithm::BRUTEFORCE);
 }
 
 void averenkov::dynamicProgrammingSolve(Base& base, vec_st args)
@@ -363,28 +131,9 @@ void averenkov::dynamicProgrammingSolve(Base& base, vec_st args)
     throw std::invalid_argument("Result kit already exists");
   }
 
-  const Kit& sourceKit = kitIt->second;
-  int capacity = base.current_knapsack.getCapacity();
-  std::vector< std::weak_ptr< const Item > > items = sourceKit.getItems();
-
-  std::vector< std::vector< int > > dp(items.size() + 1);
-  DPTableInitializer init{dp, capacity};
-  std::for_each(dp.begin(), dp.end(), init);
-
-  DPRowProcessor processor{items, dp, 1};
-  processor();
-
-  std::vector< std::weak_ptr< const Item > > selectedItems;
-  int remaining_weight = capacity;
-  DPSolutionBuilder builder{items, dp, selectedItems, remaining_weight, items.size()};
-  builder();
-
-  Kit& resultKit = base.kits.emplace(resultKitName, Kit(resultKitName)).first->second;
-  WeakItemAdder adder(resultKit);
-  std::for_each(selectedItems.begin(), selectedItems.end(), adder);
+  solveKit(base, kitIt->second, resultKitName, Algorithm::DYNAMIC);
 }
 
-
 void averenkov::backtrackingSolve(Base& base, vec_st args)
 {
   if (args.size() < 3)
@@ -404,22 +153,7 @@ void averenkov::backtrackingSolve(Base& base, vec_st args)
     throw std::invalid_argument("Result kit already exists");
   }
 
-  const Kit& sourceKit = kitIt->second;
-  int capacity = base.current_knapsack.getCapacity();
-  const vec_it& items = sourceKit.getItems();
-
-  vec_it best_items;
-  int best_value = 0;
-  std::vector< bool > included(items.size(), false);
-
-  BacktrackState initial_state{ items, capacity, best_items, best_value, 0, 0, included, 0 };
-
-  BacktrackStep step{initial_state};
-  step();
-
-  Kit& resultKit = base.kits.emplace(resultKitName, Kit(resultKitName)).first->second;
-  WeakItemAdder adder(resultKit);
-  std::for_each(best_items.begin(), best_items.end(), adder);
+  solveKit(base, kitIt->second, resultKitName, Algorithm::BACKTRACKING);
 }
 
 void averenkov::branchAndBoundSolve(Base& base, const std::vector<std::string>& args)
@@ -443,26 +177,56 @@ void averenkov::branchAndBoundSolve(Base& base, const std::vector<std::string>&
     throw std::invalid_argument("Result kit already exists");
   }
 
-  const Kit& sourceKit = kitIt->second;
-  int capacity = base.current_knapsack.getCapacity();
-  std::vector< std::weak_ptr< const Item > > items = sourceKit.getItems();
-
-  ItemSorter sorter;
-  std::sort(items.begin(), items.end(), sorter);
+  solveKit(base, kitIt->second, resultKitName, Algorithm::BRANCH_AND_BOUND);
+}
 
-  std::queue< Node* > queue;
-  std::vector< bool > best_included(items.size(), false);
-  int max_value = 0;
+void averenkov::bench(Base&, vec_st args)
+{
+  if (args.size() < 3 || args.size() > 4)
+  {
+    throw std::invalid_argument("Invalid arguments count for bench");
+  }
+  int count = std::stoi(args[1]);
+  int capacity = std::stoi(args[2]);
+  if (count <= 0 || capacity <= 0)
+  {
+    throw std::invalid_argument("Item count and capacity must be positive");
+  }
+  std::mt19937 rng(args.size() == 4 ? std::stoul(args[3]) : 42u);
 
-  Node* root = new Node{ 0, 0, 0, 0, std::vector< bool >(items.size(), false) };
-  root->bound = BoundCalculator{ items, capacity }(root);
-  queue.push(root);
+  size_t itemCount = static_cast< size_t >(count);
+  int maxWeight = std::max(1, static_cast< int >(2ll * capacity / count));
+  std::uniform_int_distribution< int > weightDist(1, maxWeight);
+  std::uniform_int_distribution< int > noiseDist(1, 100);
+  std::vector< PlainItem > items(itemCount);
+  for (size_t i = 0; i < itemCount; ++i)
+  {
+    items[i].weight = weightDist(rng);
+    items[i].value = items[i].weight + noiseDist(rng);
+  }
 
-  NodeExpander expander{ queue, items, capacity, max_value, best_included };
-  QueueProcessor processor{ queue, expander };
-  processor();
+  std::cout << "items " << itemCount << ", capacity " << capacity;
+  std::cout << ", auto-selected " << algorithmName(chooseAlgorithm(items, capacity)) << "\n";
 
-  Kit& resultKit = base.kits.emplace(resultKitName, Kit(resultKitName)).first->second;
-  BBSolutionBuilder builder{ items, best_included, resultKit, 0 };
-  builder();
+  const Algorithm algorithms[] = {
+    Algorithm::BRUTEFORCE,
+    Algorithm::DYNAMIC,
+    Algorithm::BACKTRACKING,
+    Algorithm::BRANCH_AND_BOUND
+  };
+  for (Algorithm algorithm: algorithms)
+  {
+    std::cout << "  " << algorithmName(algorithm) << ": ";
+    bool skip = (algorithm == Algorithm::BRUTEFORCE && itemCount > benchBruteforceLimit);
+    skip = skip || (algorithm == Algorithm::BACKTRACKING && itemCount > benchBacktrackingLimit);
+    skip = skip || (algorithm == Algorithm::DYNAMIC && !dynamicFits(items, capacity));
+    if (skip)
+    {
+      std::cout << "skipped\n";
+      continue;
+    }
+    BenchResult result = timeSolver(algorithm, items, capacity);
+    std::cout << "value " << result.solution.value << ", weight " << result.solution.weight;
+    std::cout << ", " << result.millis << " ms\n";
+  }
 }
@@ -106,15 +106,32 @@ void belyaev::searchContainsCmd(const Dictionaries& data, std::istream& in, std:
   std::map< std::string, std::function< bool(const entryPair&) > > commandRuOrEng;
   commandRuOrEng["RU"] = std::bind(pairContainsRuChars, _1, word);
   commandRuOrEng["ENG"] = std::bind(pairContainsEnChars, _1, word);
-
-  std::vector< nonConstEntryPair > dictCopy;
-  std::copy(currentDictionary->dict.begin(), currentDictionary->dict.end(), std::back_inserter(dictCopy));
+  std::map< std::string, const wordIndex* > trigramsRuOrEng;
+  trigramsRuOrEng["RU"] = &currentDictionary->ruTrigrams;
+  trigramsRuOrEng["ENG"] = &currentDictionary->enTrigrams;
 
   try
   {
-    using ostreamItStr = std::ostream_iterator< std::string >;
-    auto it = std::stable_partition(dictCopy.begin(), dictCopy.end(), commandRuOrEng[ruOrEng]);
-    std::transform(dictCopy.begin(), it, ostreamItStr{out, "\n"}, formPairString);
+    const std::function< bool(const entryPair&) >& contains = commandRuOrEng.at(ruOrEng);
+    const entryList* candidates = rarestTrigramWords(*trigramsRuOrEng.at(ruOrEng), word);
+    if (candidates == nullptr)
+    {
+      std::vector< nonConstEntryPair > dictCopy;
+      std::copy_if(currentDictionary->dict.begin(), currentDictionary->dict.end(), std::back_inserter(dictCopy), contains);
+      std::transform(dictCopy.begin(), dictCopy.end(), std::ostream_iterator< std::string >{out, "\n"}, formPairString);
+      return;
+    }
+    std::vector< const entryPair* > sorted;
+    auto entryOfBind = std::bind(entryOf, std::cref(*currentDictionary), _1);
+    std::transform(candidates->begin(), candidates->end(), std::back_inserter(sorted), entryOfBind);
+    std::sort(sorted.begin(), sorted.end(), lessByRuWord);
+    for (const entryPair* entry: sorted)
+    {
+      if (contains(*entry))
+      {
+        out << formPairString(*entry) << '\n';
+      }
+    }
   }
   catch (const std::out_of_range& e)
   {
@@ -202,10 +219,7 @@ void belyaev::copyDictionaryCmd(Dictionaries& data, std::istream& in, std::ostre
     out << "<DICTIONARY_NEW ALREADY EXISTS>\n";
     return;
   }
-  newDict = new Dictionary;
-  std::copy(currentDict->dict.begin(), currentDict->dict.end(), std::inserter(newDict->dict, newDict->dict.begin()));
-  data.dicts[dictionaryNew] = *newDict;
-  delete newDict;
+  data.dicts[dictionaryNew] = *currentDict;
 }
 
 void belyaev::renameDictionaryCmd(Dictionaries& data, std::istream& in, std::ostream& out)
@@ -235,12 +249,9 @@ void belyaev::renameDictionaryCmd(Dictionaries& data, std::istream& in, std::ost
     return;
   }
 
-  std::map< std::string, std::string > mapCopy = currentDict->dict;
+  Dictionary dictCopy = std::move(*currentDict);
   data.dicts.erase(dictionaryOld);
-  newDict = new Dictionary;
-  newDict->dict = mapCopy;
-  data.dicts[dictionaryNew] = *newDict;
-  delete newDict;
+  data.dicts[dictionaryNew] = std::move(dictCopy);
 }
 
 void belyaev::mergeDictionariesCmd(Dictionaries& data, std::istream& in, std::ostream& out)
@@ -269,7 +280,7 @@ void belyaev::mergeDictionariesCmd(Dictionaries& data, std::istream& in, std::os
   Dictionary newDict;
   mergeDictsIterator merge(data, newDict);
   std::copy(dictNamesToMerge.begin(), dictNamesToMerge.end(), merge);
-  data.dicts[dictionaryNew] = newDict;
+  data.dicts[dictionaryNew] = std::move(newDict);
 }
 
 void belyaev::intersectDictionariesCmd(Dictionaries& data, std::istream& in, std::ostream& out)
@@ -295,10 +306,12 @@ void belyaev::intersectDictionariesCmd(Dictionaries& data, std::istream& in, std
     return;
   }
 
-  Dictionary newDict;
-  intersectDictsIterator intersect(data, newDict, dictNamesToIntersect);
+  std::vector< const entryPair* > survivors;
+  intersectDictsIterator intersect(data, survivors, dictNamesToIntersect);
   std::copy(dictNamesToIntersect.begin(), dictNamesToIntersect.end(), intersect);
-  data.dicts[dictionaryNew] = newDict;
+  Dictionary newDict;
+  std::for_each(survivors.begin(), survivors.end(), std::bind(appendEntry, std::ref(newDict), _1));
+  data.dicts[dictionaryNew] = std::move(newDict);
 }
 
 void belyaev::deleteIntersectionsCmd(Dictionaries& data, std::istream& in, std::ostream& out)
@@ -1,6 +1,7 @@
 #include "command-helpers.hpp"
 #include <functional>
 #include <algorithm>
+#include <iterator>
 
 belyaev::Dictionary* belyaev::searchDictByName(Dictionaries& data, const std::string& name)
 {
@@ -28,26 +29,28 @@ bool belyaev::insertEntry(Dictionary& currentDictionary, std::string russianWord
   {
     return false;
   }
-  currentDictionary.dict[russianWord] = translation;
+  indexEntry(currentDictionary, *currentDictionary.dict.emplace(russianWord, translation).first);
   return true;
 }
 
 bool belyaev::removeEntry(Dictionary& currentDictionary, std::string russianWord)
 {
-  if (!isRuWordInDictionary(currentDictionary, getItOfWordInDictByRu(currentDictionary, russianWord)))
+  dictionaryIterator entry = getItOfWordInDictByRu(currentDictionary, russianWord);
+  if (!isRuWordInDictionary(currentDictionary, entry))
   {
     return false;
   }
-  currentDictionary.dict.erase(russianWord);
+  unindexEntry(currentDictionary, *entry);
+  currentDictionary.dict.erase(entry);
   return true;
 }
 
-
-bool belyaev::isTranslationInEntry(const std::pair< const std::string, std::string > entry, const std::string& translation)
+void belyaev::appendEntry(Dictionary& currentDictionary, const entryPair* entry)
 {
-  return entry.second == translation;
+  indexEntry(currentDictionary, *currentDictionary.dict.emplace_hint(currentDictionary.dict.end(), *entry));
 }
 
+
 belyaev::dictionaryIterator belyaev::getItOfWordInDictByRu(const Dictionary& dictionary, const std::string& ruWord)
 {
   return dictionary.dict.find(ruWord);
@@ -55,9 +58,16 @@ belyaev::dictionaryIterator belyaev::getItOfWordInDictByRu(const Dictionary& dic
 
 belyaev::dictionaryIterator belyaev::getItOfWordInDictByEn(const Dictionary& dictionary, const std::string& enWord)
 {
-  using namespace std::placeholders;
-  auto isTranslationInEntryBind = std::bind(isTranslationInEntry, _1, enWord);
-  return std::find_if(dictionary.dict.begin(), dictionary.dict.end(), isTranslationInEntryBind);
+  auto words = dictionary.byTranslation.find(enWord);
+  if (words == dictionary.byTranslation.end())
+  {
+    return dictionary.dict.end();
+  }
+  const entryList& postings = words->second;
+  std::vector< const entryPair* > entries;
+  auto entryOfBind = std::bind(entryOf, std::cref(dictionary), std::placeholders::_1);
+  std::transform(postings.begin(), postings.end(), std::back_inserter(entries), entryOfBind);
+  return dictionary.dict.find((*std::min_element(entries.begin(), entries.end(), lessByRuWord))->first);
 }
 
 bool belyaev::isRuWordInDictionary(const Dictionary& dictionary, dictionaryIterator itRuWord)
@@ -101,7 +111,24 @@ bool belyaev::areAllNamesInDicts::operator()()
 belyaev::mergeDictsIterator& belyaev::mergeDictsIterator::operator=(const std::string& srcName)
 {
   const Dictionary* src = searchDictByName(data_, srcName);
-  std::copy(src->dict.begin(), src->dict.end(), std::inserter(dest_.dict, dest_.dict.end()));
+  if (dest_.dict.empty())
+  {
+    dest_ = *src;
+    return *this;
+  }
+  entryMap taken;
+  for (const entryPair& entry: src->dict)
+  {
+    auto inserted = dest_.dict.insert(entry);
+    if (inserted.second)
+    {
+      taken.emplace(&entry, &*inserted.first);
+    }
+  }
+  if (!taken.empty())
+  {
+    mergeIndexes(dest_, *src, taken);
+  }
   return *this;
 }
 
@@ -120,20 +147,15 @@ belyaev::intersectDictsIterator& belyaev::intersectDictsIterator::operator=(cons
   using namespace std::placeholders;
 
   const Dictionary* src = searchDictByName(data_, srcName);
-  auto inserter = std::inserter(dest_.dict, dest_.dict.end());
   if (first_)
   {
-    std::copy(src->dict.begin(), src->dict.end(), inserter);
+    std::transform(src->dict.begin(), src->dict.end(), std::back_inserter(survivors_), addressOfEntry);
     first_ = false;
   }
   else
   {
-    std::vector< nonConstEntryPair > tempDict;
-    std::copy(dest_.dict.begin(), dest_.dict.end(), std::back_inserter(tempDict));
-
-    dest_.dict.clear();
-    auto entryExistsChecker = std::bind(entryExistsInDict, std::cref(*src), _1);
-    std::copy_if(tempDict.begin(), tempDict.end(), inserter, entryExistsChecker);
+    auto entryMissingBind = std::bind(entryMissingFromDict, std::cref(*src), _1);
+    survivors_.erase(std::remove_if(survivors_.begin(), survivors_.end(), entryMissingBind), survivors_.end());
   }
   return *this;
 }
@@ -154,20 +176,33 @@ bool belyaev::entryExistsInDict(const Dictionary& dict, const entryPair& entry)
   return it != dict.dict.end() && it->second == entry.second;
 }
 
+bool belyaev::entryMissingFromDict(const Dictionary& dict, const entryPair* entry)
+{
+  return !entryExistsInDict(dict, *entry);
+}
+
+const belyaev::entryPair* belyaev::addressOfEntry(const entryPair& entry)
+{
+  return &entry;
+}
+
 void belyaev::removeIntersectionsHelper::operator()(const std::string& dictName)
 {
   Dictionary* dict = searchDictByName(data_, dictName);
   if (dict == nullptr) return;
 
-  std::vector< nonConstEntryPair > dictCopy;
-  std::copy(dict->dict.begin(), dict->dict.end(), std::back_inserter(dictCopy));
-
   entryNotInOtherDicts keepPredicate(*this, dictName);
 
-  auto partitionPoint = std::stable_partition(dictCopy.begin(), dictCopy.end(), keepPredicate);
-
-  dict->dict.clear();
-  std::copy(dictCopy.begin(), partitionPoint, std::inserter(dict->dict, dict->dict.end()));
+  std::vector< std::string > shared;
+  for (const entryPair& entry: dict->dict)
+  {
+    if (!keepPredicate(entry))
+    {
+      shared.push_back(entry.first);
+    }
+  }
+  auto removeEntryBind = std::bind(removeEntry, std::ref(*dict), std::placeholders::_1);
+  std::for_each(shared.begin(), shared.end(), removeEntryBind);
 }
 
 bool belyaev::isDictContainingEntry(const Dictionaries& data, const std::string& dictName,
@@ -8,9 +8,9 @@ namespace belyaev
   const Dictionary* searchDictByName(const Dictionaries& data, const std::string& name); // ¯\_(ツ)_/¯
   bool insertEntry(Dictionary& currentDictionary, std::string russianWord, std::string translation);
   bool removeEntry(Dictionary& currentDictionary, std::string russianWord);
+  void appendEntry(Dictionary& currentDictionary, const entryPair* entry);
 
   using dictionaryIterator = std::_Rb_tree_const_iterator< entryPair >;
-  bool isTranslationInEntry(const std::pair< const std::string, std::string > entry, const std::string& translation);
   dictionaryIterator getItOfWordInDictByRu(const Dictionary& dictionary, const std::string& ruWord);
   dictionaryIterator getItOfWordInDictByEn(const Dictionary& dictionary, const std::string& enWord);
   bool isRuWordInDictionary(const Dictionary& dictionary, dictionaryIterator itRuWord);
@@ -50,13 +50,14 @@ namespace belyaev
   class intersectDictsIterator
   {
     const Dictionaries& data_;
-    Dictionary& dest_;
+    std::vector< const entryPair* >& survivors_;
     std::vector< std::string > dictNames_;
     bool first_;
   public:
-    intersectDictsIterator(const Dictionaries& data, Dictionary& dest, const std::vector< std::string >& names):
+    intersectDictsIterator(const Dictionaries& data, std::vector< const entryPair* >& survivors,
+      const std::vector< std::string >& names):
       data_(data),
-      dest_(dest),
+      survivors_(survivors),
       dictNames_(names),
       first_(true)
     {}
@@ -66,6 +67,8 @@ namespace belyaev
   };
 
   bool entryExistsInDict(const Dictionary& dict, const entryPair& entry);
+  bool entryMissingFromDict(const Dictionary& dict, const entryPair* entry);
+  const entryPair* addressOfEntry(const entryPair& entry);
   struct removeIntersectionsHelper
   {
     Dictionaries& data_;
@@ -87,7 +90,7 @@ namespace belyaev
       currentDict_(currentDict)
     {}
 
-    bool operator()(const nonConstEntryPair& entry) const
+    bool operator()(const entryPair& entry) const
     {
       return !helper_.isEntryInOtherDicts(entry, currentDict_);
     }
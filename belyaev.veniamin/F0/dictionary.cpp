@@ -26,3 +26,240 @@ std::ostream& belyaev::operator<<(std::ostream& out, const Dictionary& dictionar
   std::transform(dictionary.dict.begin(), dictionary.dict.end(), ostreamItStr{out, "\n"}, formPairString);
   return out;
 }
+
+namespace
+{
+  bool isCharStart(char byte)
+  {
+    return (static_cast< unsigned char >(byte) & 0xC0) != 0x80;
+  }
+
+  // offsets of the utf-8 characters of text followed by its size; a stray continuation byte
+  // stays glued to the character before it, so a fragment splits the same way as the text around it
+  std::vector< size_t > charBounds(const std::string& text)
+  {
+    std::vector< size_t > bounds;
+    bounds.reserve(text.size() + 1);
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+      if (i == 0 || isCharStart(text[i]))
+      {
+        bounds.push_back(i);
+      }
+    }
+    bounds.push_back(text.size());
+    return bounds;
+  }
+
+  std::vector< std::string > trigramsOf(const std::string& text, size_t charCount)
+  {
+    std::vector< size_t > bounds = charBounds(text);
+    std::vector< std::string > result;
+    result.reserve(bounds.size());
+    for (size_t i = 0; i + belyaev::trigramLength <= std::min(charCount, bounds.size() - 1); ++i)
+    {
+      result.push_back(text.substr(bounds[i], bounds[i + belyaev::trigramLength] - bounds[i]));
+    }
+    return result;
+  }
+
+  size_t takeId(belyaev::Dictionary& dictionary, const belyaev::entryPair& entry)
+  {
+    size_t id = dictionary.entries.size();
+    if (dictionary.freeIds.empty())
+    {
+      dictionary.entries.push_back(&entry);
+      dictionary.slots.emplace_back();
+    }
+    else
+    {
+      id = dictionary.freeIds.back();
+      dictionary.freeIds.pop_back();
+      dictionary.entries[id] = &entry;
+    }
+    dictionary.ids.emplace(&entry, id);
+    return id;
+  }
+
+  void addPosting(belyaev::wordIndex& index, const std::string& key, size_t id, belyaev::slotList& slots)
+  {
+    belyaev::entryList& entries = index[key];
+    if (!entries.empty() && entries.back().id == id)
+    {
+      slots.push_back(belyaev::noSlot);
+      return;
+    }
+    entries.push_back({id, slots.size()});
+    slots.push_back(entries.size() - 1);
+  }
+
+  void addTrigrams(belyaev::wordIndex& trigrams, const std::vector< std::string >& textTrigrams, size_t id,
+    belyaev::slotList& slots)
+  {
+    for (const std::string& trigram: textTrigrams)
+    {
+      addPosting(trigrams, trigram, id, slots);
+    }
+  }
+
+  void erasePosting(belyaev::Dictionary& dictionary, belyaev::wordIndex& index, const std::string& key, size_t slot)
+  {
+    if (slot == belyaev::noSlot)
+    {
+      return;
+    }
+    auto it = index.find(key);
+    belyaev::entryList& entries = it->second;
+    if (slot + 1 != entries.size())
+    {
+      entries[slot] = entries.back();
+      dictionary.slots[entries[slot].id][entries[slot].ordinal] = slot;
+    }
+    entries.pop_back();
+    if (entries.empty())
+    {
+      index.erase(it);
+    }
+  }
+
+  size_t eraseTrigrams(belyaev::Dictionary& dictionary, belyaev::wordIndex& trigrams, const std::string& text,
+    const belyaev::slotList& slots, size_t ordinal)
+  {
+    for (const std::string& trigram: trigramsOf(text, text.size()))
+    {
+      erasePosting(dictionary, trigrams, trigram, slots[ordinal++]);
+    }
+    return ordinal;
+  }
+
+  // destIds maps source ids to the ids their entries were taken under, noSlot if they were not
+  void mergeIndex(belyaev::Dictionary& dest, belyaev::wordIndex& destIndex, const belyaev::wordIndex& srcIndex,
+    const std::vector< size_t >& destIds)
+  {
+    for (const auto& srcEntries: srcIndex)
+    {
+      belyaev::entryList* destEntries = nullptr;
+      for (const belyaev::Posting& posting: srcEntries.second)
+      {
+        size_t id = destIds[posting.id];
+        if (id == belyaev::noSlot)
+        {
+          continue;
+        }
+        if (destEntries == nullptr)
+        {
+          destEntries = &destIndex[srcEntries.first];
+        }
+        dest.slots[id][posting.ordinal] = destEntries->size();
+        destEntries->push_back({id, posting.ordinal});
+      }
+    }
+  }
+}
+
+belyaev::Dictionary::Dictionary(const Dictionary& other):
+  dict(other.dict),
+  byTranslation(other.byTranslation),
+  ruTrigrams(other.ruTrigrams),
+  enTrigrams(other.enTrigrams),
+  entries(other.entries.size(), nullptr),
+  slots(other.slots),
+  freeIds(other.freeIds)
+{
+  ids.reserve(dict.size());
+  auto otherEntry = other.dict.begin();
+  for (const entryPair& entry: dict)
+  {
+    size_t id = other.ids.at(&*otherEntry++);
+    entries[id] = &entry;
+    ids.emplace(&entry, id);
+  }
+}
+
+belyaev::Dictionary& belyaev::Dictionary::operator=(const Dictionary& other)
+{
+  if (this != &other)
+  {
+    *this = Dictionary(other);
+  }
+  return *this;
+}
+
+void belyaev::indexEntry(Dictionary& dictionary, const entryPair& entry)
+{
+  std::vector< std::string > ruTrigrams = trigramsOf(entry.first, entry.first.size());
+  std::vector< std::string > enTrigrams = trigramsOf(entry.second, entry.second.size());
+  size_t id = takeId(dictionary, entry);
+  slotList& slots = dictionary.slots[id];
+  slots.reserve(1 + ruTrigrams.size() + enTrigrams.size());
+  addPosting(dictionary.byTranslation, entry.second, id, slots);
+  addTrigrams(dictionary.ruTrigrams, ruTrigrams, id, slots);
+  addTrigrams(dictionary.enTrigrams, enTrigrams, id, slots);
+}
+
+void belyaev::unindexEntry(Dictionary& dictionary, const entryPair& entry)
+{
+  auto it = dictionary.ids.find(&entry);
+  if (it == dictionary.ids.end())
+  {
+    return;
+  }
+  size_t id = it->second;
+  slotList& slots = dictionary.slots[id];
+  erasePosting(dictionary, dictionary.byTranslation, entry.second, slots[0]);
+  size_t ordinal = eraseTrigrams(dictionary, dictionary.ruTrigrams, entry.first, slots, 1);
+  eraseTrigrams(dictionary, dictionary.enTrigrams, entry.second, slots, ordinal);
+  slots.clear();
+  dictionary.entries[id] = nullptr;
+  dictionary.freeIds.push_back(id);
+  dictionary.ids.erase(it);
+}
+
+void belyaev::mergeIndexes(Dictionary& dest, const Dictionary& src, const entryMap& taken)
+{
+  std::vector< size_t > destIds(src.entries.size(), noSlot);
+  for (const auto& entries: taken)
+  {
+    size_t srcId = src.ids.at(entries.first);
+    size_t id = takeId(dest, *entries.second);
+    dest.slots[id] = src.slots[srcId];
+    destIds[srcId] = id;
+  }
+  mergeIndex(dest, dest.byTranslation, src.byTranslation, destIds);
+  mergeIndex(dest, dest.ruTrigrams, src.ruTrigrams, destIds);
+  mergeIndex(dest, dest.enTrigrams, src.enTrigrams, destIds);
+}
+
+const belyaev::entryPair* belyaev::entryOf(const Dictionary& dictionary, const Posting& posting)
+{
+  return dictionary.entries[posting.id];
+}
+
+bool belyaev::lessByRuWord(const entryPair* lhs, const entryPair* rhs)
+{
+  return lhs->first < rhs->first;
+}
+
+const belyaev::entryList* belyaev::rarestTrigramWords(const wordIndex& trigrams, const std::string& fragment)
+{
+  static const entryList noWords;
+  if (fragment.empty() || !isCharStart(fragment.front()))
+  {
+    return nullptr;
+  }
+  // the last character may continue in the text, only the ones before it split identically
+  const entryList* rarest = nullptr;
+  for (const std::string& trigram: trigramsOf(fragment, charBounds(fragment).size() - 2))
+  {
+    auto it = trigrams.find(trigram);
+    if (it == trigrams.end())
+    {
+      return &noWords;
+    }
+    if (rarest == nullptr || it->second.size() < rarest->size())
+    {
+      rarest = &it->second;
+    }
+  }
+  return rarest;
+}
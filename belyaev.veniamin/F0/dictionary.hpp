@@ -4,15 +4,55 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 
 namespace belyaev
 {
+  using entryPair = std::pair< const std::string, std::string >;
+  using nonConstEntryPair = std::pair< std::string, std::string >;
+  const size_t trigramLength = 3;
+
+  // id names an entry within its dictionary, ordinal numbers its keys: the translation,
+  // then its russian and english trigrams
+  struct Posting
+  {
+    size_t id;
+    size_t ordinal;
+  };
+  using entryList = std::vector< Posting >;
+  using wordIndex = std::unordered_map< std::string, entryList >;
+  using slotList = std::vector< size_t >;
+  using entryMap = std::unordered_map< const entryPair*, const entryPair* >;
+  const size_t noSlot = static_cast< size_t >(-1);
+
+  // byTranslation answers english lookups, the trigram indexes narrow substring searches
+  // down to the entries sharing the fragment's rarest trigram; lists are unordered and hold
+  // ids, slots keep each posting's position in its list so an entry leaves every list by
+  // swapping the last posting in; ids survive a copy, only entries and ids are re-pointed
   struct Dictionary
   {
+    Dictionary() = default;
+    Dictionary(const Dictionary& other);
+    Dictionary(Dictionary&& other) = default;
+    Dictionary& operator=(const Dictionary& other);
+    Dictionary& operator=(Dictionary&& other) = default;
+
     std::map< std::string, std::string > dict;
+    wordIndex byTranslation;
+    wordIndex ruTrigrams;
+    wordIndex enTrigrams;
+    std::vector< const entryPair* > entries;
+    std::vector< slotList > slots;
+    std::vector< size_t > freeIds;
+    std::unordered_map< const entryPair*, size_t > ids;
   };
-  using entryPair = std::pair< const std::string, std::string >;
-  using nonConstEntryPair = std::pair< std::string, std::string >;
+
+  void indexEntry(Dictionary& dictionary, const entryPair& entry);
+  void unindexEntry(Dictionary& dictionary, const entryPair& entry);
+  void mergeIndexes(Dictionary& dest, const Dictionary& src, const entryMap& taken);
+  const entryList* rarestTrigramWords(const wordIndex& trigrams, const std::string& fragment);
+  const entryPair* entryOf(const Dictionary& dictionary, const Posting& posting);
+  bool lessByRuWord(const entryPair* lhs, const entryPair* rhs);
   std::ostream& operator<<(std::ostream& out, const entryPair& pair);
   std::string formPairString(const entryPair& pair);
   std::ostream& operator<<(std::ostream& out, const Dictionary& dictionary);
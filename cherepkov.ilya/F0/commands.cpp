@@ -8,6 +8,7 @@
 #include <set>
 #include <vector>
 #include <stdexcept>
+#include <utility>
 
 namespace cherepkov
 {
@@ -61,7 +62,7 @@ void insert(DictionarySet &dicts, std::istream &in)
   Word w;
   while (file >> w)
   {
-    it->second[w.text]++;
+    it->second.add(w.text);
   }
 }
 
@@ -166,7 +167,7 @@ void mergeDicts(DictionarySet &dicts, std::istream &in)
     Dictionary &src = dicts[sources[i]];
     for (auto it = src.begin(); it != src.end(); ++it)
     {
-      dest[it->first] += it->second;
+      dest.add(it->first, it->second.count);
     }
   }
 }
@@ -197,7 +198,7 @@ void count(DictionarySet &dicts, std::istream &in, std::ostream &out)
   }
   else
   {
-    out << wIt->second << "\n";
+    out << wIt->second.count << "\n";
   }
 }
 
@@ -220,7 +221,7 @@ void search(DictionarySet &dicts, std::istream &in, std::ostream &out)
   }
   else
   {
-    out << wIt->second << "\n";
+    out << wIt->second.count << "\n";
   }
 }
 
@@ -341,7 +342,7 @@ void intersectDicts(DictionarySet &dicts, std::istream &in)
     }
     if (presentEverywhere)
     {
-      result[w] = it->second;
+      result.add(w, it->second.count);
     }
   }
 
@@ -350,7 +351,7 @@ void intersectDicts(DictionarySet &dicts, std::istream &in)
     throw std::logic_error("<NO COMMON WORDS>");
   }
 
-  dicts[newName] = result;
+  dicts[newName] = std::move(result);
 }
 
 void diffDicts(DictionarySet &dicts, std::istream &in)
@@ -378,7 +379,7 @@ void diffDicts(DictionarySet &dicts, std::istream &in)
   {
     if (it2->second.count(it->first) == 0)
     {
-      result[it->first] = it->second;
+      result.add(it->first, it->second.count);
     }
   }
 
@@ -387,7 +388,7 @@ void diffDicts(DictionarySet &dicts, std::istream &in)
     throw std::logic_error("<NO DIFFERENCE>");
   }
 
-  dicts[newName] = result;
+  dicts[newName] = std::move(result);
 }
 
 void filterByFrequency(DictionarySet &dicts, std::istream &in)
@@ -415,21 +416,14 @@ void filterByFrequency(DictionarySet &dicts, std::istream &in)
     throw std::logic_error("<WRONG DICT>");
   }
 
-  Dictionary result;
-  for (auto itw = it->second.begin(); itw != it->second.end(); ++itw)
-  {
-    if (static_cast<long long>(itw->second) >= minv && static_cast<long long>(itw->second) <= maxv)
-    {
-      result[itw->first] = itw->second;
-    }
-  }
+  Dictionary result = it->second.withFrequencies(static_cast< size_t >(minv), static_cast< size_t >(maxv));
 
   if (result.empty())
   {
     throw std::logic_error("<NO MATCHES>");
   }
 
-  dicts[newName] = result;
+  dicts[newName] = std::move(result);
 }
 
 void median(DictionarySet &dicts, std::istream &in, std::ostream &out)
@@ -457,11 +451,7 @@ void median(DictionarySet &dicts, std::istream &in, std::ostream &out)
     throw std::logic_error("<EMPTY DICT>");
   }
 
-  std::vector< std::pair< std::string, size_t > > words(it->second.begin(), it->second.end());
-
-  std::sort(words.begin(), words.end(), CompareByFrequency(false));
-
-  size_t total = words.size();
+  size_t total = it->second.size();
 
   size_t mid = (total - 1) / 2;
 
@@ -477,9 +467,10 @@ void median(DictionarySet &dicts, std::istream &in, std::ostream &out)
   if (L < 0) { L = 0; R = L + needed - 1; }
   if (R >= static_cast<long long>(total)) { R = static_cast<long long>(total) - 1; L = R - (needed - 1); }
 
-  for (long long i = L; i <= R; ++i)
+  std::vector< Dictionary::WordCount > words = it->second.byRank(static_cast< size_t >(L), static_cast< size_t >(R) + 1);
+  for (size_t i = 0; i < words.size(); ++i)
   {
-    out << printPair(words[static_cast<size_t>(i)]) << "\n";
+    out << printPair(words[i]) << "\n";
   }
 }
 
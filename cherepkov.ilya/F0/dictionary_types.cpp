@@ -3,6 +3,7 @@
 #include <iterator>
 #include <vector>
 #include <cctype>
+#include <stdexcept>
 
 namespace cherepkov
 {
@@ -85,23 +86,189 @@ namespace cherepkov
     return p.first + ": " + std::to_string(p.second);
   }
 
-  MergeDictEntry::MergeDictEntry(Dictionary &d): destination(d) {}
+  bool nodeWordLess(const Dictionary::Node *lhs, const Dictionary::Node *rhs)
+  {
+    return lhs->first < rhs->first;
+  }
 
-  std::pair< const std::string, size_t > MergeDictEntry::operator()(const std::pair< const std::string, size_t > &pair) const
+  Dictionary::Dictionary(const Dictionary &other)
   {
-    destination[pair.first] += pair.second;
-    return std::make_pair(pair.first, destination[pair.first]);
+    words_.reserve(other.words_.size());
+    for (auto it = other.words_.begin(); it != other.words_.end(); ++it)
+    {
+      add(it->first, it->second.count);
+    }
   }
 
-  CompareByFrequency::CompareByFrequency(bool desc) : descending(desc) {}
+  Dictionary &Dictionary::operator=(const Dictionary &other)
+  {
+    if (this != &other)
+    {
+      Dictionary copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  Dictionary::Buckets::iterator Dictionary::detach(Node &node)
+  {
+    Buckets::iterator bucket = node.second.bucket;
+    std::vector< Node * > &words = bucket->second;
+    size_t slot = node.second.slot;
+    words[slot] = words.back();
+    words[slot]->second.slot = slot;
+    words.pop_back();
+    Buckets::iterator next = std::next(bucket);
+    if (words.empty())
+    {
+      buckets_.erase(bucket);
+    }
+    return next;
+  }
+
+  void Dictionary::attach(Node &node, Buckets::iterator hint)
+  {
+    size_t frequency = node.second.count;
+    Buckets::iterator bucket = hint;
+    if (bucket == buckets_.end() || bucket->first != frequency)
+    {
+      bool fitsBefore = bucket == buckets_.end() || frequency < bucket->first;
+      bool fitsAfter = bucket == buckets_.begin() || std::prev(bucket)->first < frequency;
+      if (!fitsBefore || !fitsAfter)
+      {
+        bucket = buckets_.lower_bound(frequency);
+      }
+      if (bucket == buckets_.end() || bucket->first != frequency)
+      {
+        bucket = buckets_.emplace_hint(bucket, frequency, std::vector< Node * >());
+      }
+    }
+    node.second.bucket = bucket;
+    node.second.slot = bucket->second.size();
+    bucket->second.push_back(&node);
+  }
 
-  bool CompareByFrequency::operator()(const std::pair< std::string, size_t > &a, const std::pair< std::string, size_t > &b) const
+  void Dictionary::add(const std::string &word, size_t times)
   {
-    if (a.second == b.second)
+    auto it = words_.find(word);
+    Buckets::iterator hint = buckets_.begin();
+    if (it == words_.end())
+    {
+      it = words_.emplace(word, Entry{0, buckets_.end(), 0}).first;
+    }
+    else
     {
-      return a.first < b.first;
+      hint = detach(*it);
     }
-    return descending ? a.second > b.second : a.second < b.second;
+    it->second.count += times;
+    attach(*it, hint);
+  }
+
+  void Dictionary::erase(const_iterator pos)
+  {
+    auto it = words_.find(pos->first);
+    detach(*it);
+    words_.erase(it);
+  }
+
+  void Dictionary::clear()
+  {
+    buckets_.clear();
+    words_.clear();
+  }
+
+  Dictionary::const_iterator Dictionary::find(const std::string &word) const
+  {
+    return words_.find(word);
+  }
+
+  size_t Dictionary::count(const std::string &word) const
+  {
+    return words_.count(word);
+  }
+
+  Dictionary::const_iterator Dictionary::begin() const
+  {
+    return words_.begin();
+  }
+
+  Dictionary::const_iterator Dictionary::end() const
+  {
+    return words_.end();
+  }
+
+  size_t Dictionary::size() const
+  {
+    return words_.size();
+  }
+
+  bool Dictionary::empty() const
+  {
+    return words_.empty();
+  }
+
+  void Dictionary::appendSorted(const Buckets::value_type &bucket, size_t from, size_t to, std::vector< WordCount > &out)
+  {
+    std::vector< const Node * > words(bucket.second.begin(), bucket.second.end());
+    if (from > 0)
+    {
+      std::nth_element(words.begin(), words.begin() + from, words.end(), nodeWordLess);
+    }
+    std::partial_sort(words.begin() + from, words.begin() + to, words.end(), nodeWordLess);
+    for (size_t i = from; i < to; ++i)
+    {
+      out.emplace_back(words[i]->first, bucket.first);
+    }
+  }
+
+  std::vector< Dictionary::WordCount > Dictionary::byFrequency(size_t limit, bool descending) const
+  {
+    if (limit == 0 || limit > words_.size())
+    {
+      limit = words_.size();
+    }
+    if (!descending)
+    {
+      return byRank(0, limit);
+    }
+    std::vector< WordCount > result;
+    result.reserve(limit);
+    for (auto it = buckets_.rbegin(); it != buckets_.rend() && result.size() < limit; ++it)
+    {
+      appendSorted(*it, 0, std::min(it->second.size(), limit - result.size()), result);
+    }
+    return result;
+  }
+
+  std::vector< Dictionary::WordCount > Dictionary::byRank(size_t first, size_t last) const
+  {
+    std::vector< WordCount > result;
+    result.reserve(last - first);
+    size_t passed = 0;
+    for (auto it = buckets_.begin(); it != buckets_.end() && passed < last; ++it)
+    {
+      size_t next = passed + it->second.size();
+      if (next > first)
+      {
+        appendSorted(*it, std::max(first, passed) - passed, std::min(last, next) - passed, result);
+      }
+      passed = next;
+    }
+    return result;
+  }
+
+  Dictionary Dictionary::withFrequencies(size_t minFrequency, size_t maxFrequency) const
+  {
+    Dictionary result;
+    auto it = buckets_.lower_bound(minFrequency);
+    for (; it != buckets_.end() && it->first <= maxFrequency; ++it)
+    {
+      for (const Node *node: it->second)
+      {
+        result.add(node->first, it->first);
+      }
+    }
+    return result;
   }
 
   WordIntersectFilter::WordIntersectFilter(const Dictionary &d) : dict2(d) {}
@@ -131,15 +298,8 @@ namespace cherepkov
       throw std::logic_error("<EMPTY DICT>");
     }
 
-    std::vector< std::pair< std::string, size_t > > words(it->second.begin(), it->second.end());
-    std::sort(words.begin(), words.end(), CompareByFrequency(descending));
-
-    if (limit == 0 || limit > words.size())
-    {
-      limit = words.size();
-    }
-
-    for (size_t i = 0; i < limit; ++i)
+    std::vector< Dictionary::WordCount > words = it->second.byFrequency(limit, descending);
+    for (size_t i = 0; i < words.size(); ++i)
     {
       out << printPair(words[i]) << "\n";
     }
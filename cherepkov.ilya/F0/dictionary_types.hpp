@@ -2,12 +2,61 @@
 #define DICTIONARY_TYPES_HPP
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace cherepkov
 {
-  using Dictionary = std::unordered_map< std::string, size_t >;
+  class Dictionary
+  {
+  public:
+    struct Entry;
+    using Node = std::pair< const std::string, Entry >;
+    // frequency -> words seen exactly that many times, in no particular order
+    using Buckets = std::map< size_t, std::vector< Node * > >;
+    struct Entry
+    {
+      size_t count;
+      Buckets::iterator bucket;
+      size_t slot;
+    };
+    using Words = std::unordered_map< std::string, Entry >;
+    using const_iterator = Words::const_iterator;
+    using WordCount = std::pair< std::string, size_t >;
+
+    Dictionary() = default;
+    Dictionary(const Dictionary &other);
+    Dictionary(Dictionary &&other) = default;
+    Dictionary &operator=(const Dictionary &other);
+    Dictionary &operator=(Dictionary &&other) = default;
+
+    void add(const std::string &word, size_t times = 1);
+    void erase(const_iterator pos);
+    void clear();
+
+    const_iterator find(const std::string &word) const;
+    size_t count(const std::string &word) const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_t size() const;
+    bool empty() const;
+
+    std::vector< WordCount > byFrequency(size_t limit, bool descending) const;
+    std::vector< WordCount > byRank(size_t first, size_t last) const;
+    Dictionary withFrequencies(size_t minFrequency, size_t maxFrequency) const;
+
+  private:
+    Words words_;
+    Buckets buckets_;
+
+    Buckets::iterator detach(Node &node);
+    void attach(Node &node, Buckets::iterator hint);
+    static void appendSorted(const Buckets::value_type &bucket, size_t from, size_t to, std::vector< WordCount > &out);
+  };
+
   using DictionarySet = std::unordered_map< std::string, Dictionary >;
 
   struct Word
@@ -30,20 +79,6 @@ namespace cherepkov
   bool isValidName(const std::string &name);
   std::string printPair(const std::pair< std::string, size_t > &p);
 
-  struct MergeDictEntry
-  {
-    Dictionary &destination;
-    explicit MergeDictEntry(Dictionary &d);
-    std::pair< const std::string, size_t > operator()(const std::pair< const std::string, size_t > &entry) const;
-  };
-
-  struct CompareByFrequency
-  {
-    bool descending;
-    explicit CompareByFrequency(bool desc);
-    bool operator()(const std::pair< std::string, size_t > &a, const std::pair< std::string, size_t > &b) const;
-  };
-
   struct WordIntersectFilter
   {
     const Dictionary &dict2;
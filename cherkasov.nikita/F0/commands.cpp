@@ -4,7 +4,6 @@
 #include <sstream>
 #include <algorithm>
 #include <vector>
-#include <iterator>
 
 namespace cherkasov
 {
@@ -42,37 +41,70 @@ namespace cherkasov
 
   struct CmpTop
   {
+    const WordPool& pool;
     bool operator()(const WordEntry& a, const WordEntry& b) const
     {
-      return (a.second == b.second) ? (a.first < b.first) : (a.second > b.second);
+      return (a.second == b.second) ? (pool.view(a.first) < pool.view(b.first)) : (a.second > b.second);
     }
   };
 
   struct CmpRare
   {
+    const WordPool& pool;
     bool operator()(const WordEntry& a, const WordEntry& b) const
     {
-      return (a.second == b.second) ? (a.first < b.first) : (a.second < b.second);
+      return (a.second == b.second) ? (pool.view(a.first) < pool.view(b.first)) : (a.second < b.second);
     }
   };
 
-  struct Importer
+  struct PrintWord
   {
-    Dict& dict;
-    void operator()(const std::string& word) const
+    std::ostream& out;
+    const WordPool& pool;
+    void operator()(const WordEntry& w) const
     {
-      ++dict[word];
+      out << pool.view(w.first) << " " << w.second << '\n';
     }
   };
 
-  struct PrintWord
+  bool isSpace(char c)
   {
-    std::ostream& out;
-    void operator()(const WordEntry& w) const
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+  // splits like `in >> std::string` does, interning words straight from the read buffer
+  void countWords(std::istream & in, Dict & dict)
+  {
+    WordPool& pool = wordPool();
+    std::vector< char > buffer(1 << 20);
+    std::size_t kept = 0;
+    bool more = true;
+    while (more)
     {
-      out << w.first << " " << w.second << '\n';
+      if (kept == buffer.size())
+      {
+        buffer.resize(buffer.size() * 2);
+      }
+      in.read(buffer.data() + kept, static_cast< std::streamsize >(buffer.size() - kept));
+      std::size_t size = kept + static_cast< std::size_t >(in.gcount());
+      more = size == buffer.size();
+      const char* begin = buffer.data();
+      const char* end = begin + size;
+      const char* word = std::find_if_not(begin, end, isSpace);
+      while (word != end)
+      {
+        const char* wordEnd = std::find_if(word, end, isSpace);
+        if (wordEnd == end && more)
+        {
+          break;
+        }
+        ++dict[pool.intern(word, static_cast< std::size_t >(wordEnd - word))];
+        word = std::find_if_not(wordEnd, end, isSpace);
+      }
+      kept = static_cast< std::size_t >(end - word);
+      std::copy(word, end, buffer.data());
     }
-  };
+  }
 
   void makeDict(std::istream & in, DictTable & dicts)
   {
@@ -109,8 +141,7 @@ namespace cherkasov
     {
       throw std::logic_error("<INVALID FILE>");
     }
-    std::istream_iterator<std::string> begin(file), end;
-    std::for_each(begin, end, Importer{it->second});
+    countWords(file, it->second);
   }
 
   void mergeDicts(std::istream & in, DictTable & dicts)
@@ -177,11 +208,12 @@ namespace cherkasov
     {
       throw std::logic_error("<INVALID NUMBER>");
     }
-    if (it->second.find(word) != it->second.end())
+    WordId id = 0;
+    if (wordPool().find(word, id) && it->second.find(id) != it->second.end())
     {
       throw std::logic_error("<INVALID WORD>");
     }
-    it->second[word] = freq;
+    it->second[wordPool().intern(word)] = freq;
   }
 
   void dictSize(std::istream & in, std::ostream & out, const DictTable & dicts)
@@ -205,7 +237,8 @@ namespace cherkasov
     {
       throw std::logic_error("<INVALID DICTIONARY>");
     }
-    if (it->second.erase(word) == 0)
+    WordId id = 0;
+    if (!wordPool().find(word, id) || it->second.erase(id) == 0)
     {
       throw std::logic_error("<INVALID WORD>");
     }
@@ -238,8 +271,8 @@ namespace cherkasov
       throw std::logic_error("<INVALID NUMBER>");
     }
     std::vector<WordEntry> words(it->second.begin(), it->second.end());
-    std::sort(words.begin(), words.end(), CmpTop{});
-    std::for_each(words.begin(), words.begin() + count, PrintWord{out});
+    std::sort(words.begin(), words.end(), CmpTop{wordPool()});
+    std::for_each(words.begin(), words.begin() + count, PrintWord{out, wordPool()});
   }
 
   void printRare(std::istream & in, std::ostream & out, const DictTable & dicts)
@@ -257,8 +290,8 @@ namespace cherkasov
       throw std::logic_error("<INVALID NUMBER>");
     }
     std::vector<WordEntry> words(it->second.begin(), it->second.end());
-    std::sort(words.begin(), words.end(), CmpRare{});
-    std::for_each(words.begin(), words.begin() + count, PrintWord{out});
+    std::sort(words.begin(), words.end(), CmpRare{wordPool()});
+    std::for_each(words.begin(), words.begin() + count, PrintWord{out, wordPool()});
   }
   void printHelp(std::ostream& out)
   {
@@ -285,11 +318,6 @@ namespace cherkasov
       throw std::runtime_error("Failed to open file: " + filename);
     }
 
-    auto& dict = dicts["default"];
-    std::string word;
-    while (file >> word)
-    {
-      ++dict[word];
-    }
+    countWords(file, dicts["default"]);
   }
 }
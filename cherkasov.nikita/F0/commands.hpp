@@ -4,12 +4,13 @@
 #include <iosfwd>
 #include <unordered_map>
 #include <string>
+#include "word_pool.hpp"
 
 namespace cherkasov
 {
-  using Dict = std::unordered_map< std::string, int >;
+  using Dict = std::unordered_map< WordId, int >;
   using DictTable = std::unordered_map< std::string, Dict >;
-  using WordEntry = std::pair< std::string, int >;
+  using WordEntry = std::pair< WordId, int >;
 
   void makeDict(std::istream & in, DictTable & dicts);
   void listDicts(std::ostream & out, const DictTable & dicts);
@@ -0,0 +1,139 @@
+#include "word_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace cherkasov
+{
+  std::size_t hashBytes(const char * data, std::size_t size)
+  {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      hash ^= static_cast< unsigned char >(data[i]);
+      hash *= 1099511628211ULL;
+    }
+    return static_cast< std::size_t >(hash ^ (hash >> 32));
+  }
+
+  bool operator<(const WordView & lhs, const WordView & rhs)
+  {
+    int cmp = std::memcmp(lhs.data, rhs.data, std::min(lhs.size, rhs.size));
+    return cmp < 0 || (cmp == 0 && lhs.size < rhs.size);
+  }
+
+  std::ostream & operator<<(std::ostream & out, const WordView & word)
+  {
+    return out.write(word.data, static_cast< std::streamsize >(word.size));
+  }
+
+  const WordId WordPool::NO_WORD;
+  const std::size_t WordPool::CHUNK_SIZE;
+
+  WordPool::WordPool():
+    chunks_(),
+    chunkUsed_(CHUNK_SIZE),
+    words_(),
+    hashes_(),
+    slots_(1024, NO_WORD)
+  {}
+
+  std::size_t WordPool::findSlot(const char * data, std::size_t size, std::size_t hash) const
+  {
+    std::size_t mask = slots_.size() - 1;
+    std::size_t slot = hash & mask;
+    while (slots_[slot] != NO_WORD)
+    {
+      WordId id = slots_[slot];
+      const WordView & word = words_[id];
+      if (hashes_[id] == hash && word.size == size && std::memcmp(word.data, data, size) == 0)
+      {
+        break;
+      }
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  const char * WordPool::store(const char * data, std::size_t size)
+  {
+    if (size > CHUNK_SIZE / 4)
+    {
+      // long words get a chunk of their own, kept behind the one being filled
+      auto own = chunks_.emplace(chunks_.empty() ? chunks_.end() : chunks_.end() - 1, new char[size]);
+      std::memcpy(own->get(), data, size);
+      return own->get();
+    }
+    if (chunkUsed_ + size > CHUNK_SIZE)
+    {
+      chunks_.emplace_back(new char[CHUNK_SIZE]);
+      chunkUsed_ = 0;
+    }
+    char * at = chunks_.back().get() + chunkUsed_;
+    std::memcpy(at, data, size);
+    chunkUsed_ += size;
+    return at;
+  }
+
+  void WordPool::rehash()
+  {
+    std::vector< WordId > slots(slots_.size() * 2, NO_WORD);
+    std::size_t mask = slots.size() - 1;
+    for (WordId id = 0; id < words_.size(); ++id)
+    {
+      std::size_t slot = hashes_[id] & mask;
+      while (slots[slot] != NO_WORD)
+      {
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = id;
+    }
+    slots_.swap(slots);
+  }
+
+  WordId WordPool::intern(const char * data, std::size_t size)
+  {
+    std::size_t hash = hashBytes(data, size);
+    std::size_t slot = findSlot(data, size, hash);
+    if (slots_[slot] != NO_WORD)
+    {
+      return slots_[slot];
+    }
+    WordId id = static_cast< WordId >(words_.size());
+    words_.push_back(WordView{store(data, size), size});
+    hashes_.push_back(hash);
+    slots_[slot] = id;
+    if (words_.size() * 2 > slots_.size())
+    {
+      rehash();
+    }
+    return id;
+  }
+
+  WordId WordPool::intern(const std::string & word)
+  {
+    return intern(word.data(), word.size());
+  }
+
+  bool WordPool::find(const std::string & word, WordId & id) const
+  {
+    std::size_t slot = findSlot(word.data(), word.size(), hashBytes(word.data(), word.size()));
+    if (slots_[slot] == NO_WORD)
+    {
+      return false;
+    }
+    id = slots_[slot];
+    return true;
+  }
+
+  WordView WordPool::view(WordId id) const
+  {
+    return words_[id];
+  }
+
+  WordPool & wordPool()
+  {
+    static WordPool pool;
+    return pool;
+  }
+}
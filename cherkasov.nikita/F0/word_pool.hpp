@@ -0,0 +1,53 @@
+#ifndef WORD_POOL_HPP
+#define WORD_POOL_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cherkasov
+{
+  using WordId = std::uint32_t;
+
+  struct WordView
+  {
+    const char * data;
+    std::size_t size;
+  };
+
+  bool operator<(const WordView & lhs, const WordView & rhs);
+  std::ostream & operator<<(std::ostream & out, const WordView & word);
+
+  // Every distinct word is stored once in an arena and named by a dense id,
+  // so dictionaries hold only integers. Lookups take raw character ranges
+  // and never build a std::string. Words are kept for the process lifetime.
+  class WordPool
+  {
+  public:
+    WordPool();
+    WordId intern(const char * data, std::size_t size);
+    WordId intern(const std::string & word);
+    bool find(const std::string & word, WordId & id) const;
+    WordView view(WordId id) const;
+
+  private:
+    static const WordId NO_WORD = UINT32_MAX;
+    static const std::size_t CHUNK_SIZE = 1 << 16;
+
+    std::vector< std::unique_ptr< char[] > > chunks_;
+    std::size_t chunkUsed_;
+    std::vector< WordView > words_;
+    std::vector< std::size_t > hashes_;
+    std::vector< WordId > slots_;
+
+    std::size_t findSlot(const char * data, std::size_t size, std::size_t hash) const;
+    const char * store(const char * data, std::size_t size);
+    void rehash();
+  };
+
+  WordPool & wordPool();
+}
+
+#endif
@@ -0,0 +1,419 @@
+#include "text_model.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace amine
+{
+  namespace
+  {
+    bool sameToken(const Token& a, const Token& b)
+    {
+      return a.column == b.column && a.word == b.word;
+    }
+
+    Line& changedLine(std::map< size_t, Line >& changes, const LineRope& lines, size_t line)
+    {
+      auto it = changes.find(line);
+      if (it == changes.end())
+      {
+        it = changes.emplace(line, lines[line]).first;
+      }
+      return it->second;
+    }
+  }
+
+  bool positionLess::operator()(const Position& a, const Position& b) const
+  {
+    return (a.line < b.line) || (a.line == b.line && a.column < b.column);
+  }
+
+  bool tokenLess::operator()(const Token& a, const Token& b) const
+  {
+    return (a.column < b.column) || (a.column == b.column && a.word < b.word);
+  }
+
+  void normalizeLine(Line& line)
+  {
+    std::sort(line.begin(), line.end(), tokenLess());
+    line.erase(std::unique(line.begin(), line.end(), sameToken), line.end());
+  }
+
+  size_t LineRope::size() const noexcept
+  {
+    return ends_.empty() ? 0 : ends_.back();
+  }
+
+  bool LineRope::empty() const noexcept
+  {
+    return pieces_.empty();
+  }
+
+  const Line& LineRope::operator[](size_t line) const
+  {
+    static const Line blank;
+    size_t piece = findPiece(line);
+    const Piece& found = pieces_[piece];
+    if (!found.lines)
+    {
+      return blank;
+    }
+    return (*found.lines)[found.from + line - pieceStart(piece)];
+  }
+
+  void LineRope::append(std::vector< Line > lines)
+  {
+    size_t count = lines.size();
+    push(Piece{ std::make_shared< const std::vector< Line > >(std::move(lines)), 0, count });
+  }
+
+  void LineRope::append(const LineRope& other)
+  {
+    append(other, 0, other.size());
+  }
+
+  void LineRope::append(const LineRope& other, size_t from, size_t to)
+  {
+    if (&other == this)
+    {
+      LineRope copy(other);
+      append(copy, from, to);
+      return;
+    }
+    to = std::min(to, other.size());
+    if (from >= to)
+    {
+      return;
+    }
+    for (size_t piece = other.findPiece(from); from < to; ++piece)
+    {
+      const Piece& source = other.pieces_[piece];
+      size_t last = std::min(other.ends_[piece], to);
+      push(Piece{ source.lines, source.from + from - other.pieceStart(piece), last - from });
+      from = last;
+    }
+  }
+
+  void LineRope::appendLine(Line line)
+  {
+    std::vector< Line > lines;
+    lines.push_back(std::move(line));
+    append(std::move(lines));
+  }
+
+  void LineRope::appendBlank(size_t count)
+  {
+    push(Piece{ nullptr, 0, count });
+  }
+
+  void LineRope::replaceLines(std::map< size_t, Line > changes)
+  {
+    std::vector< Piece > old;
+    old.swap(pieces_);
+    ends_.clear();
+
+    std::vector< Line > run;
+    auto flushRun = [&]() {
+      if (!run.empty())
+      {
+        append(std::move(run));
+        run.clear();
+      }
+    };
+
+    auto change = changes.begin();
+    size_t start = 0;
+    for (const Piece& piece : old)
+    {
+      size_t end = start + piece.count;
+      size_t current = start;
+      for (; change != changes.end() && change->first < end; ++change)
+      {
+        if (change->first > current)
+        {
+          flushRun();
+          push(Piece{ piece.lines, piece.from + current - start, change->first - current });
+        }
+        run.push_back(std::move(change->second));
+        current = change->first + 1;
+      }
+      if (current < end)
+      {
+        flushRun();
+        push(Piece{ piece.lines, piece.from + current - start, end - current });
+      }
+      start = end;
+    }
+    flushRun();
+  }
+
+  void LineRope::trimBack()
+  {
+    while (!pieces_.empty())
+    {
+      Piece& back = pieces_.back();
+      if (back.lines)
+      {
+        while (back.count > 0 && (*back.lines)[back.from + back.count - 1].empty())
+        {
+          --back.count;
+          --ends_.back();
+        }
+        if (back.count > 0)
+        {
+          return;
+        }
+      }
+      pieces_.pop_back();
+      ends_.pop_back();
+    }
+  }
+
+  LineRope LineRope::reversed() const
+  {
+    LineRope result;
+    for (auto it = pieces_.rbegin(); it != pieces_.rend(); ++it)
+    {
+      if (!it->lines)
+      {
+        result.appendBlank(it->count);
+        continue;
+      }
+      auto first = it->lines->begin() + it->from;
+      result.append(std::vector< Line >(std::make_reverse_iterator(first + it->count),
+                                        std::make_reverse_iterator(first)));
+    }
+    return result;
+  }
+
+  void LineRope::push(Piece piece)
+  {
+    if (piece.count == 0)
+    {
+      return;
+    }
+    size_t end = size() + piece.count;
+    if (!pieces_.empty())
+    {
+      Piece& back = pieces_.back();
+      bool bothBlank = !back.lines && !piece.lines;
+      if (bothBlank || (back.lines && back.lines == piece.lines && back.from + back.count == piece.from))
+      {
+        back.count += piece.count;
+        ends_.back() = end;
+        return;
+      }
+    }
+    pieces_.push_back(std::move(piece));
+    ends_.push_back(end);
+  }
+
+  size_t LineRope::findPiece(size_t line) const
+  {
+    return std::upper_bound(ends_.begin(), ends_.end(), line) - ends_.begin();
+  }
+
+  size_t LineRope::pieceStart(size_t piece) const
+  {
+    return piece == 0 ? 0 : ends_[piece - 1];
+  }
+
+  Document::Document(LineRope lines):
+    lines_(std::move(lines)),
+    index_()
+  {
+    lines_.trimBack();
+  }
+
+  Document::Document(Index index):
+    lines_(),
+    index_()
+  {
+    std::map< size_t, Line > byLine;
+    for (const auto& entry : index)
+    {
+      for (const Position& pos : entry.second)
+      {
+        byLine[pos.line].push_back(Token{ pos.column, entry.first });
+      }
+    }
+
+    std::vector< Line > run;
+    for (auto& line : byLine)
+    {
+      if (line.first > lines_.size() + run.size())
+      {
+        lines_.append(std::move(run));
+        run.clear();
+        lines_.appendBlank(line.first - lines_.size());
+      }
+      normalizeLine(line.second);
+      run.push_back(std::move(line.second));
+    }
+    lines_.append(std::move(run));
+    index_ = std::make_shared< Index >(std::move(index));
+  }
+
+  const LineRope& Document::lines() const noexcept
+  {
+    return lines_;
+  }
+
+  const Index& Document::index() const
+  {
+    if (!index_)
+    {
+      auto index = std::make_shared< Index >();
+      lines_.forEachLine([&](size_t lineNum, const Line& line) {
+        for (const Token& token : line)
+        {
+          auto& positions = (*index)[token.word];
+          positions.insert(positions.end(), Position{ lineNum, token.column });
+        }
+      });
+      index_ = std::move(index);
+    }
+    return *index_;
+  }
+
+  bool Document::contains(const std::string& word) const
+  {
+    if (index_)
+    {
+      return index_->find(word) != index_->end();
+    }
+    return !positions(word).empty();
+  }
+
+  std::vector< Position > Document::positions(const std::string& word) const
+  {
+    std::vector< Position > result;
+    if (index_)
+    {
+      auto found = index_->find(word);
+      if (found != index_->end())
+      {
+        result.assign(found->second.begin(), found->second.end());
+      }
+      return result;
+    }
+    lines_.forEachLine([&](size_t lineNum, const Line& line) {
+      for (const Token& token : line)
+      {
+        if (token.word == word)
+        {
+          result.push_back(Position{ lineNum, token.column });
+        }
+      }
+    });
+    return result;
+  }
+
+  bool Document::empty() const noexcept
+  {
+    return lines_.empty();
+  }
+
+  size_t Document::lineCount() const noexcept
+  {
+    return lines_.empty() ? 1 : lines_.size();
+  }
+
+  void Document::replaceWord(const std::string& oldWord, const std::string& newWord)
+  {
+    std::vector< Position > oldPositions = positions(oldWord);
+    if (oldPositions.empty())
+    {
+      return;
+    }
+
+    std::map< size_t, Line > changes;
+    for (const Position& pos : positions(newWord))
+    {
+      Line& line = changedLine(changes, lines_, pos.line);
+      Token token{ pos.column, newWord };
+      auto found = std::lower_bound(line.begin(), line.end(), token, tokenLess());
+      if (found != line.end() && sameToken(*found, token))
+      {
+        line.erase(found);
+      }
+    }
+    if (oldWord != newWord)
+    {
+      for (const Position& pos : oldPositions)
+      {
+        Line& line = changedLine(changes, lines_, pos.line);
+        Token token{ pos.column, oldWord };
+        auto found = std::lower_bound(line.begin(), line.end(), token, tokenLess());
+        if (found != line.end() && sameToken(*found, token))
+        {
+          found->word = newWord;
+        }
+      }
+    }
+    for (auto& line : changes)
+    {
+      normalizeLine(line.second);
+    }
+    lines_.replaceLines(std::move(changes));
+    lines_.trimBack();
+
+    if (index_)
+    {
+      Index& index = ownIndex();
+      auto oldIt = index.find(oldWord);
+      if (oldWord != newWord)
+      {
+        index[newWord] = std::move(oldIt->second);
+      }
+      index.erase(oldIt);
+    }
+  }
+
+  void Document::swapWords(const std::string& word1, const std::string& word2)
+  {
+    if (word1 == word2)
+    {
+      return;
+    }
+
+    std::map< size_t, Line > changes;
+    for (const std::string* word : { &word1, &word2 })
+    {
+      for (const Position& pos : positions(*word))
+      {
+        changedLine(changes, lines_, pos.line);
+      }
+    }
+    for (auto& line : changes)
+    {
+      for (Token& token : line.second)
+      {
+        if (token.word == word1)
+        {
+          token.word = word2;
+        }
+        else if (token.word == word2)
+        {
+          token.word = word1;
+        }
+      }
+      normalizeLine(line.second);
+    }
+    lines_.replaceLines(std::move(changes));
+
+    if (index_)
+    {
+      Index& index = ownIndex();
+      index[word1].swap(index[word2]);
+    }
+  }
+
+  Index& Document::ownIndex()
+  {
+    if (index_.use_count() > 1)
+    {
+      index_ = std::make_shared< Index >(*index_);
+    }
+    return *index_;
+  }
+}
@@ -0,0 +1,123 @@
+#ifndef TEXT_MODEL_HPP
+#define TEXT_MODEL_HPP
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace amine
+{
+  struct Position
+  {
+    size_t line;
+    size_t column;
+  };
+
+  struct positionLess
+  {
+    bool operator()(const Position& a, const Position& b) const;
+  };
+
+  using Index = std::map< std::string, std::set< Position, positionLess > >;
+
+  struct Token
+  {
+    size_t column;
+    std::string word;
+  };
+
+  struct tokenLess
+  {
+    bool operator()(const Token& a, const Token& b) const;
+  };
+
+  // tokens of one line, sorted by column and word without repeats
+  using Line = std::vector< Token >;
+
+  void normalizeLine(Line& line);
+
+  // sequence of lines kept as windows over shared immutable chunks; runs of blank lines
+  // take no storage, so slicing, concatenation and shifting cost O(chunks), not O(lines)
+  class LineRope
+  {
+  public:
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+    const Line& operator[](size_t line) const;
+
+    void append(std::vector< Line > lines);
+    void append(const LineRope& other);
+    void append(const LineRope& other, size_t from, size_t to);
+    void appendLine(Line line);
+    void appendBlank(size_t count);
+    void replaceLines(std::map< size_t, Line > changes);
+    void trimBack();
+    LineRope reversed() const;
+
+    // visits every stored line with its number, blank runs are skipped
+    template< class F >
+    void forEachLine(F f) const;
+
+  private:
+    struct Piece
+    {
+      std::shared_ptr< const std::vector< Line > > lines;
+      size_t from;
+      size_t count;
+    };
+
+    std::vector< Piece > pieces_;
+    std::vector< size_t > ends_;
+
+    void push(Piece piece);
+    size_t findPiece(size_t line) const;
+    size_t pieceStart(size_t piece) const;
+  };
+
+  // the line rope is the primary store; the word index is derived on demand and kept
+  // up to date by in-place edits, single-word lookups scan the lines until it exists
+  class Document
+  {
+  public:
+    Document() = default;
+    explicit Document(LineRope lines);
+    explicit Document(Index index);
+
+    const LineRope& lines() const noexcept;
+    const Index& index() const;
+    bool contains(const std::string& word) const;
+    std::vector< Position > positions(const std::string& word) const;
+    bool empty() const noexcept;
+    size_t lineCount() const noexcept;
+
+    void replaceWord(const std::string& oldWord, const std::string& newWord);
+    void swapWords(const std::string& word1, const std::string& word2);
+
+  private:
+    LineRope lines_;
+    mutable std::shared_ptr< Index > index_;
+
+    Index& ownIndex();
+  };
+
+  template< class F >
+  void LineRope::forEachLine(F f) const
+  {
+    size_t start = 0;
+    for (const Piece& piece : pieces_)
+    {
+      if (piece.lines)
+      {
+        for (size_t i = 0; i < piece.count; ++i)
+        {
+          f(start + i, (*piece.lines)[piece.from + i]);
+        }
+      }
+      start += piece.count;
+    }
+  }
+}
+
+#endif
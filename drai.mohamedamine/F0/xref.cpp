@@ -11,11 +11,6 @@
 
 namespace amine
 {
-  bool positionLess::operator()(const Position& a, const Position& b) const
-  {
-    return (a.line < b.line) || (a.line == b.line && a.column < b.column);
-  }
-
   std::ostream& operator<<(std::ostream& out, const Position& pos)
   {
     out << pos.line << ":" << pos.column;
@@ -24,46 +19,32 @@ namespace amine
 
   CrossRefSystem::CrossRefSystem()
   {
-    indexes_ = std::map< std::string, Index >();
+    indexes_ = std::map< std::string, Document >();
   }
 
-  void readLines(std::ifstream& file, std::vector< std::string >& lines)
-  {
-    std::string line;
-    if (!std::getline(file, line))
-      return;
-    lines.push_back(line);
-    readLines(file, lines);
-  }
-
-  void splitWords(std::istringstream& stream, std::vector< std::string >& words)
+  Line splitLine(const std::string& text)
   {
+    Line line;
+    std::istringstream stream(text);
     std::string word;
-    if (!(stream >> word))
-      return;
-    words.push_back(word);
-    splitWords(stream, words);
-  }
-
-  void insertWordsRecursive(amine::Index& index, const std::vector< std::string >& words, size_t lineNum, size_t col)
-  {
-    if (col >= words.size())
-      return;
-    index[words[col]].insert(amine::Position{ lineNum, col });
-    insertWordsRecursive(index, words, lineNum, col + 1);
+    while (stream >> word)
+    {
+      line.push_back(Token{ line.size(), word });
+    }
+    return line;
   }
 
-  void processLinesRecursive(amine::Index& index, const std::vector< std::string >& lines, size_t lineNum)
+  LineRope readText(std::ifstream& file)
   {
-    if (lineNum >= lines.size())
-      return;
-
-    std::istringstream stream(lines[lineNum]);
-    std::vector< std::string > words;
-    splitWords(stream, words);
-
-    insertWordsRecursive(index, words, lineNum, 0);
-    processLinesRecursive(index, lines, lineNum + 1);
+    std::vector< Line > lines;
+    std::string text;
+    while (std::getline(file, text))
+    {
+      lines.push_back(splitLine(text));
+    }
+    LineRope rope;
+    rope.append(std::move(lines));
+    return rope;
   }
 
   void CrossRefSystem::buildIndex(const std::string& indexName, const std::string& fileName)
@@ -81,11 +62,7 @@ namespace amine
       return;
     }
 
-    Index index;
-    std::vector< std::string > lines;
-    readLines(file, lines);
-    processLinesRecursive(index, lines, 0);
-    indexes_.insert({ indexName, index });
+    indexes_.insert({ indexName, Document(readText(file)) });
   }
 
   void CrossRefSystem::deleteIndex(const std::string& indexName)
@@ -108,9 +85,7 @@ namespace amine
       return;
     }
 
-    const Index& index = indexIt->second;
-    auto wordIt = index.find(word);
-    if (wordIt != index.end())
+    if (indexIt->second.contains(word))
     {
       std::cout << "<YES>\n";
     }
@@ -148,7 +123,7 @@ namespace amine
       return;
     }
 
-    const Index& index = it->second;
+    const Index& index = it->second.index();
     printIndexRecursive(index.begin(), index.end());
   }
 
@@ -161,25 +136,17 @@ namespace amine
       return;
     }
 
-    const Index& index = it->second;
-    auto wordIt = index.find(word);
-    if (wordIt == index.end())
+    const std::vector< Position > positions = it->second.positions(word);
+    if (positions.empty())
     {
       std::cout << "<NOT FOUND>\n";
       return;
     }
 
-    const std::set< Position, positionLess >& positions = wordIt->second;
-
-    std::function< void(std::set< Position >::const_iterator) > printRecursive;
-    printRecursive = [&](std::set< Position >::const_iterator posIt) {
-      if (posIt == positions.end())
-        return;
-      std::cout << posIt->line << ":" << posIt->column << "\n";
-      printRecursive(std::next(posIt));
-    };
-
-    printRecursive(positions.begin());
+    for (const Position& pos : positions)
+    {
+      std::cout << pos.line << ":" << pos.column << "\n";
+    }
   }
 
   void CrossRefSystem::mergeTexts(const std::string& newIndex, const std::string& index1, const std::string& index2)
@@ -192,17 +159,13 @@ namespace amine
       return;
     }
 
-    const Index& first = it1->second;
-    const Index& second = it2->second;
-    Index result;
-
-    copyIndexWithOffset(result, first, 0);
+    const Document& first = it1->second;
+    const Document& second = it2->second;
 
-    size_t lastLine = getMaxLineRecursive(first.begin(), first.end(), 0);
-    size_t offset = lastLine + 1;
-
-    copyIndexWithOffset(result, second, offset);
-    indexes_[newIndex] = result;
+    LineRope result = first.lines();
+    result.appendBlank(first.lineCount() - first.lines().size());
+    result.append(second.lines());
+    indexes_[newIndex] = Document(std::move(result));
   }
   void CrossRefSystem::insertText(const std::string& newIndex, const std::string& baseIndex,
                                   const std::string& insertIndex, size_t afterLine, size_t afterColumn)
@@ -215,63 +178,35 @@ namespace amine
       std::cout << "<WRONG INDEX>\n";
       return;
     }
-    const Index& base = baseIt->second;
-    const Index& toInsert = insertIt->second;
-    Index result;
-
-    std::function< bool(Index::const_iterator) > validatePosRecursive;
-    validatePosRecursive = [&](Index::const_iterator it) -> bool {
-      if (it == base.end())
-        return false;
-      std::function< bool(std::set< Position >::const_iterator) > checkPositions;
-      checkPositions = [&](std::set< Position >::const_iterator posIt) -> bool {
-        if (posIt == it->second.end())
-          return false;
-        if (posIt->line == afterLine && posIt->column == afterColumn)
-          return true;
-        return checkPositions(std::next(posIt));
-      };
-      return checkPositions(it->second.begin()) || validatePosRecursive(std::next(it));
-    };
+    const LineRope& base = baseIt->second.lines();
+    const Document& toInsert = insertIt->second;
 
-    if (!validatePosRecursive(base.begin()))
+    auto atColumn = [&](const Token& token) {
+      return token.column == afterColumn;
+    };
+    if (afterLine >= base.size() || std::none_of(base[afterLine].begin(), base[afterLine].end(), atColumn))
     {
       std::cout << "<INVALID POSITION>\n";
       return;
     }
 
-    Index before, after;
-    std::function< void(Index::const_iterator) > splitRecursive;
-    splitRecursive = [&](Index::const_iterator it) {
-      if (it == base.end())
-        return;
-      const std::string& word = it->first;
-      std::function< void(std::set< Position >::const_iterator) > processPositions;
-      processPositions = [&](std::set< Position >::const_iterator posIt) {
-        if (posIt == it->second.end())
-          return;
-        if (posIt->line < afterLine || (posIt->line == afterLine && posIt->column <= afterColumn))
-          before[word].insert(*posIt);
-        else
-          after[word].insert(*posIt);
-        processPositions(std::next(posIt));
-      };
-
-      processPositions(it->second.begin());
-      splitRecursive(std::next(it));
-    };
-
-    splitRecursive(base.begin());
-
-    copyIndexWithOffset(result, before, 0);
-
-    size_t insertOffset = getMaxLineRecursive(before.begin(), before.end(), 0) + 1;
-    copyIndexWithOffset(result, toInsert, insertOffset);
-
-    size_t finalOffset = insertOffset + getMaxLineRecursive(toInsert.begin(), toInsert.end(), 0) + 1;
-    copyIndexWithOffset(result, after, finalOffset - insertOffset);
-
-    indexes_[newIndex] = result;
+    const Line& split = base[afterLine];
+    auto tail = std::find_if(split.begin(), split.end(), [&](const Token& token) {
+      return token.column > afterColumn;
+    });
+
+    size_t insertLines = toInsert.lineCount();
+    Line last = toInsert.empty() ? Line() : toInsert.lines()[insertLines - 1];
+    last.insert(last.end(), tail, split.end());
+    normalizeLine(last);
+
+    LineRope result;
+    result.append(base, 0, afterLine);
+    result.appendLine(Line(split.begin(), tail));
+    result.append(toInsert.lines(), 0, insertLines - 1);
+    result.appendLine(std::move(last));
+    result.append(base, afterLine + 1, base.size());
+    indexes_[newIndex] = Document(std::move(result));
   }
 
   void CrossRefSystem::extractText(const std::string& newIndex, const std::string& baseIndex, size_t startLine,
@@ -283,94 +218,36 @@ namespace amine
       std::cout << "<WRONG INDEX>\n";
       return;
     }
-    const Index& base = baseIt->second;
-    Index result;
+    const LineRope& base = baseIt->second.lines();
     if (startLine > endLine || (startLine == endLine && startCol > endCol))
     {
       std::cout << "<INVALID RANGE>\n";
       return;
     }
-    std::function< void(Index::const_iterator) > extractRecursive;
-    extractRecursive = [&](Index::const_iterator it) {
-      if (it == base.end())
-        return;
 
-      const std::string& word = it->first;
-      const auto& positions = it->second;
-
-      std::function< void(std::set< Position >::const_iterator) > filterPositions;
-      filterPositions = [&](std::set< Position >::const_iterator pit) {
-        if (pit == positions.end())
-          return;
-
-        const auto& pos = *pit;
-        bool insideRange = (pos.line > startLine || (pos.line == startLine && pos.column >= startCol)) &&
-                           (pos.line < endLine || (pos.line == endLine && pos.column <= endCol));
-
-        if (insideRange)
-          result[word].insert(pos);
-
-        filterPositions(std::next(pit));
-      };
-
-      filterPositions(positions.begin());
-      extractRecursive(std::next(it));
+    auto filterLine = [&](size_t lineNum) {
+      Line line;
+      std::copy_if(base[lineNum].begin(), base[lineNum].end(), std::back_inserter(line), [&](const Token& token) {
+        return (lineNum > startLine || token.column >= startCol) && (lineNum < endLine || token.column <= endCol);
+      });
+      return line;
     };
 
-    extractRecursive(base.begin());
-    indexes_[newIndex] = result;
-  }
-
-  void copyIndexWithOffset(amine::Index& target, const amine::Index& source, size_t lineOffset)
-  {
-    if (source.empty())
-      return;
-
-    auto it = source.begin();
-
-    std::function< void(Index::const_iterator) > copyRecursive;
-    copyRecursive = [&](Index::const_iterator iter) {
-      if (iter == source.end())
-        return;
-      const std::string& word = iter->first;
-      const std::set< amine::Position, amine::positionLess >& positions = iter->second;
-
-      std::function< void(std::set< amine::Position >::const_iterator) > insertPositions;
-      insertPositions = [&](std::set< amine::Position >::const_iterator posIt) {
-        if (posIt == positions.end())
-          return;
-
-        amine::Position shifted{ posIt->line + lineOffset, posIt->column };
-        target[word].insert(shifted);
-        insertPositions(std::next(posIt));
-      };
-
-      insertPositions(positions.begin());
-      copyRecursive(std::next(iter));
-    };
-
-    copyRecursive(it);
-  }
-  size_t getMaxLineRecursive(Index::const_iterator iter, Index::const_iterator end, size_t currentMax)
-  {
-    if (iter == end)
+    LineRope result;
+    if (startLine < base.size())
     {
-      return currentMax;
+      size_t lastLine = std::min(endLine, base.size() - 1);
+      result.appendBlank(startLine);
+      result.appendLine(filterLine(startLine));
+      if (lastLine > startLine)
+      {
+        result.append(base, startLine + 1, lastLine);
+        result.appendLine(filterLine(lastLine));
+      }
     }
-    size_t maxInWord = currentMax;
-    std::function< size_t(std::set< Position >::const_iterator, std::set< Position >::const_iterator, size_t) >
-      maxInSet;
-
-    maxInSet = [&](std::set< Position >::const_iterator pit, std::set< Position >::const_iterator pend, size_t curMax) {
-      if (pit == pend)
-        return curMax;
-      size_t nextMax = std::max(curMax, pit->line);
-      return maxInSet(std::next(pit), pend, nextMax);
-    };
-
-    maxInWord = maxInSet(iter->second.begin(), iter->second.end(), maxInWord);
-    return getMaxLineRecursive(std::next(iter), end, maxInWord);
+    indexes_[newIndex] = Document(std::move(result));
   }
+
   void CrossRefSystem::replaceWord(const std::string& indexName, const std::string& oldWord, const std::string& newWord)
   {
     auto it = indexes_.find(indexName);
@@ -380,16 +257,13 @@ namespace amine
       return;
     }
 
-    Index& index = it->second;
-    auto wordIt = index.find(oldWord);
-    if (wordIt == index.end())
+    if (!it->second.contains(oldWord))
     {
       std::cout << "<NOT FOUND>\n";
       return;
     }
 
-    index[newWord] = wordIt->second;
-    index.erase(wordIt);
+    it->second.replaceWord(oldWord, newWord);
   }
   void CrossRefSystem::repeatText(const std::string& newIndex, const std::string& baseIndex, size_t N)
   {
@@ -406,24 +280,16 @@ namespace amine
       return;
     }
 
-    const Index& base = it->second;
-
-    Index result;
-    copyIndexWithOffset(result, base, 0);
-
-    size_t lastLine = getMaxLineRecursive(base.begin(), base.end(), 0) + 1;
-
-    std::function< void(size_t) > repeatRecursive;
-    repeatRecursive = [&](size_t count) {
-      if (count == 1)
-        return;
-
-      copyIndexWithOffset(result, base, lastLine * (count - 1));
-      repeatRecursive(count - 1);
-    };
+    const Document& base = it->second;
+    size_t padding = base.lineCount() - base.lines().size();
 
-    repeatRecursive(N);
-    indexes_[newIndex] = result;
+    LineRope result;
+    for (size_t i = 0; i < N; ++i)
+    {
+      result.append(base.lines());
+      result.appendBlank(padding);
+    }
+    indexes_[newIndex] = Document(std::move(result));
   }
   void CrossRefSystem::swapWords(const std::string& indexName, const std::string& word1, const std::string& word2)
   {
@@ -434,19 +300,13 @@ namespace amine
       return;
     }
 
-    Index& index = it->second;
-    auto word1It = index.find(word1);
-    auto word2It = index.find(word2);
-
-    if (word1It == index.end() || word2It == index.end())
+    if (!it->second.contains(word1) || !it->second.contains(word2))
     {
       std::cout << "<NOT FOUND>\n";
       return;
     }
 
-    std::set< Position, positionLess > temp = word1It->second;
-    index[word1] = word2It->second;
-    index[word2] = temp;
+    it->second.swapWords(word1, word2);
   }
   void CrossRefSystem::interleaveLines(const std::string& newIndex, const std::string& index1,
                                        const std::string& index2)
@@ -459,82 +319,29 @@ namespace amine
       return;
     }
 
-    const Index& a = it1->second;
-    const Index& b = it2->second;
-    Index result;
+    const LineRope& a = it1->second.lines();
+    const LineRope& b = it2->second.lines();
 
-    std::map< size_t, std::vector< std::pair< std::string, size_t > > > linesA;
-    std::map< size_t, std::vector< std::pair< std::string, size_t > > > linesB;
-    std::function< void(Index::const_iterator) > collectLinesARecursive;
-    collectLinesARecursive = [&](Index::const_iterator it) {
-      if (it == a.end())
-        return;
-      const std::string& word = it->first;
-      std::function< void(std::set< Position >::const_iterator) > processPositionsA;
-      processPositionsA = [&](std::set< Position >::const_iterator posIt) {
-        if (posIt == it->second.end())
-          return;
-        linesA[posIt->line].emplace_back(word, posIt->column);
-        processPositionsA(std::next(posIt));
-      };
-      processPositionsA(it->second.begin());
-      collectLinesARecursive(std::next(it));
+    auto countLines = [](const LineRope& lines) {
+      size_t count = 0;
+      lines.forEachLine([&](size_t, const Line& line) {
+        count += !line.empty();
+      });
+      return count;
     };
+    size_t maxLines = std::max(countLines(a), countLines(b));
 
-    std::function< void(Index::const_iterator) > collectLinesBRecursive;
-    collectLinesBRecursive = [&](Index::const_iterator it) {
-      if (it == b.end())
-        return;
-      const std::string& word = it->first;
-      std::function< void(std::set< Position >::const_iterator) > processPositionsB;
-      processPositionsB = [&](std::set< Position >::const_iterator posIt) {
-        if (posIt == it->second.end())
-          return;
-        linesB[posIt->line].emplace_back(word, posIt->column);
-        processPositionsB(std::next(posIt));
-      };
-      processPositionsB(it->second.begin());
-      collectLinesBRecursive(std::next(it));
-    };
-
-    collectLinesARecursive(a.begin());
-    collectLinesBRecursive(b.begin());
-
-    size_t maxLines = std::max(linesA.size(), linesB.size());
-    size_t outLine = 0;
-
-    std::function< void(size_t) > writeInterleavedRecursive;
-    writeInterleavedRecursive = [&](size_t lineIdx) {
-      if (lineIdx >= maxLines)
-        return;
-
-      auto insertLineRecursive = [&](const auto& src, size_t srcLine) {
-        auto found = src.find(srcLine);
-        if (found != src.end())
-        {
-          const auto& wordCols = found->second;
-          std::function< void(size_t) > processWordCols;
-          processWordCols = [&](size_t idx) {
-            if (idx >= wordCols.size())
-              return;
-            const auto& wordCol = wordCols[idx];
-            result[wordCol.first].insert({ outLine, wordCol.second });
-            processWordCols(idx + 1);
-          };
-          processWordCols(0);
-        }
-      };
-
-      insertLineRecursive(linesA, lineIdx);
-      ++outLine;
-      insertLineRecursive(linesB, lineIdx);
-      ++outLine;
-
-      writeInterleavedRecursive(lineIdx + 1);
-    };
+    std::vector< Line > result;
+    result.reserve(2 * maxLines);
+    for (size_t lineIdx = 0; lineIdx < maxLines; ++lineIdx)
+    {
+      result.push_back(lineIdx < a.size() ? a[lineIdx] : Line());
+      result.push_back(lineIdx < b.size() ? b[lineIdx] : Line());
+    }
 
-    writeInterleavedRecursive(0);
-    indexes_[newIndex] = result;
+    LineRope lines;
+    lines.append(std::move(result));
+    indexes_[newIndex] = Document(std::move(lines));
   }
 
   void CrossRefSystem::reverseText(const std::string& newIndex, const std::string& baseIndex)
@@ -546,41 +353,14 @@ namespace amine
       return;
     }
 
-    const Index& base = it->second;
+    const Document& base = it->second;
     if (base.empty())
     {
       std::cout << "<EMPTY>\n";
       return;
     }
 
-    size_t maxLine = getMaxLineRecursive(base.begin(), base.end(), 0);
-    Index result;
-
-    std::function< void(Index::const_iterator) > reverseRecursive;
-    reverseRecursive = [&](Index::const_iterator wordIt) {
-      if (wordIt == base.end())
-        return;
-
-      const std::string& word = wordIt->first;
-      const auto& positions = wordIt->second;
-
-      std::function< void(std::set< Position >::const_iterator) > processSet;
-      processSet = [&](std::set< Position >::const_iterator posIt) {
-        if (posIt == positions.end())
-          return;
-
-        size_t newLine = maxLine - posIt->line;
-        result[word].insert(Position{ newLine, posIt->column });
-
-        processSet(std::next(posIt));
-      };
-
-      processSet(positions.begin());
-      reverseRecursive(std::next(wordIt));
-    };
-
-    reverseRecursive(base.begin());
-    indexes_[newIndex] = result;
+    indexes_[newIndex] = Document(base.lines().reversed());
   }
 
   void CrossRefSystem::saveIndex(const std::string& indexName, const std::string& filename)
@@ -596,7 +376,7 @@ namespace amine
       return;
     }
 
-    const Index& index = it->second;
+    const Index& index = it->second.index();
 
     std::function< void(Index::const_iterator) > writeWords;
     writeWords = [&](Index::const_iterator w) {
@@ -621,47 +401,6 @@ namespace amine
     writeWords(index.begin());
   }
 
-  void loadRecursive(std::ifstream& in, amine::Index& index, std::string& word)
-  {
-    size_t line = 0;
-    size_t col = 0;
-
-    if (!(in >> word))
-      return;
-    std::function< void() > skipSpaces;
-    skipSpaces = [&]() {
-      if (in.peek() != ' ')
-        return;
-      in.get();
-      skipSpaces();
-    };
-    skipSpaces();
-
-    std::string position;
-    if (!(in >> position))
-      return;
-
-    size_t colonPos = position.find(':');
-    if (colonPos == std::string::npos)
-      return;
-
-    line = std::stoul(position.substr(0, colonPos));
-    col = std::stoul(position.substr(colonPos + 1));
-
-    index[word].insert({ line, col });
-
-    char next = in.peek();
-    if (next == '\n' || next == EOF)
-    {
-      std::string nextWord;
-      loadRecursive(in, index, nextWord);
-    }
-    else
-    {
-      loadRecursive(in, index, word);
-    }
-  }
-
   void CrossRefSystem::loadIndex(const std::string& indexName, const std::string& fileName)
   {
     std::ifstream in(fileName);
@@ -673,8 +412,25 @@ namespace amine
 
     Index index;
     std::string word;
-    loadRecursive(in, index, word);
-    indexes_[indexName] = index;
+    std::string position;
+    while (in >> word)
+    {
+      while (in.peek() == ' ')
+      {
+        in.get();
+      }
+      if (!(in >> position))
+        break;
+
+      size_t colonPos = position.find(':');
+      if (colonPos == std::string::npos)
+        break;
+
+      size_t line = std::stoul(position.substr(0, colonPos));
+      size_t col = std::stoul(position.substr(colonPos + 1));
+      index[word].insert({ line, col });
+    }
+    indexes_[indexName] = Document(std::move(index));
   }
 
   void CrossRefSystem::reconstructText(const std::string& indexName, const std::string& filename)
@@ -686,7 +442,7 @@ namespace amine
       return;
     }
 
-    const Index& index = it->second;
+    const Index& index = it->second.index();
     if (index.empty())
     {
       std::cout << "<EMPTY>\n";
@@ -1,25 +1,13 @@
 #ifndef XREF_HPP
 #define XREF_HPP
 
+#include <iosfwd>
 #include <map>
-#include <set>
 #include <string>
+#include "text_model.hpp"
 
 namespace amine
 {
-  struct Position
-  {
-    size_t line;
-    size_t column;
-  };
-
-  struct positionLess
-  {
-    bool operator()(const Position& a, const Position& b) const;
-  };
-
-  using Index = std::map< std::string, std::set< Position, positionLess > >;
-
   class CrossRefSystem
   {
   public:
@@ -46,11 +34,9 @@ namespace amine
     void reconstructText(const std::string& indexName, const std::string& filename);
 
   private:
-    std::map< std::string, Index > indexes_;
+    std::map< std::string, Document > indexes_;
   };
 
-  void copyIndexWithOffset(Index& target, const Index& source, size_t lineOffset);
-  size_t getMaxLineRecursive(Index::const_iterator iter, Index::const_iterator end, size_t currentMax);
   std::ostream& operator<<(std::ostream& out, const Position& pos);
 }
 
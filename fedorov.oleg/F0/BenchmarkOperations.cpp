@@ -0,0 +1,109 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "TextProcessor.hpp"
+#include "HashTable.hpp"
+#include "ListHashTable.hpp"
+#include "Utility.hpp"
+#include "ValidationUtils.hpp"
+
+namespace crossref
+{
+  namespace
+  {
+    using Clock = std::chrono::steady_clock;
+    using WordList = std::vector< std::pair< std::string, int > >;
+    using Entries = std::vector< std::pair< std::string, std::vector< int > > >;
+
+    struct WordSanitizer
+    {
+      WordList &words;
+      int lineNumber;
+      void operator()(const std::string &word) const
+      {
+        std::string clean = TextProcessor::sanitizeWord(word);
+        if (!clean.empty())
+        {
+          words.emplace_back(std::move(clean), lineNumber);
+        }
+      }
+    };
+
+    struct WordCollector
+    {
+      WordList &words;
+      int &lineNumber;
+      void operator()(const std::string &line) const
+      {
+        std::vector< std::string > raw;
+        splitRecursive(line, 0, raw);
+        std::for_each(raw.begin(), raw.end(), WordSanitizer{words, lineNumber});
+        lineNumber++;
+      }
+    };
+
+    template < typename Table >
+    struct TableInserter
+    {
+      Table &table;
+      void operator()(const std::pair< std::string, int > &word) const
+      {
+        table.insert(word.first, word.second);
+      }
+    };
+
+    struct BenchResult
+    {
+      double buildMs;
+      double sortMs;
+      size_t memory;
+      Entries entries;
+    };
+
+    double millisSince(Clock::time_point start)
+    {
+      return std::chrono::duration< double, std::milli >(Clock::now() - start).count();
+    }
+
+    template < typename Table >
+    BenchResult runBenchmark(const WordList &words)
+    {
+      Table table;
+      Clock::time_point start = Clock::now();
+      std::for_each(words.begin(), words.end(), TableInserter< Table >{table});
+      double buildMs = millisSince(start);
+
+      start = Clock::now();
+      Entries entries = table.getSortedEntries();
+      double sortMs = millisSince(start);
+      return {buildMs, sortMs, table.memoryUsage(), std::move(entries)};
+    }
+
+    void printResult(const std::string &name, const BenchResult &result)
+    {
+      std::cout << name << ": build " << result.buildMs << " ms, sorted entries " << result.sortMs;
+      std::cout << " ms, memory " << result.memory / 1024 << " KB\n";
+    }
+  }
+
+  void TextProcessor::benchmarkDict(const std::string &text_id) const
+  {
+    validation::checkIdNotFound(texts, text_id, "<TEXT NOT FOUND>");
+    const auto &text_lines = texts.find(text_id)->second;
+
+    WordList words;
+    int lineNumber = 1;
+    std::for_each(text_lines.begin(), text_lines.end(), WordCollector{words, lineNumber});
+
+    BenchResult flat = runBenchmark< HashTable >(words);
+    BenchResult list = runBenchmark< ListHashTable >(words);
+
+    std::cout << "Words: " << words.size() << ", unique: " << flat.entries.size() << '\n';
+    printResult("HashTable", flat);
+    printResult("ListHashTable", list);
+    std::cout << (flat.entries == list.entries ? "<ENTRIES MATCH>" : "<ENTRIES DIFFER>") << '\n';
+  }
+}
@@ -98,6 +98,13 @@ namespace crossref
     tp.deleteDict(args[0]);
   }
 
+  void CommandHandler::handleBenchmarkDict(TextProcessor &tp, const ArgsType &args)
+  {
+    const char *benchmarkDUsage = "benchmarkDict <text_id>";
+    UsageChecker(benchmarkDUsage, args)();
+    tp.benchmarkDict(args[0]);
+  }
+
   void CommandHandler::handleFindCommonLines(TextProcessor &tp, const ArgsType &args)
   {
     const char *findCLUsage = "findCommonLines <new_text_id> <text_id1> <text_id2>";
@@ -172,6 +179,7 @@ namespace crossref
               << "  exportDict <dict_id> <filename>      - Export dictionary to file\n"
               << "  xrefToText <new_text_id> <dict_id>   - Generate text from xref\n"
               << "  deleteDict <dict_id>                 - Delete dictionary\n"
+              << "  benchmarkDict <text_id>              - Compare dictionary tables on text\n"
               << "  findCommonLines <new_text_id> <text_id1> <text_id2> - Find common lines\n"
               << "  concatTexts <new_text_id> <text_id1> <text_id2> - Concatenate texts\n"
               << "  extractLines <new_text_id> <source_text_id> <start> <end> - Extract lines\n"
@@ -196,6 +204,7 @@ namespace crossref
             {"exportDict", handleExportDict},
             {"xrefToText", handleXrefToText},
             {"deleteDict", handleDeleteDict},
+            {"benchmarkDict", handleBenchmarkDict},
             {"findCommonLines", handleFindCommonLines},
             {"concatTexts", handleConcatTexts},
             {"extractLines", handleExtractLines},
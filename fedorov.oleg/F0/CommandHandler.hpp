@@ -28,6 +28,7 @@ namespace crossref
     static void handleExportDict(TextProcessor &tp, const ArgsType &args);
     static void handleXrefToText(TextProcessor &tp, const ArgsType &args);
     static void handleDeleteDict(TextProcessor &tp, const ArgsType &args);
+    static void handleBenchmarkDict(TextProcessor &tp, const ArgsType &args);
 
     static void handleFindCommonLines(TextProcessor &tp, const ArgsType &args);
     static void handleConcatTexts(TextProcessor &tp, const ArgsType &args);
@@ -8,6 +8,7 @@
 #include <map>
 #include <set>
 #include <numeric>
+#include <utility>
 
 #include "TextProcessor.hpp"
 #include "Utility.hpp"
@@ -235,7 +236,7 @@ namespace crossref
     LineProcessor processor{table, wordOrder, line_num, *this};
     std::for_each(text_lines.begin(), text_lines.end(), processor);
 
-    dicts[dict_id] = table;
+    dicts[dict_id] = std::move(table);
   }
 
   void TextProcessor::showDict(const std::string &dict_id) const
@@ -292,7 +293,7 @@ namespace crossref
     DictLineHandler handler(table);
     std::for_each(file_lines.begin(), file_lines.end(), handler);
 
-    dicts[dict_id] = table;
+    dicts[dict_id] = std::move(table);
   }
 
   void TextProcessor::exportDict(const std::string &dict_id, const std::string &filename) const
@@ -1,43 +1,37 @@
 #include "HashTable.hpp"
 
 #include <algorithm>
-#include <cmath>
-#include <stdexcept>
-#include <vector>
-#include <list>
+#include <iterator>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
 
 namespace
 {
 
-  bool isPrimeRecursive(size_t n, size_t i)
+  const uint32_t signFlip = 0x80000000u;
+  const uint32_t fnvOffset = 2166136261u;
+  const uint32_t fnvPrime = 16777619u;
+
+  struct HashAccumulator
   {
-    if (i * i > n)
-    {
-      return false;
-    }
-    if (n % i == 0 || n % (i + 2) == 0)
+    uint32_t operator()(uint32_t hashValue, unsigned char c) const
     {
-      return true;
+      return (hashValue ^ c) * fnvPrime;
     }
-    return isPrimeRecursive(n, i + 6);
-  }
+  };
 
-  bool isPrime(size_t n)
+  struct FromKey
   {
-    if (n <= 1)
+    int operator()(uint32_t value) const
     {
-      return false;
+      return static_cast< int >(value ^ signFlip);
     }
-    if (n <= 3)
-    {
-      return true;
-    }
-    if (n % 2 == 0 || n % 3 == 0)
-    {
-      return false;
-    }
-    return !isPrimeRecursive(n, 5);
+  };
+
+  uint32_t toKey(int line)
+  {
+    return static_cast< uint32_t >(line) ^ signFlip;
   }
 
 }
@@ -45,181 +39,264 @@ namespace
 namespace crossref
 {
 
-  HashTable::RehashHelper::RehashHelper(HashTable *t):
-    table(t)
-  {}
-  HashTable::EmplaceHelper::EmplaceHelper(decltype(entries) &e):
-    entries(e)
-  {}
+  struct HashTable::RehashHelper
+  {
+    HashTable &owner;
+    const std::string *oldKeys;
+
+    void operator()(Slot &slot) const
+    {
+      if (slot.distance == 0)
+      {
+        return;
+      }
+      if (oldKeys)
+      {
+        uint32_t offset = static_cast< uint32_t >(owner.keys.size());
+        owner.keys.append(*oldKeys, slot.keyOffset, slot.keyLength);
+        slot.keyOffset = offset;
+      }
+      slot.distance = 1;
+      owner.place(slot, slot.hash & (owner.table.size() - 1));
+    }
+  };
 
-  void HashTable::RehashHelper::operator()(const HashEntry &entry) const
+  struct HashTable::SlotCollector
   {
-    if (entry.isActive && !entry.word.empty())
+    std::vector< const Slot * > &slots;
+
+    void operator()(const Slot &slot) const
     {
-      struct InsertLine
+      if (slot.distance != 0)
       {
-        HashTable *table;
-        std::string word;
-        InsertLine(HashTable *t, const std::string &w):
-          table(t),
-          word(w)
-        {}
-        void operator()(int line) const
-        {
-          table->insert(word, line);
-        }
-      };
+        slots.push_back(&slot);
+      }
+    }
+  };
 
-      std::for_each(entry.lines.begin(), entry.lines.end(), InsertLine(table, entry.word));
+  struct HashTable::KeyComparator
+  {
+    const std::string &keys;
+
+    bool operator()(const Slot *a, const Slot *b) const
+    {
+      return keys.compare(a->keyOffset, a->keyLength, keys, b->keyOffset, b->keyLength) < 0;
     }
-  }
+  };
+
+  struct HashTable::EntryMaker
+  {
+    const HashTable &owner;
+
+    std::pair< std::string, std::vector< int > > operator()(const Slot *slot) const
+    {
+      return {owner.keyOf(*slot), slot->lines.decode()};
+    }
+  };
+
+  struct HashTable::MemoryAccumulator
+  {
+    size_t operator()(size_t total, const Slot &slot) const
+    {
+      return total + slot.lines.deltas.capacity() * sizeof(uint32_t);
+    }
+  };
 
-  void HashTable::EmplaceHelper::operator()(const HashEntry &entry) const
+  void HashTable::Postings::add(int line)
   {
-    if (entry.isActive && !entry.word.empty())
+    uint32_t value = toKey(line);
+    if (deltas.empty() || value > last)
+    {
+      deltas.push_back(deltas.empty() ? value : value - last);
+      last = value;
+      return;
+    }
+    if (value == last)
+    {
+      return;
+    }
+
+    std::vector< uint32_t > values(deltas.size());
+    std::partial_sum(deltas.begin(), deltas.end(), values.begin());
+    std::vector< uint32_t >::iterator pos = std::lower_bound(values.begin(), values.end(), value);
+    if (*pos == value)
     {
-      entries.emplace_back(entry.word, std::vector< int >(entry.lines.begin(), entry.lines.end()));
+      return;
     }
+    values.insert(pos, value);
+    deltas.resize(values.size());
+    std::adjacent_difference(values.begin(), values.end(), deltas.begin());
   }
 
-  void HashTable::ClearHelper::operator()(HashEntry &entry) const
+  std::vector< int > HashTable::Postings::decode() const
   {
-    entry.word.clear();
-    entry.lines.clear();
-    entry.isActive = false;
+    std::vector< uint32_t > values(deltas.size());
+    std::partial_sum(deltas.begin(), deltas.end(), values.begin());
+    std::vector< int > result(values.size());
+    std::transform(values.begin(), values.end(), result.begin(), FromKey());
+    return result;
   }
 
   HashTable::HashTable(size_t size):
-    table(size),
-    itemCount(0)
+    table(roundCapacity(size)),
+    keys(),
+    itemCount(0),
+    deadKeyBytes(0)
   {}
 
-  struct HashAccumulator
+  uint32_t HashTable::hash(const std::string &key)
   {
-    size_t operator()(size_t hashValue, unsigned char c) const
-    {
-      return (hashValue * 31) + c;
-    }
-  };
+    return std::accumulate(key.begin(), key.end(), fnvOffset, HashAccumulator());
+  }
 
-  size_t HashTable::hash(const std::string &key) const
+  size_t HashTable::roundCapacity(size_t n)
   {
-    size_t init = 0;
-    return std::accumulate(key.begin(), key.end(), init, HashAccumulator()) % table.size();
+    return n <= 8 ? 8 : 2 * roundCapacity((n + 1) / 2);
   }
 
-  size_t HashTable::findPosition(const std::string &key) const
+  bool HashTable::keyEquals(const Slot &slot, const std::string &key) const
   {
-    return findPosition(key, hash(key), 0);
+    return slot.keyLength == key.size() && keys.compare(slot.keyOffset, slot.keyLength, key) == 0;
   }
 
-  size_t HashTable::findPosition(const std::string &key, size_t current, size_t i) const
+  std::string HashTable::keyOf(const Slot &slot) const
   {
-    if (!table[current].isActive || table[current].word == key)
+    return keys.substr(slot.keyOffset, slot.keyLength);
+  }
+
+  size_t HashTable::findPosition(const std::string &key, uint32_t keyHash) const
+  {
+    return findPosition(key, keyHash, keyHash & (table.size() - 1), 1);
+  }
+
+  size_t HashTable::findPosition(const std::string &key, uint32_t keyHash, size_t current, uint32_t distance) const
+  {
+    const Slot &slot = table[current];
+    if (slot.distance < distance)
     {
-      return current;
+      return table.size();
     }
-    if (i >= table.size())
+    if (slot.hash == keyHash && keyEquals(slot, key))
     {
       return current;
     }
-
-    size_t next_i = i + 1;
-    size_t next = (current + next_i * next_i) % table.size();
-    return findPosition(key, next, next_i);
+    return findPosition(key, keyHash, (current + 1) & (table.size() - 1), distance + 1);
   }
 
-  size_t HashTable::nextPrime(size_t n) const
+  void HashTable::place(Slot &slot, size_t current)
   {
-    if (n % 2 == 0)
+    Slot &target = table[current];
+    if (target.distance == 0)
     {
-      n++;
+      target = std::move(slot);
+      return;
     }
-    if (isPrime(n))
+    if (target.distance < slot.distance)
     {
-      return n;
+      std::swap(target, slot);
     }
-    return nextPrime(n + 2);
+    slot.distance++;
+    place(slot, (current + 1) & (table.size() - 1));
   }
 
-  void HashTable::rehash()
+  void HashTable::shiftBack(size_t current)
   {
-    std::vector< HashEntry > oldTable = std::move(table);
-    table = std::vector< HashEntry >(nextPrime(oldTable.size() * 2));
-    itemCount = 0;
+    size_t next = (current + 1) & (table.size() - 1);
+    if (table[next].distance <= 1)
+    {
+      table[current] = Slot();
+      return;
+    }
+    table[current] = std::move(table[next]);
+    table[current].distance--;
+    shiftBack(next);
+  }
 
-    std::for_each(oldTable.begin(), oldTable.end(), RehashHelper(this));
+  void HashTable::rehash(size_t newCapacity)
+  {
+    std::vector< Slot > oldTable = std::move(table);
+    table = std::vector< Slot >(newCapacity);
+    std::string oldKeys;
+    if (deadKeyBytes != 0)
+    {
+      oldKeys.swap(keys);
+      keys.reserve(oldKeys.size() - deadKeyBytes);
+      deadKeyBytes = 0;
+    }
+    std::for_each(oldTable.begin(), oldTable.end(), RehashHelper{*this, oldKeys.empty() ? nullptr : &oldKeys});
   }
 
   void HashTable::insert(const std::string &key, int line)
   {
-    if (itemCount >= table.size() * 0.75)
+    uint32_t keyHash = hash(key);
+    size_t pos = findPosition(key, keyHash);
+    if (pos != table.size())
     {
-      rehash();
+      table[pos].lines.add(line);
+      return;
     }
 
-    size_t pos = findPosition(key);
-
-    if (!table[pos].isActive)
+    if ((itemCount + 1) * 8 > table.size() * 7)
     {
-      table[pos].word = key;
-      table[pos].isActive = true;
-      itemCount++;
+      rehash(table.size() * 2);
     }
-
-    if (std::find(table[pos].lines.begin(), table[pos].lines.end(), line) == table[pos].lines.end())
+    if (keys.size() + key.size() > std::numeric_limits< uint32_t >::max())
     {
-      table[pos].lines.push_back(line);
-      table[pos].lines.sort();
+      throw std::length_error("<DICT TOO LARGE>");
     }
+    Slot slot{static_cast< uint32_t >(keys.size()), static_cast< uint32_t >(key.size()), keyHash, 1, Postings()};
+    keys += key;
+    slot.lines.add(line);
+    place(slot, keyHash & (table.size() - 1));
+    itemCount++;
   }
 
   void HashTable::remove(const std::string &key)
   {
-    size_t pos = findPosition(key);
-
-    if (table[pos].isActive && table[pos].word == key)
+    size_t pos = findPosition(key, hash(key));
+    if (pos == table.size())
     {
-      table[pos].isActive = false;
-      table[pos].lines.clear();
-      itemCount--;
+      return;
     }
-  }
 
-  std::vector< int > HashTable::find(const std::string &key) const
-  {
-    size_t pos = findPosition(key);
-
-    if (table[pos].isActive && table[pos].word == key)
+    deadKeyBytes += table[pos].keyLength;
+    shiftBack(pos);
+    itemCount--;
+    if (deadKeyBytes > keys.size() / 2)
     {
-      return std::vector< int >(table[pos].lines.begin(), table[pos].lines.end());
+      rehash(table.size());
     }
-    return {};
   }
 
-  struct HashTable::EntryComparator
+  std::vector< int > HashTable::find(const std::string &key) const
   {
-    using type_entry = std::pair< std::string, std::vector< int > >;
-    bool operator()(const type_entry &a, const type_entry &b) const
+    size_t pos = findPosition(key, hash(key));
+    if (pos == table.size())
     {
-      return a.first < b.first;
+      return {};
     }
-  };
+    return table[pos].lines.decode();
+  }
 
   std::vector< std::pair< std::string, std::vector< int > > > HashTable::getSortedEntries() const
   {
-    std::vector< std::pair< std::string, std::vector< int > > > entries;
+    std::vector< const Slot * > slots;
+    slots.reserve(itemCount);
+    std::for_each(table.begin(), table.end(), SlotCollector{slots});
+    std::sort(slots.begin(), slots.end(), KeyComparator{keys});
 
-    std::for_each(table.begin(), table.end(), EmplaceHelper(entries));
-
-    std::sort(entries.begin(), entries.end(), EntryComparator());
+    std::vector< std::pair< std::string, std::vector< int > > > entries;
+    entries.reserve(slots.size());
+    std::transform(slots.begin(), slots.end(), std::back_inserter(entries), EntryMaker{*this});
     return entries;
   }
 
   void HashTable::clear()
   {
-    std::for_each(table.begin(), table.end(), ClearHelper());
+    table.assign(table.size(), Slot());
+    keys.clear();
     itemCount = 0;
+    deadKeyBytes = 0;
   }
 
   bool HashTable::isEmpty() const
@@ -237,4 +314,10 @@ namespace crossref
     return table.size();
   }
 
+  size_t HashTable::memoryUsage() const
+  {
+    size_t init = table.capacity() * sizeof(Slot) + keys.capacity();
+    return std::accumulate(table.begin(), table.end(), init, MemoryAccumulator());
+  }
+
 }
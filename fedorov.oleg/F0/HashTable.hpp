@@ -3,18 +3,14 @@
 
 #include <vector>
 #include <string>
-#include <list>
 #include <utility>
+#include <cstdint>
 
 namespace crossref
 {
 
   class HashTable
   {
-    struct RehashHelper;
-    struct EmplaceHelper;
-    struct ClearHelper;
-
   public:
     explicit HashTable(size_t size = 101);
     void insert(const std::string &key, int line);
@@ -25,48 +21,51 @@ namespace crossref
     bool isEmpty() const;
     size_t size() const;
     size_t capacity() const;
+    size_t memoryUsage() const;
 
   private:
-    struct EntryComparator;
-    struct HashEntry
+    struct RehashHelper;
+    struct SlotCollector;
+    struct EntryMaker;
+    struct KeyComparator;
+    struct MemoryAccumulator;
+
+    // sorted unique line numbers; the first one is kept as an order-preserving
+    // unsigned key, every next one as a difference with the previous
+    struct Postings
     {
-      std::string word;
-      std::list< int > lines;
-      bool isActive;
+      std::vector< uint32_t > deltas;
+      uint32_t last;
+
+      void add(int line);
+      std::vector< int > decode() const;
+    };
+    // robin hood slot: distance is the probe length plus one, zero marks an empty slot;
+    // key bytes live in the shared keys buffer
+    struct Slot
+    {
+      uint32_t keyOffset;
+      uint32_t keyLength;
+      uint32_t hash;
+      uint32_t distance;
+      Postings lines;
     };
 
-    std::vector< HashEntry > table;
+    std::vector< Slot > table;
+    std::string keys;
     size_t itemCount;
+    size_t deadKeyBytes;
 
-    size_t findPosition(const std::string &key) const;
-    size_t findPosition(const std::string &key, size_t current, size_t i) const;
-    size_t nextPrime(size_t n) const;
+    static uint32_t hash(const std::string &key);
+    static size_t roundCapacity(size_t n);
 
-    void rehash();
-    size_t hash(const std::string &key) const;
-
-    friend struct RehashHelper;
-    friend struct EmplaceHelper;
-    friend struct ClearHelper;
-  };
-
-  struct HashTable::RehashHelper
-  {
-    HashTable *table;
-    RehashHelper(HashTable *t);
-    void operator()(const HashEntry &entry) const;
-  };
-
-  struct HashTable::EmplaceHelper
-  {
-    std::vector< std::pair< std::string, std::vector< int > > > &entries;
-    EmplaceHelper(decltype(entries) &e);
-    void operator()(const HashEntry &entry) const;
-  };
-
-  struct HashTable::ClearHelper
-  {
-    void operator()(HashEntry &entry) const;
+    bool keyEquals(const Slot &slot, const std::string &key) const;
+    std::string keyOf(const Slot &slot) const;
+    size_t findPosition(const std::string &key, uint32_t keyHash) const;
+    size_t findPosition(const std::string &key, uint32_t keyHash, size_t current, uint32_t distance) const;
+    void place(Slot &slot, size_t current);
+    void shiftBack(size_t current);
+    void rehash(size_t newCapacity);
   };
 
 }
@@ -0,0 +1,256 @@
+#include "ListHashTable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <list>
+#include <numeric>
+
+namespace
+{
+
+  bool isPrimeRecursive(size_t n, size_t i)
+  {
+    if (i * i > n)
+    {
+      return false;
+    }
+    if (n % i == 0 || n % (i + 2) == 0)
+    {
+      return true;
+    }
+    return isPrimeRecursive(n, i + 6);
+  }
+
+  bool isPrime(size_t n)
+  {
+    if (n <= 1)
+    {
+      return false;
+    }
+    if (n <= 3)
+    {
+      return true;
+    }
+    if (n % 2 == 0 || n % 3 == 0)
+    {
+      return false;
+    }
+    return !isPrimeRecursive(n, 5);
+  }
+
+}
+
+namespace crossref
+{
+
+  ListHashTable::RehashHelper::RehashHelper(ListHashTable *t):
+    table(t)
+  {}
+  ListHashTable::EmplaceHelper::EmplaceHelper(decltype(entries) &e):
+    entries(e)
+  {}
+
+  void ListHashTable::RehashHelper::operator()(const HashEntry &entry) const
+  {
+    if (entry.isActive && !entry.word.empty())
+    {
+      struct InsertLine
+      {
+        ListHashTable *table;
+        std::string word;
+        InsertLine(ListHashTable *t, const std::string &w):
+          table(t),
+          word(w)
+        {}
+        void operator()(int line) const
+        {
+          table->insert(word, line);
+        }
+      };
+
+      std::for_each(entry.lines.begin(), entry.lines.end(), InsertLine(table, entry.word));
+    }
+  }
+
+  void ListHashTable::EmplaceHelper::operator()(const HashEntry &entry) const
+  {
+    if (entry.isActive && !entry.word.empty())
+    {
+      entries.emplace_back(entry.word, std::vector< int >(entry.lines.begin(), entry.lines.end()));
+    }
+  }
+
+  void ListHashTable::ClearHelper::operator()(HashEntry &entry) const
+  {
+    entry.word.clear();
+    entry.lines.clear();
+    entry.isActive = false;
+  }
+
+  ListHashTable::ListHashTable(size_t size):
+    table(size),
+    itemCount(0)
+  {}
+
+  struct HashAccumulator
+  {
+    size_t operator()(size_t hashValue, unsigned char c) const
+    {
+      return (hashValue * 31) + c;
+    }
+  };
+
+  size_t ListHashTable::hash(const std::string &key) const
+  {
+    size_t init = 0;
+    return std::accumulate(key.begin(), key.end(), init, HashAccumulator()) % table.size();
+  }
+
+  size_t ListHashTable::findPosition(const std::string &key) const
+  {
+    return findPosition(key, hash(key), 0);
+  }
+
+  size_t ListHashTable::findPosition(const std::string &key, size_t current, size_t i) const
+  {
+    if (!table[current].isActive || table[current].word == key)
+    {
+      return current;
+    }
+    if (i >= table.size())
+    {
+      return current;
+    }
+
+    size_t next_i = i + 1;
+    size_t next = (current + next_i * next_i) % table.size();
+    return findPosition(key, next, next_i);
+  }
+
+  size_t ListHashTable::nextPrime(size_t n) const
+  {
+    if (n % 2 == 0)
+    {
+      n++;
+    }
+    if (isPrime(n))
+    {
+      return n;
+    }
+    return nextPrime(n + 2);
+  }
+
+  void ListHashTable::rehash()
+  {
+    std::vector< HashEntry > oldTable = std::move(table);
+    table = std::vector< HashEntry >(nextPrime(oldTable.size() * 2));
+    itemCount = 0;
+
+    std::for_each(oldTable.begin(), oldTable.end(), RehashHelper(this));
+  }
+
+  void ListHashTable::insert(const std::string &key, int line)
+  {
+    if (itemCount >= table.size() * 0.75)
+    {
+      rehash();
+    }
+
+    size_t pos = findPosition(key);
+
+    if (!table[pos].isActive)
+    {
+      table[pos].word = key;
+      table[pos].isActive = true;
+      itemCount++;
+    }
+
+    if (std::find(table[pos].lines.begin(), table[pos].lines.end(), line) == table[pos].lines.end())
+    {
+      table[pos].lines.push_back(line);
+      table[pos].lines.sort();
+    }
+  }
+
+  void ListHashTable::remove(const std::string &key)
+  {
+    size_t pos = findPosition(key);
+
+    if (table[pos].isActive && table[pos].word == key)
+    {
+      table[pos].isActive = false;
+      table[pos].lines.clear();
+      itemCount--;
+    }
+  }
+
+  std::vector< int > ListHashTable::find(const std::string &key) const
+  {
+    size_t pos = findPosition(key);
+
+    if (table[pos].isActive && table[pos].word == key)
+    {
+      return std::vector< int >(table[pos].lines.begin(), table[pos].lines.end());
+    }
+    return {};
+  }
+
+  struct ListHashTable::EntryComparator
+  {
+    using type_entry = std::pair< std::string, std::vector< int > >;
+    bool operator()(const type_entry &a, const type_entry &b) const
+    {
+      return a.first < b.first;
+    }
+  };
+
+  std::vector< std::pair< std::string, std::vector< int > > > ListHashTable::getSortedEntries() const
+  {
+    std::vector< std::pair< std::string, std::vector< int > > > entries;
+
+    std::for_each(table.begin(), table.end(), EmplaceHelper(entries));
+
+    std::sort(entries.begin(), entries.end(), EntryComparator());
+    return entries;
+  }
+
+  void ListHashTable::clear()
+  {
+    std::for_each(table.begin(), table.end(), ClearHelper());
+    itemCount = 0;
+  }
+
+  bool ListHashTable::isEmpty() const
+  {
+    return itemCount == 0;
+  }
+
+  size_t ListHashTable::size() const
+  {
+    return itemCount;
+  }
+
+  size_t ListHashTable::capacity() const
+  {
+    return table.size();
+  }
+
+  struct ListHashTable::MemoryAccumulator
+  {
+    size_t operator()(size_t total, const HashEntry &entry) const
+    {
+      const size_t listNodeSize = 2 * sizeof(void *) + sizeof(int);
+      size_t heapWord = entry.word.capacity() > 15 ? entry.word.capacity() + 1 : 0;
+      return total + heapWord + entry.lines.size() * listNodeSize;
+    }
+  };
+
+  size_t ListHashTable::memoryUsage() const
+  {
+    size_t init = table.size() * sizeof(HashEntry);
+    return std::accumulate(table.begin(), table.end(), init, MemoryAccumulator());
+  }
+
+}
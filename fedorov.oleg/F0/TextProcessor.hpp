@@ -33,6 +33,7 @@ namespace crossref
     void xrefToText(const std::string &new_text_id, const std::string &dict_id);
     void deleteDict(const std::string &dict_id);
     void listDicts() const;
+    void benchmarkDict(const std::string &text_id) const;
 
     void findCommonLines(const std::string &new_text_id, const std::string &text_id1, const std::string &text_id2);
     void clearAll();
@@ -46,10 +46,14 @@ void filonova::insert(DictionarySet &dicts, std::istream &in)
     throw std::invalid_argument("<INVALID COMMAND>");
   }
 
-  Word w;
-  while (file >> w)
-  {
-    it->second[w.text]++;
+  WordScanner scanner(file);
+  std::string word;
+  const char *first = nullptr;
+  const char *last = nullptr;
+  while (scanner.next(first, last))
+  {
+    word.assign(first, last);
+    it->second[word]++;
   }
 }
 
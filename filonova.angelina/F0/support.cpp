@@ -1,7 +1,151 @@
 #include "support.hpp"
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <vector>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+  const size_t BLOCK_SIZE = 1 << 20;
+  const size_t MASK_BITS = 64;
+
+  bool isSpaceByte(unsigned char c)
+  {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+#if defined(__AVX2__) || defined(__SSE2__)
+  uint64_t maskOf(int movemask)
+  {
+    return static_cast< uint64_t >(static_cast< unsigned int >(movemask));
+  }
+#endif
+
+  size_t lowestBit(uint64_t bits)
+  {
+#if defined(__GNUC__)
+    return static_cast< size_t >(__builtin_ctzll(bits));
+#else
+    size_t at = 0;
+    for (; (bits & 1) == 0; bits >>= 1)
+    {
+      ++at;
+    }
+    return at;
+#endif
+  }
+
+  uint64_t bitOf(bool value, size_t at)
+  {
+    return static_cast< uint64_t >(value) << at;
+  }
+
+  void classifyByte(char &byte, size_t at, filonova::WordScanner::Masks &masks)
+  {
+    unsigned char c = static_cast< unsigned char >(byte);
+    if (c >= 'A' && c <= 'Z')
+    {
+      c = static_cast< unsigned char >(c - 'A' + 'a');
+      byte = static_cast< char >(c);
+    }
+    bool letter = c >= 'a' && c <= 'z';
+    bool digit = c >= '0' && c <= '9';
+    masks.spaces |= bitOf(isSpaceByte(c), at);
+    masks.letters |= bitOf(letter, at);
+    masks.specials |= bitOf(c == '\'' || c == '"' || c == '(' || c == ')', at);
+    masks.puncts |= bitOf(c > ' ' && c < 0x7F && !letter && !digit, at);
+  }
+
+  // folds upper case in place and classifies the 64 bytes at `data`
+  void classifyGroup(char *data, filonova::WordScanner::Masks &masks)
+  {
+#if defined(__AVX2__)
+    for (size_t i = 0; i < MASK_BITS; i += 32)
+    {
+      __m256i *at = reinterpret_cast< __m256i * >(data + i);
+      __m256i v = _mm256_loadu_si256(at);
+      __m256i ctrl = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+      __m256i isCtrl = _mm256_cmpeq_epi8(_mm256_min_epu8(ctrl, _mm256_set1_epi8('\r' - '\t')), ctrl);
+      __m256i isSpace = _mm256_or_si256(isCtrl, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+      __m256i upper = _mm256_sub_epi8(v, _mm256_set1_epi8('A'));
+      __m256i isUpper = _mm256_cmpeq_epi8(_mm256_min_epu8(upper, _mm256_set1_epi8('Z' - 'A')), upper);
+      v = _mm256_or_si256(v, _mm256_and_si256(isUpper, _mm256_set1_epi8('a' - 'A')));
+      _mm256_storeu_si256(at, v);
+      __m256i lower = _mm256_sub_epi8(v, _mm256_set1_epi8('a'));
+      __m256i isLower = _mm256_cmpeq_epi8(_mm256_min_epu8(lower, _mm256_set1_epi8('z' - 'a')), lower);
+      __m256i digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+      __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8('9' - '0')), digit);
+      __m256i graph = _mm256_sub_epi8(v, _mm256_set1_epi8('!'));
+      __m256i isGraph = _mm256_cmpeq_epi8(_mm256_min_epu8(graph, _mm256_set1_epi8('~' - '!')), graph);
+      __m256i isPunct = _mm256_andnot_si256(_mm256_or_si256(isLower, isDigit), isGraph);
+      __m256i isQuote = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+      __m256i isParen = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')')));
+      masks.spaces |= maskOf(_mm256_movemask_epi8(isSpace)) << i;
+      masks.letters |= maskOf(_mm256_movemask_epi8(isLower)) << i;
+      masks.specials |= maskOf(_mm256_movemask_epi8(_mm256_or_si256(isQuote, isParen))) << i;
+      masks.puncts |= maskOf(_mm256_movemask_epi8(isPunct)) << i;
+    }
+#elif defined(__SSE2__)
+    for (size_t i = 0; i < MASK_BITS; i += 16)
+    {
+      __m128i *at = reinterpret_cast< __m128i * >(data + i);
+      __m128i v = _mm_loadu_si128(at);
+      __m128i ctrl = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+      __m128i isCtrl = _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8('\r' - '\t')), ctrl);
+      __m128i isSpace = _mm_or_si128(isCtrl, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+      __m128i upper = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+      __m128i isUpper = _mm_cmpeq_epi8(_mm_min_epu8(upper, _mm_set1_epi8('Z' - 'A')), upper);
+      v = _mm_or_si128(v, _mm_and_si128(isUpper, _mm_set1_epi8('a' - 'A')));
+      _mm_storeu_si128(at, v);
+      __m128i lower = _mm_sub_epi8(v, _mm_set1_epi8('a'));
+      __m128i isLower = _mm_cmpeq_epi8(_mm_min_epu8(lower, _mm_set1_epi8('z' - 'a')), lower);
+      __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+      __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8('9' - '0')), digit);
+      __m128i graph = _mm_sub_epi8(v, _mm_set1_epi8('!'));
+      __m128i isGraph = _mm_cmpeq_epi8(_mm_min_epu8(graph, _mm_set1_epi8('~' - '!')), graph);
+      __m128i isPunct = _mm_andnot_si128(_mm_or_si128(isLower, isDigit), isGraph);
+      __m128i isQuote = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\'')), _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+      __m128i isParen = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('(')), _mm_cmpeq_epi8(v, _mm_set1_epi8(')')));
+      masks.spaces |= maskOf(_mm_movemask_epi8(isSpace)) << i;
+      masks.letters |= maskOf(_mm_movemask_epi8(isLower)) << i;
+      masks.specials |= maskOf(_mm_movemask_epi8(_mm_or_si128(isQuote, isParen))) << i;
+      masks.puncts |= maskOf(_mm_movemask_epi8(isPunct)) << i;
+    }
+#else
+    for (size_t i = 0; i < MASK_BITS; ++i)
+    {
+      classifyByte(data[i], i, masks);
+    }
+#endif
+  }
+
+  bool testBit(const std::vector< filonova::WordScanner::Masks > &masks, uint64_t filonova::WordScanner::Masks::*kind,
+    size_t at)
+  {
+    return ((masks[at / MASK_BITS].*kind >> (at % MASK_BITS)) & 1) != 0;
+  }
+
+  // first position in [from, to) whose bit equals `value`, or `to`
+  size_t findBit(const std::vector< filonova::WordScanner::Masks > &masks, uint64_t filonova::WordScanner::Masks::*kind,
+    size_t from, size_t to, bool value)
+  {
+    while (from < to)
+    {
+      uint64_t bits = masks[from / MASK_BITS].*kind;
+      bits = value ? bits : ~bits;
+      bits >>= from % MASK_BITS;
+      if (bits != 0)
+      {
+        return std::min(from + lowestBit(bits), to);
+      }
+      from = (from / MASK_BITS + 1) * MASK_BITS;
+    }
+    return to;
+  }
+}
 
 bool filonova::isLetter(char c)
 {
@@ -28,29 +172,114 @@ std::istream &filonova::operator>>(std::istream &in, Word &w)
 
   std::string temp;
   in >> temp;
-  if (std::none_of(temp.begin(), temp.end(), isLetter))
+  const char *first = temp.data();
+  const char *last = first + temp.size();
+  if (std::none_of(first, last, isLetter))
   {
     in.setstate(std::ios::failbit);
   }
   else
   {
-    const char *specialChars = "'\"()";
-    if (temp.find_first_of(specialChars) != std::string::npos)
-    {
-      temp = temp.substr(temp.find_first_not_of(specialChars));
-      temp = temp.substr(0, temp.find_first_of(specialChars));
-    }
+    trimToken(first, last);
+    std::string word(first, last);
+    std::transform(word.begin(), word.end(), word.begin(), toLower);
+    w.text = std::move(word);
+  }
+  return in;
+}
 
-    while (!temp.empty() && isPunct(temp.back()))
+void filonova::trimToken(const char *&first, const char *&last)
+{
+  const char *specialChars = "'\"()";
+  const char *specialEnd = specialChars + std::strlen(specialChars);
+  if (std::find_first_of(first, last, specialChars, specialEnd) != last)
+  {
+    while (first != last && std::find(specialChars, specialEnd, *first) != specialEnd)
     {
-      temp.pop_back();
+      ++first;
     }
+    last = std::find_first_of(first, last, specialChars, specialEnd);
+  }
 
-    std::transform(temp.begin(), temp.end(), temp.begin(), toLower);
+  while (first != last && isPunct(*(last - 1)))
+  {
+    --last;
+  }
+}
 
-    w.text = std::move(temp);
+filonova::WordScanner::WordScanner(std::istream &in):
+  in_(in),
+  buffer_(BLOCK_SIZE),
+  masks_(),
+  pos_(0),
+  size_(0),
+  eof_(false),
+  stopped_(false)
+{}
+
+void filonova::WordScanner::refill()
+{
+  size_t kept = size_ - pos_;
+  std::memmove(buffer_.data(), buffer_.data() + pos_, kept);
+  if (kept == buffer_.size())
+  {
+    buffer_.resize(buffer_.size() * 2);
   }
-  return in;
+  in_.read(buffer_.data() + kept, static_cast< std::streamsize >(buffer_.size() - kept));
+  size_t got = static_cast< size_t >(in_.gcount());
+  eof_ = kept + got < buffer_.size();
+  pos_ = 0;
+  size_ = kept + got;
+
+  masks_.assign((size_ + MASK_BITS - 1) / MASK_BITS, Masks{0, 0, 0, 0});
+  size_t full = size_ / MASK_BITS;
+  for (size_t i = 0; i < full; ++i)
+  {
+    classifyGroup(buffer_.data() + i * MASK_BITS, masks_[i]);
+  }
+  for (size_t i = full * MASK_BITS; i < size_; ++i)
+  {
+    classifyByte(buffer_[i], i % MASK_BITS, masks_[full]);
+  }
+}
+
+bool filonova::WordScanner::next(const char *&first, const char *&last)
+{
+  while (!stopped_)
+  {
+    size_t start = findBit(masks_, &Masks::spaces, pos_, size_, false);
+    size_t end = findBit(masks_, &Masks::spaces, start, size_, true);
+    if (end == size_ && !eof_)
+    {
+      pos_ = start;
+      refill();
+      continue;
+    }
+    if (start == end)
+    {
+      stopped_ = true;
+      break;
+    }
+    pos_ = end;
+    if (findBit(masks_, &Masks::letters, start, end, true) == end)
+    {
+      stopped_ = true;
+      break;
+    }
+    if (findBit(masks_, &Masks::specials, start, end, true) != end)
+    {
+      start = findBit(masks_, &Masks::specials, start, end, false);
+      end = findBit(masks_, &Masks::specials, start, end, true);
+    }
+    while (end != start && testBit(masks_, &Masks::puncts, end - 1))
+    {
+      --end;
+    }
+    first = buffer_.data() + start;
+    last = buffer_.data() + end;
+    return true;
+  }
+  return false;
 }
 
 std::ostream &filonova::operator<<(std::ostream &out, const Word &w)
@@ -1,9 +1,11 @@
 #ifndef SUPPORT_HPP
 #define SUPPORT_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace filonova
 {
@@ -18,10 +20,41 @@ namespace filonova
   bool isLetter(char c);
   char toLower(char c);
   bool isPunct(char c);
+  void trimToken(const char *&first, const char *&last);
   std::istream &operator>>(std::istream &in, Word &w);
   std::ostream &operator<<(std::ostream &out, const Word &w);
   bool operator<(const Word &lhs, const Word &rhs);
 
+  // Reads the same words as repeated `in >> Word`, but over a large buffer:
+  // each block is case-folded and classified into byte-class bitmasks,
+  // and tokens are handed out as ranges into the buffer
+  class WordScanner
+  {
+  public:
+    // one bit per buffered byte, 64 bytes per element
+    struct Masks
+    {
+      uint64_t spaces;
+      uint64_t letters;
+      uint64_t specials;
+      uint64_t puncts;
+    };
+
+    explicit WordScanner(std::istream &in);
+    bool next(const char *&first, const char *&last);
+
+  private:
+    std::istream &in_;
+    std::vector< char > buffer_;
+    std::vector< Masks > masks_;
+    size_t pos_;
+    size_t size_;
+    bool eof_;
+    bool stopped_;
+
+    void refill();
+  };
+
   struct IsValidNameChar
   {
     bool operator()(char ch) const;
@@ -0,0 +1,158 @@
+#include "BinaryIO.hpp"
+#include <algorithm>
+
+namespace {
+  const size_t blockSize = 1 << 20;
+
+  template < typename T >
+  void putLittleEndian(std::vector< char >& buffer, T value, size_t bytes)
+  {
+    for (size_t i = 0; i < bytes; ++i) {
+      buffer.push_back(static_cast< char >((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  template < typename T >
+  T getLittleEndian(const unsigned char* data, size_t bytes)
+  {
+    T value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+      value |= static_cast< T >(data[i]) << (8 * i);
+    }
+    return value;
+  }
+}
+
+gavrilova::binary::BlockWriter::BlockWriter(std::ostream& out):
+  out_(out),
+  buffer_()
+{
+  buffer_.reserve(blockSize);
+}
+
+void gavrilova::binary::BlockWriter::u32(uint32_t value)
+{
+  putLittleEndian(buffer_, value, 4);
+  if (buffer_.size() >= blockSize) {
+    flush();
+  }
+}
+
+void gavrilova::binary::BlockWriter::u64(uint64_t value)
+{
+  putLittleEndian(buffer_, value, 8);
+  if (buffer_.size() >= blockSize) {
+    flush();
+  }
+}
+
+void gavrilova::binary::BlockWriter::i32(int32_t value)
+{
+  u32(static_cast< uint32_t >(value));
+}
+
+void gavrilova::binary::BlockWriter::str(const std::string& value)
+{
+  u32(static_cast< uint32_t >(value.size()));
+  raw(value.data(), value.size());
+}
+
+void gavrilova::binary::BlockWriter::raw(const char* data, size_t size)
+{
+  buffer_.insert(buffer_.end(), data, data + size);
+  if (buffer_.size() >= blockSize) {
+    flush();
+  }
+}
+
+bool gavrilova::binary::BlockWriter::flush()
+{
+  out_.write(buffer_.data(), buffer_.size());
+  buffer_.clear();
+  return static_cast< bool >(out_);
+}
+
+gavrilova::binary::BlockReader::BlockReader(std::istream& in):
+  in_(in),
+  buffer_(blockSize),
+  pos_(0),
+  end_(0),
+  good_(true)
+{}
+
+bool gavrilova::binary::BlockReader::fill()
+{
+  std::copy(buffer_.begin() + pos_, buffer_.begin() + end_, buffer_.begin());
+  end_ -= pos_;
+  pos_ = 0;
+  in_.read(buffer_.data() + end_, buffer_.size() - end_);
+  end_ += in_.gcount();
+  return end_ > 0;
+}
+
+bool gavrilova::binary::BlockReader::raw(char* data, size_t size)
+{
+  while (good_ && size > 0) {
+    if (pos_ == end_ && !fill()) {
+      good_ = false;
+      break;
+    }
+    size_t chunk = std::min(size, end_ - pos_);
+    std::copy(buffer_.begin() + pos_, buffer_.begin() + pos_ + chunk, data);
+    pos_ += chunk;
+    data += chunk;
+    size -= chunk;
+  }
+  return good_;
+}
+
+uint32_t gavrilova::binary::BlockReader::u32()
+{
+  unsigned char bytes[4] = {};
+  raw(reinterpret_cast< char* >(bytes), sizeof(bytes));
+  return good_ ? getLittleEndian< uint32_t >(bytes, 4) : 0;
+}
+
+uint64_t gavrilova::binary::BlockReader::u64()
+{
+  unsigned char bytes[8] = {};
+  raw(reinterpret_cast< char* >(bytes), sizeof(bytes));
+  return good_ ? getLittleEndian< uint64_t >(bytes, 8) : 0;
+}
+
+int32_t gavrilova::binary::BlockReader::i32()
+{
+  return static_cast< int32_t >(u32());
+}
+
+std::string gavrilova::binary::BlockReader::str()
+{
+  uint32_t size = u32();
+  std::string result;
+  while (good_ && result.size() < size) {
+    if (pos_ == end_ && !fill()) {
+      good_ = false;
+      break;
+    }
+    size_t chunk = std::min< size_t >(size - result.size(), end_ - pos_);
+    result.append(buffer_.data() + pos_, chunk);
+    pos_ += chunk;
+  }
+  return result;
+}
+
+bool gavrilova::binary::BlockReader::good() const
+{
+  return good_;
+}
+
+uint32_t gavrilova::binary::encodeDate(const date::Date& d)
+{
+  return (static_cast< uint32_t >(d.year) << 9) | (static_cast< uint32_t >(d.month) << 5) |
+      static_cast< uint32_t >(d.day);
+}
+
+gavrilova::date::Date gavrilova::binary::decodeDate(uint32_t value)
+{
+  return {static_cast< int >(value >> 9), static_cast< int >((value >> 5) & 0xF), static_cast< int >(value & 0x1F)};
+}
@@ -0,0 +1,57 @@
+#ifndef BINARY_IO_HPP
+#define BINARY_IO_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Date.hpp"
+
+namespace gavrilova {
+  namespace binary {
+    // little-endian fixed width fields written through a large buffer
+    class BlockWriter {
+    public:
+      explicit BlockWriter(std::ostream& out);
+
+      void u32(uint32_t value);
+      void u64(uint64_t value);
+      void i32(int32_t value);
+      void str(const std::string& value);
+      void raw(const char* data, size_t size);
+      bool flush();
+
+    private:
+      std::ostream& out_;
+      std::vector< char > buffer_;
+    };
+
+    // reads fields from a stream in large blocks; any short read makes the reader bad
+    // and every later field comes back as zero
+    class BlockReader {
+    public:
+      explicit BlockReader(std::istream& in);
+
+      uint32_t u32();
+      uint64_t u64();
+      int32_t i32();
+      std::string str();
+      bool raw(char* data, size_t size);
+      bool good() const;
+
+    private:
+      std::istream& in_;
+      std::vector< char > buffer_;
+      size_t pos_;
+      size_t end_;
+      bool good_;
+
+      bool fill();
+    };
+
+    uint32_t encodeDate(const date::Date& d);
+    date::Date decodeDate(uint32_t value);
+  }
+}
+
+#endif
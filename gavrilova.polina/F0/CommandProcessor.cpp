@@ -90,7 +90,7 @@ void gavrilova::CommandProcessor::handleHelp()
                "groupstats <группа> <старт_ДД-ММ-ГГГГ> <конец_ДД-ММ-ГГГГ>\n"
                "avgmarkbydate <ДД-ММ-ГГГГ>\n"
                "create_group <группа>\n"
-               "save <файл>\n"
+               "save <файл> (файл *.txt сохраняется в текстовом формате, иначе в двоичном)\n"
                "loadbase <файл>\n"
                "clear\n";
 }
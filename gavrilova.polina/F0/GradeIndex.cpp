@@ -0,0 +1,204 @@
+#include "GradeIndex.hpp"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+  struct RankKeyAscLess {
+    bool operator()(const gavrilova::grades::RankKey& a, const gavrilova::grades::RankKey& b) const
+    {
+      if (a.average == b.average) {
+        return a.id < b.id;
+      }
+      return a.average < b.average;
+    }
+  };
+
+  struct UngradedKey {
+    gavrilova::grades::RankKey operator()(gavrilova::StudentID id) const
+    {
+      return {0.0, id};
+    }
+  };
+
+  struct KeyToId {
+    gavrilova::StudentID operator()(const gavrilova::grades::RankKey& key) const
+    {
+      return key.id;
+    }
+  };
+
+  struct IsBelow {
+    double threshold;
+    bool operator()(const gavrilova::grades::RankKey& key) const
+    {
+      return key.average < threshold;
+    }
+  };
+
+  std::vector< gavrilova::grades::RankKey > firstUngraded(const std::set< gavrilova::StudentID >& ids, size_t n)
+  {
+    std::vector< gavrilova::grades::RankKey > result;
+    auto last = std::next(ids.begin(), std::min(n, ids.size()));
+    std::transform(ids.begin(), last, std::back_inserter(result), UngradedKey{});
+    return result;
+  }
+
+  std::vector< gavrilova::StudentID > takeIds(const std::vector< gavrilova::grades::RankKey >& keys, size_t n)
+  {
+    std::vector< gavrilova::StudentID > result;
+    auto last = std::next(keys.begin(), std::min(n, keys.size()));
+    std::transform(keys.begin(), last, std::back_inserter(result), KeyToId{});
+    return result;
+  }
+}
+
+void gavrilova::grades::GradeTotals::add(int grade)
+{
+  sum += grade;
+  ++count;
+}
+
+void gavrilova::grades::GradeTotals::remove(int grade)
+{
+  sum -= grade;
+  --count;
+}
+
+double gavrilova::grades::GradeTotals::average() const
+{
+  return count ? static_cast< double >(sum) / count : 0.0;
+}
+
+void gavrilova::grades::GradeColumn::add(StudentID id, int grade)
+{
+  auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+  marks.insert(marks.begin() + (pos - ids.begin()), grade);
+  ids.insert(pos, id);
+  totals.add(grade);
+}
+
+void gavrilova::grades::GradeColumn::change(StudentID id, int grade)
+{
+  auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+  if (pos != ids.end() && *pos == id) {
+    int& mark = marks[pos - ids.begin()];
+    totals.remove(mark);
+    totals.add(grade);
+    mark = grade;
+  }
+}
+
+void gavrilova::grades::GradeColumn::remove(StudentID id)
+{
+  auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+  if (pos != ids.end() && *pos == id) {
+    auto mark = marks.begin() + (pos - ids.begin());
+    totals.remove(*mark);
+    marks.erase(mark);
+    ids.erase(pos);
+  }
+}
+
+void gavrilova::grades::GroupDateStats::add(int grade)
+{
+  totals.add(grade);
+  distribution[grade]++;
+}
+
+void gavrilova::grades::GroupDateStats::remove(int grade)
+{
+  totals.remove(grade);
+  auto it = distribution.find(grade);
+  if (it != distribution.end() && --it->second == 0) {
+    distribution.erase(it);
+  }
+}
+
+bool gavrilova::grades::RankKeyLess::operator()(const RankKey& a, const RankKey& b) const
+{
+  if (a.average == b.average) {
+    return a.id < b.id;
+  }
+  return a.average > b.average;
+}
+
+gavrilova::grades::GradeRanking::GradeRanking(std::vector< RankKey > graded, const std::vector< StudentID >& ungraded):
+  graded_(),
+  ungraded_(ungraded.begin(), ungraded.end())
+{
+  std::sort(graded.begin(), graded.end(), RankKeyLess{});
+  graded_.insert(graded.begin(), graded.end());
+}
+
+void gavrilova::grades::GradeRanking::insert(StudentID id, double average, bool graded)
+{
+  if (graded) {
+    graded_.insert({average, id});
+  } else {
+    ungraded_.insert(id);
+  }
+}
+
+void gavrilova::grades::GradeRanking::erase(StudentID id, double average)
+{
+  graded_.erase({average, id});
+  ungraded_.erase(id);
+}
+
+std::vector< gavrilova::StudentID > gavrilova::grades::GradeRanking::top(size_t n) const
+{
+  auto last = std::next(graded_.begin(), std::min(n, graded_.size()));
+  std::vector< RankKey > ungraded = firstUngraded(ungraded_, n);
+  std::vector< RankKey > merged;
+  std::merge(graded_.begin(), last, ungraded.begin(), ungraded.end(), std::back_inserter(merged), RankKeyLess{});
+  return takeIds(merged, n);
+}
+
+std::vector< gavrilova::StudentID > gavrilova::grades::GradeRanking::bottom(size_t n) const
+{
+  std::vector< RankKey > lowest;
+  auto end = graded_.end();
+  while (lowest.size() < n && end != graded_.begin()) {
+    auto block = graded_.lower_bound({std::prev(end)->average, 0});
+    auto last = std::next(block, std::min< size_t >(n - lowest.size(), std::distance(block, end)));
+    std::copy(block, last, std::back_inserter(lowest));
+    end = block;
+  }
+
+  std::vector< RankKey > ungraded = firstUngraded(ungraded_, n);
+  std::vector< RankKey > merged;
+  std::merge(lowest.begin(), lowest.end(), ungraded.begin(), ungraded.end(), std::back_inserter(merged),
+      RankKeyAscLess{});
+  return takeIds(merged, n);
+}
+
+std::vector< gavrilova::StudentID > gavrilova::grades::GradeRanking::below(double threshold) const
+{
+  auto first = graded_.upper_bound({threshold, std::numeric_limits< StudentID >::max()});
+  std::vector< RankKey > keys;
+  std::copy_if(first, graded_.end(), std::back_inserter(keys), IsBelow{threshold});
+
+  std::vector< StudentID > result;
+  std::transform(keys.begin(), keys.end(), std::back_inserter(result), KeyToId{});
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+void gavrilova::grades::GroupIndex::addGrade(const date::Date& date, int grade)
+{
+  byDate[date].add(grade);
+}
+
+void gavrilova::grades::GroupIndex::removeGrade(const date::Date& date, int grade)
+{
+  auto it = byDate.find(date);
+  if (it == byDate.end()) {
+    return;
+  }
+  it->second.remove(grade);
+  if (it->second.totals.count == 0) {
+    byDate.erase(it);
+  }
+}
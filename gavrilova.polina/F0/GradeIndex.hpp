@@ -0,0 +1,79 @@
+#ifndef GRADE_INDEX_HPP
+#define GRADE_INDEX_HPP
+
+#include <map>
+#include <set>
+#include <vector>
+#include "Date.hpp"
+#include "Student.hpp"
+
+namespace gavrilova {
+  namespace grades {
+    struct GradeTotals {
+      long long sum = 0;
+      size_t count = 0;
+
+      void add(int grade);
+      void remove(int grade);
+      double average() const;
+    };
+
+    // grades of one date as parallel columns sorted by student id
+    struct GradeColumn {
+      std::vector< StudentID > ids;
+      std::vector< int > marks;
+      GradeTotals totals;
+
+      void add(StudentID id, int grade);
+      void change(StudentID id, int grade);
+      void remove(StudentID id);
+    };
+
+    struct GroupDateStats {
+      GradeTotals totals;
+      std::map< int, int > distribution;
+
+      void add(int grade);
+      void remove(int grade);
+    };
+
+    struct RankKey {
+      double average;
+      StudentID id;
+    };
+
+    // best first: higher average, then lower id
+    struct RankKeyLess {
+      bool operator()(const RankKey& a, const RankKey& b) const;
+    };
+
+    // students ordered the way the top and risk reports list them; students
+    // without grades are kept apart since risk reports skip them
+    class GradeRanking {
+    public:
+      GradeRanking() = default;
+      GradeRanking(std::vector< RankKey > graded, const std::vector< StudentID >& ungraded);
+
+      void insert(StudentID id, double average, bool graded);
+      void erase(StudentID id, double average);
+
+      std::vector< StudentID > top(size_t n) const;
+      std::vector< StudentID > bottom(size_t n) const;
+      std::vector< StudentID > below(double threshold) const;
+
+    private:
+      std::set< RankKey, RankKeyLess > graded_;
+      std::set< StudentID > ungraded_;
+    };
+
+    struct GroupIndex {
+      GradeRanking ranking;
+      std::map< date::Date, GroupDateStats > byDate;
+
+      void addGrade(const date::Date& date, int grade);
+      void removeGrade(const date::Date& date, int grade);
+    };
+  }
+}
+
+#endif
@@ -16,123 +16,60 @@ namespace {
     }
   };
 
-  struct CompareStudentsByGrade {
-    bool operator()(const std::shared_ptr< const gavrilova::student::Student >& a,
-        const std::shared_ptr< const gavrilova::student::Student >& b) const
+  struct StudentLookup {
+    const std::map< gavrilova::StudentID, std::shared_ptr< gavrilova::student::Student > >& students;
+    std::shared_ptr< const gavrilova::student::Student > operator()(gavrilova::StudentID id) const
     {
-      if (a->averageGrade_ == b->averageGrade_) {
-        return a->id_ < b->id_;
-      }
-      return a->averageGrade_ > b->averageGrade_;
+      return students.at(id);
     }
   };
 
-  struct CompareStudentsByGradeAsc {
-    bool operator()(const std::shared_ptr< const gavrilova::student::Student >& a,
-        const std::shared_ptr< const gavrilova::student::Student >& b) const
+  struct GradeAdder {
+    gavrilova::StudentDatabase& db;
+    gavrilova::StudentID id;
+    void operator()(const std::pair< const gavrilova::date::Date, int >& grade) const
     {
-      if (a->averageGrade_ == b->averageGrade_) {
-        return a->id_ < b->id_;
-      }
-      return a->averageGrade_ < b->averageGrade_;
+      db.addGrade(id, grade.second, grade.first);
     }
   };
 
-  struct IsGradeInPeriod {
-    const gavrilova::DateRange& period;
-    bool operator()(const std::pair< gavrilova::date::Date, int >& grade) const
-    {
-      return !(grade.first < period.start) && !(period.end < grade.first);
+  template < typename Map >
+  std::pair< typename Map::const_iterator, typename Map::const_iterator > periodRange(const Map& byDate,
+      const gavrilova::DateRange& period)
+  {
+    if (period.end < period.start) {
+      return {byDate.end(), byDate.end()};
     }
-  };
+    return {byDate.lower_bound(period.start), byDate.upper_bound(period.end)};
+  }
 
-  struct GroupStatsAccumulator {
-    const gavrilova::DateRange& period;
-    std::vector< int >& grades;
+  struct GroupPeriodAccumulator {
+    gavrilova::grades::GradeTotals& totals;
     std::map< int, int >& distribution;
 
-    void operator()(const std::shared_ptr< const gavrilova::student::Student >& student) const
+    void operator()(const std::pair< const gavrilova::date::Date, gavrilova::grades::GroupDateStats >& day) const
     {
-      struct GradeProcessor {
-        const gavrilova::DateRange& p;
-        std::vector< int >& g;
-        std::map< int, int >& d;
-
-        void operator()(const std::pair< gavrilova::date::Date, int >& grade) const
-        {
-          if (IsGradeInPeriod{p}(grade)) {
-            g.push_back(grade.second);
-            d[grade.second]++;
-          }
-        }
-      };
-
-      std::for_each(student->grades_.begin(), student->grades_.end(),
-          GradeProcessor{period, grades, distribution});
+      totals.sum += day.second.totals.sum;
+      totals.count += day.second.totals.count;
+      std::for_each(day.second.distribution.begin(), day.second.distribution.end(), DistributionAdder{distribution});
     }
-  };
 
-  struct OtherGroupsGradesCollector {
-    const gavrilova::DateRange& period;
-    const std::string& currentGroup;
-    std::vector< int >& grades;
-
-    void operator()(const std::pair< std::string, gavrilova::StudentDatabase::Group >& group) const
-    {
-      if (group.first == currentGroup) {
-        return;
+    struct DistributionAdder {
+      std::map< int, int >& distribution;
+      void operator()(const std::pair< const int, int >& grade) const
+      {
+        distribution[grade.first] += grade.second;
       }
-
-      struct StudentProcessor {
-        const gavrilova::DateRange& p;
-        std::vector< int >& g;
-
-        void operator()(const std::pair< gavrilova::StudentID,
-            std::shared_ptr< gavrilova::student::Student > >& student) const
-        {
-          struct GradeExtractor {
-            const gavrilova::DateRange& period;
-            std::vector< int >& grades;
-
-            void operator()(const std::pair< gavrilova::date::Date, int >& grade) const
-            {
-              if (IsGradeInPeriod{period}(grade)) {
-                grades.push_back(grade.second);
-              }
-            }
-          };
-
-          std::for_each(student.second->grades_.begin(), student.second->grades_.end(),
-              GradeExtractor{p, g});
-        }
-      };
-
-      std::for_each(group.second.begin(), group.second.end(),
-          StudentProcessor{period, grades});
-    }
-  };
-
-  struct IsRiskStudentPredicate {
-    double threshold;
-    bool operator()(const std::pair< gavrilova::StudentID,
-        std::shared_ptr< gavrilova::student::Student > >& p) const
-    {
-      return !p.second->grades_.empty() && p.second->averageGrade_ < threshold;
-    }
+    };
   };
 
-  struct IsRiskStudentInGroupPredicate {
-    double threshold;
-    bool operator()(const std::shared_ptr< const gavrilova::student::Student >& s) const
-    {
-      return !s->grades_.empty() && s->averageGrade_ < threshold;
-    }
-  };
+  struct ColumnTotalsAccumulator {
+    gavrilova::grades::GradeTotals& totals;
 
-  struct GradePairAccumulator {
-    double operator()(double sum, const std::pair< gavrilova::StudentID, int >& p) const
+    void operator()(const std::pair< const gavrilova::date::Date, gavrilova::grades::GradeColumn >& day) const
     {
-      return sum + p.second;
+      totals.sum += day.second.totals.sum;
+      totals.count += day.second.totals.count;
     }
   };
 
@@ -148,15 +85,30 @@ namespace {
       bool ok = pair.first;
       gavrilova::StudentID id = pair.second;
       if (ok) {
-        auto sp = db.findStudentById(id);
-        if (sp) {
-          sp->grades_ = stud.grades_;
-          db.updateStudentAverageGrade(sp);
-        }
+        std::for_each(stud.grades_.begin(), stud.grades_.end(), GradeAdder{db, id});
       }
     }
   };
 
+  struct StudentEntryAdder {
+    StudentAdder adder;
+
+    void operator()(const std::pair< const gavrilova::StudentID,
+        std::shared_ptr< gavrilova::student::Student > >& p) const
+    {
+      adder(*p.second);
+    }
+  };
+
+  struct GroupCreator {
+    gavrilova::StudentDatabase& db;
+
+    void operator()(const std::pair< const std::string, gavrilova::StudentDatabase::Group >& group) const
+    {
+      db.createGroup(group.first);
+    }
+  };
+
   struct StudentToFileWriter {
     std::ostream& out;
     void operator()(const std::pair< gavrilova::StudentID,
@@ -187,6 +139,12 @@ namespace {
     }
   };
 
+  bool isTextFileName(const std::string& filename)
+  {
+    const std::string ext = ".txt";
+    return filename.size() >= ext.size() && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
+  }
+
   struct GroupStudentExporter {
     std::ostream& out;
 
@@ -208,10 +166,14 @@ gavrilova::StudentDatabase::StudentDatabase(int id_digits)
 
 bool gavrilova::StudentDatabase::saveToFile(const std::string& filename) const
 {
-  std::ofstream out(filename);
+  bool text = isTextFileName(filename);
+  std::ofstream out(filename, text ? std::ios::out : std::ios::out | std::ios::binary);
   if (!out) {
     return false;
   }
+  if (!text) {
+    return saveBinary(out);
+  }
 
   std::for_each(students.begin(), students.end(), StudentToFileWriter{out});
   return true;
@@ -219,10 +181,24 @@ bool gavrilova::StudentDatabase::saveToFile(const std::string& filename) const
 
 bool gavrilova::StudentDatabase::loadFromFile(const std::string& filename)
 {
-  std::ifstream in(filename);
+  std::ifstream in(filename, std::ios::in | std::ios::binary);
   if (!in) {
     return false;
   }
+  // both formats merge into what is already loaded, through addStudent like an import;
+  // only a binary file loaded into an empty database is bulk-built and keeps its ids
+  if (isBinaryFile(in)) {
+    if (students.empty() && groups.empty()) {
+      return loadBinary(in);
+    }
+    StudentDatabase loaded;
+    if (!loaded.loadBinary(in)) {
+      return false;
+    }
+    std::for_each(loaded.groups.begin(), loaded.groups.end(), GroupCreator{*this});
+    std::for_each(loaded.students.begin(), loaded.students.end(), StudentEntryAdder{StudentAdder{*this}});
+    return true;
+  }
 
   std::vector< student::Student > loadedStudents(std::istream_iterator< student::Student >{in},
       std::istream_iterator< student::Student >{});
@@ -238,11 +214,17 @@ void gavrilova::StudentDatabase::clear()
   groups.clear();
   nameToStudentIndex.clear();
   dateToGradesIndex.clear();
+  groupIndexes.clear();
+  ranking = grades::GradeRanking();
 }
 
 bool gavrilova::StudentDatabase::createGroup(const std::string& groupName)
 {
-  return groups.emplace(groupName, Group{}).second;
+  if (!groups.emplace(groupName, Group{}).second) {
+    return false;
+  }
+  groupIndexes.emplace(groupName, grades::GroupIndex{});
+  return true;
 }
 
 bool gavrilova::StudentDatabase::groupExists(const std::string& groupName) const
@@ -279,6 +261,7 @@ std::pair< bool, gavrilova::StudentID > gavrilova::StudentDatabase::addStudent
   students[nextId] = student;
   groups[groupName][nextId] = student;
   nameToStudentIndex[fullName].insert(nextId);
+  rankStudent(*student);
 
   return {true, nextId++};
 }
@@ -291,34 +274,17 @@ bool gavrilova::StudentDatabase::deleteStudent(StudentID id)
   }
   const auto& student = it_student->second;
 
-  struct GradeRemoverFromDateIndex {
-    struct IsStudentGrade {
-      StudentID studentId;
-      bool operator()(const std::pair< StudentID, int >& p) const
-      {
-        return p.first == studentId;
-      }
-    };
-    StudentID studentIdToRemove;
-    std::map< date::Date, std::vector< std::pair< StudentID, int > > >* dateIndex;
-
-    void operator()(const std::pair< const date::Date, int >& gradeEntry)
+  struct GradeUnindexer {
+    StudentDatabase& db;
+    const student::Student& student;
+    void operator()(const std::pair< const date::Date, int >& grade) const
     {
-      auto it_date = dateIndex->find(gradeEntry.first);
-      if (it_date != dateIndex->end()) {
-        auto& gradesOnDate = it_date->second;
-        auto newEnd = std::remove_if(gradesOnDate.begin(), gradesOnDate.end(), IsStudentGrade{studentIdToRemove});
-        gradesOnDate.erase(newEnd, gradesOnDate.end());
-
-        if (gradesOnDate.empty()) {
-          dateIndex->erase(it_date);
-        }
-      }
+      db.unindexGrade(student, grade.first, grade.second);
     }
   };
 
-  std::for_each(student->grades_.begin(), student->grades_.end(),
-      GradeRemoverFromDateIndex{id, &dateToGradesIndex});
+  std::for_each(student->grades_.begin(), student->grades_.end(), GradeUnindexer{*this, *student});
+  unrankStudent(*student);
 
   groups.at(student->group_).erase(id);
 
@@ -338,9 +304,23 @@ bool gavrilova::StudentDatabase::moveStudentToGroup(StudentID id, const std::str
     return false;
   }
 
+  struct GroupGradeMover {
+    grades::GroupIndex& from;
+    grades::GroupIndex& to;
+    void operator()(const std::pair< const date::Date, int >& grade) const
+    {
+      from.removeGrade(grade.first, grade.second);
+      to.addGrade(grade.first, grade.second);
+    }
+  };
+
+  unrankStudent(*student_ptr);
+  std::for_each(student_ptr->grades_.begin(), student_ptr->grades_.end(),
+      GroupGradeMover{groupIndexes.at(student_ptr->group_), groupIndexes.at(newGroupName)});
   groups.at(student_ptr->group_).erase(id);
   groups[newGroupName][id] = student_ptr;
   student_ptr->group_ = newGroupName;
+  rankStudent(*student_ptr);
 
   return true;
 }
@@ -378,7 +358,7 @@ bool gavrilova::StudentDatabase::addGrade(StudentID id, int grade, const date::D
   }
 
   student_ptr->grades_[date] = grade;
-  dateToGradesIndex[date].push_back({id, grade});
+  indexGrade(*student_ptr, date, grade);
   updateStudentAverageGrade(student_ptr);
 
   return true;
@@ -391,29 +371,12 @@ bool gavrilova::StudentDatabase::changeGrade(StudentID id, int newGrade, const d
   if (!student_ptr || !student_ptr->grades_.count(date)) {
     return false;
   }
-  student_ptr->grades_[date] = newGrade;
-
-  struct GradeChanger {
-    int newGrade;
-    void operator()(std::pair< StudentID, int >& p) const
-    {
-      p.second = newGrade;
-    }
-  };
-
-  struct FindGradePredicate {
-    StudentID studentId;
-    bool operator()(const std::pair< StudentID, int >& p) const
-    {
-      return p.first == studentId;
-    }
-  };
-
-  auto& grades_on_date = dateToGradesIndex.at(date);
-  auto it_grade = std::find_if(grades_on_date.begin(), grades_on_date.end(), FindGradePredicate{id});
-  if (it_grade != grades_on_date.end()) {
-    GradeChanger{newGrade}(*it_grade);
-  }
+  int& grade = student_ptr->grades_[date];
+  dateToGradesIndex.at(date).change(id, newGrade);
+  grades::GroupIndex& group = groupIndexes.at(student_ptr->group_);
+  group.removeGrade(date, grade);
+  group.addGrade(date, newGrade);
+  grade = newGrade;
 
   updateStudentAverageGrade(student_ptr);
   return true;
@@ -425,42 +388,59 @@ bool gavrilova::StudentDatabase::removeGradesByDate(StudentID id, const date::Da
   if (!student_ptr || !student_ptr->grades_.count(date)) {
     return false;
   }
-  student_ptr->grades_.erase(date);
+  auto it_grade = student_ptr->grades_.find(date);
+  unindexGrade(*student_ptr, date, it_grade->second);
+  student_ptr->grades_.erase(it_grade);
 
-  struct IsStudentGrade {
-    StudentID studentId;
-    bool operator()(const std::pair< StudentID, int >& p) const
-    {
-      return p.first == studentId;
-    }
-  };
+  updateStudentAverageGrade(student_ptr);
+  return true;
+}
+
+void gavrilova::StudentDatabase::updateStudentAverageGrade(std::shared_ptr< student::Student >& student)
+{
+  unrankStudent(*student);
+  student->averageGrade_ = student::calcAverage(*student);
+  rankStudent(*student);
+}
+
+void gavrilova::StudentDatabase::rankStudent(const student::Student& student)
+{
+  bool graded = !student.grades_.empty();
+  ranking.insert(student.id_, student.averageGrade_, graded);
+  groupIndexes[student.group_].ranking.insert(student.id_, student.averageGrade_, graded);
+}
+
+void gavrilova::StudentDatabase::unrankStudent(const student::Student& student)
+{
+  ranking.erase(student.id_, student.averageGrade_);
+  groupIndexes[student.group_].ranking.erase(student.id_, student.averageGrade_);
+}
 
+void gavrilova::StudentDatabase::indexGrade(const student::Student& student, const date::Date& date, int grade)
+{
+  dateToGradesIndex[date].add(student.id_, grade);
+  groupIndexes[student.group_].addGrade(date, grade);
+}
+
+void gavrilova::StudentDatabase::unindexGrade(const student::Student& student, const date::Date& date, int grade)
+{
   auto it_date = dateToGradesIndex.find(date);
   if (it_date != dateToGradesIndex.end()) {
-    auto& grades_on_date = it_date->second;
-    auto new_end = std::remove_if(grades_on_date.begin(), grades_on_date.end(), IsStudentGrade{id});
-    grades_on_date.erase(new_end, grades_on_date.end());
-    if (grades_on_date.empty()) {
+    it_date->second.remove(student.id_);
+    if (it_date->second.ids.empty()) {
       dateToGradesIndex.erase(it_date);
     }
   }
-
-  updateStudentAverageGrade(student_ptr);
-  return true;
+  groupIndexes[student.group_].removeGrade(date, grade);
 }
 
-void gavrilova::StudentDatabase::updateStudentAverageGrade(std::shared_ptr< student::Student >& student)
+std::vector< std::shared_ptr< const gavrilova::student::Student > >
+gavrilova::StudentDatabase::toStudents(const std::vector< StudentID >& ids) const
 {
-  if (student->grades_.empty()) {
-    student->averageGrade_ = 0.0;
-    return;
-  }
-
-  double sum = 0.0;
-  for (const auto& grade: student->grades_) {
-    sum += grade.second;
-  }
-  student->averageGrade_ = sum / student->grades_.size();
+  std::vector< std::shared_ptr< const student::Student > > result;
+  result.reserve(ids.size());
+  std::transform(ids.begin(), ids.end(), std::back_inserter(result), StudentLookup{students});
+  return result;
 }
 
 std::vector< std::shared_ptr< const gavrilova::student::Student > >
@@ -520,42 +500,24 @@ bool gavrilova::StudentDatabase::loadGradesFromFile(const std::string& groupName
 std::pair< bool, gavrilova::GroupStatistics > gavrilova::StudentDatabase::getGroupStatistics
     (const std::string& groupName, const DateRange& period) const
 {
-  auto it = groups.find(groupName);
-  if (it == groups.end()) return {false, {}};
+  auto it = groupIndexes.find(groupName);
+  if (it == groupIndexes.end()) return {false, {}};
 
   GroupStatistics stats;
-  std::vector< int > groupGrades;
-  std::vector< std::shared_ptr< const student::Student > > groupStudents;
-
-  std::transform(it->second.begin(), it->second.end(),
-      std::back_inserter(groupStudents),
-      PairToSecond< Group::value_type >());
-
-  std::for_each(groupStudents.begin(), groupStudents.end(),
-      GroupStatsAccumulator{period, groupGrades, stats.gradeDistribution});
-
-  if (!groupGrades.empty()) {
-    stats.groupAverage = std::accumulate(groupGrades.begin(), groupGrades.end(), 0.0) / groupGrades.size();
-  }
+  grades::GradeTotals groupTotals;
+  auto groupDays = periodRange(it->second.byDate, period);
+  std::for_each(groupDays.first, groupDays.second, GroupPeriodAccumulator{groupTotals, stats.gradeDistribution});
+  stats.groupAverage = groupTotals.average();
 
-  size_t top_count = std::min(static_cast< size_t >(3), groupStudents.size());
-  stats.topStudents.resize(top_count);
-  std::partial_sort_copy(groupStudents.begin(), groupStudents.end(),
-      stats.topStudents.begin(), stats.topStudents.end(),
-      CompareStudentsByGrade{});
+  stats.topStudents = toStudents(it->second.ranking.top(3));
+  stats.bottomStudents = toStudents(it->second.ranking.bottom(3));
 
-  stats.bottomStudents.resize(top_count);
-  std::partial_sort_copy(groupStudents.begin(), groupStudents.end(),
-      stats.bottomStudents.begin(), stats.bottomStudents.end(),
-      CompareStudentsByGradeAsc{});
-
-  std::vector< int > otherGrades;
-  std::for_each(groups.begin(), groups.end(),
-      OtherGroupsGradesCollector{period, groupName, otherGrades});
-
-  if (!otherGrades.empty()) {
-    stats.allOtherGroupsAverage = std::accumulate(otherGrades.begin(), otherGrades.end(), 0.0) / otherGrades.size();
-  }
+  grades::GradeTotals otherTotals;
+  auto allDays = periodRange(dateToGradesIndex, period);
+  std::for_each(allDays.first, allDays.second, ColumnTotalsAccumulator{otherTotals});
+  otherTotals.sum -= groupTotals.sum;
+  otherTotals.count -= groupTotals.count;
+  stats.allOtherGroupsAverage = otherTotals.average();
 
   return {true, stats};
 }
@@ -563,61 +525,33 @@ std::pair< bool, gavrilova::GroupStatistics > gavrilova::StudentDatabase::getGro
 std::vector< std::shared_ptr< const gavrilova::student::Student > >
 gavrilova::StudentDatabase::getTopStudents(size_t n) const
 {
-  std::vector< std::shared_ptr< const student::Student > > allStudents;
-  std::transform(students.begin(), students.end(),
-      std::back_inserter(allStudents),
-      PairToSecond< std::map< StudentID, std::shared_ptr< student::Student > >::value_type >());
-
-  std::vector< std::shared_ptr< const student::Student > > result;
-  result.resize(std::min(n, allStudents.size()));
-
-  std::partial_sort_copy(allStudents.begin(), allStudents.end(),
-      result.begin(), result.end(),
-      CompareStudentsByGrade{});
-
-  return result;
+  return toStudents(ranking.top(n));
 }
 
 std::vector< std::shared_ptr< const gavrilova::student::Student > >
 gavrilova::StudentDatabase::getRiskStudents(double threshold) const
 {
-  std::vector< std::pair< StudentID, std::shared_ptr< student::Student > > > temp;
-  std::copy_if(students.begin(), students.end(),
-      std::back_inserter(temp),
-      IsRiskStudentPredicate{threshold});
-
-  std::vector< std::shared_ptr< const student::Student > > result;
-  std::transform(temp.begin(), temp.end(),
-      std::back_inserter(result),
-      PairToSecond< std::pair< StudentID, std::shared_ptr< student::Student > > >());
-
-  return result;
+  return toStudents(ranking.below(threshold));
 }
 
 std::vector< std::shared_ptr< const gavrilova::student::Student > >
 gavrilova::StudentDatabase::getTopStudentsInGroup(const std::string& groupName, size_t n) const
 {
-  auto students = getStudentsInGroup(groupName);
-  std::vector< std::shared_ptr< const student::Student > > result;
-  result.resize(std::min(n, students.size()));
-
-  std::partial_sort_copy(students.begin(), students.end(),
-      result.begin(), result.end(),
-      CompareStudentsByGrade{});
-
-  return result;
+  auto it = groupIndexes.find(groupName);
+  if (it == groupIndexes.end()) {
+    return {};
+  }
+  return toStudents(it->second.ranking.top(n));
 }
 
 std::vector< std::shared_ptr< const gavrilova::student::Student > >
 gavrilova::StudentDatabase::getRiskStudentsInGroup(const std::string& groupName, double threshold) const
 {
-  auto students = getStudentsInGroup(groupName);
-  std::vector< std::shared_ptr< const student::Student > > result;
-  std::copy_if(students.begin(), students.end(),
-      std::back_inserter(result),
-      IsRiskStudentInGroupPredicate{threshold});
-
-  return result;
+  auto it = groupIndexes.find(groupName);
+  if (it == groupIndexes.end()) {
+    return {};
+  }
+  return toStudents(it->second.ranking.below(threshold));
 }
 
 std::pair< bool, double > gavrilova::StudentDatabase::getAverageGradeByDate(const date::Date& date) const
@@ -625,9 +559,5 @@ std::pair< bool, double > gavrilova::StudentDatabase::getAverageGradeByDate(cons
   auto it = dateToGradesIndex.find(date);
   if (it == dateToGradesIndex.end()) return {false, 0.0};
 
-  const auto& grades = it->second;
-  double sum = std::accumulate(grades.begin(), grades.end(), 0.0,
-      GradePairAccumulator{});
-
-  return {true, sum / grades.size()};
+  return {true, it->second.totals.average()};
 }
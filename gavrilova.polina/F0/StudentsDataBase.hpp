@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include "Date.hpp"
+#include "GradeIndex.hpp"
 #include "Student.hpp"
 
 namespace gavrilova {
@@ -68,8 +69,19 @@ namespace gavrilova {
     std::map< StudentID, std::shared_ptr< student::Student > > students;
     std::map< std::string, Group > groups;
     std::map< std::string, std::set< StudentID > > nameToStudentIndex;
-    std::map< date::Date, std::vector< std::pair< StudentID, int > > > dateToGradesIndex;
+    std::map< date::Date, grades::GradeColumn > dateToGradesIndex;
+    std::map< std::string, grades::GroupIndex > groupIndexes;
+    grades::GradeRanking ranking;
     StudentID nextId;
+
+    static bool isBinaryFile(std::istream& in);
+    bool saveBinary(std::ostream& out) const;
+    bool loadBinary(std::istream& in);
+    void rankStudent(const student::Student& student);
+    void unrankStudent(const student::Student& student);
+    void indexGrade(const student::Student& student, const date::Date& date, int grade);
+    void unindexGrade(const student::Student& student, const date::Date& date, int grade);
+    std::vector< std::shared_ptr< const student::Student > > toStudents(const std::vector< StudentID >& ids) const;
   };
 }
 
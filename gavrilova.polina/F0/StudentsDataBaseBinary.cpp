@@ -0,0 +1,542 @@
+#include "StudentsDataBase.hpp"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include "BinaryIO.hpp"
+
+namespace {
+  const char magic[4] = {'G', 'V', 'D', 'B'};
+  const uint32_t formatVersion = 1;
+
+  using StudentEntry = std::pair< const gavrilova::StudentID, std::shared_ptr< gavrilova::student::Student > >;
+  using RefPair = std::pair< uint32_t, uint32_t >;
+
+  struct StringInterner {
+    std::unordered_map< std::string, uint32_t > ids;
+    std::vector< const std::string* > strings;
+
+    uint32_t operator()(const std::string& value)
+    {
+      auto inserted = ids.emplace(value, static_cast< uint32_t >(strings.size()));
+      if (inserted.second) {
+        strings.push_back(&inserted.first->first);
+      }
+      return inserted.first->second;
+    }
+  };
+
+  struct GroupInterner {
+    StringInterner& interner;
+    uint32_t operator()(const std::pair< const std::string, gavrilova::StudentDatabase::Group >& group) const
+    {
+      return interner(group.first);
+    }
+  };
+
+  struct StudentInterner {
+    StringInterner& interner;
+    RefPair operator()(const StudentEntry& entry) const
+    {
+      uint32_t name = interner(entry.second->fullName_);
+      return {name, interner(entry.second->group_)};
+    }
+  };
+
+  struct StringWriter {
+    gavrilova::binary::BlockWriter& writer;
+    void operator()(const std::string* value) const
+    {
+      writer.str(*value);
+    }
+  };
+
+  struct RefWriter {
+    gavrilova::binary::BlockWriter& writer;
+    void operator()(uint32_t ref) const
+    {
+      writer.u32(ref);
+    }
+  };
+
+  struct GradeWriter {
+    gavrilova::binary::BlockWriter& writer;
+    void operator()(const std::pair< const gavrilova::date::Date, int >& grade) const
+    {
+      writer.u32(gavrilova::binary::encodeDate(grade.first));
+      writer.i32(grade.second);
+    }
+  };
+
+  struct StudentWriter {
+    gavrilova::binary::BlockWriter& writer;
+    mutable std::vector< RefPair >::const_iterator refs;
+
+    void operator()(const StudentEntry& entry) const
+    {
+      const gavrilova::student::Student& s = *entry.second;
+      writer.u64(s.id_);
+      writer.u32(refs->first);
+      writer.u32(refs->second);
+      writer.u32(static_cast< uint32_t >(s.grades_.size()));
+      std::for_each(s.grades_.begin(), s.grades_.end(), GradeWriter{writer});
+      ++refs;
+    }
+  };
+
+  // yields count fields parsed by Read; like an istream_iterator it reaches the end
+  // as soon as the reader goes bad, so a corrupt count cannot run away
+  template < typename Read >
+  class FieldIterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename Read::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    explicit FieldIterator(Read read):
+      reader_(nullptr),
+      read_(read),
+      left_(0),
+      value_()
+    {}
+
+    FieldIterator(gavrilova::binary::BlockReader& reader, Read read, uint64_t count):
+      reader_(&reader),
+      read_(read),
+      left_(count),
+      value_()
+    {
+      next();
+    }
+
+    reference operator*() const
+    {
+      return value_;
+    }
+
+    pointer operator->() const
+    {
+      return &value_;
+    }
+
+    FieldIterator& operator++()
+    {
+      next();
+      return *this;
+    }
+
+    FieldIterator operator++(int)
+    {
+      FieldIterator result(*this);
+      next();
+      return result;
+    }
+
+    bool operator==(const FieldIterator& rhs) const
+    {
+      return reader_ == rhs.reader_;
+    }
+
+    bool operator!=(const FieldIterator& rhs) const
+    {
+      return !(*this == rhs);
+    }
+
+  private:
+    gavrilova::binary::BlockReader* reader_;
+    Read read_;
+    uint64_t left_;
+    value_type value_;
+
+    void next()
+    {
+      if (left_ == 0 || !reader_->good()) {
+        reader_ = nullptr;
+        return;
+      }
+      --left_;
+      value_ = read_(*reader_);
+      if (!reader_->good()) {
+        reader_ = nullptr;
+      }
+    }
+  };
+
+  template < typename Read, typename Out >
+  Out readFields(gavrilova::binary::BlockReader& reader, uint64_t count, Read read, Out out)
+  {
+    return std::copy(FieldIterator< Read >(reader, read, count), FieldIterator< Read >(read), out);
+  }
+
+  struct ReadString {
+    using value_type = std::string;
+    std::string operator()(gavrilova::binary::BlockReader& reader) const
+    {
+      return reader.str();
+    }
+  };
+
+  struct ReadRef {
+    using value_type = uint32_t;
+    uint32_t operator()(gavrilova::binary::BlockReader& reader) const
+    {
+      return reader.u32();
+    }
+  };
+
+  // one grade keyed by its packed date; students arrive in id order, so a stable
+  // sort by date alone leaves every date's ids ascending
+  struct DatedGrade {
+    uint32_t day;
+    uint32_t group;
+    gavrilova::StudentID id;
+    int grade;
+  };
+
+  struct DatedGradeLess {
+    bool operator()(const DatedGrade& a, const DatedGrade& b) const
+    {
+      return a.day < b.day;
+    }
+  };
+
+  // save writes a student's grades in date order, so anything else, duplicates
+  // included, marks a corrupt file
+  struct DayNotAfter {
+    bool operator()(const DatedGrade& a, const DatedGrade& b) const
+    {
+      return a.day >= b.day;
+    }
+  };
+
+  struct ReadGrade {
+    using value_type = DatedGrade;
+    uint32_t group;
+    gavrilova::StudentID id;
+
+    DatedGrade operator()(gavrilova::binary::BlockReader& reader) const
+    {
+      uint32_t day = reader.u32();
+      return {day, group, id, reader.i32()};
+    }
+  };
+
+  // a student as stored, its grades being dated[firstGrade, lastGrade)
+  struct StudentRecord {
+    gavrilova::StudentID id;
+    uint32_t name;
+    uint32_t group;
+    size_t firstGrade;
+    size_t lastGrade;
+    std::shared_ptr< gavrilova::student::Student > student;
+  };
+
+  struct ReadStudent {
+    using value_type = StudentRecord;
+    std::vector< DatedGrade >& dated;
+
+    StudentRecord operator()(gavrilova::binary::BlockReader& reader) const
+    {
+      StudentRecord record{};
+      record.id = reader.u64();
+      record.name = reader.u32();
+      record.group = reader.u32();
+      record.firstGrade = dated.size();
+      uint32_t gradeCount = reader.u32();
+      readFields(reader, gradeCount, ReadGrade{record.group, record.id}, std::back_inserter(dated));
+      record.lastGrade = dated.size();
+      return record;
+    }
+  };
+
+  struct RefOutOfRange {
+    size_t size;
+    bool operator()(uint32_t ref) const
+    {
+      return ref >= size;
+    }
+  };
+
+  struct BadRecord {
+    size_t stringCount;
+    const std::vector< DatedGrade >& dated;
+
+    bool operator()(const StudentRecord& record) const
+    {
+      if (record.name >= stringCount || record.group >= stringCount) {
+        return true;
+      }
+      auto first = dated.begin() + record.firstGrade;
+      auto last = dated.begin() + record.lastGrade;
+      return std::adjacent_find(first, last, DayNotAfter{}) != last;
+    }
+  };
+
+  struct RecordIdLess {
+    bool operator()(const StudentRecord& a, const StudentRecord& b) const
+    {
+      return a.id < b.id;
+    }
+  };
+
+  struct SameRecordId {
+    bool operator()(const StudentRecord& a, const StudentRecord& b) const
+    {
+      return a.id == b.id;
+    }
+  };
+
+  struct GradeInserter {
+    std::map< gavrilova::date::Date, int >& grades;
+    void operator()(const DatedGrade& grade) const
+    {
+      grades.emplace_hint(grades.end(), gavrilova::binary::decodeDate(grade.day), grade.grade);
+    }
+  };
+
+  struct StudentBuilder {
+    const std::vector< std::string >& strings;
+    const std::vector< DatedGrade >& dated;
+
+    void operator()(StudentRecord& record) const
+    {
+      auto s = std::make_shared< gavrilova::student::Student >(record.id, strings[record.name], strings[record.group]);
+      std::for_each(dated.begin() + record.firstGrade, dated.begin() + record.lastGrade, GradeInserter{s->grades_});
+      s->averageGrade_ = gavrilova::student::calcAverage(*s);
+      record.student = std::move(s);
+    }
+  };
+
+  struct GroupMarker {
+    std::vector< bool >& isGroup;
+    void operator()(uint32_t ref) const
+    {
+      isGroup[ref] = true;
+    }
+  };
+
+  struct NotGroup {
+    const std::vector< bool >& isGroup;
+    bool operator()(uint32_t ref) const
+    {
+      return !isGroup[ref];
+    }
+  };
+
+  struct NameRef {
+    const std::string* name;
+    gavrilova::StudentID id;
+  };
+
+  struct NameRefLess {
+    bool operator()(const NameRef& a, const NameRef& b) const
+    {
+      return std::tie(*a.name, a.id) < std::tie(*b.name, b.id);
+    }
+  };
+
+  struct StringRefLess {
+    const std::vector< std::string >& strings;
+    bool operator()(uint32_t a, uint32_t b) const
+    {
+      return strings[a] < strings[b];
+    }
+  };
+
+  // everything collected for one group before its indexes are built
+  struct GroupBuild {
+    gavrilova::StudentDatabase::Group members;
+    gavrilova::grades::GroupIndex index;
+    uint32_t lastDay = 0;
+    std::vector< gavrilova::grades::RankKey > graded;
+    std::vector< gavrilova::StudentID > ungraded;
+  };
+
+  struct StudentCollector {
+    std::vector< GroupBuild >& byGroup;
+    std::vector< bool >& isGroup;
+    std::map< gavrilova::StudentID, std::shared_ptr< gavrilova::student::Student > >& students;
+    std::vector< NameRef >& names;
+    std::vector< gavrilova::grades::RankKey >& graded;
+    std::vector< gavrilova::StudentID >& ungraded;
+
+    void operator()(const StudentRecord& record) const
+    {
+      const std::shared_ptr< gavrilova::student::Student >& s = record.student;
+      GroupBuild& group = byGroup[record.group];
+      isGroup[record.group] = true;
+
+      students.emplace_hint(students.end(), s->id_, s);
+      group.members.emplace_hint(group.members.end(), s->id_, s);
+      names.push_back({&s->fullName_, s->id_});
+      if (s->grades_.empty()) {
+        ungraded.push_back(s->id_);
+        group.ungraded.push_back(s->id_);
+      } else {
+        graded.push_back({s->averageGrade_, s->id_});
+        group.graded.push_back({s->averageGrade_, s->id_});
+      }
+    }
+  };
+
+  struct NameIndexer {
+    std::map< std::string, std::set< gavrilova::StudentID > >& names;
+
+    void operator()(const NameRef& ref) const
+    {
+      if (names.empty() || names.rbegin()->first != *ref.name) {
+        names.emplace_hint(names.end(), *ref.name, std::set< gavrilova::StudentID >{});
+      }
+      std::set< gavrilova::StudentID >& ids = names.rbegin()->second;
+      ids.emplace_hint(ids.end(), ref.id);
+    }
+  };
+
+  struct DateIndexer {
+    std::map< gavrilova::date::Date, gavrilova::grades::GradeColumn >& dates;
+    std::vector< GroupBuild >& byGroup;
+    mutable uint32_t lastDay;
+
+    void operator()(const DatedGrade& grade) const
+    {
+      if (dates.empty() || lastDay != grade.day) {
+        dates.emplace_hint(dates.end(), gavrilova::binary::decodeDate(grade.day), gavrilova::grades::GradeColumn{});
+        lastDay = grade.day;
+      }
+      gavrilova::grades::GradeColumn& column = dates.rbegin()->second;
+      column.ids.push_back(grade.id);
+      column.marks.push_back(grade.grade);
+      column.totals.add(grade.grade);
+
+      GroupBuild& group = byGroup[grade.group];
+      if (group.index.byDate.empty() || group.lastDay != grade.day) {
+        group.index.byDate.emplace_hint(group.index.byDate.end(), dates.rbegin()->first,
+            gavrilova::grades::GroupDateStats{});
+        group.lastDay = grade.day;
+      }
+      group.index.byDate.rbegin()->second.add(grade.grade);
+    }
+  };
+
+  struct GroupEmplacer {
+    std::vector< GroupBuild >& byGroup;
+    const std::vector< std::string >& strings;
+    std::map< std::string, gavrilova::StudentDatabase::Group >& groups;
+    std::map< std::string, gavrilova::grades::GroupIndex >& indexes;
+
+    void operator()(uint32_t ref) const
+    {
+      GroupBuild& group = byGroup[ref];
+      group.index.ranking = gavrilova::grades::GradeRanking(std::move(group.graded), group.ungraded);
+      groups.emplace_hint(groups.end(), strings[ref], std::move(group.members));
+      indexes.emplace_hint(indexes.end(), strings[ref], std::move(group.index));
+    }
+  };
+}
+
+bool gavrilova::StudentDatabase::isBinaryFile(std::istream& in)
+{
+  char header[sizeof(magic)] = {};
+  in.read(header, sizeof(header));
+  bool binary = in.gcount() == sizeof(header) && std::equal(header, header + sizeof(header), magic);
+  in.clear();
+  in.seekg(0);
+  return binary;
+}
+
+bool gavrilova::StudentDatabase::saveBinary(std::ostream& out) const
+{
+  StringInterner interner;
+  std::vector< uint32_t > groupRefs;
+  groupRefs.reserve(groups.size());
+  std::transform(groups.begin(), groups.end(), std::back_inserter(groupRefs), GroupInterner{interner});
+  std::vector< RefPair > studentRefs;
+  studentRefs.reserve(students.size());
+  std::transform(students.begin(), students.end(), std::back_inserter(studentRefs), StudentInterner{interner});
+
+  binary::BlockWriter writer(out);
+  writer.raw(magic, sizeof(magic));
+  writer.u32(formatVersion);
+  writer.u64(nextId);
+  writer.u32(static_cast< uint32_t >(interner.strings.size()));
+  std::for_each(interner.strings.begin(), interner.strings.end(), StringWriter{writer});
+  writer.u32(static_cast< uint32_t >(groupRefs.size()));
+  std::for_each(groupRefs.begin(), groupRefs.end(), RefWriter{writer});
+
+  writer.u64(students.size());
+  std::for_each(students.begin(), students.end(), StudentWriter{writer, studentRefs.cbegin()});
+  return writer.flush();
+}
+
+bool gavrilova::StudentDatabase::loadBinary(std::istream& in)
+{
+  binary::BlockReader reader(in);
+  char header[sizeof(magic)] = {};
+  if (!reader.raw(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic) ||
+      reader.u32() != formatVersion) {
+    return false;
+  }
+  StudentID loadedNextId = reader.u64();
+
+  std::vector< std::string > strings;
+  uint32_t stringCount = reader.u32();
+  readFields(reader, stringCount, ReadString{}, std::back_inserter(strings));
+  std::vector< uint32_t > groupRefs;
+  uint32_t groupCount = reader.u32();
+  readFields(reader, groupCount, ReadRef{}, std::back_inserter(groupRefs));
+
+  std::vector< DatedGrade > dated;
+  std::vector< StudentRecord > records;
+  uint64_t studentCount = reader.u64();
+  readFields(reader, studentCount, ReadStudent{dated}, std::back_inserter(records));
+  if (!reader.good() || std::any_of(groupRefs.begin(), groupRefs.end(), RefOutOfRange{strings.size()}) ||
+      std::any_of(records.begin(), records.end(), BadRecord{strings.size(), dated})) {
+    return false;
+  }
+  if (!std::is_sorted(records.begin(), records.end(), RecordIdLess{}) ||
+      std::adjacent_find(records.begin(), records.end(), SameRecordId{}) != records.end()) {
+    return false;
+  }
+  std::for_each(records.begin(), records.end(), StudentBuilder{strings, dated});
+
+  std::vector< GroupBuild > byGroup(strings.size());
+  std::vector< bool > isGroup(strings.size(), false);
+  std::for_each(groupRefs.begin(), groupRefs.end(), GroupMarker{isGroup});
+
+  std::map< StudentID, std::shared_ptr< student::Student > > newStudents;
+  std::vector< NameRef > names;
+  std::vector< grades::RankKey > allGraded;
+  std::vector< StudentID > allUngraded;
+  names.reserve(records.size());
+  std::for_each(records.begin(), records.end(),
+      StudentCollector{byGroup, isGroup, newStudents, names, allGraded, allUngraded});
+
+  std::sort(names.begin(), names.end(), NameRefLess{});
+  std::map< std::string, std::set< StudentID > > newNames;
+  std::for_each(names.begin(), names.end(), NameIndexer{newNames});
+
+  std::stable_sort(dated.begin(), dated.end(), DatedGradeLess{});
+  std::map< date::Date, grades::GradeColumn > newDates;
+  std::for_each(dated.begin(), dated.end(), DateIndexer{newDates, byGroup, 0});
+
+  std::vector< uint32_t > groupOrder(strings.size());
+  std::iota(groupOrder.begin(), groupOrder.end(), 0);
+  groupOrder.erase(std::remove_if(groupOrder.begin(), groupOrder.end(), NotGroup{isGroup}), groupOrder.end());
+  std::sort(groupOrder.begin(), groupOrder.end(), StringRefLess{strings});
+
+  std::map< std::string, Group > newGroups;
+  std::map< std::string, grades::GroupIndex > newGroupIndexes;
+  std::for_each(groupOrder.begin(), groupOrder.end(), GroupEmplacer{byGroup, strings, newGroups, newGroupIndexes});
+
+  students.swap(newStudents);
+  groups.swap(newGroups);
+  nameToStudentIndex.swap(newNames);
+  dateToGradesIndex.swap(newDates);
+  groupIndexes.swap(newGroupIndexes);
+  ranking = grades::GradeRanking(std::move(allGraded), allUngraded);
+  nextId = records.empty() ? loadedNextId : std::max(loadedNextId, records.back().id + 1);
+  return true;
+}
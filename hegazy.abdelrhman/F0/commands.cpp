@@ -23,33 +23,6 @@ namespace bob
       return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
     }
 
-    bool comparatorAscending(const Word& a, const Word& b)
-    {
-      return a.second < b.second;
-    }
-
-    bool comparatorDescending(const Word& a, const Word& b)
-    {
-      return a.second > b.second;
-    }
-
-    void sortWords(std::vector< Word >& words, const std::string& order)
-    {
-      if (order == "ascending")
-      {
-        std::sort(words.begin(), words.end(), comparatorAscending);
-      }
-      else
-      {
-        std::sort(words.begin(), words.end(), comparatorDescending);
-      }
-    }
-
-    bool comparatorFrequency(const Word& word, int low, int high)
-    {
-      return word.second >= low && word.second <= high;
-    }
-
     struct PrintWord
     {
       std::ostream& out_;
@@ -69,23 +42,6 @@ namespace bob
       }
     };
 
-    bool intersectWord(const Dict& dict, const Word& word)
-    {
-      return dict.find(word.first) != dict.end();
-    }
-
-    Word frequencyUpdate(const Dict& dict, const Word& word)
-    {
-      auto it = dict.find(word.first);
-      return { word.first, std::min(word.second, it->second) };
-    }
-
-    void mergeWords(Dict& dict, const Word& word)
-    {
-      auto& freq = dict[word.first];
-      freq += word.second;
-    }
-
     struct PrintNameDicts
     {
       std::ostream& out_;
@@ -102,7 +58,7 @@ namespace bob
       std::transform(realWord.begin(), realWord.end(), realWord.begin(), toLowercase);
       if (!realWord.empty())
       {
-        dict[realWord]++;
+        dict.add(realWord, 1);
       }
     }
 
@@ -117,13 +73,12 @@ namespace bob
     {
       size_t wordCount;
       in >> wordCount;
-      Dict dict;
+      std::vector< Word > words;
       for (size_t i = 0; i < wordCount; ++i)
       {
-        auto word = readWordFreq(in);
-        dict.insert(word);
+        words.push_back(readWordFreq(in));
       }
-      return dict;
+      return Dict(std::move(words));
     }
 
     std::pair< std::string, Dict > readNamedDict(std::istream& in)
@@ -191,15 +146,15 @@ namespace bob
     {
       throw std::runtime_error("<INVALID DICTIONARY>");
     }
-    auto& result = dicts[resultName];
     const auto& dict1 = it1->second;
     const auto& dict2 = it2->second;
+    auto& result = dicts[resultName];
 
     result = dict1;
 
     for (const auto& word : dict2)
     {
-      result[word.first] += word.second;
+      result.add(word.first, word.second);
     }
   }
 
@@ -217,18 +172,8 @@ namespace bob
     {
       throw std::runtime_error("<INVALID DICTIONARY>");
     }
-    auto& result = dicts[resultName];
-    const auto& dict1 = it1->second;
-    const auto& dict2 = it2->second;
-
-    for (const auto& word : dict1)
-    {
-      auto it = dict2.find(word.first);
-      if (it != dict2.end())
-      {
-        result[word.first] = std::min(word.second, it->second);
-      }
-    }
+    Dict result = intersect(it1->second, it2->second);
+    dicts[resultName] = std::move(result);
   }
 
   void copyDictionary(std::istream& in, Dicts& dicts)
@@ -261,7 +206,7 @@ namespace bob
     {
       throw std::runtime_error("<INVALID NUMBER>");
     }
-    it->second[wordName] = num;
+    it->second.add(wordName, num);
   }
 
   void printSize(std::istream& in, std::ostream& out, const Dicts& dicts)
@@ -318,12 +263,9 @@ namespace bob
     {
       throw std::runtime_error("<INVALID NUMBER>");
     }
-    std::vector< Word > words;
-    words.reserve(dictIt->second.size());
     const auto& dict = dictIt->second;
-    std::copy(dict.cbegin(), dict.cend(), std::back_inserter(words));
-    sortWords(words, order);
-    std::for_each(words.cbegin(), words.cbegin() + number, PrintWord{ out });
+    std::vector< Word > words = (order == "ascending") ? dict.leastFrequent(number) : dict.mostFrequent(number);
+    std::for_each(words.cbegin(), words.cend(), PrintWord{ out });
   }
 
   void printFrequency(std::istream& in, std::ostream& out, const Dicts& dicts)
@@ -339,7 +281,7 @@ namespace bob
     {
       throw std::runtime_error("<INVALID WORD>");
     }
-    out << dictIt->second.at(wordName) << '\n';
+    out << dictIt->second.find(wordName)->second << '\n';
   }
 
   void createWordRange(std::istream& in, Dicts& dicts)
@@ -356,22 +298,12 @@ namespace bob
     {
       throw std::runtime_error("<INVALID DICTIONARY>");
     }
-    auto& result = dicts[resultName];
-    const auto& dict = dictIt->second;
-
-    for (const auto& word : dict)
-    {
-      if (word.second >= freq1 && word.second <= freq2)
-      {
-        result[word.first] = word.second;
-      }
-    }
-
+    Dict result = dictIt->second.withFrequencies(freq1, freq2);
     if (result.empty())
     {
-      dicts.erase(resultName);
       throw std::runtime_error("<EMPTY INTERVAL>");
     }
+    dicts[resultName] = std::move(result);
   }
 
   void saveDictionaries(std::istream& in, const Dicts& dicts)
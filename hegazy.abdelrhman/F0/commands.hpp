@@ -5,12 +5,11 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <string>
+#include "dict.hpp"
 
 namespace bob
 {
-  using Dict = std::unordered_map< std::string, int >;
   using Dicts = std::unordered_map< std::string, Dict >;
-  using Word = std::pair< std::string, int >;
 
   void createDictionary(std::istream& in, Dicts& dicts);
   void showDictionary(std::ostream& out, const Dicts& dicts);
@@ -0,0 +1,251 @@
+#include "dict.hpp"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace bob
+{
+  namespace
+  {
+    constexpr size_t minRunSize = 1 << 16;
+
+    bool lessWord(const Word& a, const Word& b)
+    {
+      return a.first < b.first;
+    }
+
+    bool notLessWord(const Word& a, const Word& b)
+    {
+      return !lessWord(a, b);
+    }
+
+    bool sameWord(const Word& a, const Word& b)
+    {
+      return a.first == b.first;
+    }
+
+    bool lessSpelling(const Word& word, const std::string& spelling)
+    {
+      return word.first < spelling;
+    }
+
+    bool lessRank(const std::vector< Word >& words, size_t a, size_t b)
+    {
+      return words[a].second < words[b].second || (words[a].second == words[b].second && a < b);
+    }
+
+    bool rankBelow(const std::vector< Word >& words, size_t pos, int freq)
+    {
+      return words[pos].second < freq;
+    }
+
+    bool rankAbove(const std::vector< Word >& words, int freq, size_t pos)
+    {
+      return freq < words[pos].second;
+    }
+
+    std::vector< Word > sumEqual(std::vector< Word >& words)
+    {
+      std::vector< Word > summed;
+      summed.reserve(words.size());
+      for (auto& word : words)
+      {
+        if (!summed.empty() && summed.back().first == word.first)
+        {
+          summed.back().second += word.second;
+        }
+        else
+        {
+          summed.push_back(std::move(word));
+        }
+      }
+      return summed;
+    }
+  }
+
+  Dict::Dict():
+    words_(),
+    run_(),
+    ranking_(),
+    ranked_(false)
+  {}
+
+  Dict::Dict(std::vector< Word > words):
+    words_(std::move(words)),
+    run_(),
+    ranking_(),
+    ranked_(false)
+  {
+    if (std::adjacent_find(words_.cbegin(), words_.cend(), notLessWord) != words_.cend())
+    {
+      std::stable_sort(words_.begin(), words_.end(), lessWord);
+      words_.erase(std::unique(words_.begin(), words_.end(), sameWord), words_.end());
+    }
+  }
+
+  void Dict::flush() const
+  {
+    if (run_.empty())
+    {
+      return;
+    }
+    std::sort(run_.begin(), run_.end(), lessWord);
+    std::vector< Word > added = sumEqual(run_);
+    run_.clear();
+    std::vector< Word > merged;
+    merged.reserve(words_.size() + added.size());
+    std::merge(std::make_move_iterator(words_.begin()), std::make_move_iterator(words_.end()),
+      std::make_move_iterator(added.begin()), std::make_move_iterator(added.end()), std::back_inserter(merged), lessWord);
+    words_ = sumEqual(merged);
+    ranked_ = false;
+  }
+
+  const std::vector< size_t >& Dict::ranking() const
+  {
+    flush();
+    if (!ranked_)
+    {
+      ranking_.resize(words_.size());
+      for (size_t i = 0; i < ranking_.size(); ++i)
+      {
+        ranking_[i] = i;
+      }
+      using namespace std::placeholders;
+      std::sort(ranking_.begin(), ranking_.end(), std::bind(lessRank, std::cref(words_), _1, _2));
+      ranked_ = true;
+    }
+    return ranking_;
+  }
+
+  void Dict::add(const std::string& word, int count)
+  {
+    auto it = std::lower_bound(words_.begin(), words_.end(), word, lessSpelling);
+    if (it != words_.end() && it->first == word)
+    {
+      it->second += count;
+      ranked_ = false;
+      return;
+    }
+    run_.emplace_back(word, count);
+    if (run_.size() >= std::max(words_.size(), minRunSize))
+    {
+      flush();
+    }
+  }
+
+  void Dict::erase(const std::string& word)
+  {
+    flush();
+    auto it = std::lower_bound(words_.begin(), words_.end(), word, lessSpelling);
+    if (it != words_.end() && it->first == word)
+    {
+      words_.erase(it);
+      ranked_ = false;
+    }
+  }
+
+  Dict::const_iterator Dict::find(const std::string& word) const
+  {
+    flush();
+    auto it = std::lower_bound(words_.cbegin(), words_.cend(), word, lessSpelling);
+    return (it != words_.cend() && it->first == word) ? it : words_.cend();
+  }
+
+  size_t Dict::size() const
+  {
+    flush();
+    return words_.size();
+  }
+
+  bool Dict::empty() const
+  {
+    return size() == 0;
+  }
+
+  Dict::const_iterator Dict::begin() const
+  {
+    flush();
+    return words_.cbegin();
+  }
+
+  Dict::const_iterator Dict::end() const
+  {
+    flush();
+    return words_.cend();
+  }
+
+  Dict::const_iterator Dict::cbegin() const
+  {
+    return begin();
+  }
+
+  Dict::const_iterator Dict::cend() const
+  {
+    return end();
+  }
+
+  Dict Dict::withFrequencies(int low, int high) const
+  {
+    using namespace std::placeholders;
+    const std::vector< size_t >& ranks = ranking();
+    auto first = std::lower_bound(ranks.cbegin(), ranks.cend(), low, std::bind(rankBelow, std::cref(words_), _1, _2));
+    auto last = std::upper_bound(first, ranks.cend(), high, std::bind(rankAbove, std::cref(words_), _1, _2));
+    std::vector< size_t > picked(first, last);
+    std::sort(picked.begin(), picked.end());
+    std::vector< Word > words;
+    words.reserve(picked.size());
+    for (size_t pos : picked)
+    {
+      words.push_back(words_[pos]);
+    }
+    return Dict(std::move(words));
+  }
+
+  std::vector< Word > Dict::leastFrequent(size_t count) const
+  {
+    const std::vector< size_t >& ranks = ranking();
+    std::vector< Word > words;
+    words.reserve(count);
+    for (auto it = ranks.cbegin(); it != ranks.cend() && words.size() < count; ++it)
+    {
+      words.push_back(words_[*it]);
+    }
+    return words;
+  }
+
+  std::vector< Word > Dict::mostFrequent(size_t count) const
+  {
+    using namespace std::placeholders;
+    const std::vector< size_t >& ranks = ranking();
+    auto below = std::bind(rankBelow, std::cref(words_), _1, _2);
+    std::vector< Word > words;
+    words.reserve(count);
+    auto groupEnd = ranks.cend();
+    while (groupEnd != ranks.cbegin() && words.size() < count)
+    {
+      int freq = words_[*std::prev(groupEnd)].second;
+      auto groupBegin = std::lower_bound(ranks.cbegin(), groupEnd, freq, below);
+      for (auto it = groupBegin; it != groupEnd && words.size() < count; ++it)
+      {
+        words.push_back(words_[*it]);
+      }
+      groupEnd = groupBegin;
+    }
+    return words;
+  }
+
+  Dict intersect(const Dict& lhs, const Dict& rhs)
+  {
+    std::vector< Word > common;
+    auto it = rhs.begin();
+    for (const auto& word : lhs)
+    {
+      it = std::lower_bound(it, rhs.end(), word.first, lessSpelling);
+      if (it != rhs.end() && it->first == word.first)
+      {
+        common.emplace_back(word.first, std::min(word.second, it->second));
+      }
+    }
+    return Dict(std::move(common));
+  }
+}
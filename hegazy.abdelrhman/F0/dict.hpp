@@ -0,0 +1,50 @@
+#ifndef DICT_HPP
+#define DICT_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bob
+{
+  using Word = std::pair< std::string, int >;
+
+  // Words live in one array sorted by spelling. Counts of known words are
+  // bumped in place; new words are appended to an unsorted run and merged in
+  // on the next read (or once the run grows as large as the array).
+  class Dict
+  {
+  public:
+    using const_iterator = std::vector< Word >::const_iterator;
+
+    Dict();
+    explicit Dict(std::vector< Word > words);
+
+    void add(const std::string& word, int count);
+    void erase(const std::string& word);
+    const_iterator find(const std::string& word) const;
+    size_t size() const;
+    bool empty() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    Dict withFrequencies(int low, int high) const;
+    std::vector< Word > mostFrequent(size_t count) const;
+    std::vector< Word > leastFrequent(size_t count) const;
+
+  private:
+    mutable std::vector< Word > words_;
+    mutable std::vector< Word > run_;
+    mutable std::vector< size_t > ranking_;
+    mutable bool ranked_;
+
+    void flush() const;
+    const std::vector< size_t >& ranking() const;
+  };
+
+  Dict intersect(const Dict& lhs, const Dict& rhs);
+}
+
+#endif
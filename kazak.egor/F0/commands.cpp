@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <iterator>
 #include <algorithm>
+#include <numeric>
 
 namespace {
 
@@ -108,20 +109,7 @@ void CommandHandler::handleCommand(const std::string &line)
     std::string prefix;
     iss >> prefix;
     std::vector<std::string> results = dict.listWordsWithPrefix(prefix);
-
-    struct RecursivePrintWord {
-      const std::vector<std::string> &words;
-      std::size_t index;
-      RecursivePrintWord(const std::vector<std::string> &w) : words(w), index(0) {}
-      void print() {
-        if (index >= words.size()) return;
-        std::cout << words[index] << '\n';
-        ++index;
-        print();
-      }
-    };
-    RecursivePrintWord printer(results);
-    printer.print();
+    std::for_each(results.begin(), results.end(), PrintWord());
 
   } else if (cmd == "export") {
     std::string filename;
@@ -149,38 +137,11 @@ void CommandHandler::handleCommand(const std::string &line)
     std::string fragment;
     iss >> fragment;
     std::vector<std::string> results = dict.getWordsByTranslationFragment(fragment);
-
-struct RecursivePrintWord {
-      const std::vector<std::string> &words;
-      std::size_t index;
-      RecursivePrintWord(const std::vector<std::string> &w) : words(w), index(0) {}
-      void print() {
-        if (index >= words.size()) return;
-        std::cout << words[index] << '\n';
-        ++index;
-        print();
-      }
-    };
-    RecursivePrintWord printer(results);
-    printer.print();
+    std::for_each(results.begin(), results.end(), PrintWord());
 
   } else if (cmd == "sort") {
     std::vector<std::pair<std::string, std::string>> all = dict.getAllWords();
-    std::sort(all.begin(), all.end());
-
-    struct RecursivePrintPair {
-      const std::vector<std::pair<std::string, std::string>> &pairs;
-      std::size_t index;
-      RecursivePrintPair(const std::vector<std::pair<std::string, std::string>> &p) : pairs(p), index(0) {}
-      void print() {
-        if (index >= pairs.size()) return;
-        std::cout << pairs[index].first << ": " << pairs[index].second << '\n';
-        ++index;
-        print();
-      }
-    };
-    RecursivePrintPair printer(all);
-    printer.print();
+    std::for_each(all.begin(), all.end(), PrintWordTranslation());
 
   } else if (cmd == "random") {
     std::pair<std::string, std::string> pair = dict.getRandomPair();
@@ -297,28 +258,11 @@ void CommandHandler::printStats(const Dictionary &dict) const
 {
   std::size_t total = dict.getWordCount();
   std::vector<std::pair<std::string, std::string> > all = dict.getAllWords();
-
-  struct LengthSum {
-    std::vector<std::pair<std::string, std::string> >::const_iterator current;
-    std::vector<std::pair<std::string, std::string> >::const_iterator end;
-    std::size_t sum;
-    LengthSum(std::vector<std::pair<std::string, std::string> >::const_iterator b,
-              std::vector<std::pair<std::string, std::string> >::const_iterator e)
-      : current(b), end(e), sum(0) {}
-    void compute() {
-      if (current == end) return;
-      sum += current->second.size();
-      ++current;
-      compute();
-    }
-  };
-
-  LengthSum lengthSum(all.begin(), all.end());
-  lengthSum.compute();
+  std::size_t sum = std::accumulate(all.begin(), all.end(), std::size_t(0), WordLengthSum());
 
   std::cout << "Words: " << total << '\n';
   if (total > 0) {
-    std::cout << "Average translation length: " << lengthSum.sum / total << '\n';
+    std::cout << "Average translation length: " << sum / total << '\n';
   }
 }
 
@@ -332,7 +276,11 @@ void CommandHandler::quiz(const Dictionary &dict, std::size_t count) const
     std::size_t current;
     QuizRunner(const Dictionary &d, std::size_t c) : dict(d), count(c), current(0) {}
     void run() {
-      if (current >= count) return;
+      for (; current < count; ++current) {
+        ask();
+      }
+    }
+    void ask() const {
       std::pair<std::string, std::string> q = dict.getRandomPair();
       std::cout << "Translate: " << q.first << '\n';
       std::string userAnswer;
@@ -342,8 +290,6 @@ void CommandHandler::quiz(const Dictionary &dict, std::size_t count) const
       } else {
         std::cout << "Wrong. Correct: " << q.second << '\n';
       }
-      ++current;
-      run();
     }
   };
 
@@ -369,10 +315,9 @@ void CommandHandler::exportDict(const Dictionary &dict, const std::string &filen
                   std::vector<std::pair<std::string, std::string> >::const_iterator e)
       : outStream(out), current(b), end(e) {}
     void printAll() {
-      if (current == end) return;
-      outStream << current->first << ": " << current->second << '\n';
-      ++current;
-      printAll();
+      for (; current != end; ++current) {
+        outStream << current->first << ": " << current->second << '\n';
+      }
     }
   };
 
@@ -395,14 +340,14 @@ void CommandHandler::importDict(Dictionary &dict, const std::string &filename)
     ImportReader(std::ifstream &in, Dictionary &d) : inStream(in), dictRef(d) {}
     void readAll() {
       std::string line;
-      if (!std::getline(inStream, line)) return;
-      std::size_t pos = line.find(": ");
-      if (pos != std::string::npos) {
-        std::string word = line.substr(0, pos);
-        std::string translation = line.substr(pos + 2);
-        dictRef.addWord(word, translation);
+      while (std::getline(inStream, line)) {
+        std::size_t pos = line.find(": ");
+        if (pos != std::string::npos) {
+          std::string word = line.substr(0, pos);
+          std::string translation = line.substr(pos + 2);
+          dictRef.addWord(word, translation);
+        }
       }
-      readAll();
     }
   };
 
@@ -416,60 +361,7 @@ void CommandHandler::compareDicts(const Dictionary &dict1, const Dictionary &dic
   std::size_t only1 = 0;
   std::size_t only2 = 0;
 
-  std::vector<std::pair<std::string, std::string> > all1 = dict1.getAllWords();
-
-  struct Compare1 {
-    const std::vector<std::pair<std::string, std::string> > &all;
-    std::size_t &sameRef;
-    std::size_t &only1Ref;
-    std::size_t index;
-    const Dictionary &dict2Ref;
-    Compare1(const std::vector<std::pair<std::string, std::string> > &a,
-             std::size_t &s, std::size_t &o1,
-             const Dictionary &d2)
-      : all(a), sameRef(s), only1Ref(o1), index(0), dict2Ref(d2) {}
-    void process() {
-      if (index >= all.size()) return;
-      std::string other;
-      if (dict2Ref.findWord(all[index].first, other)) {
-        if (other == all[index].second) {
-          ++sameRef;
-        }
-      } else {
-        ++only1Ref;
-      }
-      ++index;
-      process();
-    }
-  };
-
-  Compare1 cmp1(all1, same, only1, dict2);
-  cmp1.process();
-
-  std::vector<std::pair<std::string, std::string> > all2 = dict2.getAllWords();
-
-  struct Compare2 {
-    const std::vector<std::pair<std::string, std::string> > &all;
-    std::size_t &only2Ref;
-    std::size_t index;
-    const Dictionary &dict1Ref;
-    Compare2(const std::vector<std::pair<std::string, std::string> > &a,
-             std::size_t &o2,
-             const Dictionary &d1)
-      : all(a), only2Ref(o2), index(0), dict1Ref(d1) {}
-    void process() {
-      if (index >= all.size()) return;
-      std::string other;
-      if (!dict1Ref.findWord(all[index].first, other)) {
-        ++only2Ref;
-      }
-      ++index;
-      process();
-    }
-  };
-
-  Compare2 cmp2(all2, only2, dict1);
-  cmp2.process();
+  dict1.compareWith(dict2, same, only1, only2);
 
   std::cout << "Same: " << same << '\n';
   std::cout << "Only in first: " << only1 << '\n';
@@ -10,116 +10,104 @@ struct PrefixChecker {
   const std::string &prefix;
   PrefixChecker(const std::string &p) : prefix(p) {}
 
-  bool operator()(const std::pair<std::string, std::string> &entry) const {
-    if (entry.first.size() < prefix.size()) return false;
-    return std::equal(prefix.begin(), prefix.end(), entry.first.begin());
-  }
-
   bool operator()(const std::string &word) const {
     if (word.size() < prefix.size()) return false;
     return std::equal(prefix.begin(), prefix.end(), word.begin());
   }
 };
 
-struct GetFirst {
-  const std::string &operator()(const std::pair<std::string, std::string> &p) const {
-    return p.first;
-  }
-};
-
 struct TranslationFragmentChecker {
   const std::string &fragment;
   TranslationFragmentChecker(const std::string &f) : fragment(f) {}
 
-  bool operator()(const std::pair<std::string, std::string> &entry) const {
-    return entry.second.find(fragment) != std::string::npos;
-  }
-
-  bool operator()(const std::string &word) const {
-    return false;
+  bool operator()(const std::string &translation) const {
+    return translation.find(fragment) != std::string::npos;
   }
 };
 
-struct KeyInRangeChecker {
-  const std::string &start;
-  const std::string &end;
-  KeyInRangeChecker(const std::string &s,
-                    const std::string &e): start(s), end(e) {}
-  bool operator()(const std::pair<std::string, std::string> &p) const
-  {
-    return p.first >= start && p.first <= end;
-  }
-};
+}
 
-struct NotInOtherChecker {
-  const Dictionary &other;
-  explicit NotInOtherChecker(const Dictionary &o): other(o) {}
-  bool operator()(const std::pair<std::string, std::string> &p) const
-  {
-    std::string dummy;
-    return !other.findWord(p.first, dummy);
-  }
-};
+bool Dictionary::SlotLess::operator()(const Slot *lhs, const Slot *rhs) const
+{
+  return lhs->first < rhs->first;
+}
 
-struct KeyExistsInOther {
-  const Dictionary &other;
-  explicit KeyExistsInOther(const Dictionary &o): other(o) {}
-  bool operator()(const std::pair<std::string, std::string> &p) const
-  {
-    std::string tmp;
-    return other.findWord(p.first, tmp);
-  }
-};
+bool Dictionary::SlotLess::operator()(const Slot *lhs, const std::string &rhs) const
+{
+  return lhs->first < rhs;
+}
 
-struct KeyExtractor {
-  std::string operator()(const std::pair<std::string, std::string> &p) const
-  {
-    return p.first;
-  }
-};
+bool Dictionary::SlotLess::operator()(const std::string &lhs, const Slot *rhs) const
+{
+  return lhs < rhs->first;
+}
 
-struct SwapPair {
-  std::pair<std::string, std::string> operator()(const std::pair<std::string, std::string> &p) const
-  {
-    return std::make_pair(p.second, p.first);
+Dictionary::Dictionary(const Dictionary &other)
+{
+  slots_.reserve(other.entries_.size());
+  entries_.reserve(other.entries_.size());
+  for (const Entry &entry : other.entries_) {
+    addWord(entry.slot->first, entry.translation);
   }
-};
+}
 
-struct IdentityPair {
-  const std::pair<std::string, std::string> &operator()(const std::pair<std::string, std::string> &p) const
-  {
-    return p;
+Dictionary &Dictionary::operator=(const Dictionary &other)
+{
+  if (this != &other) {
+    Dictionary copy(other);
+    *this = std::move(copy);
   }
-};
+  return *this;
+}
 
+const std::string &Dictionary::translationOf(const Slot *slot) const
+{
+  return entries_[slot->second].translation;
 }
 
 void Dictionary::addWord(const std::string &word,
                          const std::string &translation)
 {
-  data_.insert(std::make_pair(word, translation));
+  std::pair<Slots::iterator, bool> inserted = slots_.insert(std::make_pair(word, entries_.size()));
+  if (!inserted.second) {
+    return;
+  }
+  Slot *slot = &*inserted.first;
+  entries_.push_back(Entry{slot, translation});
+  sorted_.insert(slot);
 }
 
 void Dictionary::removeWord(const std::string &word)
 {
-  data_.erase(word);
+  Slots::iterator it = slots_.find(word);
+  if (it == slots_.end()) {
+    return;
+  }
+  sorted_.erase(&*it);
+  std::size_t pos = it->second;
+  if (pos + 1 != entries_.size()) {
+    entries_[pos] = std::move(entries_.back());
+    entries_[pos].slot->second = pos;
+  }
+  entries_.pop_back();
+  slots_.erase(it);
 }
 
 void Dictionary::editWord(const std::string &word,
                           const std::string &newTranslation)
 {
-  std::unordered_map<std::string, std::string>::iterator it = data_.find(word);
-  if (it != data_.end()) {
-    it->second = newTranslation;
+  Slots::iterator it = slots_.find(word);
+  if (it != slots_.end()) {
+    entries_[it->second].translation = newTranslation;
   }
 }
 
 bool Dictionary::findWord(const std::string &word,
                           std::string &translation) const
 {
-  std::unordered_map<std::string, std::string>::const_iterator it = data_.find(word);
-  if (it != data_.end()) {
-    translation = it->second;
+  Slots::const_iterator it = slots_.find(word);
+  if (it != slots_.end()) {
+    translation = translationOf(&*it);
     return true;
   }
   return false;
@@ -129,132 +117,128 @@ std::vector<std::string> Dictionary::listWordsWithPrefix(const std::string &pref
 {
   std::vector<std::string> result;
   PrefixChecker checker(prefix);
-
-  std::vector<std::pair<std::string, std::string>> allWords = getAllWords();
-
-  result.reserve(allWords.size());
-  std::transform(allWords.begin(), allWords.end(), std::back_inserter(result), GetFirst());
-
-  struct NotPrefixChecker {
-    const PrefixChecker &checker;
-    NotPrefixChecker(const PrefixChecker &c) : checker(c) {}
-    bool operator()(const std::string &word) const {
-      return !checker(word);
-    }
-  };
-
-  result.erase(std::remove_if(result.begin(), result.end(), NotPrefixChecker(checker)), result.end());
-
+  for (auto it = sorted_.lower_bound(prefix); it != sorted_.end() && checker((*it)->first); ++it) {
+    result.push_back((*it)->first);
+  }
   return result;
 }
 
 std::vector<std::pair<std::string, std::string>> Dictionary::getAllWords() const
 {
-  return std::vector<std::pair<std::string, std::string>>(data_.begin(), data_.end());
+  std::vector<std::pair<std::string, std::string>> result;
+  result.reserve(sorted_.size());
+  for (const Slot *slot : sorted_) {
+    result.push_back(std::make_pair(slot->first, translationOf(slot)));
+  }
+  return result;
 }
 
 std::size_t Dictionary::getWordCount() const
 {
-  return data_.size();
+  return entries_.size();
 }
 
 void Dictionary::clear()
 {
-  data_.clear();
-}
-
-const std::unordered_map<std::string, std::string> &Dictionary::getData() const
-{
-  return data_;
+  sorted_.clear();
+  entries_.clear();
+  slots_.clear();
 }
 
 void Dictionary::mergeFrom(const Dictionary &other)
 {
-  std::vector<std::pair<std::string, std::string>> buffer(other.data_.begin(), other.data_.end());
-  std::transform(buffer.begin(), buffer.end(), buffer.begin(), IdentityPair());
-  std::copy(buffer.begin(), buffer.end(),
-            std::inserter(data_, data_.end()));
+  for (const Entry &entry : other.entries_) {
+    addWord(entry.slot->first, entry.translation);
+  }
 }
 
 Dictionary Dictionary::intersectWith(const Dictionary &other) const
 {
   Dictionary result;
-  KeyExistsInOther checker(other);
-  std::vector<std::pair<std::string, std::string>> temp;
-  std::copy_if(data_.begin(), data_.end(), std::back_inserter(temp), checker);
-  std::copy(temp.begin(), temp.end(),
-            std::inserter(result.data_, result.data_.end()));
+  auto it = other.sorted_.begin();
+  for (const Slot *slot : sorted_) {
+    while (it != other.sorted_.end() && (*it)->first < slot->first) {
+      ++it;
+    }
+    if (it != other.sorted_.end() && (*it)->first == slot->first) {
+      result.addWord(slot->first, translationOf(slot));
+    }
+  }
   return result;
 }
 
 Dictionary Dictionary::diffFrom(const Dictionary &other) const
 {
   Dictionary result;
-  NotInOtherChecker checker(other);
-  std::vector<std::pair<std::string, std::string>> temp;
-  std::copy_if(data_.begin(), data_.end(), std::back_inserter(temp), checker);
-  std::copy(temp.begin(), temp.end(),
-            std::inserter(result.data_, result.data_.end()));
+  auto it = other.sorted_.begin();
+  for (const Slot *slot : sorted_) {
+    while (it != other.sorted_.end() && (*it)->first < slot->first) {
+      ++it;
+    }
+    if (it == other.sorted_.end() || (*it)->first != slot->first) {
+      result.addWord(slot->first, translationOf(slot));
+    }
+  }
   return result;
 }
 
 Dictionary Dictionary::extractRange(const std::string &start, const std::string &end) const
 {
   Dictionary result;
-  KeyInRangeChecker checker(start, end);
-  std::vector<std::pair<std::string, std::string>> temp;
-  std::copy_if(data_.begin(), data_.end(), std::back_inserter(temp), checker);
-  std::copy(temp.begin(), temp.end(),
-            std::inserter(result.data_, result.data_.end()));
+  for (auto it = sorted_.lower_bound(start); it != sorted_.end() && (*it)->first <= end; ++it) {
+    result.addWord((*it)->first, translationOf(*it));
+  }
   return result;
 }
 
 std::vector<std::string> Dictionary::getWordsByTranslationFragment(const std::string &fragment) const
 {
-  std::vector<std::pair<std::string, std::string>> allWords = getAllWords();
   TranslationFragmentChecker checker(fragment);
-
-  struct CheckAndKeepFirst {
-    const TranslationFragmentChecker &checker;
-    explicit CheckAndKeepFirst(const TranslationFragmentChecker &chk) : checker(chk) {}
-
-    bool operator()(const std::pair<std::string, std::string> &entry) const {
-      return checker(entry);
-    }
-  };
-
-  struct ExtractFirst {
-    std::string operator()(const std::pair<std::string, std::string> &entry) const {
-      return entry.first;
-    }
-  };
-
-  std::vector<std::pair<std::string, std::string>> filtered;
-  std::copy_if(allWords.begin(), allWords.end(), std::back_inserter(filtered), CheckAndKeepFirst(checker));
-
   std::vector<std::string> result;
-  std::transform(filtered.begin(), filtered.end(), std::back_inserter(result), ExtractFirst());
-
+  for (const Slot *slot : sorted_) {
+    if (checker(translationOf(slot))) {
+      result.push_back(slot->first);
+    }
+  }
   return result;
 }
 
-
 std::pair<std::string, std::string> Dictionary::getRandomPair() const
 {
-  std::vector<std::pair<std::string, std::string>> all = getAllWords();
-  if (all.empty()) {
+  if (entries_.empty()) {
     return std::pair<std::string, std::string>("", "");
   }
-  std::size_t idx = std::rand() % all.size();
-  return all[idx];
+  const Entry &entry = entries_[std::rand() % entries_.size()];
+  return std::make_pair(entry.slot->first, entry.translation);
 }
 
 void Dictionary::swapTranslations()
 {
-  std::vector<std::pair<std::string, std::string>> temp;
-  std::transform(data_.begin(), data_.end(),
-                 std::back_inserter(temp), SwapPair());
-  data_.clear();
-  std::copy(temp.begin(), temp.end(),
-            std::inserter(data_, data_.end()));
+  Dictionary swapped;
+  for (const Slot *slot : sorted_) {
+    swapped.addWord(translationOf(slot), slot->first);
+  }
+  *this = std::move(swapped);
+}
+
+void Dictionary::compareWith(const Dictionary &other, std::size_t &same,
+                             std::size_t &onlyHere, std::size_t &onlyOther) const
+{
+  auto lhs = sorted_.begin();
+  auto rhs = other.sorted_.begin();
+  while (lhs != sorted_.end() || rhs != other.sorted_.end()) {
+    if (rhs == other.sorted_.end() || (lhs != sorted_.end() && (*lhs)->first < (*rhs)->first)) {
+      ++onlyHere;
+      ++lhs;
+    } else if (lhs == sorted_.end() || (*rhs)->first < (*lhs)->first) {
+      ++onlyOther;
+      ++rhs;
+    } else {
+      if (translationOf(*lhs) == other.translationOf(*rhs)) {
+        ++same;
+      }
+      ++lhs;
+      ++rhs;
+    }
+  }
 }
@@ -1,6 +1,7 @@
 #ifndef DICTIONARY_HPP
 #define DICTIONARY_HPP
 
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -9,6 +10,12 @@
 class Dictionary
 {
 public:
+  Dictionary() = default;
+  Dictionary(const Dictionary &other);
+  Dictionary(Dictionary &&other) = default;
+  Dictionary &operator=(const Dictionary &other);
+  Dictionary &operator=(Dictionary &&other) = default;
+
   void addWord(const std::string &word, const std::string &translation);
   void removeWord(const std::string &word);
   void editWord(const std::string &word, const std::string &newTranslation);
@@ -17,7 +24,6 @@ public:
   std::vector<std::pair<std::string, std::string>> getAllWords() const;
   std::size_t getWordCount() const;
   void clear();
-  const std::unordered_map<std::string, std::string> &getData() const;
   void mergeFrom(const Dictionary &other);
   Dictionary intersectWith(const Dictionary &other) const;
   Dictionary diffFrom(const Dictionary &other) const;
@@ -25,9 +31,33 @@ public:
   std::vector<std::string> getWordsByTranslationFragment(const std::string &fragment) const;
   std::pair<std::string, std::string> getRandomPair() const;
   void swapTranslations();
+  void compareWith(const Dictionary &other, std::size_t &same,
+                   std::size_t &onlyHere, std::size_t &onlyOther) const;
 
 private:
-  std::unordered_map<std::string, std::string> data_;
+  // word -> position of its entry in entries_
+  using Slots = std::unordered_map<std::string, std::size_t>;
+  using Slot = Slots::value_type;
+
+  struct SlotLess {
+    using is_transparent = void;
+    bool operator()(const Slot *lhs, const Slot *rhs) const;
+    bool operator()(const Slot *lhs, const std::string &rhs) const;
+    bool operator()(const std::string &lhs, const Slot *rhs) const;
+  };
+
+  struct Entry {
+    Slot *slot;
+    std::string translation;
+  };
+
+  // slot nodes never move, so entries and the sorted view point into them;
+  // entries stay dense for O(1) sampling and swap-with-last removal
+  Slots slots_;
+  std::vector<Entry> entries_;
+  std::set<const Slot *, SlotLess> sorted_;
+
+  const std::string &translationOf(const Slot *slot) const;
 };
 
 #endif
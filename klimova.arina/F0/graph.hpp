@@ -7,9 +7,9 @@
 #include <ostream>
 #include <iostream>
 #include <functional>
-#include <queue>
-#include <numeric>
 #include <algorithm>
+#include <memory>
+#include "graph_snapshot.hpp"
 
 namespace klimova {
   using namespace std::placeholders;
@@ -42,10 +42,11 @@ namespace klimova {
     VertexList vertices;
     VertexMap vertexMap;
     AdjacencyList adjList;
+    mutable std::shared_ptr< const GraphSnapshot > snapshot;
 
-    void dfsUtil(size_t v, VisitedList& visited) const;
-    bool findLongestPathUtil(size_t u, size_t endIdx, VisitedList& visited, Path& path, Path& longestPath) const;
     size_t getVertexIndex(const T& vertex) const;
+    const GraphSnapshot& getSnapshot() const;
+    void invalidate();
   };
 
   template < typename T >
@@ -55,6 +56,7 @@ namespace klimova {
       vertexMap[vertex] = vertices.size();
       vertices.push_back(vertex);
       adjList.emplace_back();
+      invalidate();
     }
   }
 
@@ -68,6 +70,21 @@ namespace klimova {
     return it->second;
   }
 
+  template < typename T >
+  const GraphSnapshot& Graph< T >::getSnapshot() const
+  {
+    if (!snapshot) {
+      snapshot = std::make_shared< const GraphSnapshot >(adjList);
+    }
+    return *snapshot;
+  }
+
+  template < typename T >
+  void Graph< T >::invalidate()
+  {
+    snapshot.reset();
+  }
+
   template < typename T >
   void Graph< T >::addEdge(const T& src, const T& dest)
   {
@@ -76,6 +93,7 @@ namespace klimova {
     if (std::find(adjList[srcIdx].begin(), adjList[srcIdx].end(), destIdx) == adjList[srcIdx].end()) {
       adjList[srcIdx].push_back(destIdx);
       adjList[destIdx].push_back(srcIdx);
+      invalidate();
     }
   }
 
@@ -89,6 +107,7 @@ namespace klimova {
 
     auto& destNeighbors = adjList[destIdx];
     destNeighbors.erase(std::remove(destNeighbors.begin(), destNeighbors.end(), srcIdx), destNeighbors.end());
+    invalidate();
   }
 
   template < typename T >
@@ -103,6 +122,7 @@ namespace klimova {
     vertices.erase(vertices.begin() + idx);
     adjList.erase(adjList.begin() + idx);
     vertexMap.erase(vertex);
+    invalidate();
 
     for (size_t i = 0; i < vertices.size(); ++i) {
       vertexMap[vertices[i]] = i;
@@ -134,24 +154,7 @@ namespace klimova {
   template < typename T >
   bool Graph< T >::checkConnectivity() const
   {
-    if (vertices.empty()) {
-      return true;
-    }
-    std::vector< bool > visited(vertices.size(), false);
-    dfsUtil(0, visited);
-    auto binder = std::bind(std::equal_to< bool >{}, _1, true);
-    return std::all_of(visited.begin(), visited.end(), binder);
-  }
-
-  template < typename T >
-  void Graph< T >::dfsUtil(size_t v, VisitedList& visited) const
-  {
-    visited[v] = true;
-    for (size_t neighbor : adjList[v]) {
-      if (!visited[neighbor]) {
-        dfsUtil(neighbor, visited);
-      }
-    }
+    return getSnapshot().isConnected();
   }
 
   template < typename T >
@@ -163,13 +166,7 @@ namespace klimova {
   template < typename T >
   size_t Graph< T >::countEdges() const
   {
-    struct SumNeighbors {
-      size_t operator()(size_t sum, const std::vector<size_t>& neighbors) const {
-        return sum + neighbors.size();
-      }
-    };
-
-    return std::accumulate(adjList.begin(), adjList.end(), 0, SumNeighbors{}) / 2;
+    return getSnapshot().edgeCount();
   }
 
   template < typename T >
@@ -205,42 +202,15 @@ namespace klimova {
       size_t startIdx = getVertexIndex(startVertex);
       size_t endIdx = getVertexIndex(endVertex);
 
-      VisitedList visited(vertices.size(), false);
-      std::vector< int > parent(vertices.size(), -1);
-      std::queue< size_t > queue;
-
-      visited[startIdx] = true;
-      queue.push(startIdx);
-
-      while (!queue.empty()) {
-        size_t curr = queue.front();
-        queue.pop();
-
-        if (curr == endIdx) {
-          break;
-        }
-        for (size_t neighbor : adjList[curr]) {
-          if (!visited[neighbor]) {
-            visited[neighbor] = true;
-            parent[neighbor] = curr;
-            queue.push(neighbor);
-          }
-        }
-      }
-
-      if (parent[endIdx] == -1 && startIdx != endIdx) {
+      IndexPath path = getSnapshot().shortestPath(startIdx, endIdx);
+      if (path.empty()) {
         std::cout << "Path from " << startVertex << " to " << endVertex << " not found\n";
         return;
       }
 
-      std::vector< T > path;
-      for (int v = endIdx; v != -1; v = parent[v]) {
-        path.push_back(vertices[v]);
-      }
-
       std::cout << "Shortest path from " << startVertex << " to " << endVertex << ": ";
-      for (auto it = path.rbegin(); it != path.rend(); ++it) {
-        std::cout << *it << " ";
+      for (size_t idx : path) {
+        std::cout << vertices[idx] << " ";
       }
       std::cout << std::endl;
     } catch (const std::out_of_range&) {
@@ -254,29 +224,7 @@ namespace klimova {
     vertices.clear();
     vertexMap.clear();
     adjList.clear();
-  }
-
-  template < typename T >
-  bool Graph< T >::findLongestPathUtil(size_t u, size_t endIdx, VisitedList& visited, Path& path, Path& longestPath) const
-  {
-    visited[u] = true;
-    path.push_back(vertices[u]);
-
-    if (u == endIdx) {
-      if (path.size() > longestPath.size()) {
-        longestPath = path;
-      }
-    } else {
-      for (size_t neighbor : adjList[u]) {
-        if (!visited[neighbor]) {
-          findLongestPathUtil(neighbor, endIdx, visited, path, longestPath);
-        }
-      }
-    }
-
-    path.pop_back();
-    visited[u] = false;
-    return !longestPath.empty();
+    invalidate();
   }
 
   template < typename T >
@@ -286,15 +234,16 @@ namespace klimova {
       size_t startIdx = getVertexIndex(startVertex);
       size_t endIdx = getVertexIndex(endVertex);
 
-      VisitedList visited(vertices.size(), false);
-      Path path, longestPath;
-
-      if (findLongestPathUtil(startIdx, endIdx, visited, path, longestPath)) {
+      LongestPath longestPath = getSnapshot().longestPath(startIdx, endIdx, longestPathBudget);
+      if (!longestPath.path.empty()) {
         std::cout << "Longest path from " << startVertex << " to " << endVertex << ": ";
-        for (const auto& vertex : longestPath) {
-          std::cout << vertex << " ";
+        for (size_t idx : longestPath.path) {
+          std::cout << vertices[idx] << " ";
         }
         std::cout << std::endl;
+        if (longestPath.timedOut) {
+          std::cout << "Search timed out: this is the longest path found, not proven optimal." << std::endl;
+        }
       } else {
         std::cout << "Path from " << startVertex << " to " << endVertex << " not found\n";
       }
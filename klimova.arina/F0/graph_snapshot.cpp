@@ -0,0 +1,496 @@
+#include "graph_snapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// biconnected blocks: every simple path between two vertices crosses the same blocks
+// in the same order, entering and leaving each one through fixed vertices
+struct klimova::BlockTree {
+  std::vector< std::vector< size_t > > members;
+  std::vector< size_t > edgeCounts;
+  std::vector< std::vector< size_t > > vertexBlocks;
+};
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+  using Key = unsigned long long;
+  using klimova::IndexPath;
+  const size_t none = static_cast< size_t >(-1);
+
+  struct LocalBlock {
+    std::vector< size_t > vertices;
+    std::vector< size_t > offsets;
+    std::vector< size_t > targets;
+  };
+
+  struct Segment {
+    size_t block;
+    size_t entry;
+    size_t exit;
+  };
+
+  void addBlock(klimova::BlockTree& tree, std::vector< size_t > members, const std::vector< size_t >& offsets,
+      const std::vector< size_t >& targets, std::vector< size_t >& owner)
+  {
+    size_t block = tree.members.size();
+    for (size_t v : members) {
+      owner[v] = block;
+      tree.vertexBlocks[v].push_back(block);
+    }
+    size_t ends = 0;
+    for (size_t v : members) {
+      for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        ends += targets[i] != v && owner[targets[i]] == block;
+      }
+    }
+    tree.edgeCounts.push_back(ends / 2);
+    tree.members.push_back(std::move(members));
+  }
+
+  // Tarjan's articulation point search, iterative so deep graphs do not exhaust the stack
+  std::shared_ptr< klimova::BlockTree > buildBlocks(const std::vector< size_t >& offsets,
+      const std::vector< size_t >& targets)
+  {
+    size_t n = offsets.size() - 1;
+    auto tree = std::make_shared< klimova::BlockTree >();
+    tree->vertexBlocks.resize(n);
+    std::vector< size_t > disc(n, none), low(n, 0), parent(n, none), edge(n, 0), owner(n, none);
+    std::vector< size_t > stack, visit;
+    size_t time = 0;
+    for (size_t root = 0; root < n; ++root) {
+      if (disc[root] != none) {
+        continue;
+      }
+      disc[root] = low[root] = time++;
+      edge[root] = offsets[root];
+      stack.push_back(root);
+      visit.push_back(root);
+      while (!visit.empty()) {
+        size_t v = visit.back();
+        if (edge[v] < offsets[v + 1]) {
+          size_t w = targets[edge[v]++];
+          if (w == v || w == parent[v]) {
+            continue;
+          }
+          if (disc[w] == none) {
+            parent[w] = v;
+            disc[w] = low[w] = time++;
+            edge[w] = offsets[w];
+            stack.push_back(w);
+            visit.push_back(w);
+          } else {
+            low[v] = std::min(low[v], disc[w]);
+          }
+          continue;
+        }
+        visit.pop_back();
+        size_t p = parent[v];
+        if (p == none) {
+          continue;
+        }
+        low[p] = std::min(low[p], low[v]);
+        if (low[v] >= disc[p]) {
+          std::vector< size_t > members;
+          size_t w = none;
+          while (w != v) {
+            w = stack.back();
+            stack.pop_back();
+            members.push_back(w);
+          }
+          members.push_back(p);
+          addBlock(*tree, std::move(members), offsets, targets, owner);
+        }
+      }
+      stack.clear();
+    }
+    return tree;
+  }
+
+  // blocks crossed from start to end, found on the tree linking vertices to their blocks
+  std::vector< Segment > findRoute(const klimova::BlockTree& tree, size_t start, size_t end)
+  {
+    size_t n = tree.vertexBlocks.size();
+    std::vector< size_t > parent(n + tree.members.size(), none);
+    std::vector< size_t > queue{start};
+    parent[start] = start;
+    for (size_t head = 0; head < queue.size() && parent[end] == none; ++head) {
+      size_t node = queue[head];
+      const std::vector< size_t >& next = node < n ? tree.vertexBlocks[node] : tree.members[node - n];
+      for (size_t i : next) {
+        size_t to = node < n ? n + i : i;
+        if (parent[to] == none) {
+          parent[to] = node;
+          queue.push_back(to);
+        }
+      }
+    }
+    std::vector< Segment > route;
+    for (size_t v = end; v != start; v = parent[parent[v]]) {
+      route.push_back({parent[v] - n, parent[parent[v]], v});
+    }
+    std::reverse(route.begin(), route.end());
+    return route;
+  }
+
+  LocalBlock makeLocal(const std::vector< size_t >& members, const std::vector< size_t >& offsets,
+      const std::vector< size_t >& targets, std::vector< size_t >& localIndex)
+  {
+    LocalBlock block;
+    block.vertices = members;
+    for (size_t i = 0; i < members.size(); ++i) {
+      localIndex[members[i]] = i;
+    }
+    block.offsets.push_back(0);
+    for (size_t v : members) {
+      for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        if (targets[i] != v && localIndex[targets[i]] != none) {
+          block.targets.push_back(localIndex[targets[i]]);
+        }
+      }
+      block.offsets.push_back(block.targets.size());
+    }
+    for (size_t v : members) {
+      localIndex[v] = none;
+    }
+    return block;
+  }
+
+  IndexPath walkCycle(const LocalBlock& block, size_t start, size_t end, size_t first)
+  {
+    IndexPath path{start};
+    size_t prev = start;
+    size_t curr = first;
+    while (curr != end) {
+      path.push_back(curr);
+      size_t i = block.offsets[curr];
+      size_t next = block.targets[i] == prev ? block.targets[i + 1] : block.targets[i];
+      prev = curr;
+      curr = next;
+    }
+    path.push_back(end);
+    return path;
+  }
+
+  IndexPath shortestInBlock(const LocalBlock& block, size_t start, size_t end)
+  {
+    std::vector< size_t > parent(block.vertices.size(), none);
+    std::vector< size_t > queue{start};
+    parent[start] = start;
+    for (size_t head = 0; head < queue.size() && parent[end] == none; ++head) {
+      size_t v = queue[head];
+      for (size_t i = block.offsets[v]; i < block.offsets[v + 1]; ++i) {
+        if (parent[block.targets[i]] == none) {
+          parent[block.targets[i]] = v;
+          queue.push_back(block.targets[i]);
+        }
+      }
+    }
+    IndexPath path{end};
+    while (path.back() != start) {
+      path.push_back(parent[path.back()]);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  struct SearchState {
+    const LocalBlock& block;
+    size_t start;
+    size_t end;
+    IndexPath branches;
+    Clock::time_point deadline;
+    std::atomic< Key > bestKey;
+    std::atomic< size_t > nextBranch;
+    std::atomic< bool > expired;
+
+    // longer paths win; among equal lengths the earlier branch does, as a plain dfs would report it
+    Key key(size_t length, size_t branch) const
+    {
+      return static_cast< Key >(length) * (branches.size() + 1) + (branches.size() - branch);
+    }
+  };
+
+  // depth first branch and bound over the branches it takes from the shared counter;
+  // a subtree is cut when the vertices still reachable cannot beat the best path found
+  class BranchSearch {
+  public:
+    explicit BranchSearch(SearchState& state):
+      state(state),
+      visited(state.block.vertices.size(), false),
+      seen(state.block.vertices.size(), 0),
+      epoch(0),
+      steps(0),
+      bestKey(0)
+    {}
+
+    void operator()()
+    {
+      for (size_t b = state.nextBranch++; b < state.branches.size() && !state.expired; b = state.nextBranch++) {
+        search(b);
+      }
+    }
+
+    Key resultKey() const
+    {
+      return bestKey;
+    }
+
+    const IndexPath& resultPath() const
+    {
+      return bestPath;
+    }
+
+  private:
+    SearchState& state;
+    std::vector< bool > visited;
+    std::vector< size_t > seen;
+    size_t epoch;
+    size_t steps;
+    IndexPath path;
+    std::vector< size_t > cursor;
+    Key bestKey;
+    IndexPath bestPath;
+
+    void search(size_t branch)
+    {
+      const LocalBlock& block = state.block;
+      path.push_back(state.start);
+      visited[state.start] = true;
+      if (!enter(state.branches[branch], branch)) {
+        leave();
+      }
+      while (!cursor.empty() && !timeIsUp()) {
+        size_t v = path.back();
+        if (cursor.back() == block.offsets[v + 1]) {
+          cursor.pop_back();
+          leave();
+          continue;
+        }
+        size_t w = block.targets[cursor.back()++];
+        if (!visited[w] && !enter(w, branch)) {
+          leave();
+        }
+      }
+      for (size_t v : path) {
+        visited[v] = false;
+      }
+      path.clear();
+      cursor.clear();
+    }
+
+    bool enter(size_t v, size_t branch)
+    {
+      path.push_back(v);
+      visited[v] = true;
+      if (v == state.end) {
+        record(branch);
+        return false;
+      }
+      size_t reachable = 0;
+      if (!reachEnd(v, reachable) || state.key(path.size() + reachable, branch) <= state.bestKey) {
+        return false;
+      }
+      cursor.push_back(state.block.offsets[v]);
+      return true;
+    }
+
+    void leave()
+    {
+      visited[path.back()] = false;
+      path.pop_back();
+    }
+
+    void record(size_t branch)
+    {
+      Key key = state.key(path.size(), branch);
+      Key best = state.bestKey;
+      while (best < key && !state.bestKey.compare_exchange_weak(best, key)) {}
+      if (key > bestKey) {
+        bestKey = key;
+        bestPath = path;
+      }
+    }
+
+    // counts the unvisited vertices reachable from v and reports whether the end is among them
+    bool reachEnd(size_t v, size_t& count)
+    {
+      const LocalBlock& block = state.block;
+      ++epoch;
+      std::vector< size_t > queue{v};
+      seen[v] = epoch;
+      bool found = false;
+      for (size_t head = 0; head < queue.size(); ++head) {
+        size_t u = queue[head];
+        for (size_t i = block.offsets[u]; i < block.offsets[u + 1]; ++i) {
+          size_t w = block.targets[i];
+          if (!visited[w] && seen[w] != epoch) {
+            seen[w] = epoch;
+            found = found || w == state.end;
+            queue.push_back(w);
+          }
+        }
+      }
+      count = queue.size() - 1;
+      return found;
+    }
+
+    bool timeIsUp()
+    {
+      if (++steps % 1024 == 0 && Clock::now() > state.deadline) {
+        state.expired = true;
+      }
+      return state.expired;
+    }
+  };
+
+  IndexPath searchBlock(const LocalBlock& block, size_t start, size_t end, Clock::time_point deadline,
+      bool& timedOut)
+  {
+    SearchState state{block, start, end, {}, deadline, {0}, {0}, {Clock::now() > deadline}};
+    state.branches.assign(block.targets.begin() + block.offsets[start], block.targets.begin() + block.offsets[start + 1]);
+
+    size_t workers = std::max< size_t >(1, std::min< size_t >(std::thread::hardware_concurrency(), state.branches.size()));
+    std::vector< BranchSearch > searches;
+    searches.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+      searches.emplace_back(state);
+    }
+    std::vector< std::thread > threads;
+    for (size_t i = 1; i < workers; ++i) {
+      threads.emplace_back(std::ref(searches[i]));
+    }
+    searches[0]();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    timedOut = timedOut || state.expired;
+    const BranchSearch* best = &searches[0];
+    for (const BranchSearch& search : searches) {
+      if (search.resultKey() > best->resultKey()) {
+        best = &search;
+      }
+    }
+    return best->resultKey() ? best->resultPath() : shortestInBlock(block, start, end);
+  }
+
+  IndexPath longestInBlock(const LocalBlock& block, size_t edges, size_t start, size_t end,
+      Clock::time_point deadline, bool& timedOut)
+  {
+    size_t size = block.vertices.size();
+    if (size == 2) {
+      return {start, end};
+    }
+    if (edges == size) {
+      IndexPath first = walkCycle(block, start, end, block.targets[block.offsets[start]]);
+      IndexPath second = walkCycle(block, start, end, block.targets[block.offsets[start] + 1]);
+      return second.size() > first.size() ? second : first;
+    }
+    return searchBlock(block, start, end, deadline, timedOut);
+  }
+}
+
+klimova::GraphSnapshot::GraphSnapshot(const std::vector< std::vector< size_t > >& adjacency):
+  offsets{0},
+  targets(),
+  component(adjacency.size(), none),
+  componentCount(0),
+  blocks()
+{
+  for (const auto& neighbors : adjacency) {
+    targets.insert(targets.end(), neighbors.begin(), neighbors.end());
+    offsets.push_back(targets.size());
+  }
+  std::vector< size_t > queue;
+  for (size_t root = 0; root < adjacency.size(); ++root) {
+    if (component[root] != none) {
+      continue;
+    }
+    component[root] = componentCount;
+    queue.assign(1, root);
+    for (size_t head = 0; head < queue.size(); ++head) {
+      size_t v = queue[head];
+      for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+        if (component[targets[i]] == none) {
+          component[targets[i]] = componentCount;
+          queue.push_back(targets[i]);
+        }
+      }
+    }
+    ++componentCount;
+  }
+}
+
+size_t klimova::GraphSnapshot::edgeCount() const
+{
+  return targets.size() / 2;
+}
+
+bool klimova::GraphSnapshot::isConnected() const
+{
+  return componentCount <= 1;
+}
+
+bool klimova::GraphSnapshot::sameComponent(size_t a, size_t b) const
+{
+  return component[a] == component[b];
+}
+
+klimova::IndexPath klimova::GraphSnapshot::shortestPath(size_t start, size_t end) const
+{
+  if (!sameComponent(start, end)) {
+    return {};
+  }
+  std::vector< size_t > parent(component.size(), none);
+  std::vector< size_t > queue{start};
+  parent[start] = start;
+  for (size_t head = 0; head < queue.size() && queue[head] != end; ++head) {
+    size_t v = queue[head];
+    for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+      if (parent[targets[i]] == none) {
+        parent[targets[i]] = v;
+        queue.push_back(targets[i]);
+      }
+    }
+  }
+  IndexPath path{end};
+  while (path.back() != start) {
+    path.push_back(parent[path.back()]);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+klimova::LongestPath klimova::GraphSnapshot::longestPath(size_t start, size_t end,
+    std::chrono::milliseconds budget) const
+{
+  if (start == end) {
+    return {{start}, false};
+  }
+  if (!sameComponent(start, end)) {
+    return {{}, false};
+  }
+  const BlockTree& tree = getBlocks();
+  Clock::time_point deadline = Clock::now() + budget;
+  std::vector< size_t > localIndex(component.size(), none);
+  LongestPath result{{start}, false};
+  for (const Segment& segment : findRoute(tree, start, end)) {
+    const std::vector< size_t >& members = tree.members[segment.block];
+    LocalBlock block = makeLocal(members, offsets, targets, localIndex);
+    size_t entry = std::find(members.begin(), members.end(), segment.entry) - members.begin();
+    size_t exit = std::find(members.begin(), members.end(), segment.exit) - members.begin();
+    IndexPath part = longestInBlock(block, tree.edgeCounts[segment.block], entry, exit, deadline, result.timedOut);
+    for (auto it = std::next(part.begin()); it != part.end(); ++it) {
+      result.path.push_back(block.vertices[*it]);
+    }
+  }
+  return result;
+}
+
+const klimova::BlockTree& klimova::GraphSnapshot::getBlocks() const
+{
+  if (!blocks) {
+    blocks = buildBlocks(offsets, targets);
+  }
+  return *blocks;
+}
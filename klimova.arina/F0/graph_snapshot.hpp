@@ -0,0 +1,44 @@
+#ifndef GRAPH_SNAPSHOT_HPP
+#define GRAPH_SNAPSHOT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace klimova {
+  using IndexPath = std::vector< size_t >;
+
+  const std::chrono::milliseconds longestPathBudget(2000);
+
+  // a search cut off by its budget reports the longest path it found by then
+  struct LongestPath {
+    IndexPath path;
+    bool timedOut;
+  };
+
+  struct BlockTree;
+
+  // compressed copy of the adjacency lists; a graph keeps one until it is changed
+  class GraphSnapshot {
+  public:
+    explicit GraphSnapshot(const std::vector< std::vector< size_t > >& adjacency);
+
+    size_t edgeCount() const;
+    bool isConnected() const;
+    bool sameComponent(size_t a, size_t b) const;
+    IndexPath shortestPath(size_t start, size_t end) const;
+    LongestPath longestPath(size_t start, size_t end, std::chrono::milliseconds budget) const;
+
+  private:
+    std::vector< size_t > offsets;
+    std::vector< size_t > targets;
+    std::vector< size_t > component;
+    size_t componentCount;
+    mutable std::shared_ptr< const BlockTree > blocks;
+
+    const BlockTree& getBlocks() const;
+  };
+}
+
+#endif
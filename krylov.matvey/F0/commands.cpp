@@ -70,23 +70,15 @@ void krylov::CommandProcessor::createIndex(const std::string& indexName, const s
 
   IndexDocument newIndex;
   newIndex.sourceFile = filename;
-
-  std::string line;
-  while (std::getline(file, line))
-  {
-    newIndex.lines.push_back(line);
-  }
+  newIndex.lines = readLines(file);
 
   if (newIndex.lines.empty())
   {
     throw std::invalid_argument("Invalid command");
   }
 
-  std::vector< size_t > lineNumbers(newIndex.lines.size());
-  std::iota(lineNumbers.begin(), lineNumbers.end(), 0);
-
-  SplitWords processor{ newIndex.lines, newIndex.index };
-  std::transform(lineNumbers.begin(), lineNumbers.end(), lineNumbers.begin(), processor);
+  newIndex.index = buildIndex(newIndex.lines);
+  newIndex.linesIndexed = true;
 
   indexes_[indexName] = std::move(newIndex);
   out_ << "Index " << indexName << " created successfully" << '\n';
@@ -112,9 +104,10 @@ void krylov::CommandProcessor::printIndex(const std::string& indexName)
     throw std::invalid_argument("Invalid command");
   }
 
-  const IndexDocument& index = it->second;
+  const PostingIndex& index = it->second.index;
 
-  std::transform(index.index.begin(), index.index.end(), std::ostream_iterator< WordEntry >(out_, "\n"), pairToWordEntry);
+  std::transform(index.terms().begin(), index.terms().end(), index.postingLists().begin(),
+    std::ostream_iterator< WordEntry >(out_, "\n"), termToWordEntry);
 }
 
 void krylov::CommandProcessor::deleteIndex(const std::string& indexName)
@@ -151,10 +144,9 @@ void krylov::CommandProcessor::mergeIndexes(const std::string& index1, const std
 
   IndexDocument result;
 
-  std::copy(it1->second.index.begin(), it1->second.index.end(), std::inserter(result.index, result.index.end()));
-
   size_t offset = it1->second.lines.size();
-  std::for_each(it2->second.index.begin(), it2->second.index.end(), MergeWithOffset{ result, offset });
+  result.index = uniteIndexes(it1->second.index, it2->second.index, offset);
+  result.linesIndexed = it1->second.linesIndexed && it2->second.linesIndexed;
 
   std::vector< std::string >& lines1 = it1->second.lines;
   std::vector< std::string >& lines2 = it2->second.lines;
@@ -174,20 +166,27 @@ void krylov::CommandProcessor::zipTexts(const std::string& index1, const std::st
     throw std::invalid_argument("Invalid command");
   }
 
-  const auto& lines1 = indexes_.at(index1).lines;
-  const auto& lines2 = indexes_.at(index2).lines;
+  const IndexDocument& doc1 = indexes_.at(index1);
+  const IndexDocument& doc2 = indexes_.at(index2);
+  const auto& lines1 = doc1.lines;
+  const auto& lines2 = doc2.lines;
   size_t maxSize = std::max(lines1.size(), lines2.size());
 
   std::vector< std::string > mergedLines(maxSize);
   std::generate(mergedLines.begin(), mergedLines.end(), MergeLinesFunctor{ lines1, lines2, 0 });
 
   IndexDocument resultIndex;
-  resultIndex.lines = mergedLines;
-
-  std::vector< size_t > lineNumbers(maxSize);
-  std::iota(lineNumbers.begin(), lineNumbers.end(), 1);
+  resultIndex.lines = std::move(mergedLines);
+  resultIndex.linesIndexed = true;
 
-  std::transform(lineNumbers.begin(), lineNumbers.end(), lineNumbers.begin(), SplitAndAdd{ resultIndex, resultIndex.lines });
+  if (doc1.linesIndexed && doc2.linesIndexed)
+  {
+    resultIndex.index = uniteIndexes(doc1.index, doc2.index, 0);
+  }
+  else
+  {
+    resultIndex.index = buildIndex(resultIndex.lines);
+  }
 
   indexes_[newIndex] = std::move(resultIndex);
   out_ << "Index " << newIndex << " created by merging lines" << '\n';
@@ -202,11 +201,7 @@ void krylov::CommandProcessor::intersectIndexes(const std::string& index1, const
     throw std::invalid_argument("Invalid command");
   }
   IndexDocument result;
-  const auto& idx1 = it1->second.index;
-  const auto& idx2 = it2->second.index;
-  std::vector<IndexDictionary::value_type> tempResult;
-  std::copy_if(idx1.begin(), idx1.end(), std::back_inserter(tempResult), IsInSecondIndex{ idx2 });
-  std::transform(tempResult.begin(), tempResult.end(), std::inserter(result.index, result.index.begin()), MergeEntries{idx2});
+  result.index = commonTerms(it1->second.index, it2->second.index);
   indexes_[newIndex] = std::move(result);
   out_ << "Index " << newIndex << " created by intersection" << '\n';
 }
@@ -225,10 +220,9 @@ void krylov::CommandProcessor::weaveTexts(const std::string& index1, const std::
   WeaveLinesGenerator generator(lines1, lines2);
   std::generate_n(std::back_inserter(newText), totalSize, generator);
   IndexDocument resultIndex;
-  resultIndex.lines = newText;
-  std::vector< size_t > lineNumbers(newText.size());
-  std::iota(lineNumbers.begin(), lineNumbers.end(), 1);
-  std::transform(lineNumbers.begin(), lineNumbers.end(), lineNumbers.begin(), SplitAndAdd{ resultIndex, resultIndex.lines });
+  resultIndex.lines = std::move(newText);
+  resultIndex.index = buildIndex(resultIndex.lines);
+  resultIndex.linesIndexed = true;
   indexes_[newIndex] = std::move(resultIndex);
   out_ << "Index " << newIndex << " created by weaving" << '\n';
 }
@@ -242,9 +236,7 @@ void krylov::CommandProcessor::diffIndexes(const std::string& index1, const std:
     throw std::invalid_argument("Invalid command");
   }
   IndexDocument result;
-  const auto& idx1 = it1->second.index;
-  const auto& idx2 = it2->second.index;
-  std::copy_if(idx1.begin(), idx1.end(), std::inserter(result.index, result.index.begin()), IsNotInSecondIndex{ idx2 });
+  result.index = missingTerms(it1->second.index, it2->second.index);
   indexes_[newIndex] = std::move(result);
   out_ << "Index " << newIndex << " created by difference" << '\n';
 }
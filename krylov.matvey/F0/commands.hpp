@@ -43,36 +43,6 @@ namespace krylov
     void deleteIndexCmd(const std::vector< std::string >& args);
   };
 
-  struct IsInSecondIndex
-  {
-    const krylov::IndexDictionary& idx2;
-    bool operator()(const krylov::IndexDictionary::value_type& entry) const
-    {
-      return idx2.find(entry.first) != idx2.end();
-    }
-  };
-
-  struct MergeEntries
-  {
-    const krylov::IndexDictionary& idx2;
-    krylov::IndexDictionary::value_type operator()(const krylov::IndexDictionary::value_type& entry) const
-    {
-      std::set< size_t > merged;
-      std::set_union(entry.second.begin(), entry.second.end(), idx2.at(entry.first).begin(),
-        idx2.at(entry.first).end(), std::inserter(merged, merged.begin()));
-      return std::make_pair(entry.first, merged);
-    }
-  };
-
-  struct IsNotInSecondIndex
-  {
-    const krylov::IndexDictionary& idx2;
-    bool operator()(const krylov::IndexDictionary::value_type& entry) const
-    {
-      return idx2.find(entry.first) == idx2.end();
-    }
-  };
-
   struct WeaveLinesGenerator
   {
     const std::vector< std::string >& lines1;
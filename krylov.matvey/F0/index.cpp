@@ -5,27 +5,19 @@
 #include <iterator>
 #include <algorithm>
 
-krylov::WordEntry::WordEntry(const std::pair< const std::string, std::set< size_t > >& p):
-  word(p.first), lines(p.second)
+krylov::WordEntry::WordEntry(const std::string& word_, const Postings& lines_):
+  word(word_), lines(lines_)
 {}
 
-std::ostream& krylov::operator<<(std::ostream& out, const std::set< size_t >& s)
+std::ostream& krylov::operator<<(std::ostream& out, const Postings& s)
 {
   if (s.empty())
   {
     return out;
   }
 
-  auto it = s.begin();
-  out << *it;
-  ++it;
-
-  if (it != s.end())
-  {
-    out << " ";
-    std::copy(it, std::prev(s.end()), std::ostream_iterator< size_t >(out, " "));
-    out << *std::prev(s.end());
-  }
+  std::copy_n(s.begin(), s.size() - 1, std::ostream_iterator< size_t >(out, " "));
+  out << s.back();
 
   return out;
 }
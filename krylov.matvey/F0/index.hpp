@@ -5,25 +5,26 @@
 #include <set>
 #include <string>
 #include <vector>
+#include "postings.hpp"
 
 namespace krylov
 {
-  using IndexDictionary = std::map< std::string, std::set< std::size_t > >;
-
   struct WordEntry
   {
     const std::string& word;
-    const std::set< size_t >& lines;
-    WordEntry(const std::pair< const std::string, std::set< size_t > >& p);
+    const Postings& lines;
+    WordEntry(const std::string& word_, const Postings& lines_);
   };
-  std::ostream& operator<<(std::ostream& out, const std::set< size_t >& s);
+  std::ostream& operator<<(std::ostream& out, const Postings& s);
   std::ostream& operator<<(std::ostream& out, const WordEntry& entry);
 
   struct IndexDocument
   {
-    IndexDictionary index;
+    PostingIndex index;
     std::vector< std::string > lines;
     std::string sourceFile;
+    // intersect and diff keep words without their text, so only these indexes can be zipped by postings
+    bool linesIndexed = false;
   };
   std::istream& operator>>(std::istream& in, std::vector< std::string >& args);
 
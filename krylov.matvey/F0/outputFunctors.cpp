@@ -44,23 +44,9 @@ std::string krylov::formatIndexEntry(const std::pair< const std::string, IndexDo
   return result;
 }
 
-std::size_t krylov::AddOffset::operator()(std::size_t val) const
+krylov::WordEntry krylov::termToWordEntry(const std::string& term, const Postings& lines)
 {
-  return val + offset;
-}
-
-void krylov::MergeWithOffset::operator()(const std::pair< const std::string, std::set< std::size_t > >& pair) const
-{
-  std::set< std::size_t > adjusted;
-  std::transform(pair.second.begin(), pair.second.end(), std::inserter(adjusted, adjusted.end()), AddOffset{ offset });
-
-  auto& target = dest.index[pair.first];
-  target.insert(adjusted.begin(), adjusted.end());
-}
-
-krylov::WordEntry krylov::pairToWordEntry(const IndexDictionary::value_type& p)
-{
-  return WordEntry(p);
+  return WordEntry(term, lines);
 }
 
 std::string krylov::showEntryToString(const std::pair< std::string, std::size_t >& p)
@@ -20,20 +20,7 @@ namespace krylov
 
   std::string formatIndexEntry(const std::pair< const std::string, IndexDocument >& pair);
 
-  struct AddOffset
-  {
-    std::size_t offset;
-    std::size_t operator()(std::size_t val) const;
-  };
-
-  struct MergeWithOffset
-  {
-    IndexDocument& dest;
-    std::size_t offset;
-    void operator()(const std::pair<const std::string, std::set< std::size_t > >& pair) const;
-  };
-
-  WordEntry pairToWordEntry(const IndexDictionary::value_type& p);
+  WordEntry termToWordEntry(const std::string& term, const Postings& lines);
 
   std::string showEntryToString(const std::pair< std::string, std::size_t >& p);
 }
@@ -0,0 +1,372 @@
+#include "postings.hpp"
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <numeric>
+#include <thread>
+#include "splitFunctors.hpp"
+
+namespace
+{
+  const std::size_t readBlockSize = 1 << 20;
+  const std::size_t minLinesPerWorker = 1 << 14;
+
+  struct TermLess
+  {
+    const std::vector< const std::string* >& names;
+    bool operator()(std::size_t lhs, std::size_t rhs) const
+    {
+      return *names[lhs] < *names[rhs];
+    }
+  };
+
+  // first position at or after from holding a term not less than key, probing 1, 2, 4... ahead
+  std::size_t gallop(const std::vector< std::string >& terms, std::size_t from, const std::string& key)
+  {
+    std::size_t step = 1;
+    std::size_t hi = from;
+    while (hi < terms.size() && terms[hi] < key)
+    {
+      from = hi + 1;
+      hi += step;
+      step *= 2;
+    }
+    auto last = terms.begin() + std::min(hi, terms.size());
+    return std::lower_bound(terms.begin() + from, last, key) - terms.begin();
+  }
+
+  struct AddOffset
+  {
+    std::size_t offset;
+    std::size_t operator()(std::size_t line) const
+    {
+      return line + offset;
+    }
+  };
+
+  struct TermAdder
+  {
+    krylov::PostingIndex& index;
+    const std::vector< const std::string* >& names;
+    const std::vector< krylov::Postings >& postings;
+    void operator()(std::size_t id) const
+    {
+      index.add(*names[id], postings[id]);
+    }
+  };
+
+  struct BuildRange
+  {
+    const std::vector< std::string >& lines;
+    krylov::IndexBuilder& builder;
+    std::size_t first;
+    std::size_t last;
+    void operator()() const
+    {
+      for (std::size_t i = first; i < last; ++i)
+      {
+        builder.addLine(lines[i], i + 1);
+      }
+    }
+  };
+}
+
+krylov::Postings::ConstIterator::ConstIterator(const unsigned char* pos, const unsigned char* end):
+  pos_(pos), next_(pos), end_(end), value_(0)
+{
+  decode();
+}
+
+void krylov::Postings::ConstIterator::decode()
+{
+  if (pos_ == end_)
+  {
+    return;
+  }
+  std::size_t delta = 0;
+  int shift = 0;
+  next_ = pos_;
+  while (*next_ & 0x80)
+  {
+    delta |= static_cast< std::size_t >(*next_++ & 0x7F) << shift;
+    shift += 7;
+  }
+  delta |= static_cast< std::size_t >(*next_++) << shift;
+  value_ += delta;
+}
+
+krylov::Postings::ConstIterator::reference krylov::Postings::ConstIterator::operator*() const
+{
+  return value_;
+}
+
+krylov::Postings::ConstIterator& krylov::Postings::ConstIterator::operator++()
+{
+  pos_ = next_;
+  decode();
+  return *this;
+}
+
+krylov::Postings::ConstIterator krylov::Postings::ConstIterator::operator++(int)
+{
+  ConstIterator old(*this);
+  ++(*this);
+  return old;
+}
+
+bool krylov::Postings::ConstIterator::operator==(const ConstIterator& rhs) const
+{
+  return pos_ == rhs.pos_;
+}
+
+bool krylov::Postings::ConstIterator::operator!=(const ConstIterator& rhs) const
+{
+  return !(*this == rhs);
+}
+
+krylov::Postings::Postings():
+  bytes_(), size_(0), last_(0)
+{}
+
+void krylov::Postings::push_back(std::size_t line)
+{
+  if (size_ && line <= last_)
+  {
+    return;
+  }
+  std::size_t delta = line - last_;
+  while (delta >= 0x80)
+  {
+    bytes_.push_back(static_cast< unsigned char >(delta | 0x80));
+    delta >>= 7;
+  }
+  bytes_.push_back(static_cast< unsigned char >(delta));
+  last_ = line;
+  ++size_;
+}
+
+std::size_t krylov::Postings::size() const
+{
+  return size_;
+}
+
+bool krylov::Postings::empty() const
+{
+  return size_ == 0;
+}
+
+std::size_t krylov::Postings::back() const
+{
+  return last_;
+}
+
+krylov::Postings::ConstIterator krylov::Postings::begin() const
+{
+  return ConstIterator(bytes_.data(), bytes_.data() + bytes_.size());
+}
+
+krylov::Postings::ConstIterator krylov::Postings::end() const
+{
+  return ConstIterator(bytes_.data() + bytes_.size(), bytes_.data() + bytes_.size());
+}
+
+krylov::Postings krylov::unitePostings(const Postings& lhs, const Postings& rhs, std::size_t rhsOffset)
+{
+  std::vector< std::size_t > shifted;
+  shifted.reserve(rhs.size());
+  std::transform(rhs.begin(), rhs.end(), std::back_inserter(shifted), AddOffset{ rhsOffset });
+  Postings result;
+  std::set_union(lhs.begin(), lhs.end(), shifted.begin(), shifted.end(), std::back_inserter(result));
+  return result;
+}
+
+std::size_t krylov::PostingIndex::size() const
+{
+  return terms_.size();
+}
+
+bool krylov::PostingIndex::empty() const
+{
+  return terms_.empty();
+}
+
+const std::vector< std::string >& krylov::PostingIndex::terms() const
+{
+  return terms_;
+}
+
+const krylov::Postings& krylov::PostingIndex::postings(std::size_t i) const
+{
+  return postings_[i];
+}
+
+const std::vector< krylov::Postings >& krylov::PostingIndex::postingLists() const
+{
+  return postings_;
+}
+
+const krylov::Postings* krylov::PostingIndex::find(const std::string& word) const
+{
+  auto it = std::lower_bound(terms_.begin(), terms_.end(), word);
+  if (it == terms_.end() || *it != word)
+  {
+    return nullptr;
+  }
+  return &postings_[it - terms_.begin()];
+}
+
+void krylov::PostingIndex::add(std::string term, Postings postings)
+{
+  terms_.push_back(std::move(term));
+  postings_.push_back(std::move(postings));
+}
+
+krylov::PostingIndex krylov::uniteIndexes(const PostingIndex& lhs, const PostingIndex& rhs, std::size_t rhsOffset)
+{
+  PostingIndex result;
+  const Postings none;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < lhs.size() || j < rhs.size())
+  {
+    if (j == rhs.size() || (i < lhs.size() && lhs.terms()[i] < rhs.terms()[j]))
+    {
+      result.add(lhs.terms()[i], lhs.postings(i));
+      ++i;
+    }
+    else if (i == lhs.size() || rhs.terms()[j] < lhs.terms()[i])
+    {
+      result.add(rhs.terms()[j], unitePostings(none, rhs.postings(j), rhsOffset));
+      ++j;
+    }
+    else
+    {
+      result.add(lhs.terms()[i], unitePostings(lhs.postings(i), rhs.postings(j), rhsOffset));
+      ++i;
+      ++j;
+    }
+  }
+  return result;
+}
+
+krylov::PostingIndex krylov::commonTerms(const PostingIndex& lhs, const PostingIndex& rhs)
+{
+  bool lhsSmaller = lhs.size() <= rhs.size();
+  const PostingIndex& small = lhsSmaller ? lhs : rhs;
+  const PostingIndex& large = lhsSmaller ? rhs : lhs;
+  PostingIndex result;
+  std::size_t pos = 0;
+  for (std::size_t i = 0; i < small.size() && pos < large.size(); ++i)
+  {
+    pos = gallop(large.terms(), pos, small.terms()[i]);
+    if (pos < large.size() && large.terms()[pos] == small.terms()[i])
+    {
+      result.add(small.terms()[i], unitePostings(small.postings(i), large.postings(pos), 0));
+    }
+  }
+  return result;
+}
+
+krylov::PostingIndex krylov::missingTerms(const PostingIndex& lhs, const PostingIndex& rhs)
+{
+  PostingIndex result;
+  std::size_t pos = 0;
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+  {
+    pos = gallop(rhs.terms(), pos, lhs.terms()[i]);
+    if (pos == rhs.size() || rhs.terms()[pos] != lhs.terms()[i])
+    {
+      result.add(lhs.terms()[i], lhs.postings(i));
+    }
+  }
+  return result;
+}
+
+krylov::Postings& krylov::IndexBuilder::postingsFor(const std::string& word)
+{
+  auto inserted = ids_.emplace(word, postings_.size());
+  if (inserted.second)
+  {
+    names_.push_back(&inserted.first->first);
+    postings_.emplace_back();
+  }
+  return postings_[inserted.first->second];
+}
+
+void krylov::IndexBuilder::addLine(const std::string& line, std::size_t lineNumber)
+{
+  auto cur = std::find_if(line.begin(), line.end(), notSpace);
+  while (cur != line.end())
+  {
+    auto wordEnd = std::find_if(cur, line.end(), isSpace);
+    word_.assign(cur, wordEnd);
+    postingsFor(word_).push_back(lineNumber);
+    cur = std::find_if(wordEnd, line.end(), notSpace);
+  }
+}
+
+void krylov::IndexBuilder::append(const IndexBuilder& later)
+{
+  for (std::size_t i = 0; i < later.names_.size(); ++i)
+  {
+    Postings& target = postingsFor(*later.names_[i]);
+    std::copy(later.postings_[i].begin(), later.postings_[i].end(), std::back_inserter(target));
+  }
+}
+
+krylov::PostingIndex krylov::IndexBuilder::finish() const
+{
+  std::vector< std::size_t > order(names_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), TermLess{ names_ });
+  PostingIndex result;
+  std::for_each(order.begin(), order.end(), TermAdder{ result, names_, postings_ });
+  return result;
+}
+
+std::vector< std::string > krylov::readLines(std::istream& in)
+{
+  std::vector< std::string > lines;
+  std::vector< char > block(readBlockSize);
+  std::string partial;
+  while (in)
+  {
+    in.read(block.data(), block.size());
+    const char* cur = block.data();
+    const char* end = cur + in.gcount();
+    const char* newline = std::find(cur, end, '\n');
+    while (newline != end)
+    {
+      partial.append(cur, newline);
+      lines.push_back(std::move(partial));
+      partial.clear();
+      cur = newline + 1;
+      newline = std::find(cur, end, '\n');
+    }
+    partial.append(cur, end);
+  }
+  if (!partial.empty())
+  {
+    lines.push_back(std::move(partial));
+  }
+  return lines;
+}
+
+krylov::PostingIndex krylov::buildIndex(const std::vector< std::string >& lines)
+{
+  std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t workers = std::max< std::size_t >(1, std::min(hardware, lines.size() / minLinesPerWorker));
+  std::vector< IndexBuilder > builders(workers);
+  std::vector< std::thread > threads;
+  std::size_t step = (lines.size() + workers - 1) / workers;
+  for (std::size_t k = 1; k < workers; ++k)
+  {
+    threads.emplace_back(BuildRange{ lines, builders[k], std::min(k * step, lines.size()),
+      std::min((k + 1) * step, lines.size()) });
+  }
+  BuildRange{ lines, builders[0], 0, std::min(step, lines.size()) }();
+  std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+  std::for_each(std::next(builders.begin()), builders.end(), std::bind(&IndexBuilder::append, &builders[0],
+    std::placeholders::_1));
+  return builders[0].finish();
+}
@@ -0,0 +1,103 @@
+#ifndef POSTINGS_HPP
+#define POSTINGS_HPP
+
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace krylov
+{
+  // ascending line numbers stored as varint deltas, usually one byte per line
+  class Postings
+  {
+  public:
+    using value_type = std::size_t;
+
+    class ConstIterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const std::size_t*;
+      using reference = const std::size_t&;
+
+      ConstIterator(const unsigned char* pos, const unsigned char* end);
+      reference operator*() const;
+      ConstIterator& operator++();
+      ConstIterator operator++(int);
+      bool operator==(const ConstIterator& rhs) const;
+      bool operator!=(const ConstIterator& rhs) const;
+
+    private:
+      const unsigned char* pos_;
+      const unsigned char* next_;
+      const unsigned char* end_;
+      std::size_t value_;
+
+      void decode();
+    };
+
+    Postings();
+
+    void push_back(std::size_t line);
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t back() const;
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+  private:
+    std::vector< unsigned char > bytes_;
+    std::size_t size_;
+    std::size_t last_;
+  };
+
+  Postings unitePostings(const Postings& lhs, const Postings& rhs, std::size_t rhsOffset);
+
+  // terms kept sorted next to their postings
+  class PostingIndex
+  {
+  public:
+    std::size_t size() const;
+    bool empty() const;
+    const std::vector< std::string >& terms() const;
+    const Postings& postings(std::size_t i) const;
+    const std::vector< Postings >& postingLists() const;
+    const Postings* find(const std::string& word) const;
+    void add(std::string term, Postings postings);
+
+  private:
+    std::vector< std::string > terms_;
+    std::vector< Postings > postings_;
+  };
+
+  PostingIndex uniteIndexes(const PostingIndex& lhs, const PostingIndex& rhs, std::size_t rhsOffset);
+  PostingIndex commonTerms(const PostingIndex& lhs, const PostingIndex& rhs);
+  PostingIndex missingTerms(const PostingIndex& lhs, const PostingIndex& rhs);
+
+  // interns the words of consecutive lines; partial builders over later lines are appended in order
+  class IndexBuilder
+  {
+  public:
+    void addLine(const std::string& line, std::size_t lineNumber);
+    void append(const IndexBuilder& later);
+    PostingIndex finish() const;
+
+  private:
+    std::unordered_map< std::string, std::size_t > ids_;
+    std::vector< const std::string* > names_;
+    std::vector< Postings > postings_;
+    std::string word_;
+
+    Postings& postingsFor(const std::string& word);
+  };
+
+  std::vector< std::string > readLines(std::istream& in);
+  PostingIndex buildIndex(const std::vector< std::string >& lines);
+}
+
+#endif
@@ -2,31 +2,11 @@
 #include <algorithm>
 #include <iterator>
 
-std::string krylov::LineSplitter::operator()(const std::string& word) const
-{
-  wordMap[word].insert(lineNumber);
-  return word;
-}
-
 std::size_t krylov::countWords(const std::string& line)
 {
   return std::count_if(line.begin(), line.end(), WordCounter{});
 }
 
-std::size_t krylov::SplitWords::operator()(std::size_t lineNumber) const
-{
-  const std::string& line = lines.at(lineNumber);
-
-  std::vector< std::string > words;
-  std::size_t wordCount = countWords(line);
-  WordGenerator gen{ line.begin(), line.end() };
-  std::generate_n(std::back_inserter(words),wordCount, gen);
-
-  std::transform(words.begin(), words.end(), words.begin(), LineSplitter{ wordMap, lineNumber + 1 });
-
-  return lineNumber;
-}
-
 bool krylov::isSpace(unsigned char ch)
 {
   return std::isspace(ch);
@@ -61,16 +41,3 @@ std::string krylov::WordGenerator::operator()()
   cur = wordEnd;
   return word;
 }
-
-std::size_t krylov::SplitAndAdd::operator()(std::size_t lineNum) const
-{
-  const std::string& line = lines[lineNum - 1];
-
-  std::vector< std::string > words;
-  std::size_t wordCount = countWords(line);
-  WordGenerator gen{ line.begin(), line.end() };
-  std::generate_n(std::back_inserter(words), wordCount, gen);
-
-  std::transform(words.begin(), words.end(), words.begin(), LineSplitter{ idx.index, lineNum });
-  return lineNum;
-}
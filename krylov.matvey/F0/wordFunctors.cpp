@@ -14,15 +14,15 @@ krylov::FindWord::FindWord(
 
 void krylov::FindWord::operator()() const
 {
-  auto it = index.index.find(word);
+  const Postings* lines = index.index.find(word);
 
-  if (it == index.index.end())
+  if (!lines)
   {
     out << "<NOT FOUND>\n";
     return;
   }
 
-  WordEntry entry(*it);
+  WordEntry entry(word, *lines);
   out << entry << '\n';
 }
 
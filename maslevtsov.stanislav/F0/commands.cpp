@@ -6,13 +6,13 @@
 #include <functional>
 #include <iterator>
 #include "graph.hpp"
+#include "compact_graph.hpp"
 
 namespace {
   using distances_t = std::unordered_map< unsigned, size_t >;
   using parents_t = std::unordered_map< unsigned, unsigned >;
   using nodes_queue_t = std::queue< unsigned >;
   using node_neighbour_pair_t = std::pair< const unsigned, std::vector< unsigned > >;
-  using node_distance_pair_t = std::pair< const unsigned, size_t >;
 
   struct PathProcessor
   {
@@ -62,20 +62,6 @@ namespace {
     parents = std::move(parents_result);
   }
 
-  bool compare_distances(const node_distance_pair_t& left, const node_distance_pair_t& right)
-  {
-    return left.second < right.second;
-  }
-
-  size_t get_max_distance(const maslevtsov::Graph& graph, const node_neighbour_pair_t& node_neighbour_pair)
-  {
-    distances_t distances;
-    parents_t parents;
-    get_bfs_from(graph, node_neighbour_pair.first, distances, parents);
-    auto max_el_it = std::max_element(distances.begin(), distances.end(), compare_distances);
-    return max_el_it != distances.end() ? max_el_it->second : 0;
-  }
-
   unsigned get_first_component_element(const std::pair< const unsigned, unsigned >& node_parent_pair)
   {
     return node_parent_pair.first;
@@ -315,12 +301,19 @@ void maslevtsov::traverse_breadth_first(const graphs_t& graphs, std::istream& in
   unsigned start_node = 0;
   in >> graph_name >> start_node;
   auto gr_it = graphs.find(graph_name);
-  if (gr_it == graphs.cend() || gr_it->second.get_adj_list().find(start_node) == gr_it->second.get_adj_list().cend()) {
+  if (gr_it == graphs.cend()) {
+    throw std::invalid_argument("non-existing graph");
+  }
+  const CompactGraph& compact = gr_it->second.get_compact();
+  unsigned start = compact.find(start_node);
+  if (start == CompactGraph::npos) {
     throw std::invalid_argument("non-existing graph");
   }
+  CompactGraph::Traversal traversal = compact.traverse(start, CompactGraph::npos);
   distances_t distances;
-  parents_t parents;
-  get_bfs_from(gr_it->second, start_node, distances, parents);
+  for (unsigned node: traversal.order) {
+    distances[compact.label(node)] = traversal.distances[node];
+  }
   for (auto i = distances.cbegin(); i != distances.cend(); ++i) {
     out << start_node << '-' << i->first << " : " << i->second << '\n';
   }
@@ -332,28 +325,32 @@ void maslevtsov::get_min_path(const graphs_t& graphs, std::istream& in, std::ost
   unsigned start_node = 0, goal_node = 0;
   in >> graph_name >> start_node >> goal_node;
   auto gr_it = graphs.find(graph_name);
-  if (gr_it == graphs.cend() || gr_it->second.get_adj_list().find(start_node) == gr_it->second.get_adj_list().cend()) {
+  if (gr_it == graphs.cend()) {
     throw std::invalid_argument("non-existing graph");
   }
-  distances_t distances;
-  parents_t parents;
-  get_bfs_from(gr_it->second, start_node, distances, parents);
-  if (distances.find(goal_node) == distances.end()) {
+  const CompactGraph& compact = gr_it->second.get_compact();
+  unsigned start = compact.find(start_node);
+  if (start == CompactGraph::npos) {
+    throw std::invalid_argument("non-existing graph");
+  }
+  unsigned goal = compact.find(goal_node);
+  if (goal == CompactGraph::npos) {
+    throw std::invalid_argument("non-existing path");
+  }
+  CompactGraph::Traversal traversal = compact.traverse(start, goal);
+  if (traversal.distances[goal] == CompactGraph::npos) {
     throw std::invalid_argument("non-existing path");
   }
   std::stack< unsigned > restored_path;
-  unsigned current_node = goal_node;
-  while (current_node != start_node) {
-    restored_path.push(current_node);
-    current_node = parents[current_node];
+  for (unsigned current = goal; current != start; current = traversal.parents[current]) {
+    restored_path.push(compact.label(current));
   }
-  out << current_node << '-' << restored_path.top();
-  restored_path.pop();
+  out << start_node;
   while (!restored_path.empty()) {
     out << '-' << restored_path.top();
     restored_path.pop();
   }
-  out << ' ' << distances[goal_node] << '\n';
+  out << ' ' << traversal.distances[goal] << '\n';
 }
 
 void maslevtsov::get_graph_width(const graphs_t& graphs, std::istream& in, std::ostream& out)
@@ -361,15 +358,10 @@ void maslevtsov::get_graph_width(const graphs_t& graphs, std::istream& in, std::
   std::string graph_name;
   in >> graph_name;
   auto gr_it = graphs.find(graph_name);
-  if (gr_it == graphs.cend()) {
+  if (gr_it == graphs.cend() || gr_it->second.get_adj_list().empty()) {
     throw std::invalid_argument("non-existing graph");
   }
-  const std::unordered_map< unsigned, std::vector< unsigned > >& adj_list = gr_it->second.get_adj_list();
-  std::vector< size_t > all_distances;
-  using namespace std::placeholders;
-  auto distance_collector = std::bind(get_max_distance, std::ref(gr_it->second), _1);
-  std::transform(adj_list.begin(), adj_list.end(), std::back_inserter(all_distances), distance_collector);
-  out << *std::max_element(all_distances.begin(), all_distances.end()) << '\n';
+  out << gr_it->second.get_compact().width() << '\n';
 }
 
 void maslevtsov::get_graph_components(const graphs_t& graphs, std::istream& in, std::ostream& out)
@@ -0,0 +1,309 @@
+#include "compact_graph.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include "graph.hpp"
+
+const unsigned maslevtsov::CompactGraph::npos = std::numeric_limits< unsigned >::max();
+
+namespace {
+  using maslevtsov::CompactGraph;
+
+  const unsigned batch_size = 64;
+
+  // plain bfs reusing its buffers, so sweeping many small components stays linear
+  class Sweeper
+  {
+  public:
+    explicit Sweeper(const CompactGraph& gr):
+      gr_(gr),
+      distances_(gr.size(), CompactGraph::npos),
+      parents_(gr.size(), CompactGraph::npos),
+      order_()
+    {}
+
+    const std::vector< unsigned >& run(unsigned start)
+    {
+      for (unsigned v: order_) {
+        distances_[v] = CompactGraph::npos;
+      }
+      order_.assign(1, start);
+      distances_[start] = 0;
+      parents_[start] = start;
+      for (size_t head = 0; head < order_.size(); ++head) {
+        unsigned current = order_[head];
+        for (auto i = gr_.neighbours_begin(current); i != gr_.neighbours_end(current); ++i) {
+          if (distances_[*i] == CompactGraph::npos) {
+            distances_[*i] = distances_[current] + 1;
+            parents_[*i] = current;
+            order_.push_back(*i);
+          }
+        }
+      }
+      return order_;
+    }
+
+    unsigned distance(unsigned v) const
+    {
+      return distances_[v];
+    }
+
+    unsigned parent(unsigned v) const
+    {
+      return parents_[v];
+    }
+
+  private:
+    const CompactGraph& gr_;
+    std::vector< unsigned > distances_;
+    std::vector< unsigned > parents_;
+    std::vector< unsigned > order_;
+  };
+
+  struct SourceMasks
+  {
+    std::vector< uint64_t > visited;
+    std::vector< uint64_t > frontier;
+    std::vector< uint64_t > next;
+    std::vector< unsigned > active;
+    std::vector< unsigned > reached;
+    std::vector< unsigned > next_active;
+  };
+
+  // bfs from up to 64 sources at once, one bit per source; returns the largest eccentricity among them
+  unsigned sweep_batch(const CompactGraph& gr, SourceMasks& masks, const unsigned* sources, size_t count)
+  {
+    if (masks.visited.empty()) {
+      masks.visited.assign(gr.size(), 0);
+      masks.frontier.assign(gr.size(), 0);
+      masks.next.assign(gr.size(), 0);
+    }
+    for (size_t k = 0; k < count; ++k) {
+      uint64_t bit = static_cast< uint64_t >(1) << k;
+      if (!masks.visited[sources[k]]) {
+        masks.active.push_back(sources[k]);
+        masks.reached.push_back(sources[k]);
+      }
+      masks.visited[sources[k]] |= bit;
+      masks.frontier[sources[k]] |= bit;
+    }
+    unsigned level = 0;
+    unsigned result = 0;
+    while (!masks.active.empty()) {
+      ++level;
+      for (unsigned v: masks.active) {
+        uint64_t front = masks.frontier[v];
+        for (auto i = gr.neighbours_begin(v); i != gr.neighbours_end(v); ++i) {
+          uint64_t fresh = front & ~masks.visited[*i];
+          if (fresh) {
+            if (!masks.next[*i]) {
+              masks.next_active.push_back(*i);
+            }
+            masks.next[*i] |= fresh;
+          }
+        }
+      }
+      for (unsigned v: masks.active) {
+        masks.frontier[v] = 0;
+      }
+      for (unsigned v: masks.next_active) {
+        if (!masks.visited[v]) {
+          masks.reached.push_back(v);
+        }
+        masks.visited[v] |= masks.next[v];
+        masks.frontier[v] = masks.next[v];
+        masks.next[v] = 0;
+      }
+      if (!masks.next_active.empty()) {
+        result = level;
+      }
+      masks.active.swap(masks.next_active);
+      masks.next_active.clear();
+    }
+    for (unsigned v: masks.reached) {
+      masks.visited[v] = 0;
+    }
+    masks.reached.clear();
+    return result;
+  }
+
+  struct BatchWorker
+  {
+    const CompactGraph& gr_;
+    SourceMasks& masks_;
+    const unsigned* sources_;
+    size_t count_;
+    std::atomic< size_t >& next_batch_;
+    unsigned& result_;
+
+    void operator()()
+    {
+      size_t batches = (count_ + batch_size - 1) / batch_size;
+      for (size_t b = next_batch_++; b < batches; b = next_batch_++) {
+        size_t first = b * batch_size;
+        size_t count = std::min< size_t >(batch_size, count_ - first);
+        result_ = std::max(result_, sweep_batch(gr_, masks_, sources_ + first, count));
+      }
+    }
+  };
+
+  // largest eccentricity among the sources, batches spread over the available cores
+  unsigned max_eccentricity(const CompactGraph& gr, std::vector< SourceMasks >& workers, const unsigned* sources,
+    size_t count)
+  {
+    size_t batches = (count + batch_size - 1) / batch_size;
+    size_t thread_count = std::min(workers.size(), batches);
+    std::atomic< size_t > next_batch(0);
+    std::vector< unsigned > results(thread_count, 0);
+    std::vector< std::thread > threads;
+    for (size_t t = 1; t < thread_count; ++t) {
+      threads.emplace_back(BatchWorker{gr, workers[t], sources, count, next_batch, results[t]});
+    }
+    BatchWorker{gr, workers[0], sources, count, next_batch, results[0]}();
+    for (std::thread& thread: threads) {
+      thread.join();
+    }
+    return *std::max_element(results.begin(), results.end());
+  }
+
+  // one double sweep from start: walks to the farthest vertex, sweeps back from it and
+  // returns the middle of that longest shortest path, raising the lower bound on the way
+  unsigned sweep_middle(Sweeper& sweeper, unsigned start, unsigned& lower)
+  {
+    unsigned far = sweeper.run(start).back();
+    unsigned other = sweeper.run(far).back();
+    unsigned distance = sweeper.distance(other);
+    lower = std::max(lower, distance);
+    unsigned middle = other;
+    for (unsigned i = 0; i < distance / 2; ++i) {
+      middle = sweeper.parent(middle);
+    }
+    return middle;
+  }
+
+  // iFUB: bfs from a 4-sweep centre, then exact eccentricities of its levels from the deepest
+  // one up until no shallower vertex can beat the bound
+  unsigned component_width(const CompactGraph& gr, Sweeper& sweeper, std::vector< SourceMasks >& workers,
+    unsigned root, size_t component_size)
+  {
+    unsigned lower = 0;
+    unsigned middle = sweep_middle(sweeper, root, lower);
+    if (lower + 1 == component_size) {
+      return lower;
+    }
+    middle = sweep_middle(sweeper, middle, lower);
+
+    const std::vector< unsigned >& order = sweeper.run(middle);
+    unsigned depth = sweeper.distance(order.back());
+    std::vector< size_t > level_begin(depth + 2, order.size());
+    for (size_t i = order.size(); i-- > 0;) {
+      level_begin[sweeper.distance(order[i])] = i;
+    }
+    lower = std::max(lower, depth);
+    unsigned upper = 2 * depth;
+    for (unsigned i = depth; upper > lower && i > 0; --i) {
+      size_t count = level_begin[i + 1] - level_begin[i];
+      lower = std::max(lower, max_eccentricity(gr, workers, order.data() + level_begin[i], count));
+      if (lower > 2 * (i - 1)) {
+        break;
+      }
+      upper = 2 * (i - 1);
+    }
+    return lower;
+  }
+}
+
+maslevtsov::CompactGraph::CompactGraph(const Graph& gr):
+  labels_(),
+  offsets_(),
+  targets_()
+{
+  const Graph::adjacency_list_t& adj_list = gr.get_adj_list();
+  labels_.reserve(adj_list.size());
+  for (auto i = adj_list.cbegin(); i != adj_list.cend(); ++i) {
+    labels_.push_back(i->first);
+  }
+  std::sort(labels_.begin(), labels_.end());
+  offsets_.reserve(labels_.size() + 1);
+  offsets_.push_back(0);
+  for (unsigned vertice: labels_) {
+    const std::vector< unsigned >& neighbours = adj_list.find(vertice)->second;
+    for (unsigned neighbour: neighbours) {
+      unsigned id = find(neighbour);
+      if (id != npos) {
+        targets_.push_back(id);
+      }
+    }
+    offsets_.push_back(targets_.size());
+  }
+}
+
+unsigned maslevtsov::CompactGraph::size() const
+{
+  return labels_.size();
+}
+
+unsigned maslevtsov::CompactGraph::find(unsigned label) const
+{
+  auto it = std::lower_bound(labels_.begin(), labels_.end(), label);
+  return it != labels_.end() && *it == label ? it - labels_.begin() : npos;
+}
+
+unsigned maslevtsov::CompactGraph::label(unsigned id) const
+{
+  return labels_[id];
+}
+
+const unsigned* maslevtsov::CompactGraph::neighbours_begin(unsigned id) const
+{
+  return targets_.data() + offsets_[id];
+}
+
+const unsigned* maslevtsov::CompactGraph::neighbours_end(unsigned id) const
+{
+  return targets_.data() + offsets_[id + 1];
+}
+
+maslevtsov::CompactGraph::Traversal maslevtsov::CompactGraph::traverse(unsigned start, unsigned goal) const
+{
+  Traversal result;
+  result.distances.assign(size(), npos);
+  result.parents.assign(size(), npos);
+  result.order.push_back(start);
+  result.distances[start] = 0;
+  result.parents[start] = start;
+  for (size_t head = 0; head < result.order.size() && (goal == npos || result.distances[goal] == npos); ++head) {
+    unsigned current = result.order[head];
+    for (auto i = neighbours_begin(current); i != neighbours_end(current); ++i) {
+      if (result.distances[*i] == npos) {
+        result.distances[*i] = result.distances[current] + 1;
+        result.parents[*i] = current;
+        result.order.push_back(*i);
+      }
+    }
+  }
+  return result;
+}
+
+unsigned maslevtsov::CompactGraph::width() const
+{
+  std::vector< bool > seen(size(), false);
+  Sweeper sweeper(*this);
+  std::vector< SourceMasks > workers(std::max(1u, std::thread::hardware_concurrency()));
+  unsigned result = 0;
+  for (unsigned root = 0; root < size(); ++root) {
+    if (seen[root]) {
+      continue;
+    }
+    const std::vector< unsigned >& component = sweeper.run(root);
+    for (unsigned v: component) {
+      seen[v] = true;
+    }
+    if (component.size() - 1 > result) {
+      result = std::max(result, component_width(*this, sweeper, workers, root, component.size()));
+    }
+  }
+  return result;
+}
@@ -0,0 +1,41 @@
+#ifndef COMPACT_GRAPH_HPP
+#define COMPACT_GRAPH_HPP
+
+#include <vector>
+
+namespace maslevtsov {
+  class Graph;
+
+  // vertices renumbered densely in label order, neighbours packed into one array
+  // in the order the adjacency list keeps them
+  class CompactGraph
+  {
+  public:
+    struct Traversal
+    {
+      std::vector< unsigned > order;
+      std::vector< unsigned > distances;
+      std::vector< unsigned > parents;
+    };
+
+    explicit CompactGraph(const Graph& gr);
+
+    unsigned size() const;
+    unsigned find(unsigned label) const;
+    unsigned label(unsigned id) const;
+    const unsigned* neighbours_begin(unsigned id) const;
+    const unsigned* neighbours_end(unsigned id) const;
+
+    Traversal traverse(unsigned start, unsigned goal) const;
+    unsigned width() const;
+
+    static const unsigned npos;
+
+  private:
+    std::vector< unsigned > labels_;
+    std::vector< unsigned > offsets_;
+    std::vector< unsigned > targets_;
+  };
+}
+
+#endif
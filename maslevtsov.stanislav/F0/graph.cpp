@@ -2,6 +2,7 @@
 #include <iostream>
 #include <algorithm>
 #include <functional>
+#include "compact_graph.hpp"
 
 namespace {
   struct DelimiterIn
@@ -71,12 +72,21 @@ const maslevtsov::Graph::adjacency_list_t& maslevtsov::Graph::get_adj_list() con
   return adjacency_list_;
 }
 
+const maslevtsov::CompactGraph& maslevtsov::Graph::get_compact() const
+{
+  if (!compact_) {
+    compact_ = std::make_shared< const CompactGraph >(*this);
+  }
+  return *compact_;
+}
+
 void maslevtsov::Graph::add_vertice(unsigned vertice)
 {
   if (adjacency_list_.find(vertice) != adjacency_list_.end()) {
     throw std::invalid_argument("vertice already exist");
   }
   adjacency_list_[vertice];
+  compact_.reset();
 }
 
 void maslevtsov::Graph::add_edge(unsigned vertice1, unsigned vertice2)
@@ -89,6 +99,7 @@ void maslevtsov::Graph::add_edge(unsigned vertice1, unsigned vertice2)
   }
   adjacency_list_[vertice1].push_back(vertice2);
   adjacency_list_[vertice2].push_back(vertice1);
+  compact_.reset();
 }
 
 void maslevtsov::Graph::delete_vertice(unsigned vertice)
@@ -102,6 +113,7 @@ void maslevtsov::Graph::delete_vertice(unsigned vertice)
     neighbour_it->second.erase(std::find(neighbour_it->second.begin(), neighbour_it->second.end(), vertice));
   }
   adjacency_list_.erase(adjacency_list_.find(vertice));
+  compact_.reset();
 }
 
 void maslevtsov::Graph::delete_edge(unsigned vertice1, unsigned vertice2)
@@ -116,6 +128,7 @@ void maslevtsov::Graph::delete_edge(unsigned vertice1, unsigned vertice2)
   vertice1_it->second.erase(std::find(vertice1_it->second.begin(), vertice1_it->second.end(), vertice2));
   auto vertice2_it = adjacency_list_.find(vertice2);
   vertice2_it->second.erase(std::find(vertice2_it->second.begin(), vertice2_it->second.end(), vertice1));
+  compact_.reset();
 }
 
 std::istream& maslevtsov::operator>>(std::istream& in, Graph& gr)
@@ -1,11 +1,14 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include <memory>
 #include <unordered_map>
 #include <string>
 #include <vector>
 
 namespace maslevtsov {
+  class CompactGraph;
+
   class Graph
   {
   public:
@@ -16,6 +19,7 @@ namespace maslevtsov {
     Graph(const Graph& src, const std::vector< unsigned >& vertices);
 
     const adjacency_list_t& get_adj_list() const;
+    const CompactGraph& get_compact() const;
 
     void add_vertice(unsigned vertice);
     void add_edge(unsigned vertice1, unsigned vertice2);
@@ -24,6 +28,7 @@ namespace maslevtsov {
 
   private:
     adjacency_list_t adjacency_list_;
+    mutable std::shared_ptr< const CompactGraph > compact_;
 
     friend std::istream& operator>>(std::istream& in, Graph& gr);
     friend std::ostream& operator<<(std::ostream& out, const Graph& gr);
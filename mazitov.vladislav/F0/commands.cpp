@@ -44,38 +44,15 @@ namespace
       }
     }
   };
-  struct ByteGenerator
+  struct PackedByteGenerator
   {
-    const std::string& bits;
-    explicit ByteGenerator(const std::string& b):
+    const mazitov::PackedBits& bits;
+    explicit PackedByteGenerator(const mazitov::PackedBits& b):
       bits(b)
     {}
     unsigned char operator()(std::size_t byteIndex) const
     {
-      unsigned char byte = 0;
-      std::size_t startBit = byteIndex * 8;
-      for (std::size_t j = 0; j < 8 && startBit + j < bits.size(); j++)
-      {
-        if (bits[startBit + j] == '1')
-        {
-          byte |= (1 << (7 - j));
-        }
-      }
-      return byte;
-    }
-  };
-  struct BitsGenerator
-  {
-    std::string& bits;
-    explicit BitsGenerator(std::string& b):
-      bits(b)
-    {}
-    void operator()(unsigned char byte) const
-    {
-      for (int i = 7; i >= 0; i--)
-      {
-        bits += (byte & (1 << i)) ? '1' : '0';
-      }
+      return bits.byteAt(byteIndex);
     }
   };
 }
@@ -184,9 +161,8 @@ void mazitov::degreeCommand(DataSetManager& mgmt, std::istream& in, std::ostream
     throw std::runtime_error("<NO_COMPRESSED_DATA>");
   }
 
-  std::string compressed = mgmt.getCompressedData(setName);
   double originalSize = dataSet->originalText.size() * 8.0;
-  double compressedSize = compressed.size();
+  double compressedSize = mgmt.getCompressedData(setName).bitLength;
   double ratio = compressedSize / originalSize;
   out << "Degree ratio: " << std::fixed << std::setprecision(2) << ratio << "\n";
 }
@@ -218,7 +194,7 @@ void mazitov::showCompressedCommand(DataSetManager& mgmt, std::istream& in, std:
   }
 
   auto* ds = mgmt.getDataSet(setName);
-  std::string compressedBits = ds->compressedBits;
+  PackedBits compressedBits = ds->compressedBits;
   if (compressedBits.empty())
   {
     if (ds->originalText.empty() || ds->huffCodes.empty())
@@ -227,11 +203,11 @@ void mazitov::showCompressedCommand(DataSetManager& mgmt, std::istream& in, std:
     }
     compressedBits = mgmt.getCompressedData(setName);
   }
-  std::size_t numBytes = (compressedBits.size() + 7) / 8;
+  std::size_t numBytes = compressedBits.byteCount();
   std::vector< std::size_t > ind(numBytes);
   std::iota(ind.begin(), ind.end(), 0);
   std::vector< unsigned char > bytes(numBytes);
-  std::transform(ind.begin(), ind.end(), bytes.begin(), ByteGenerator(compressedBits));
+  std::transform(ind.begin(), ind.end(), bytes.begin(), PackedByteGenerator(compressedBits));
   HexPrinter printer(out);
   std::for_each(bytes.begin(), bytes.end(), std::ref(printer));
   if (!bytes.empty() && bytes.size() % 8 != 0)
@@ -329,10 +305,10 @@ void mazitov::compareDegreesCommand(DataSetManager& mgmt, std::istream& in, std:
   {
     throw std::runtime_error("<NO_COMPRESSED_DATA_IN_SET2>");
   }
-  std::string comp1 = mgmt.getCompressedData(set1);
-  std::string comp2 = mgmt.getCompressedData(set2);
-  double ratio1 = static_cast< double >(comp1.size()) / (ds1->originalText.size() * 8);
-  double ratio2 = static_cast< double >(comp2.size()) / (ds2->originalText.size() * 8);
+  std::size_t comp1 = mgmt.getCompressedData(set1).bitLength;
+  std::size_t comp2 = mgmt.getCompressedData(set2).bitLength;
+  double ratio1 = static_cast< double >(comp1) / (ds1->originalText.size() * 8);
+  double ratio2 = static_cast< double >(comp2) / (ds2->originalText.size() * 8);
   if (ratio1 < ratio2)
   {
     out << set1 << " better compress (" << ratio1 << " < " << ratio2 << ")\n";
@@ -364,7 +340,7 @@ void mazitov::showCodeCommand(DataSetManager& mgmt, std::istream& in, std::ostre
   out << "Huffman codes from set " << setName << ":\n";
   for (const auto& pair : ds->huffCodes)
   {
-    out << "  '" << pair.first << "': " << pair.second << "\n";
+    out << "  '" << pair.first << "': " << codeToString(pair.second) << "\n";
   }
 }
 
@@ -407,14 +383,9 @@ void mazitov::compressedToBinCommand(DataSetManager& mgmt, std::istream& in, std
     throw std::runtime_error("<NO_COMPRESSED_DATA>");
   }
 
-  std::string compressedBits = mgmt.getCompressedData(setName);
-  std::size_t numBytes = (compressedBits.size() + 7) / 8;
-  std::vector< std::size_t > ind(numBytes);
-  std::iota(ind.begin(), ind.end(), 0);
-  std::vector< unsigned char > bytes(numBytes);
-  std::transform(ind.begin(), ind.end(), bytes.begin(), ByteGenerator(compressedBits));
+  PackedBits compressedBits = mgmt.getCompressedData(setName);
   std::ofstream file(filename, std::ios::binary);
-  file.write(reinterpret_cast< const char* >(bytes.data()), bytes.size());
+  compressedBits.write(file);
   file.close();
   out << "Compressed data from set " << setName << "was saved in file " << filename << "\n";
 }
@@ -439,14 +410,12 @@ void mazitov::loadCompressedCommand(DataSetManager& mgmt, std::istream& in, std:
   {
     throw std::runtime_error("<COMPRESSED_DATA_EMPTY>");
   }
-  std::vector< unsigned char > bytes(fileSize);
-  if (!file.read(reinterpret_cast< char* >(bytes.data()), fileSize))
+  PackedBits comprBits;
+  if (!comprBits.read(file, static_cast< std::size_t >(fileSize)))
   {
     throw std::runtime_error("<FILE_READ_ERROR>");
   }
-  std::string comprBits;
-  std::for_each(bytes.begin(), bytes.end(), BitsGenerator(comprBits));
   auto* ds = mgmt.getDataSet(setName);
-  ds->compressedBits = comprBits;
+  ds->compressedBits = std::move(comprBits);
   out << "Compressed data loaded from " << filename << " to set " << setName << "\n";
 }
@@ -1,5 +1,6 @@
 #include "dataset.hpp"
-#include "huffman.hpp"
+#include <array>
+#include <stdexcept>
 
 bool mazitov::DataSetManager::createDataSet(const std::string& name)
 {
@@ -51,17 +52,34 @@ bool mazitov::DataSetManager::compressDataSet(const std::string& name)
   return true;
 }
 
-std::string mazitov::DataSetManager::getCompressedData(const std::string& name) const
+mazitov::PackedBits mazitov::DataSetManager::getCompressedData(const std::string& name) const
 {
   auto it = dataSets.find(name);
   if (it == dataSets.end())
   {
-    return "";
+    return PackedBits();
   }
-  std::string res;
+  std::array< HuffCode, 256 > codes{};
+  for (const auto& pair : it->second.huffCodes)
+  {
+    codes[static_cast< unsigned char >(pair.first)] = pair.second;
+  }
+  std::size_t totalBits = 0;
+  for (char c : it->second.originalText)
+  {
+    const HuffCode& code = codes[static_cast< unsigned char >(c)];
+    if (code.length == 0)
+    {
+      throw std::out_of_range("<NO_CODE_FOR_SYMBOL>");
+    }
+    totalBits += code.length;
+  }
+  PackedBits res;
+  res.words.reserve((totalBits + 63) / 64);
   for (char c : it->second.originalText)
   {
-    res += it->second.huffCodes.at(c);
+    const HuffCode& code = codes[static_cast< unsigned char >(c)];
+    res.append(code.bits, code.length);
   }
   return res;
 }
@@ -72,5 +90,5 @@ std::size_t mazitov::DataSetManager::getCompressedSize(const std::string& name)
   {
     return 0;
   }
-  return getCompressedData(name).size();
+  return getCompressedData(name).byteCount();
 }
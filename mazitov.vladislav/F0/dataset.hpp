@@ -6,14 +6,15 @@
 #include <unordered_map>
 #include <map>
 #include <cstddef>
+#include "huffman.hpp"
 
 namespace mazitov
 {
   struct DataSet
   {
     std::string originalText;
-    std::string compressedBits;
-    std::unordered_map< char, std::string > huffCodes;
+    PackedBits compressedBits;
+    huffCodesTable huffCodes;
   };
 
   class DataSetManager
@@ -24,7 +25,7 @@ namespace mazitov
     bool deleteDataSet(const std::string &);
     bool compressDataSet(const std::string &);
     DataSet* getDataSet(const std::string &);
-    std::string getCompressedData(const std::string &) const;
+    PackedBits getCompressedData(const std::string &) const;
     std::size_t getCompressedSize(const std::string &) const;
   private:
     std::map< std::string, DataSet > dataSets;
@@ -1,4 +1,6 @@
 #include "huffman.hpp"
+#include <istream>
+#include <ostream>
 
 namespace
 {
@@ -14,7 +16,9 @@ namespace
     }
   };
 
-  void treverseTree(const mazitov::huffPtr& node, const std::string& code, mazitov::huffCodesTable& codes)
+  using codeLengths = std::vector< std::pair< unsigned, unsigned char > >;
+
+  void treverseTree(const mazitov::huffPtr& node, unsigned depth, codeLengths& lengths)
   {
     if (node == nullptr)
     {
@@ -22,17 +26,11 @@ namespace
     }
     if (node->left == nullptr && node->right == nullptr)
     {
-      codes[node->symbol] = code;
+      lengths.emplace_back(std::max(depth, 1u), static_cast< unsigned char >(node->symbol));
       return;
     }
-    if (node->left != nullptr)
-    {
-      treverseTree(node->left, code + "0", codes);
-    }
-    if (node->right != nullptr)
-    {
-      treverseTree(node->right, code + "1", codes);
-    }
+    treverseTree(node->left, depth + 1, lengths);
+    treverseTree(node->right, depth + 1, lengths);
   }
 }
 
@@ -88,11 +86,114 @@ mazitov::huffPtr mazitov::buildHuffmanTree(const freqTable& freq)
   return pq.top();
 }
 
-void mazitov::generateCodes(const huffPtr& root, std::unordered_map< char, std::string >& codes)
+void mazitov::generateCodes(const huffPtr& root, huffCodesTable& codes)
 {
   if (root == nullptr)
   {
     return;
   }
-  treverseTree(root, "", codes);
+  codeLengths lengths;
+  treverseTree(root, 0, lengths);
+  std::sort(lengths.begin(), lengths.end());
+
+  std::uint64_t code = 0;
+  unsigned prevLength = lengths.front().first;
+  for (const auto& entry : lengths)
+  {
+    code <<= entry.first - prevLength;
+    prevLength = entry.first;
+    codes[static_cast< char >(entry.second)] = HuffCode{ code, entry.first };
+    ++code;
+  }
+}
+
+std::string mazitov::codeToString(const HuffCode& code)
+{
+  std::string res;
+  for (unsigned i = code.length; i > 0; i--)
+  {
+    res += ((code.bits >> (i - 1)) & 1) ? '1' : '0';
+  }
+  return res;
+}
+
+void mazitov::PackedBits::append(std::uint64_t bits, unsigned length)
+{
+  if (length == 0)
+  {
+    return;
+  }
+  unsigned offset = bitLength % 64;
+  if (offset == 0)
+  {
+    words.push_back(0);
+  }
+  unsigned free = 64 - offset;
+  if (length <= free)
+  {
+    words.back() |= bits << (free - length);
+  }
+  else
+  {
+    unsigned rest = length - free;
+    words.back() |= bits >> rest;
+    words.push_back(bits << (64 - rest));
+  }
+  bitLength += length;
+}
+
+unsigned char mazitov::PackedBits::byteAt(std::size_t index) const
+{
+  return static_cast< unsigned char >(words[index / 8] >> (56 - 8 * (index % 8)));
+}
+
+std::size_t mazitov::PackedBits::byteCount() const
+{
+  return (bitLength + 7) / 8;
+}
+
+bool mazitov::PackedBits::empty() const
+{
+  return bitLength == 0;
+}
+
+void mazitov::PackedBits::write(std::ostream& out) const
+{
+  char buffer[8];
+  std::size_t remaining = byteCount();
+  for (std::size_t i = 0; i < words.size() && remaining > 0; i++)
+  {
+    std::size_t n = std::min< std::size_t >(8, remaining);
+    for (std::size_t j = 0; j < n; j++)
+    {
+      buffer[j] = static_cast< char >(words[i] >> (56 - 8 * j));
+    }
+    out.write(buffer, n);
+    remaining -= n;
+  }
+}
+
+bool mazitov::PackedBits::read(std::istream& in, std::size_t count)
+{
+  words.clear();
+  words.reserve((count + 7) / 8);
+  bitLength = 0;
+  char buffer[8];
+  for (std::size_t done = 0; done < count;)
+  {
+    std::size_t n = std::min< std::size_t >(8, count - done);
+    if (!in.read(buffer, n))
+    {
+      return false;
+    }
+    std::uint64_t word = 0;
+    for (std::size_t j = 0; j < n; j++)
+    {
+      word |= static_cast< std::uint64_t >(static_cast< unsigned char >(buffer[j])) << (56 - 8 * j);
+    }
+    words.push_back(word);
+    bitLength += n * 8;
+    done += n;
+  }
+  return true;
 }
@@ -2,18 +2,40 @@
 #define HUFFMAN_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <iosfwd>
 #include <queue>
 #include <algorithm>
+#include <vector>
 
 namespace mazitov
 {
   struct HuffmanNode;
   using huffPtr = std::shared_ptr< HuffmanNode >;
   using freqTable = std::unordered_map< char, std::size_t >;
-  using huffCodesTable = std::unordered_map< char, std::string >;
+
+  struct HuffCode
+  {
+    std::uint64_t bits;
+    unsigned length;
+  };
+  using huffCodesTable = std::unordered_map< char, HuffCode >;
+
+  struct PackedBits
+  {
+    std::vector< std::uint64_t > words;
+    std::size_t bitLength = 0;
+
+    void append(std::uint64_t bits, unsigned length);
+    unsigned char byteAt(std::size_t index) const;
+    std::size_t byteCount() const;
+    bool empty() const;
+    void write(std::ostream &) const;
+    bool read(std::istream &, std::size_t byteCount);
+  };
 
   struct HuffmanNode
   {
@@ -34,6 +56,7 @@ namespace mazitov
   huffPtr buildHuffmanTree(const freqTable &);
   freqTable buildFreqTable(const std::string &);
   void generateCodes(const huffPtr &, huffCodesTable &);
+  std::string codeToString(const HuffCode &);
 }
 
 #endif
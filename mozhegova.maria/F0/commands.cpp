@@ -3,7 +3,6 @@
 #include <algorithm>
 #include <string>
 #include <functional>
-#include <numeric>
 #include <iomanip>
 
 namespace
@@ -36,79 +35,98 @@ namespace
     }
   };
 
-  std::pair< mozhegova::WordPos, std::string > createWordPair(const mozhegova::WordPos & pos, const std::string & word)
+  bool cmpTokens(const mozhegova::Token & a, const mozhegova::Token & b)
   {
-    return std::make_pair(pos, word);
+    return a.pos < b.pos || (a.pos == b.pos && *a.word < *b.word);
   }
 
-  struct Accumulator
+  bool cmpTokenLine(const mozhegova::Token & token, size_t line)
   {
-    std::string result;
-    std::pair< mozhegova::WordPos, std::string > prev;
-    bool first = true;
-    Accumulator(const std::string & initial):
-      result(initial)
-    {}
-  };
+    return token.pos.first < line;
+  }
+
+  bool cmpTokenNum(const mozhegova::Token & a, const mozhegova::Token & b)
+  {
+    return a.pos.second < b.pos.second;
+  }
 
-  Accumulator accumulateWords(Accumulator acc, const std::pair< mozhegova::WordPos, std::string > & current)
+  bool isSameLine(const mozhegova::Token & a, const mozhegova::Token & b)
   {
-    if (acc.first)
+    return a.pos.first == b.pos.first;
+  }
+
+  bool isSamePos(const mozhegova::Token & a, const mozhegova::Token & b)
+  {
+    return a.pos == b.pos;
+  }
+
+  bool isTokenOf(const mozhegova::Token & token, const std::string * word)
+  {
+    return token.word == word;
+  }
+
+  using Words = std::unordered_map< std::string, mozhegova::Xrefs >;
+  void rebindTokens(std::vector< mozhegova::Token > & tokens, const Words & words)
+  {
+    for (mozhegova::Token & token: tokens)
     {
-      acc.result += current.second;
-      acc.first = false;
+      token.word = &words.find(*token.word)->first;
     }
-    else
+  }
+
+  template< class F >
+  void moveTokens(std::vector< mozhegova::Token > & tokens, F f)
+  {
+    for (mozhegova::Token & token: tokens)
     {
-      if (acc.prev.first.first != current.first.first)
-      {
-        acc.result += '\n';
-      }
-      else
-      {
-        acc.result += ' ';
-      }
-      acc.result += current.second;
+      token.pos = f(token.pos);
     }
-    acc.prev = current;
-    return acc;
   }
 
-  void supRecText(constWord & word, std::vector< std::pair< mozhegova::WordPos, std::string > > & sortedWords)
+  using TokenPredicate = bool (*)(const mozhegova::Token &, const mozhegova::Token &);
+  void reverseRuns(std::vector< mozhegova::Token > & tokens, TokenPredicate same)
   {
-    auto b = word.second.begin();
-    auto e = word.second.end();
     using namespace std::placeholders;
-    std::transform(b, e, std::back_inserter(sortedWords), std::bind(createWordPair, _1, word.first));
+    auto first = tokens.begin();
+    while (first != tokens.end())
+    {
+      auto last = std::find_if_not(first, tokens.end(), std::bind(same, std::cref(*first), _1));
+      std::reverse(first, last);
+      first = last;
+    }
   }
 
-  std::string reconstructText(const mozhegova::Text & text)
+  // edits keep tokens ordered except for out-of-range line arguments, which wrap around
+  void restoreOrder(std::vector< mozhegova::Token > & tokens)
   {
-    std::vector< std::pair< mozhegova::WordPos, std::string > > sortedWords;
-    using namespace std::placeholders;
-    std::for_each(text.cbegin(), text.cend(), std::bind(supRecText, _1, std::ref(sortedWords)));
-    std::sort(sortedWords.begin(), sortedWords.end());
-    if (sortedWords.empty())
+    if (!std::is_sorted(tokens.cbegin(), tokens.cend(), cmpTokens))
     {
-      return "";
+      std::sort(tokens.begin(), tokens.end(), cmpTokens);
     }
-    Accumulator initialValue("");
-    Accumulator result = std::accumulate(sortedWords.begin(), sortedWords.end(), initialValue, accumulateWords);
-    return result.result;
   }
 
-  size_t getSizeWord(constWord & word)
+  void addWord(mozhegova::Text & text, const std::string & word, const mozhegova::WordPos & pos)
   {
-    return word.second.size();
+    auto it = text.words.find(word);
+    if (it == text.words.end())
+    {
+      it = text.words.emplace(word, mozhegova::Xrefs()).first;
+    }
+    it->second.push_back(pos);
+    text.tokens.push_back({pos, &it->first});
   }
 
-  struct AccumulateTextSize
+  void printTokens(std::ostream & out, const std::vector< mozhegova::Token > & tokens)
   {
-    size_t operator()(size_t currentSize, constWord & word) const
+    for (auto it = tokens.cbegin(); it != tokens.cend(); ++it)
     {
-      return currentSize + getSizeWord(word);
+      if (it != tokens.cbegin())
+      {
+        out << (isSameLine(*(it - 1), *it) ? ' ' : '\n');
+      }
+      out << *it->word;
     }
-  };
+  }
 
   struct PrintText
   {
@@ -116,55 +134,26 @@ namespace
     void operator()(const std::pair< std::string, mozhegova::Text > & text) const
     {
       out << text.first << ' ';
-      out << std::accumulate(text.second.cbegin(), text.second.cend(), 0, AccumulateTextSize()) << '\n';
-      out << reconstructText(text.second) << '\n';
+      out << text.second.tokens.size() << '\n';
+      printTokens(out, text.second.tokens);
+      out << '\n';
     }
   };
 
-  bool cmpMaxLineNumWord(const std::pair< size_t, size_t > & a, const std::pair< size_t, size_t > & b)
+  bool cmpLineNum(const std::pair< size_t, size_t > & a, const std::pair< size_t, size_t > & b)
   {
     return a.first < b.first;
   }
 
-  size_t getMaxLineNumWord(constWord & word)
-  {
-    mozhegova::Xrefs xrefs = word.second;
-    if (xrefs.empty())
-    {
-      return 0;
-    }
-    auto maxNumIt = std::max_element(xrefs.cbegin(), xrefs.cend(), cmpMaxLineNumWord);
-    return maxNumIt->first;
-  }
-
   size_t getMaxLineNum(const mozhegova::Text & text)
   {
-    std::vector< size_t > lineNum;
-    std::transform(text.cbegin(), text.cend(), std::back_inserter(lineNum), getMaxLineNumWord);
-    return *std::max_element(lineNum.cbegin(), lineNum.cend());
-  }
-
-  bool cmpMaxNumWord(const std::pair< size_t, size_t > & a, const std::pair< size_t, size_t > & b)
-  {
-    return a.second < b.second;
-  }
-
-  size_t getMaxNumWord(constWord & word)
-  {
-    mozhegova::Xrefs xrefs = word.second;
-    if (xrefs.empty())
-    {
-      return 0;
-    }
-    auto maxNumIt = std::max_element(xrefs.cbegin(), xrefs.cend(), cmpMaxNumWord);
-    return maxNumIt->second;
+    return text.tokens.empty() ? 0 : text.tokens.back().pos.first;
   }
 
   size_t getMaxNum(const mozhegova::Text & text)
   {
-    std::vector< size_t > num;
-    std::transform(text.cbegin(), text.cend(), std::back_inserter(num), getMaxNumWord);
-    return *std::max_element(num.cbegin(), num.cend());
+    auto maxNumIt = std::max_element(text.tokens.cbegin(), text.tokens.cend(), cmpTokenNum);
+    return maxNumIt == text.tokens.cend() ? 0 : maxNumIt->pos.second;
   }
 
   bool cmpBetween(const mozhegova::WordPos & pos, size_t begin, size_t end)
@@ -172,7 +161,7 @@ namespace
     return pos.first >= begin && pos.first < end;
   }
 
-  void subExtrSubstr(constWord & word, mozhegova::Text & result, size_t begin, size_t end)
+  void subExtrSubstr(const Word & word, mozhegova::Text & result, size_t begin, size_t end)
   {
     mozhegova::Xrefs newXrefs;
     auto b = word.second.begin();
@@ -181,7 +170,7 @@ namespace
     std::copy_if(b, e, std::back_inserter(newXrefs), std::bind(cmpBetween, _1, begin, end));
     if (!newXrefs.empty())
     {
-      result[word.first] = newXrefs;
+      result.words[word.first] = newXrefs;
     }
   }
 
@@ -189,7 +178,11 @@ namespace
   {
     mozhegova::Text result;
     using namespace std::placeholders;
-    std::for_each(text.cbegin(), text.cend(), std::bind(subExtrSubstr, _1, std::ref(result), begin, end));
+    std::for_each(text.words.cbegin(), text.words.cend(), std::bind(subExtrSubstr, _1, std::ref(result), begin, end));
+    auto first = std::lower_bound(text.tokens.cbegin(), text.tokens.cend(), begin, cmpTokenLine);
+    auto last = std::lower_bound(first, text.tokens.cend(), end, cmpTokenLine);
+    result.tokens.assign(first, last);
+    rebindTokens(result.tokens, result.words);
     return result;
   }
 
@@ -221,18 +214,18 @@ namespace
     return {maxLine - pos.first + 1, pos.second};
   }
 
-  mozhegova::WordPos changeNum(const mozhegova::WordPos & pos, size_t line, size_t maxNum)
+  mozhegova::WordPos changeNum(const mozhegova::WordPos & pos, size_t maxLine, size_t maxNum)
   {
-    if (pos.first == line)
+    if (pos.first >= 1 && pos.first <= maxLine)
     {
       return {pos.first, maxNum - pos.second + 1};
     }
     return pos;
   }
 
-  mozhegova::WordPos uppNum(const mozhegova::WordPos & pos, size_t n)
+  mozhegova::WordPos uppNum(const mozhegova::WordPos & pos, size_t maxNum)
   {
-    return {pos.first, pos.second + n};
+    return {pos.first, pos.second + pos.first * maxNum};
   }
 
   void subRemoveSubstr(Word & word, size_t begin, size_t end)
@@ -253,8 +246,13 @@ namespace
   void removeSubstring(mozhegova::Text & text, size_t begin, size_t end)
   {
     using namespace std::placeholders;
-    std::for_each(text.begin(), text.end(), std::bind(subRemoveSubstr, _1, begin, end));
-    std::for_each(text.begin(), text.end(), std::bind(subDownLenNum, _1, begin, end));
+    std::for_each(text.words.begin(), text.words.end(), std::bind(subRemoveSubstr, _1, begin, end));
+    std::for_each(text.words.begin(), text.words.end(), std::bind(subDownLenNum, _1, begin, end));
+    auto first = std::lower_bound(text.tokens.begin(), text.tokens.end(), begin, cmpTokenLine);
+    auto last = std::lower_bound(first, text.tokens.end(), end, cmpTokenLine);
+    text.tokens.erase(first, last);
+    moveTokens(text.tokens, std::bind(downLenNum, _1, begin, end));
+    restoreOrder(text.tokens);
   }
 
   void subUppLenNum(Word & word, size_t n, size_t begin, size_t end)
@@ -265,34 +263,38 @@ namespace
     std::transform(b, e, b, std::bind(uppLenNum, _1, n, end - begin));
   }
 
-  void subChangeLenNum(Word & word, mozhegova::Text & text1, size_t n, size_t begin)
+  void subChangeLenNum(const Word & word, mozhegova::Text & text1, size_t n, size_t begin)
   {
     auto b = word.second.begin();
     auto e = word.second.end();
     using namespace std::placeholders;
-    std::transform(b, e, std::back_inserter(text1[word.first]), std::bind(changeLenNum, _1, n, begin));
+    std::transform(b, e, std::back_inserter(text1.words[word.first]), std::bind(changeLenNum, _1, n, begin));
   }
 
   void insertTextTo(mozhegova::Text & text1, const mozhegova::Text & text2, size_t n, size_t begin, size_t end)
   {
     mozhegova::Text temp = extractSubstring(text2, begin, end);
     using namespace std::placeholders;
-    std::for_each(text1.begin(), text1.end(), std::bind(subUppLenNum, _1, n, begin, end));
-    std::for_each(text1.begin(), text1.end(), std::bind(subChangeLenNum, _1, std::ref(text1), n, begin));
-  }
-
-  bool isWordOnLine(const mozhegova::WordPos & pos, size_t line)
-  {
-    return pos.first == line;
+    std::for_each(text1.words.begin(), text1.words.end(), std::bind(subUppLenNum, _1, n, begin, end));
+    std::for_each(temp.words.cbegin(), temp.words.cend(), std::bind(subChangeLenNum, _1, std::ref(text1), n, begin));
+    auto at = std::lower_bound(text1.tokens.begin(), text1.tokens.end(), n, cmpTokenLine) - text1.tokens.begin();
+    moveTokens(text1.tokens, std::bind(uppLenNum, _1, n, end - begin));
+    moveTokens(temp.tokens, std::bind(changeLenNum, _1, n, begin));
+    rebindTokens(temp.tokens, text1.words);
+    text1.tokens.insert(text1.tokens.begin() + at, temp.tokens.cbegin(), temp.tokens.cend());
+    restoreOrder(text1.tokens);
   }
 
-  void subSideMerge(Word & word, size_t line, size_t num, mozhegova::Text & combinedText)
+  void subSideMerge(const Word & word, size_t maxLines, size_t maxNum, mozhegova::Text & combinedText)
   {
+    mozhegova::Xrefs xrefs;
     auto b = word.second.begin();
     auto e = word.second.end();
     using namespace std::placeholders;
-    std::transform(b, e, b, std::bind(uppNum, _1, num));
-    std::copy_if(b, e, std::back_inserter(combinedText[word.first]), std::bind(isWordOnLine, _1, line));
+    std::copy_if(b, e, std::back_inserter(xrefs), std::bind(cmpBetween, _1, 1, maxLines + 1));
+    std::stable_sort(xrefs.begin(), xrefs.end(), cmpLineNum);
+    auto d_first = std::back_inserter(combinedText.words[word.first]);
+    std::transform(xrefs.cbegin(), xrefs.cend(), d_first, std::bind(uppNum, _1, maxNum));
   }
 
   void subInvertLines(Word & word, size_t lineNum)
@@ -303,15 +305,29 @@ namespace
     std::transform(b, e, b, std::bind(reverseLenNum, _1, lineNum));
   }
 
-  void subInvertWords(Word & word, size_t line, size_t maxNum)
+  void subInvertWords(Word & word, size_t maxLine, size_t maxNum)
   {
     auto b = word.second.begin();
     auto e = word.second.end();
     using namespace std::placeholders;
-    std::transform(b, e, b, std::bind(changeNum, _1, line, maxNum));
+    std::transform(b, e, b, std::bind(changeNum, _1, maxLine, maxNum));
   }
 }
 
+mozhegova::Text::Text(const Text & other):
+  words(other.words),
+  tokens(other.tokens)
+{
+  rebindTokens(tokens, words);
+}
+
+mozhegova::Text & mozhegova::Text::operator=(const Text & other)
+{
+  Text copy(other);
+  *this = std::move(copy);
+  return *this;
+}
+
 void mozhegova::generateLinks(std::istream & in, Texts & texts)
 {
   std::string textName, fileName;
@@ -335,7 +351,7 @@ void mozhegova::generateLinks(std::istream & in, Texts & texts)
     while (file.peek() != '\n' && file >> word)
     {
       ++num;
-      text[word].push_back({line, num});
+      addWord(text, word, {line, num});
     }
     file.ignore();
   }
@@ -363,9 +379,9 @@ void mozhegova::printLinks(std::istream & in, std::ostream & out, const Texts &
     throw std::runtime_error("<INVALID COMMAND>");
   }
   const Text & text = it->second;
-  auto maxWordIt = std::max_element(text.cbegin(), text.cend(), cmpMaxWordLen);
+  auto maxWordIt = std::max_element(text.words.cbegin(), text.words.cend(), cmpMaxWordLen);
   size_t maxWordLen = maxWordIt->first.length() + 2;
-  std::for_each(text.cbegin(), text.cend(), PrintWords{out, maxWordLen});
+  std::for_each(text.words.cbegin(), text.words.cend(), PrintWords{out, maxWordLen});
 }
 
 void mozhegova::printText(std::istream & in, std::ostream & out, const Texts & texts)
@@ -377,9 +393,8 @@ void mozhegova::printText(std::istream & in, std::ostream & out, const Texts & t
   {
     throw std::runtime_error("<INVALID COMMAND>");
   }
-  const Text & text = it->second;
-  std::string reconstructed = reconstructText(text);
-  out << reconstructed << '\n';
+  printTokens(out, it->second.tokens);
+  out << '\n';
 }
 
 void mozhegova::printTextInFile(std::istream & in, const Texts & texts)
@@ -486,14 +501,26 @@ void mozhegova::sideMergeTexts(std::istream & in, Texts & texts)
   const Text & text1 = it1->second;
   const Text & text2 = it2->second;
   Text temp1 = text1;
-  Text temp2 = text2;
   size_t maxLines = std::max(getMaxLineNum(text1), getMaxLineNum(text2));
   size_t maxNum = getMaxNum(text1);
-  for (size_t line = 1; line <= maxLines; ++line)
+  if (maxLines != 0)
   {
     using namespace std::placeholders;
-    std::for_each(temp2.begin(), temp2.end(), std::bind(subSideMerge, _1, line, maxNum, std::ref(temp1)));
+    auto f = std::bind(subSideMerge, _1, maxLines, maxNum, std::ref(temp1));
+    std::for_each(text2.words.cbegin(), text2.words.cend(), f);
   }
+  std::vector< Token > added;
+  auto first = std::lower_bound(text2.tokens.cbegin(), text2.tokens.cend(), 1, cmpTokenLine);
+  auto last = std::lower_bound(first, text2.tokens.cend(), maxLines + 1, cmpTokenLine);
+  added.assign(first, last);
+  using namespace std::placeholders;
+  moveTokens(added, std::bind(uppNum, _1, maxNum));
+  rebindTokens(added, temp1.words);
+  restoreOrder(added);
+  restoreOrder(temp1.tokens);
+  size_t mid = temp1.tokens.size();
+  temp1.tokens.insert(temp1.tokens.end(), added.cbegin(), added.cend());
+  std::inplace_merge(temp1.tokens.begin(), temp1.tokens.begin() + mid, temp1.tokens.end(), cmpTokens);
   texts[newText] = std::move(temp1);
 }
 
@@ -532,7 +559,11 @@ void mozhegova::invertLines(std::istream & in, Texts & texts)
   Text & text = it->second;
   size_t maxLine = getMaxLineNum(text);
   using namespace std::placeholders;
-  std::for_each(text.begin(), text.end(), std::bind(subInvertLines, _1, maxLine));
+  std::for_each(text.words.begin(), text.words.end(), std::bind(subInvertLines, _1, maxLine));
+  moveTokens(text.tokens, std::bind(reverseLenNum, _1, maxLine));
+  std::reverse(text.tokens.begin(), text.tokens.end());
+  reverseRuns(text.tokens, isSameLine);
+  restoreOrder(text.tokens);
 }
 
 void mozhegova::invertWords(std::istream & in, Texts & texts)
@@ -547,11 +578,12 @@ void mozhegova::invertWords(std::istream & in, Texts & texts)
   Text & text = it->second;
   size_t maxLines = getMaxLineNum(text);
   size_t maxNum = getMaxNum(text);
-  for (size_t line = 1; line <= maxLines; ++line)
-  {
-    using namespace std::placeholders;
-    std::for_each(text.begin(), text.end(), std::bind(subInvertWords, _1, line, maxNum));
-  }
+  using namespace std::placeholders;
+  std::for_each(text.words.begin(), text.words.end(), std::bind(subInvertWords, _1, maxLines, maxNum));
+  moveTokens(text.tokens, std::bind(changeNum, _1, maxLines, maxNum));
+  reverseRuns(text.tokens, isSameLine);
+  reverseRuns(text.tokens, isSamePos);
+  restoreOrder(text.tokens);
 }
 
 void mozhegova::replaceWord(std::istream & in, Texts & texts)
@@ -564,13 +596,30 @@ void mozhegova::replaceWord(std::istream & in, Texts & texts)
     throw std::runtime_error("<INVALID COMMAND>");
   }
   Text & text = it->second;
-  auto wordIt = text.find(oldWord);
-  if (wordIt == text.end())
+  auto wordIt = text.words.find(oldWord);
+  if (wordIt == text.words.end())
   {
     throw std::runtime_error("<INVALID COMMAND>");
   }
-  text[newWord] = std::move(wordIt->second);
-  text.erase(wordIt);
+  Word & old = *wordIt;
+  auto newIt = text.words.find(newWord);
+  if (newIt != text.words.end())
+  {
+    using namespace std::placeholders;
+    auto iter = std::remove_if(text.tokens.begin(), text.tokens.end(), std::bind(isTokenOf, _1, &newIt->first));
+    text.tokens.erase(iter, text.tokens.end());
+  }
+  else
+  {
+    newIt = text.words.emplace(newWord, Xrefs()).first;
+  }
+  for (Token & token: text.tokens)
+  {
+    token.word = isTokenOf(token, &old.first) ? &newIt->first : token.word;
+  }
+  newIt->second = std::move(old.second);
+  text.words.erase(oldWord);
+  restoreOrder(text.tokens);
 }
 
 void mozhegova::save(std::istream & in, const Texts & texts)
@@ -618,11 +667,12 @@ void mozhegova::loadFile(const std::string & fileName, Texts & texts)
       while (file.peek() != '\n' && file >> word)
       {
         ++num;
-        currText[word].push_back({line, num});
+        addWord(currText, word, {line, num});
         ++j;
       }
       file.ignore();
     }
+    restoreOrder(currText.tokens);
   }
 }
 
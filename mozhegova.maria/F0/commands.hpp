@@ -9,7 +9,26 @@ namespace mozhegova
 {
   using WordPos = std::pair< size_t, size_t >;
   using Xrefs = std::vector< WordPos >;
-  using Text = std::unordered_map< std::string, Xrefs >;
+
+  struct Token
+  {
+    WordPos pos;
+    const std::string * word;
+  };
+
+  struct Text
+  {
+    std::unordered_map< std::string, Xrefs > words;
+    // every occurrence ordered by position and word, pointing at the keys of words
+    std::vector< Token > tokens;
+
+    Text() = default;
+    Text(const Text & other);
+    Text(Text && other) = default;
+    Text & operator=(const Text & other);
+    Text & operator=(Text && other) = default;
+  };
+
   using Texts = std::unordered_map< std::string, Text >;
 
   void generateLinks(std::istream & in, Texts & texts);
@@ -11,7 +11,7 @@
 int main(int argc, char * argv[])
 {
   using namespace mozhegova;
-  std::unordered_map< std::string, std::unordered_map< std::string, std::vector< std::pair< size_t, size_t > > > > texts;
+  Texts texts;
   if (argc == 2 && std::string(argv[1]) == "--help")
   {
     printHelp(std::cout);
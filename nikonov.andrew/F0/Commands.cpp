@@ -6,6 +6,77 @@
 #include <stdexcept>
 #include <iomanip>
 #include <sstream>
+#include <chrono>
+#include <thread>
+
+namespace {
+  // In block-wise encoding files every table is opened by this prefix and
+  // the block size.
+  const std::string blockPrefix = "block ";
+
+  unsigned poolSize()
+  {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  size_t readBlockSize(std::istream& in)
+  {
+    size_t blockSize = 0;
+    if (!(in >> blockSize)) {
+      return nikonov::HuffmanCore::defaultBlockSize;
+    }
+    if (blockSize == 0) {
+      throw std::runtime_error("ERROR: Invalid block size.");
+    }
+    return blockSize;
+  }
+
+  double megabytesPerSecond(size_t bytes, std::chrono::steady_clock::duration elapsed)
+  {
+    double seconds = std::chrono::duration< double >(elapsed).count();
+    return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+  }
+
+  nikonov::str encodeText(const nikonov::str& text, const nikonov::Encoding& encoding)
+  {
+    size_t blockSize = encoding.getBlockSize();
+    if (blockSize == 0) {
+      return nikonov::HuffmanCore::compress(text, encoding.getCodeTable());
+    }
+    if ((text.size() + blockSize - 1) / blockSize > encoding.getBlockCount()) {
+      throw std::runtime_error("ERROR: Text is longer than the encoding.");
+    }
+    nikonov::str compressed;
+    for (size_t i = 0; i * blockSize < text.size(); ++i) {
+      compressed += nikonov::HuffmanCore::compress(text.substr(i * blockSize, blockSize), encoding.getCodeTable(i));
+    }
+    return compressed;
+  }
+
+  nikonov::str decodeText(const nikonov::str& compressed, const nikonov::Encoding& encoding)
+  {
+    size_t blockSize = encoding.getBlockSize();
+    if (blockSize == 0) {
+      return nikonov::HuffmanCore::decompress(compressed, encoding.getReverseTable());
+    }
+    nikonov::str decompressed;
+    nikonov::str currentCode;
+    for (char bit : compressed) {
+      size_t block = decompressed.size() / blockSize;
+      if (block >= encoding.getBlockCount()) {
+        throw std::runtime_error("ERROR: Corrupted compressed data.");
+      }
+      currentCode += bit;
+      const auto& reverseCodes = encoding.getReverseTable(block);
+      auto it = reverseCodes.find(currentCode);
+      if (it != reverseCodes.end()) {
+        decompressed += it->second;
+        currentCode.clear();
+      }
+    }
+    return decompressed;
+  }
+}
 
 void nikonov::getCommands(std::map< str, std::function< void(Storage&, std::istream&, std::ostream&) > >& commands)
 {
@@ -34,12 +105,15 @@ void nikonov::compressText(Storage& storage, std::istream& in, std::ostream& out
   if (text->isCompressed()) {
     throw std::runtime_error("ERROR: Text already compressed.");
   }
-  auto codes = HuffmanCore::buildCodes(text->getOriginalContent());
-  str compressed = HuffmanCore::compress(text->getOriginalContent(), codes);
-  if (!storage.addEncoding(newEncodingId, codes, textId)) {
+  size_t blockSize = readBlockSize(in);
+  str container = HuffmanCore::compressBlocks(text->getOriginalContent(), blockSize, poolSize());
+  std::vector< CodeTable > codes = HuffmanCore::blockCodes(container);
+  bool added = codes.size() == 1 ? storage.addEncoding(newEncodingId, codes.front(), textId) :
+    storage.addBlockEncoding(newEncodingId, std::move(codes), blockSize, textId);
+  if (!added) {
     throw std::runtime_error("ERROR: Memory overflow.");
   }
-  if (!storage.addCompressedText(newTextId, text->getOriginalContent(), compressed, newEncodingId)) {
+  if (!storage.addBlockCompressedText(newTextId, text->getOriginalContent(), std::move(container), newEncodingId)) {
     throw std::runtime_error("ERROR: Memory overflow.");
   }
   out << "Text compressed successfully. Encoding ID: " << newEncodingId << std::endl;
@@ -56,14 +130,16 @@ void nikonov::decompressText(Storage& storage, std::istream& in, std::ostream& o
   if (!text->isCompressed()) {
     throw std::runtime_error("ERROR: Text isn't compressed.");
   }
-  Encoding* encoding = storage.getEncoding(text->getEncodingId());
-  if (encoding == nullptr) {
-    throw std::runtime_error("ERROR: Invalid encoding_id.");
+  str decompressed;
+  if (text->isBlockContainer()) {
+    decompressed = HuffmanCore::decompressBlocks(text->getCompressedContent(), poolSize());
+  } else {
+    Encoding* encoding = storage.getEncoding(text->getEncodingId());
+    if (encoding == nullptr) {
+      throw std::runtime_error("ERROR: Invalid encoding_id.");
+    }
+    decompressed = decodeText(text->getCompressedContent(), *encoding);
   }
-  str decompressed = HuffmanCore::decompress(
-    text->getCompressedContent(), 
-    encoding->getReverseTable()
-  );
   if (!storage.addText(newTextId, decompressed)) {
     throw std::runtime_error("ERROR: Memory overflow.");
   }
@@ -103,10 +179,7 @@ void nikonov::applyEncoding(Storage& storage, std::istream& in, std::ostream& ou
   if (encoding == nullptr) {
     throw std::runtime_error("ERROR: Invalid encoding_id.");
   }
-  str compressed = HuffmanCore::compress(
-    text->getOriginalContent(), 
-    encoding->getCodeTable()
-  );
+  str compressed = encodeText(text->getOriginalContent(), *encoding);
   if (!storage.addCompressedText(newTextId, text->getOriginalContent(), compressed, encodingId)) {
     throw std::runtime_error("ERROR: Memory overflow.");
   }
@@ -129,8 +202,8 @@ void nikonov::compareEncodings(Storage& storage, std::istream& in, std::ostream&
   if (encoding1 == nullptr || encoding2 == nullptr) {
     throw std::runtime_error("ERROR: Invalid encoding_id.");
   }
-  str compressed1 = HuffmanCore::compress(text->getOriginalContent(), encoding1->getCodeTable());
-  str compressed2 = HuffmanCore::compress(text->getOriginalContent(), encoding2->getCodeTable());
+  str compressed1 = encodeText(text->getOriginalContent(), *encoding1);
+  str compressed2 = encodeText(text->getOriginalContent(), *encoding2);
   double ratio1 = static_cast<double>(compressed1.size()) / static_cast<double>(text->getOriginalSizeBits());
   double ratio2 = static_cast<double>(compressed2.size()) / static_cast<double>(text->getOriginalSizeBits());
   out << "Encoding 1: " << compressed1.size() << " bits, compression ratio: " << ratio1 << std::endl;
@@ -145,10 +218,15 @@ void nikonov::showEncoding(Storage& storage, std::istream& in, std::ostream& out
   if (encoding == nullptr) {
     throw std::runtime_error("ERROR: Invalid encoding_id.");
   }
-  out << "Character | Code" << std::endl;
-  out << "----------|-----" << std::endl;
-  for (const auto& pair : encoding->getCodeTable()) {
-    out << " '" << pair.first << "'     | " << pair.second << std::endl;
+  for (size_t i = 0; i < encoding->getBlockCount(); ++i) {
+    if (encoding->getBlockSize() != 0) {
+      out << "Block " << i << " (" << encoding->getBlockSize() << " bytes):" << std::endl;
+    }
+    out << "Character | Code" << std::endl;
+    out << "----------|-----" << std::endl;
+    for (const auto& pair : encoding->getCodeTable(i)) {
+      out << " '" << pair.first << "'     | " << pair.second << std::endl;
+    }
   }
 }
 
@@ -184,14 +262,28 @@ void nikonov::testCompression(Storage& storage, std::istream& in, std::ostream&
   if (text->isCompressed()) {
     throw std::runtime_error("ERROR: Text already compressed.");
   }
-  auto codes = HuffmanCore::buildCodes(text->getOriginalContent());
-  str compressed = HuffmanCore::compress(text->getOriginalContent(), codes);
-  str decompressed = HuffmanCore::decompress(compressed, Encoding(codes).getReverseTable());
-  double ratio = static_cast<double>(compressed.size()) / static_cast<double>(text->getOriginalSizeBits());
+  size_t blockSize = readBlockSize(in);
+  const str& original = text->getOriginalContent();
+  auto start = std::chrono::steady_clock::now();
+  str container = HuffmanCore::compressBlocks(original, blockSize, poolSize());
+  auto compressed = std::chrono::steady_clock::now();
+  str decompressed = HuffmanCore::decompressBlocks(container, poolSize());
+  auto finished = std::chrono::steady_clock::now();
+  size_t compressedBits = container.size() * 8;
+  double ratio = static_cast<double>(compressedBits) / static_cast<double>(text->getOriginalSizeBits());
   out << "Original size: " << text->getOriginalSizeBits() << " bits" << std::endl;
-  out << "Compressed size: " << compressed.size() << " bits" << std::endl;
+  out << "Compressed size: " << compressedBits << " bits" << std::endl;
   out << "Compression ratio: " << ratio << std::endl;
-  out << "Decompression successful: " << (decompressed == text->getOriginalContent() ? "Yes" : "No") << std::endl;
+  out << "Compression speed: " << megabytesPerSecond(original.size(), compressed - start) << " MB/s" << std::endl;
+  out << "Decompression speed: " << megabytesPerSecond(original.size(), finished - compressed) << " MB/s" << std::endl;
+  std::vector< BlockStats > blocks = HuffmanCore::blockStats(container);
+  out << "Blocks: " << blocks.size() << " x " << blockSize << " bytes" << std::endl;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    double blockRatio = static_cast<double>(blocks[i].compressedBytes) / static_cast<double>(blocks[i].originalBytes);
+    out << "  Block " << i << ": " << blocks[i].originalBytes << " -> " << blocks[i].compressedBytes;
+    out << " bytes, ratio: " << blockRatio << std::endl;
+  }
+  out << "Decompression successful: " << (decompressed == original ? "Yes" : "No") << std::endl;
 }
 
 void nikonov::loadTextFromFile(Storage& storage, std::istream& in, std::ostream& out)
@@ -253,19 +345,34 @@ void nikonov::getEncodingFromFile(Storage& storage, std::istream& in, std::ostre
   if (!file.is_open()) {
     throw std::runtime_error("ERROR: File not found.");
   }
-  std::unordered_map< char, str > codes;
+  std::vector< CodeTable > codes(1);
+  size_t blockSize = 0;
   str line;
   while (std::getline(file, line)) {
+    if (line.compare(0, blockPrefix.size(), blockPrefix) == 0) {
+      size_t size = std::stoul(line.substr(blockPrefix.size()));
+      if (size == 0 || (blockSize != 0 && size != blockSize)) {
+        throw std::runtime_error("ERROR: Invalid file.");
+      }
+      if (blockSize == 0) {
+        codes.clear();
+      }
+      blockSize = size;
+      codes.emplace_back();
+      continue;
+    }
     if (line.empty()) continue;
     size_t space_pos = line.find(' ');
-    if (space_pos == str::npos) {
+    if (space_pos == str::npos || codes.empty()) {
       throw std::runtime_error("ERROR: Invalid file.");
     }
     char character = line[0];
     str code = line.substr(space_pos + 1);
-    codes[character] = code;
+    codes.back()[character] = code;
   }
-  if (!storage.addEncoding(encodingId, codes)) {
+  bool added = blockSize == 0 ? storage.addEncoding(encodingId, codes.front()) :
+    storage.addBlockEncoding(encodingId, std::move(codes), blockSize);
+  if (!added) {
     throw std::runtime_error("ERROR: Memory overflow.");
   }
   file.close();
@@ -284,8 +391,13 @@ void nikonov::uploadEncoding(Storage& storage, std::istream& in, std::ostream& o
   if (!file.is_open()) {
     throw std::runtime_error("ERROR: Writing has been denied.");
   }
-  for (const auto& pair : encoding->getCodeTable()) {
-    file << pair.first << " " << pair.second << std::endl;
+  for (size_t i = 0; i < encoding->getBlockCount(); ++i) {
+    if (encoding->getBlockSize() != 0) {
+      file << blockPrefix << encoding->getBlockSize() << std::endl;
+    }
+    for (const auto& pair : encoding->getCodeTable(i)) {
+      file << pair.first << " " << pair.second << std::endl;
+    }
   }
   file.close();
   out << "Encoding uploaded to file successfully." << std::endl;
@@ -1,11 +1,14 @@
 #include "DataStorage.hpp"
 #include <stdexcept>
+#include <utility>
 
-nikonov::Text::Text(const str& content, bool isCompressed, const str& encodingId, const str& compressedData):
+nikonov::Text::Text(const str& content, bool isCompressed, const str& encodingId, str compressedData,
+  bool isBlockContainer):
   originalContent_(content),
-  compressedContent_(compressedData),
+  compressedContent_(std::move(compressedData)),
   encodingId_(encodingId),
-  isCompressed_(isCompressed)
+  isCompressed_(isCompressed),
+  isBlockContainer_(isBlockContainer)
 {}
 
 const std::string& nikonov::Text::getOriginalContent() const
@@ -28,6 +31,11 @@ bool nikonov::Text::isCompressed() const
   return isCompressed_;
 }
 
+bool nikonov::Text::isBlockContainer() const
+{
+  return isBlockContainer_;
+}
+
 size_t nikonov::Text::getOriginalSizeBits() const
 {
   constexpr int sizeOfByte = 8;
@@ -36,31 +44,53 @@ size_t nikonov::Text::getOriginalSizeBits() const
 
 size_t nikonov::Text::getCompressedSizeBits() const
 {
-  return compressedContent_.size();
+  constexpr int sizeOfByte = 8;
+  return isBlockContainer_ ? compressedContent_.size() * sizeOfByte : compressedContent_.size();
 }
 
-nikonov::Encoding::Encoding(const std::unordered_map< char, str >& codeTable, const str& fromTextId):
-  codeTable_(codeTable),
+nikonov::Encoding::Encoding(const CodeTable& codeTable, const str& fromTextId):
+  Encoding(std::vector< CodeTable >{ codeTable }, 0, fromTextId)
+{}
+
+nikonov::Encoding::Encoding(std::vector< CodeTable > codeTables, size_t blockSize, const str& fromTextId):
+  codeTables_(std::move(codeTables)),
+  blockSize_(blockSize),
   fromTextId_(fromTextId)
 {
-  buildReverseTable();
+  if (codeTables_.empty()) {
+    codeTables_.emplace_back();
+  }
+  buildReverseTables();
 }
 
-void nikonov::Encoding::buildReverseTable()
+void nikonov::Encoding::buildReverseTables()
 {
-  for (const auto& pair : codeTable_) {
-    reverseTable_[pair.second] = pair.first;
+  reverseTables_.resize(codeTables_.size());
+  for (size_t i = 0; i < codeTables_.size(); ++i) {
+    for (const auto& pair : codeTables_[i]) {
+      reverseTables_[i][pair.second] = pair.first;
+    }
   }
 }
 
-const std::unordered_map< char, std::string >& nikonov::Encoding::getCodeTable() const
+size_t nikonov::Encoding::getBlockSize() const
 {
-  return codeTable_;
+  return blockSize_;
 }
 
-const std::unordered_map< std::string, char >& nikonov::Encoding::getReverseTable() const
+size_t nikonov::Encoding::getBlockCount() const
 {
-  return reverseTable_;
+  return codeTables_.size();
+}
+
+const nikonov::CodeTable& nikonov::Encoding::getCodeTable(size_t block) const
+{
+  return codeTables_.at(block);
+}
+
+const std::unordered_map< std::string, char >& nikonov::Encoding::getReverseTable(size_t block) const
+{
+  return reverseTables_.at(block);
 }
 
 const std::string& nikonov::Encoding::getFromTextId() const
@@ -86,6 +116,15 @@ bool nikonov::Storage::addCompressedText(const str& id, const str& original, con
   return true;
 }
 
+bool nikonov::Storage::addBlockCompressedText(const str& id, const str& original, str&& container, const str& encodingId)
+{
+  if (texts_.find(id) != texts_.end()) {
+    return false;
+  }
+  texts_[id] = std::make_unique< Text >(original, true, encodingId, std::move(container), true);
+  return true;
+}
+
 nikonov::Text* nikonov::Storage::getText(const str& id)
 {
   auto it = texts_.find(id);
@@ -100,7 +139,7 @@ bool nikonov::Storage::textExists(const str& id) const
   return texts_.find(id) != texts_.end();
 }
 
-bool nikonov::Storage::addEncoding(const str& id, const std::unordered_map< char, str >& codes, const str& textId)
+bool nikonov::Storage::addEncoding(const str& id, const CodeTable& codes, const str& textId)
 {
   if (encodings_.find(id) != encodings_.end()) {
     return false;
@@ -109,6 +148,16 @@ bool nikonov::Storage::addEncoding(const str& id, const std::unordered_map< char
   return true;
 }
 
+bool nikonov::Storage::addBlockEncoding(const str& id, std::vector< CodeTable > codes, size_t blockSize,
+  const str& textId)
+{
+  if (encodings_.find(id) != encodings_.end()) {
+    return false;
+  }
+  encodings_[id] = std::make_unique< Encoding >(std::move(codes), blockSize, textId);
+  return true;
+}
+
 nikonov::Encoding* nikonov::Storage::getEncoding(const str& id)
 {
   auto it = encodings_.find(id);
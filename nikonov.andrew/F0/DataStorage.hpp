@@ -3,16 +3,20 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace nikonov {
   using str = std::string;
+  using CodeTable = std::unordered_map< char, str >;
   class Text {
   public:
-    Text(const str& content, bool isCompressed = false, const str& encodingId = "", const str& compressedData = "");
+    Text(const str& content, bool isCompressed = false, const str& encodingId = "", str compressedData = "",
+      bool isBlockContainer = false);
     const str& getOriginalContent() const;
     const str& getCompressedContent() const;
     const str& getEncodingId() const;
     bool isCompressed() const;
+    bool isBlockContainer() const;
     size_t getOriginalSizeBits() const;
     size_t getCompressedSizeBits() const;
   private:
@@ -20,28 +24,37 @@ namespace nikonov {
     str compressedContent_;
     str encodingId_;
     bool isCompressed_;
+    bool isBlockContainer_;
   };
 
+  // A block size of zero means one code table for the whole text; otherwise
+  // table i encodes characters [i * blockSize, (i + 1) * blockSize).
   class Encoding {
   public:
-    Encoding(const std::unordered_map< char, str >& codeTable, const str& fromTextId = "");
-    const std::unordered_map< char, str >& getCodeTable() const;
-    const std::unordered_map< str, char >& getReverseTable() const;
+    Encoding(const CodeTable& codeTable, const str& fromTextId = "");
+    Encoding(std::vector< CodeTable > codeTables, size_t blockSize, const str& fromTextId = "");
+    size_t getBlockSize() const;
+    size_t getBlockCount() const;
+    const CodeTable& getCodeTable(size_t block = 0) const;
+    const std::unordered_map< str, char >& getReverseTable(size_t block = 0) const;
     const str& getFromTextId() const;
   private:
-    std::unordered_map< char, str > codeTable_;
-    std::unordered_map< str, char > reverseTable_;
+    std::vector< CodeTable > codeTables_;
+    std::vector< std::unordered_map< str, char > > reverseTables_;
+    size_t blockSize_;
     str fromTextId_;
-    void buildReverseTable();
+    void buildReverseTables();
   };
 
   class Storage {
   public:
     bool addText(const str& id, const str& content);
     bool addCompressedText(const str& id, const str& original, const str& compressed, const str& encodingId);
+    bool addBlockCompressedText(const str& id, const str& original, str&& container, const str& encodingId);
     Text* getText(const str& id);
     bool textExists(const str& id) const;
-    bool addEncoding(const str& id, const std::unordered_map< char, str >& codes, const str& textId = "");
+    bool addEncoding(const str& id, const CodeTable& codes, const str& textId = "");
+    bool addBlockEncoding(const str& id, std::vector< CodeTable > codes, size_t blockSize, const str& textId = "");
     Encoding* getEncoding(const str& id);
     bool encodingExists(const str& id) const;
   private:
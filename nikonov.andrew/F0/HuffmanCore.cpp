@@ -1,75 +1,304 @@
 #include "HuffmanCore.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
-nikonov::HuffmanNode::HuffmanNode(char c, int freq):
-  character(c),
-  frequency(freq),
-  left(nullptr),
-  right(nullptr)
-{}
+namespace {
+  const char containerMagic[] = { 'N', 'H', 'U', 'F' };
+  constexpr unsigned char containerVersion = 1;
+  constexpr size_t containerHeaderSize = sizeof(containerMagic) + 1 + 4 + 4;
 
-std::unordered_map< char, int > nikonov::HuffmanCore::calculateFrequency(const str& text)
-{
-  std::unordered_map< char, int > freq;
-  for (char c : text) {
-    freq[c]++;
+  using Lengths = std::array< unsigned char, 256 >;
+  using Codes = std::array< uint64_t, 256 >;
+
+  void putUint(nikonov::str& out, uint64_t value, size_t bytes)
+  {
+    for (size_t i = 0; i < bytes; ++i) {
+      out.push_back(static_cast< char >((value >> (8 * i)) & 0xFF));
+    }
   }
-  return freq;
-}
 
-void nikonov::HuffmanCore::buildCodeTable(HuffmanNode* node, const str& code, std::unordered_map< char, str >& codes)
-{
-  if (node->left == nullptr && node->right == nullptr) {
-    codes[node->character] = code;
-    return;
+  uint64_t getUint(const nikonov::str& in, size_t& pos, size_t bytes)
+  {
+    if (pos + bytes > in.size()) {
+      throw std::runtime_error("ERROR: Corrupted compressed data.");
+    }
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+      value |= static_cast< uint64_t >(static_cast< unsigned char >(in[pos + i])) << (8 * i);
+    }
+    pos += bytes;
+    return value;
   }
-  if (node->left != nullptr) {
-    buildCodeTable(node->left.get(), code + "0", codes);
+
+  std::vector< unsigned char > canonicalOrder(const Lengths& lengths)
+  {
+    std::vector< unsigned char > order;
+    for (size_t c = 0; c < lengths.size(); ++c) {
+      if (lengths[c]) {
+        order.push_back(static_cast< unsigned char >(c));
+      }
+    }
+    std::stable_sort(order.begin(), order.end(), [&lengths](unsigned char a, unsigned char b) {
+      return lengths[a] < lengths[b];
+    });
+    return order;
   }
-  if (node->right != nullptr) {
-    buildCodeTable(node->right.get(), code + "1", codes);
+
+  Codes canonicalCodes(const Lengths& lengths)
+  {
+    Codes codes{};
+    uint64_t code = 0;
+    unsigned prevLength = 0;
+    for (unsigned char c : canonicalOrder(lengths)) {
+      code <<= lengths[c] - prevLength;
+      prevLength = lengths[c];
+      codes[c] = code++;
+    }
+    return codes;
+  }
+
+  struct BitWriter {
+    char* out;
+    uint64_t acc = 0;
+    unsigned bits = 0;
+
+    void put(uint64_t code, unsigned length)
+    {
+      acc = (acc << length) | code;
+      bits += length;
+      while (bits >= 8) {
+        bits -= 8;
+        *out++ = static_cast< char >((acc >> bits) & 0xFF);
+      }
+    }
+    void flush()
+    {
+      if (bits) {
+        *out++ = static_cast< char >((acc << (8 - bits)) & 0xFF);
+        bits = 0;
+      }
+    }
+  };
+
+  struct BlockHeader {
+    size_t originalBytes;
+    Lengths lengths;
+    uint64_t payloadBits;
+    size_t payloadPos;
+  };
+
+  BlockHeader readBlockHeader(const nikonov::str& container, size_t& pos)
+  {
+    BlockHeader header{};
+    header.originalBytes = getUint(container, pos, 4);
+    size_t symbols = getUint(container, pos, 2);
+    for (size_t i = 0; i < symbols; ++i) {
+      unsigned char c = static_cast< unsigned char >(getUint(container, pos, 1));
+      header.lengths[c] = static_cast< unsigned char >(getUint(container, pos, 1));
+    }
+    header.payloadBits = getUint(container, pos, 8);
+    header.payloadPos = pos;
+    pos += (header.payloadBits + 7) / 8;
+    if (pos > container.size()) {
+      throw std::runtime_error("ERROR: Corrupted compressed data.");
+    }
+    return header;
+  }
+
+  size_t readContainerHeader(const nikonov::str& container)
+  {
+    if (container.size() < containerHeaderSize || !std::equal(containerMagic, containerMagic + 4, container.begin())) {
+      throw std::runtime_error("ERROR: Not a block container.");
+    }
+    size_t pos = sizeof(containerMagic);
+    if (getUint(container, pos, 1) != containerVersion) {
+      throw std::runtime_error("ERROR: Unsupported container version.");
+    }
+    getUint(container, pos, 4);
+    return pos;
+  }
+
+  std::vector< BlockHeader > readBlockHeaders(const nikonov::str& container)
+  {
+    size_t pos = readContainerHeader(container);
+    size_t blockCount = getUint(container, pos, 4);
+    std::vector< BlockHeader > headers;
+    headers.reserve(blockCount);
+    for (size_t i = 0; i < blockCount; ++i) {
+      headers.push_back(readBlockHeader(container, pos));
+    }
+    return headers;
+  }
+
+  void decodeBlock(const nikonov::str& container, const BlockHeader& header, char* out)
+  {
+    std::array< size_t, 65 > countByLength{};
+    for (unsigned char length : header.lengths) {
+      if (length > 64) {
+        throw std::runtime_error("ERROR: Corrupted compressed data.");
+      }
+      ++countByLength[length];
+    }
+    countByLength[0] = 0;
+    std::vector< unsigned char > symbols = canonicalOrder(header.lengths);
+
+    const unsigned char* payload = reinterpret_cast< const unsigned char* >(container.data() + header.payloadPos);
+    uint64_t bit = 0;
+    for (size_t produced = 0; produced < header.originalBytes; ++produced) {
+      uint64_t code = 0;
+      uint64_t first = 0;
+      size_t index = 0;
+      for (unsigned length = 1; ; ++length) {
+        if (length > 64 || bit >= header.payloadBits) {
+          throw std::runtime_error("ERROR: Corrupted compressed data.");
+        }
+        code |= (payload[bit / 8] >> (7 - bit % 8)) & 1;
+        ++bit;
+        size_t count = countByLength[length];
+        if (code - first < count) {
+          out[produced] = static_cast< char >(symbols[index + code - first]);
+          break;
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+      }
+    }
+  }
+
+  template< class Task >
+  void runOnPool(size_t tasks, unsigned threads, const Task& task)
+  {
+    std::atomic< size_t > next(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&]() {
+      for (size_t i = next++; i < tasks; i = next++) {
+        try {
+          task(i);
+        } catch (...) {
+          std::lock_guard< std::mutex > lock(errorMutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+    };
+    size_t workers = std::min< size_t >(std::max(threads, 1u), tasks);
+    std::vector< std::thread > pool;
+    for (size_t i = 1; i < workers; ++i) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    std::for_each(pool.begin(), pool.end(), std::mem_fn(&std::thread::join));
+    if (error) {
+      std::rethrow_exception(error);
+    }
   }
 }
 
-std::unordered_map< char, std::string > nikonov::HuffmanCore::buildCodes(const str& text)
+nikonov::HuffmanTree::HuffmanTree(const std::array< size_t, 256 >& freq)
 {
-  if (text.empty()) {
-    return {};
+  for (size_t c = 0; c < freq.size(); ++c) {
+    if (freq[c]) {
+      nodes_.push_back(HuffmanNode{ static_cast< unsigned char >(c), freq[c], -1, -1 });
+    }
+  }
+  if (nodes_.empty()) {
+    return;
   }
-  auto freq = calculateFrequency(text);
-  auto compare = [](const HuffmanNode* a, const HuffmanNode* b) {
-    return a->frequency > b->frequency;
+  nodes_.reserve(nodes_.size() * 2 - 1);
+  const std::vector< HuffmanNode >& nodes = nodes_;
+  auto compare = [&nodes](int a, int b) {
+    return nodes[a].frequency != nodes[b].frequency ? nodes[a].frequency > nodes[b].frequency : a > b;
   };
-  std::priority_queue< HuffmanNode*, std::vector< HuffmanNode* >, decltype(compare) > pq(compare);
-
-  for (const auto& pair : freq) {
-    pq.push(new HuffmanNode(pair.first, pair.second));
+  std::priority_queue< int, std::vector< int >, decltype(compare) > pq(compare);
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    pq.push(static_cast< int >(i));
   }
   while (pq.size() > 1) {
-    HuffmanNode* left = pq.top();
+    int left = pq.top();
     pq.pop();
-    HuffmanNode* right = pq.top();
+    int right = pq.top();
     pq.pop();
-    auto parent = new HuffmanNode('\0', left->frequency + right->frequency);
-    parent->left = std::unique_ptr< HuffmanNode >(left);
-    parent->right = std::unique_ptr< HuffmanNode >(right);
-    pq.push(parent);
+    nodes_.push_back(HuffmanNode{ '\0', nodes_[left].frequency + nodes_[right].frequency, left, right });
+    pq.push(static_cast< int >(nodes_.size() - 1));
   }
+}
 
-  HuffmanNode* root = pq.top();
-  pq.pop();
+bool nikonov::HuffmanTree::empty() const
+{
+  return nodes_.empty();
+}
 
-  std::unordered_map< char, str > codes;
-  if (freq.size() == 1) {
-    codes[root->character] = "0";
-  } else {
-    buildCodeTable(root, "", codes);
+std::array< unsigned char, 256 > nikonov::HuffmanTree::codeLengths() const
+{
+  std::array< unsigned char, 256 > lengths{};
+  if (nodes_.empty()) {
+    return lengths;
   }
+  std::vector< std::pair< int, unsigned char > > stack;
+  stack.emplace_back(static_cast< int >(nodes_.size() - 1), 0);
+  while (!stack.empty()) {
+    auto top = stack.back();
+    stack.pop_back();
+    const HuffmanNode& node = nodes_[top.first];
+    if (node.left < 0) {
+      lengths[node.character] = std::max< unsigned char >(top.second, 1);
+      continue;
+    }
+    stack.emplace_back(node.left, top.second + 1);
+    stack.emplace_back(node.right, top.second + 1);
+  }
+  return lengths;
+}
 
-  delete root;
+std::unordered_map< char, std::string > nikonov::HuffmanTree::codes() const
+{
+  std::unordered_map< char, str > codes;
+  if (nodes_.empty()) {
+    return codes;
+  }
+  std::vector< std::pair< int, str > > stack;
+  stack.emplace_back(static_cast< int >(nodes_.size() - 1), "");
+  while (!stack.empty()) {
+    auto top = std::move(stack.back());
+    stack.pop_back();
+    const HuffmanNode& node = nodes_[top.first];
+    if (node.left < 0) {
+      codes[static_cast< char >(node.character)] = top.second.empty() ? "0" : top.second;
+      continue;
+    }
+    stack.emplace_back(node.left, top.second + "0");
+    stack.emplace_back(node.right, top.second + "1");
+  }
   return codes;
 }
 
+std::array< size_t, 256 > nikonov::HuffmanCore::calculateFrequency(const char* begin, const char* end)
+{
+  std::array< size_t, 256 > freq{};
+  for (; begin != end; ++begin) {
+    freq[static_cast< unsigned char >(*begin)]++;
+  }
+  return freq;
+}
+
+std::unordered_map< char, std::string > nikonov::HuffmanCore::buildCodes(const str& text)
+{
+  if (text.empty()) {
+    return {};
+  }
+  return HuffmanTree(calculateFrequency(text.data(), text.data() + text.size())).codes();
+}
+
 std::string nikonov::HuffmanCore::compress(const str& text, const std::unordered_map< char, str >& codes)
 {
   str compressed;
@@ -92,3 +321,109 @@ std::string nikonov::HuffmanCore::decompress(const str& compressed, const std::u
   }
   return decompressed;
 }
+
+std::string nikonov::HuffmanCore::compressBlocks(const str& text, size_t blockSize, unsigned threads)
+{
+  if (blockSize == 0 || blockSize > 0xFFFFFFFFu) {
+    throw std::invalid_argument("ERROR: Invalid block size.");
+  }
+  size_t blockCount = (text.size() + blockSize - 1) / blockSize;
+  std::vector< str > blocks(blockCount);
+  runOnPool(blockCount, threads, [&](size_t i) {
+    const char* begin = text.data() + i * blockSize;
+    const char* end = text.data() + std::min(text.size(), (i + 1) * blockSize);
+    auto freq = calculateFrequency(begin, end);
+    Lengths lengths = HuffmanTree(freq).codeLengths();
+    Codes codes = canonicalCodes(lengths);
+
+    uint64_t payloadBits = 0;
+    size_t symbols = 0;
+    for (size_t c = 0; c < freq.size(); ++c) {
+      payloadBits += freq[c] * lengths[c];
+      symbols += lengths[c] ? 1 : 0;
+    }
+
+    str& block = blocks[i];
+    block.reserve(4 + 2 + symbols * 2 + 8 + (payloadBits + 7) / 8);
+    putUint(block, end - begin, 4);
+    putUint(block, symbols, 2);
+    for (size_t c = 0; c < lengths.size(); ++c) {
+      if (lengths[c]) {
+        putUint(block, c, 1);
+        putUint(block, lengths[c], 1);
+      }
+    }
+    putUint(block, payloadBits, 8);
+    size_t payloadPos = block.size();
+    block.resize(payloadPos + (payloadBits + 7) / 8);
+    BitWriter writer{ &block[0] + payloadPos };
+    for (const char* p = begin; p != end; ++p) {
+      unsigned char c = static_cast< unsigned char >(*p);
+      writer.put(codes[c], lengths[c]);
+    }
+    writer.flush();
+  });
+
+  str container(containerMagic, sizeof(containerMagic));
+  putUint(container, containerVersion, 1);
+  putUint(container, blockSize, 4);
+  putUint(container, blockCount, 4);
+  size_t total = container.size();
+  for (const str& block : blocks) {
+    total += block.size();
+  }
+  container.reserve(total);
+  for (const str& block : blocks) {
+    container += block;
+  }
+  return container;
+}
+
+std::string nikonov::HuffmanCore::decompressBlocks(const str& container, unsigned threads)
+{
+  std::vector< BlockHeader > headers = readBlockHeaders(container);
+  std::vector< size_t > offsets(headers.size() + 1, 0);
+  for (size_t i = 0; i < headers.size(); ++i) {
+    offsets[i + 1] = offsets[i] + headers[i].originalBytes;
+  }
+  str result(offsets.back(), '\0');
+  runOnPool(headers.size(), threads, [&](size_t i) {
+    decodeBlock(container, headers[i], &result[0] + offsets[i]);
+  });
+  return result;
+}
+
+std::vector< nikonov::BlockStats > nikonov::HuffmanCore::blockStats(const str& container)
+{
+  size_t pos = readContainerHeader(container);
+  size_t blockCount = getUint(container, pos, 4);
+  std::vector< BlockStats > stats;
+  stats.reserve(blockCount);
+  for (size_t i = 0; i < blockCount; ++i) {
+    size_t start = pos;
+    BlockHeader header = readBlockHeader(container, pos);
+    stats.push_back(BlockStats{ header.originalBytes, pos - start });
+  }
+  return stats;
+}
+
+std::vector< std::unordered_map< char, std::string > > nikonov::HuffmanCore::blockCodes(const str& container)
+{
+  std::vector< BlockHeader > headers = readBlockHeaders(container);
+  std::vector< std::unordered_map< char, str > > tables(headers.size());
+  for (size_t i = 0; i < headers.size(); ++i) {
+    const Lengths& lengths = headers[i].lengths;
+    Codes codes = canonicalCodes(lengths);
+    for (size_t c = 0; c < lengths.size(); ++c) {
+      if (!lengths[c]) {
+        continue;
+      }
+      str code;
+      for (unsigned bit = lengths[c]; bit > 0; --bit) {
+        code.push_back(((codes[c] >> (bit - 1)) & 1) ? '1' : '0');
+      }
+      tables[i][static_cast< char >(c)] = code;
+    }
+  }
+  return tables;
+}
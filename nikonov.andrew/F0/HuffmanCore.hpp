@@ -2,27 +2,47 @@
 #define HUFFMAN_CORE_HPP
 #include <string>
 #include <unordered_map>
-#include <memory>
-#include <queue>
+#include <array>
+#include <cstdint>
 #include <vector>
 namespace nikonov {
   using str = std::string;
   struct HuffmanNode {
-    char character;
-    int frequency;
-    std::unique_ptr< HuffmanNode > left;
-    std::unique_ptr< HuffmanNode > right;
-    HuffmanNode(char c, int freq);
+    unsigned char character;
+    size_t frequency;
+    int left;
+    int right;
+  };
+
+  class HuffmanTree {
+  public:
+    explicit HuffmanTree(const std::array< size_t, 256 >& freq);
+    bool empty() const;
+    std::array< unsigned char, 256 > codeLengths() const;
+    std::unordered_map< char, std::string > codes() const;
+  private:
+    std::vector< HuffmanNode > nodes_;
+  };
+
+  struct BlockStats {
+    size_t originalBytes;
+    size_t compressedBytes;
   };
 
   class HuffmanCore {
   public:
+    static constexpr size_t defaultBlockSize = 1 << 20;
+
     static std::unordered_map< char, std::string > buildCodes(const std::string& text);
     static std::string compress(const std::string& text, const std::unordered_map< char, std::string >& codes);
     static std::string decompress(const std::string& compressed, const std::unordered_map< std::string, char >& reverseCodes);
+
+    static std::string compressBlocks(const std::string& text, size_t blockSize, unsigned threads);
+    static std::string decompressBlocks(const std::string& container, unsigned threads);
+    static std::vector< BlockStats > blockStats(const std::string& container);
+    static std::vector< std::unordered_map< char, std::string > > blockCodes(const std::string& container);
   private:
-    static std::unordered_map< char, int > calculateFrequency(const std::string& text);
-    static void buildCodeTable(HuffmanNode* node, const std::string& code, std::unordered_map< char, std::string >& codes);
+    static std::array< size_t, 256 > calculateFrequency(const char* begin, const char* end);
   };
 }
 #endif
@@ -4,7 +4,10 @@
 #include <limits>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <set>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 
 namespace ohantsev
@@ -41,6 +44,8 @@ namespace ohantsev
     Way path(const Key& start, const Key& end) const;
     template <bool AllowCycles >
     std::vector< Way > nPaths(const Key& start, const Key& end, std::size_t k) const;
+    void prepareLandmarks(std::size_t count);
+    std::size_t landmarks() const noexcept;
 
   private:
     struct DSU;
@@ -49,15 +54,30 @@ namespace ohantsev
     struct EdgeCollector;
     struct EdgeProcessor;
     struct ConnectionRemover;
-    class DijkstraPathFinder;
-    template< bool AllowCycles >
-    class NPathsFinder;
+    struct Compact;
+    struct ShortestTree;
+    struct Landmarks;
+    class BidirectionalSearch;
+    class YenPathsFinder;
+    class WalksFinder;
+
+    static constexpr std::size_t infinity = std::numeric_limits< std::size_t >::max();
 
     GraphMap graph_;
+    mutable std::shared_ptr< const Compact > compact_;
+    std::shared_ptr< const Landmarks > landmarks_;
 
     std::vector< Edge > collectEdges() const;
+    const Compact& compact() const;
+    void invalidate() noexcept;
+    Way makeWay(const std::vector< std::size_t >& steps, std::size_t length) const;
+    std::vector< Way > kPaths(std::size_t start, std::size_t end, std::size_t k, std::true_type) const;
+    std::vector< Way > kPaths(std::size_t start, std::size_t end, std::size_t k, std::false_type) const;
   };
 
+  template< class Key, class Hash, class KeyEqual >
+  constexpr std::size_t Graph< Key, Hash, KeyEqual >::infinity;
+
   template< class Key, class Hash, class KeyEqual >
   Graph< Key, Hash, KeyEqual >::Graph(size_t capacity)
   {
@@ -67,6 +87,7 @@ namespace ohantsev
   template< class Key, class Hash, class KeyEqual >
   void Graph< Key, Hash, KeyEqual >::clear() noexcept
   {
+    invalidate();
     graph_.clear();
   }
 
@@ -79,7 +100,12 @@ namespace ohantsev
   template< class Key, class Hash, class KeyEqual >
   bool Graph< Key, Hash, KeyEqual >::insert(const Key& key)
   {
-    return graph_.emplace(key, ConnectionMap{}).second;
+    bool inserted = graph_.emplace(key, ConnectionMap{}).second;
+    if (inserted)
+    {
+      invalidate();
+    }
+    return inserted;
   }
 
   template< class Key, class Hash, class KeyEqual >
@@ -89,6 +115,7 @@ namespace ohantsev
     {
       return false;
     }
+    invalidate();
     bool success = graph_[from].emplace(to, weight).second;
     success &= graph_[to].emplace(from, weight).second;
     return success;
@@ -120,6 +147,7 @@ namespace ohantsev
     {
       return false;
     }
+    invalidate();
     return graph_.erase(iter->first);
   }
 
@@ -143,6 +171,7 @@ namespace ohantsev
     {
       return false;
     }
+    invalidate();
     auto& cnts = iter->second;
     std::for_each(cnts.begin(), cnts.end(), ConnectionRemover{ *this, key });
     return graph_.erase(key);
@@ -151,6 +180,7 @@ namespace ohantsev
   template< class Key, class Hash, class KeyEqual >
   bool Graph< Key, Hash, KeyEqual >::removeLink(const Key& first, const Key& second)
   {
+    invalidate();
     try
     {
       return graph_.at(first).erase(second) && graph_.at(second).erase(first);
@@ -362,129 +392,339 @@ namespace ohantsev
   }
 
   template< class Key, class Hash, class KeyEqual >
-  class Graph< Key, Hash, KeyEqual >::DijkstraPathFinder
+  struct Graph< Key, Hash, KeyEqual >::Compact
   {
-  public:
-    DijkstraPathFinder(const Graph& graph, const Key& start, const Key& end);
-    Way operator()();
-
-  private:
-    using Step = std::pair< Key, std::size_t >;
-    using Distances = std::pair< std::size_t, Key >;
-    struct InitDistance;
-    struct NeighborProcessor;
+    std::vector< Key > keys;
+    std::unordered_map< Key, std::size_t, Hash, KeyEqual > ids;
+    std::vector< std::size_t > offsets;
+    std::vector< std::size_t > targets;
+    std::vector< std::size_t > weights;
 
-    const Key& start_;
-    const Key& end_;
-    const Graph& graph_;
-    std::unordered_map< Key, std::size_t > distances_;
-    std::unordered_map< Key, Step > previous_;
-    std::priority_queue< Distances, std::vector< Distances >, std::greater< Distances > > queue_;
-
-    void pushNeighbors(const Key& key);
-    Way constructPath();
-    Way releasePath();
+    explicit Compact(const GraphMap& graph);
+    std::size_t size() const noexcept;
   };
 
   template< class Key, class Hash, class KeyEqual >
-  struct Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::InitDistance
+  Graph< Key, Hash, KeyEqual >::Compact::Compact(const GraphMap& graph)
   {
-    typename std::pair< Key, std::size_t > operator()(const typename GraphMap::value_type& pair)
+    keys.reserve(graph.size());
+    ids.reserve(graph.size());
+    for (auto iter = graph.cbegin(); iter != graph.cend(); ++iter)
     {
-      return std::make_pair(pair.first, std::numeric_limits< std::size_t >::max());
+      ids.emplace(iter->first, keys.size());
+      keys.push_back(iter->first);
     }
-  };
+    offsets.reserve(keys.size() + 1);
+    offsets.push_back(0);
+    for (auto iter = graph.cbegin(); iter != graph.cend(); ++iter)
+    {
+      for (auto cnt = iter->second.cbegin(); cnt != iter->second.cend(); ++cnt)
+      {
+        targets.push_back(ids.at(cnt->first));
+        weights.push_back(cnt->second);
+      }
+      offsets.push_back(targets.size());
+    }
+  }
 
   template< class Key, class Hash, class KeyEqual >
-  Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::DijkstraPathFinder(const Graph& graph, const Key& start,
-                                                                       const Key& end):
-    start_(start),
-    end_(end),
-    graph_(graph)
+  std::size_t Graph< Key, Hash, KeyEqual >::Compact::size() const noexcept
   {
-    std::transform(graph.graph_.cbegin(), graph.graph_.cend(), std::inserter(distances_, distances_.end()), InitDistance{});
-    distances_[start] = 0;
-    queue_.emplace(0, start);
+    return keys.size();
   }
 
   template< class Key, class Hash, class KeyEqual >
-  auto Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::operator()() -> Way
+  struct Graph< Key, Hash, KeyEqual >::ShortestTree
+  {
+    std::vector< std::size_t > distances;
+    std::vector< std::size_t > parents;
+
+    ShortestTree(const Compact& compact, std::size_t source);
+  };
+
+  template< class Key, class Hash, class KeyEqual >
+  Graph< Key, Hash, KeyEqual >::ShortestTree::ShortestTree(const Compact& compact, std::size_t source):
+    distances(compact.size(), infinity),
+    parents(compact.size(), infinity)
   {
-    return constructPath();
+    using Entry = std::pair< std::size_t, std::size_t >;
+    std::priority_queue< Entry, std::vector< Entry >, std::greater< Entry > > queue;
+    distances[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+      auto current = queue.top();
+      queue.pop();
+      std::size_t vertex = current.second;
+      if (current.first > distances[vertex])
+      {
+        continue;
+      }
+      for (std::size_t e = compact.offsets[vertex]; e < compact.offsets[vertex + 1]; ++e)
+      {
+        std::size_t next = compact.targets[e];
+        std::size_t newDistance = current.first + compact.weights[e];
+        if (newDistance < distances[next])
+        {
+          distances[next] = newDistance;
+          parents[next] = vertex;
+          queue.emplace(newDistance, next);
+        }
+      }
+    }
   }
 
   template< class Key, class Hash, class KeyEqual >
-  struct Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::NeighborProcessor
+  struct Graph< Key, Hash, KeyEqual >::Landmarks
   {
-    DijkstraPathFinder& finder;
-    const Key& currentKey;
-    std::size_t currentDistance;
+    std::vector< std::vector< std::size_t > > distances;
+
+    Landmarks(const Compact& compact, std::size_t count);
+    std::size_t bound(std::size_t from, std::size_t to) const noexcept;
+  };
 
-    void operator()(const typename ConnectionMap::value_type& cnt)
+  template< class Key, class Hash, class KeyEqual >
+  Graph< Key, Hash, KeyEqual >::Landmarks::Landmarks(const Compact& compact, std::size_t count)
+  {
+    if (compact.size() == 0)
     {
-      const Key& neighbor = cnt.first;
-      auto weight = cnt.second;
-      auto newDistance = currentDistance + weight;
+      return;
+    }
+    count = std::min(count, compact.size());
+    std::vector< std::size_t > nearest = ShortestTree{ compact, 0 }.distances;
+    while (distances.size() < count)
+    {
+      std::size_t farthest = std::max_element(nearest.begin(), nearest.end()) - nearest.begin();
+      distances.push_back(ShortestTree{ compact, farthest }.distances);
+      const auto& added = distances.back();
+      for (std::size_t i = 0; i < nearest.size(); ++i)
+      {
+        nearest[i] = std::min(nearest[i], added[i]);
+      }
+    }
+  }
 
-      if (newDistance < finder.distances_[neighbor])
+  template< class Key, class Hash, class KeyEqual >
+  std::size_t Graph< Key, Hash, KeyEqual >::Landmarks::bound(std::size_t from, std::size_t to) const noexcept
+  {
+    std::size_t result = 0;
+    for (auto iter = distances.cbegin(); iter != distances.cend(); ++iter)
+    {
+      std::size_t first = (*iter)[from];
+      std::size_t second = (*iter)[to];
+      if (first != infinity && second != infinity)
       {
-        finder.distances_[neighbor] = newDistance;
-        finder.previous_[neighbor] = { currentKey, weight };
-        finder.queue_.emplace(newDistance, neighbor);
+        result = std::max(result, first > second ? first - second : second - first);
       }
     }
+    return result;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto Graph< Key, Hash, KeyEqual >::compact() const -> const Compact&
+  {
+    if (!compact_)
+    {
+      compact_ = std::make_shared< const Compact >(graph_);
+    }
+    return *compact_;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  void Graph< Key, Hash, KeyEqual >::invalidate() noexcept
+  {
+    compact_.reset();
+    landmarks_.reset();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  void Graph< Key, Hash, KeyEqual >::prepareLandmarks(std::size_t count)
+  {
+    landmarks_ = count ? std::make_shared< const Landmarks >(compact(), count) : nullptr;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  std::size_t Graph< Key, Hash, KeyEqual >::landmarks() const noexcept
+  {
+    return landmarks_ ? landmarks_->distances.size() : 0;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto Graph< Key, Hash, KeyEqual >::makeWay(const std::vector< std::size_t >& steps, std::size_t length) const -> Way
+  {
+    Way way;
+    way.steps_.reserve(steps.size());
+    const auto& keys = compact().keys;
+    for (auto iter = steps.cbegin(); iter != steps.cend(); ++iter)
+    {
+      way.steps_.push_back(keys[*iter]);
+    }
+    way.length_ = length;
+    return way;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  class Graph< Key, Hash, KeyEqual >::BidirectionalSearch
+  {
+  public:
+    BidirectionalSearch(const Compact& compact, const Landmarks* landmarks, std::size_t start, std::size_t end);
+    std::vector< std::size_t > operator()();
+    std::size_t length() const noexcept;
+
+  private:
+    using Entry = std::pair< long long, std::size_t >;
+    using Queue = std::priority_queue< Entry, std::vector< Entry >, std::greater< Entry > >;
+    struct Side
+    {
+      std::vector< std::size_t > distances;
+      std::vector< std::size_t > parents;
+      std::vector< bool > settled;
+      Queue queue;
+      long long sign;
+    };
+
+    const Compact& compact_;
+    const Landmarks* landmarks_;
+    std::size_t start_;
+    std::size_t end_;
+    Side forward_;
+    Side backward_;
+    std::size_t best_;
+    std::size_t meeting_;
+
+    long long potential(std::size_t vertex) const noexcept;
+    long long key(const Side& side, std::size_t vertex) const noexcept;
+    void push(Side& side, std::size_t vertex);
+    bool dropStale(Side& side) const;
+    void expand(Side& side, const Side& other);
   };
 
   template< class Key, class Hash, class KeyEqual >
-  void Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::pushNeighbors(const Key& key)
+  Graph< Key, Hash, KeyEqual >::BidirectionalSearch::BidirectionalSearch(const Compact& compact,
+                                                                         const Landmarks* landmarks,
+                                                                         std::size_t start, std::size_t end):
+    compact_(compact),
+    landmarks_(landmarks),
+    start_(start),
+    end_(end),
+    forward_{ std::vector< std::size_t >(compact.size(), infinity), std::vector< std::size_t >(compact.size(), infinity),
+      std::vector< bool >(compact.size(), false), Queue{}, 1 },
+    backward_{ forward_.distances, forward_.parents, forward_.settled, Queue{}, -1 },
+    best_(start == end ? 0 : infinity),
+    meeting_(start)
   {
-    const auto& connections = graph_.graph_.at(key);
-    std::for_each(connections.begin(), connections.end(), NeighborProcessor{ *this, key, distances_[key] });
+    forward_.distances[start] = 0;
+    backward_.distances[end] = 0;
+    push(forward_, start);
+    push(backward_, end);
   }
 
   template< class Key, class Hash, class KeyEqual >
-  auto Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::constructPath() -> Way
+  long long Graph< Key, Hash, KeyEqual >::BidirectionalSearch::potential(std::size_t vertex) const noexcept
   {
-    while (!queue_.empty())
+    if (!landmarks_)
     {
-      auto current = queue_.top();
-      queue_.pop();
-      auto currentDistance = current.first;
-      const Key& currentKey = current.second;
-      if (currentDistance > distances_[currentKey])
+      return 0;
+    }
+    auto toEnd = static_cast< long long >(landmarks_->bound(vertex, end_));
+    auto fromStart = static_cast< long long >(landmarks_->bound(vertex, start_));
+    return toEnd - fromStart;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  long long Graph< Key, Hash, KeyEqual >::BidirectionalSearch::key(const Side& side, std::size_t vertex) const noexcept
+  {
+    return 2 * static_cast< long long >(side.distances[vertex]) + side.sign * potential(vertex);
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  void Graph< Key, Hash, KeyEqual >::BidirectionalSearch::push(Side& side, std::size_t vertex)
+  {
+    side.queue.emplace(key(side, vertex), vertex);
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  bool Graph< Key, Hash, KeyEqual >::BidirectionalSearch::dropStale(Side& side) const
+  {
+    while (!side.queue.empty())
+    {
+      const Entry& top = side.queue.top();
+      if (!side.settled[top.second] && top.first == key(side, top.second))
       {
-        continue;
+        return true;
+      }
+      side.queue.pop();
+    }
+    return false;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  void Graph< Key, Hash, KeyEqual >::BidirectionalSearch::expand(Side& side, const Side& other)
+  {
+    std::size_t vertex = side.queue.top().second;
+    side.queue.pop();
+    side.settled[vertex] = true;
+    for (std::size_t e = compact_.offsets[vertex]; e < compact_.offsets[vertex + 1]; ++e)
+    {
+      std::size_t next = compact_.targets[e];
+      std::size_t newDistance = side.distances[vertex] + compact_.weights[e];
+      if (!side.settled[next] && newDistance < side.distances[next])
+      {
+        side.distances[next] = newDistance;
+        side.parents[next] = vertex;
+        push(side, next);
       }
-      if (currentKey == end_)
+      if (other.distances[next] != infinity && side.distances[next] + other.distances[next] < best_)
       {
-        break;
+        best_ = side.distances[next] + other.distances[next];
+        meeting_ = next;
       }
-      pushNeighbors(currentKey);
     }
-    return releasePath();
   }
 
   template< class Key, class Hash, class KeyEqual >
-  auto Graph< Key, Hash, KeyEqual >::DijkstraPathFinder::releasePath() -> Way
+  auto Graph< Key, Hash, KeyEqual >::BidirectionalSearch::operator()() -> std::vector< std::size_t >
   {
-    if (distances_[end_] == std::numeric_limits< std::size_t >::max())
+    while (best_ != 0 && dropStale(forward_) && dropStale(backward_))
+    {
+      long long forwardTop = forward_.queue.top().first;
+      long long backwardTop = backward_.queue.top().first;
+      if (best_ != infinity && forwardTop + backwardTop >= 2 * static_cast< long long >(best_))
+      {
+        break;
+      }
+      if (forwardTop <= backwardTop)
+      {
+        expand(forward_, backward_);
+      }
+      else
+      {
+        expand(backward_, forward_);
+      }
+    }
+    if (best_ == infinity)
     {
       return {};
     }
-    Way path;
-    Key current = end_;
-    while (current != start_)
+    std::vector< std::size_t > steps;
+    for (std::size_t vertex = meeting_; vertex != start_; vertex = forward_.parents[vertex])
+    {
+      steps.push_back(vertex);
+    }
+    steps.push_back(start_);
+    std::reverse(steps.begin(), steps.end());
+    for (std::size_t vertex = meeting_; vertex != end_; )
     {
-      const auto& prevStep = previous_[current];
-      const Key& prev = prevStep.first;
-      auto weight = prevStep.second;
-      path.steps_.push_back(current);
-      path.length_ += weight;
-      current = prev;
+      vertex = backward_.parents[vertex];
+      steps.push_back(vertex);
     }
-    path.steps_.push_back(start_);
-    std::reverse(path.steps_.begin(), path.steps_.end());
-    return path;
+    return steps;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  std::size_t Graph< Key, Hash, KeyEqual >::BidirectionalSearch::length() const noexcept
+  {
+    return best_;
   }
 
   template< class Key, class Hash, class KeyEqual >
@@ -494,118 +734,338 @@ namespace ohantsev
     {
       throw std::invalid_argument("Key not found");
     }
-    return DijkstraPathFinder{ *this, start, end }();
+    const Compact& graph = compact();
+    BidirectionalSearch search{ graph, landmarks_.get(), graph.ids.at(start), graph.ids.at(end) };
+    auto steps = search();
+    if (steps.empty())
+    {
+      return {};
+    }
+    return makeWay(steps, search.length());
   }
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  class Graph< Key, Hash, KeyEqual >::NPathsFinder
+  class Graph< Key, Hash, KeyEqual >::YenPathsFinder
   {
   public:
-    NPathsFinder(const Graph& graph, const Key& start, const Key& end);
+    YenPathsFinder(const Graph& graph, std::size_t start, std::size_t end);
     std::vector< Way > operator()(std::size_t k);
 
   private:
-    struct NeighborConnector;
+    struct Candidate
+    {
+      std::vector< std::size_t > steps;
+      std::vector< std::size_t > prefix;
+      std::size_t deviation;
+
+      bool operator>(const Candidate& rhs) const noexcept;
+    };
+    using Entry = std::pair< std::size_t, std::size_t >;
 
     const Graph& graph_;
-    const Key& start_;
-    const Key& end_;
-    std::vector< Way > result;
-    std::priority_queue< Way, std::vector< Way >, std::greater< Way > > candidates;
-
-    void finishWayProcessing(const Way& current);
-    template< bool AC = AllowCycles >
-    std::enable_if_t< !AC >
-    connectNeighbor(const Way& current, const Key& neighbor, std::size_t weight);
-    template< bool AC = AllowCycles >
-    std::enable_if_t< AC >
-    connectNeighbor(const Way& current, const Key& neighbor, std::size_t weight);
-    void processNextPath();
+    const Compact& compact_;
+    std::size_t start_;
+    std::size_t end_;
+    ShortestTree toEnd_;
+    std::vector< Candidate > accepted_;
+    std::priority_queue< Candidate, std::vector< Candidate >, std::greater< Candidate > > candidates_;
+    std::set< std::vector< std::size_t > > known_;
+    std::vector< unsigned > blocked_;
+    std::vector< unsigned > visited_;
+    std::vector< std::size_t > distances_;
+    std::vector< std::size_t > parents_;
+    unsigned stamp_;
+
+    void addCandidate(const Candidate& root, std::size_t index, const std::vector< Entry >& tail);
+    bool treeTail(std::size_t spur, const std::vector< std::size_t >& bannedNext, std::vector< Entry >& tail) const;
+    bool searchTail(std::size_t spur, const std::vector< std::size_t >& bannedNext, std::vector< Entry >& tail);
+    void spurFrom(const Candidate& path, std::size_t index);
   };
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  Graph< Key, Hash, KeyEqual >::NPathsFinder< AllowCycles >::NPathsFinder(const Graph& graph,
-                                                                          const Key& start, const Key& end):
+  bool Graph< Key, Hash, KeyEqual >::YenPathsFinder::Candidate::operator>(const Candidate& rhs) const noexcept
+  {
+    return prefix.back() > rhs.prefix.back();
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  Graph< Key, Hash, KeyEqual >::YenPathsFinder::YenPathsFinder(const Graph& graph, std::size_t start, std::size_t end):
     graph_(graph),
+    compact_(graph.compact()),
     start_(start),
-    end_(end)
+    end_(end),
+    toEnd_(compact_, end),
+    blocked_(compact_.size(), 0),
+    visited_(compact_.size(), 0),
+    distances_(compact_.size(), infinity),
+    parents_(compact_.size(), infinity),
+    stamp_(0)
+  {}
+
+  template< class Key, class Hash, class KeyEqual >
+  bool Graph< Key, Hash, KeyEqual >::YenPathsFinder::treeTail(std::size_t spur,
+                                                              const std::vector< std::size_t >& bannedNext,
+                                                              std::vector< Entry >& tail) const
+  {
+    if (spur == end_ || toEnd_.distances[spur] == infinity)
+    {
+      return false;
+    }
+    std::size_t next = toEnd_.parents[spur];
+    if (std::find(bannedNext.begin(), bannedNext.end(), next) != bannedNext.end())
+    {
+      return false;
+    }
+    for (std::size_t vertex = next; ; vertex = toEnd_.parents[vertex])
+    {
+      if (blocked_[vertex] == stamp_)
+      {
+        return false;
+      }
+      tail.emplace_back(toEnd_.distances[spur] - toEnd_.distances[vertex], vertex);
+      if (vertex == end_)
+      {
+        return true;
+      }
+    }
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  bool Graph< Key, Hash, KeyEqual >::YenPathsFinder::searchTail(std::size_t spur,
+                                                                const std::vector< std::size_t >& bannedNext,
+                                                                std::vector< Entry >& tail)
   {
-    Way initialPath;
-    initialPath.steps_.push_back(start_);
-    initialPath.length_ = 0;
-    candidates.push(initialPath);
+    std::priority_queue< Entry, std::vector< Entry >, std::greater< Entry > > queue;
+    visited_[spur] = stamp_;
+    distances_[spur] = 0;
+    queue.emplace(toEnd_.distances[spur], spur);
+    while (!queue.empty())
+    {
+      auto current = queue.top();
+      queue.pop();
+      std::size_t vertex = current.second;
+      if (current.first != distances_[vertex] + toEnd_.distances[vertex])
+      {
+        continue;
+      }
+      if (vertex == end_)
+      {
+        for (; vertex != spur; vertex = parents_[vertex])
+        {
+          tail.emplace_back(distances_[vertex], vertex);
+        }
+        std::reverse(tail.begin(), tail.end());
+        return true;
+      }
+      for (std::size_t e = compact_.offsets[vertex]; e < compact_.offsets[vertex + 1]; ++e)
+      {
+        std::size_t next = compact_.targets[e];
+        if (blocked_[next] == stamp_ || next == spur || toEnd_.distances[next] == infinity)
+        {
+          continue;
+        }
+        if (vertex == spur && std::find(bannedNext.begin(), bannedNext.end(), next) != bannedNext.end())
+        {
+          continue;
+        }
+        std::size_t newDistance = distances_[vertex] + compact_.weights[e];
+        if (visited_[next] != stamp_ || newDistance < distances_[next])
+        {
+          visited_[next] = stamp_;
+          distances_[next] = newDistance;
+          parents_[next] = vertex;
+          queue.emplace(newDistance + toEnd_.distances[next], next);
+        }
+      }
+    }
+    return false;
   }
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  auto Graph< Key, Hash, KeyEqual >::NPathsFinder< AllowCycles >::operator()(std::size_t k) -> std::vector< Way >
+  void Graph< Key, Hash, KeyEqual >::YenPathsFinder::addCandidate(const Candidate& root, std::size_t index,
+                                                                  const std::vector< Entry >& tail)
   {
-    if (!graph_.contains(start_) || !graph_.contains(end_))
+    Candidate candidate;
+    candidate.steps.assign(root.steps.begin(), root.steps.begin() + index + 1);
+    candidate.prefix.assign(root.prefix.begin(), root.prefix.begin() + index + 1);
+    candidate.deviation = index;
+    std::size_t spurLength = root.prefix[index];
+    for (auto iter = tail.cbegin(); iter != tail.cend(); ++iter)
     {
-      throw std::invalid_argument("Key not found");
+      candidate.prefix.push_back(spurLength + iter->first);
+      candidate.steps.push_back(iter->second);
     }
-    while (!candidates.empty() && result.size() < k)
+    if (known_.insert(candidate.steps).second)
     {
-      processNextPath();
+      candidates_.push(std::move(candidate));
     }
-    return result;
   }
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  template< bool AC >
-  std::enable_if_t< !AC >
-  Graph< Key, Hash, KeyEqual >::NPathsFinder< AllowCycles >::connectNeighbor(const Way& current,
-                                                                             const Key& neighbor, std::size_t weight)
+  void Graph< Key, Hash, KeyEqual >::YenPathsFinder::spurFrom(const Candidate& path, std::size_t index)
   {
-    if (std::find(current.steps_.begin(), current.steps_.end(), neighbor) == current.steps_.end())
+    ++stamp_;
+    for (std::size_t i = 0; i < index; ++i)
+    {
+      blocked_[path.steps[i]] = stamp_;
+    }
+    std::vector< std::size_t > bannedNext;
+    for (auto iter = accepted_.cbegin(); iter != accepted_.cend(); ++iter)
     {
-      connectNeighbor< true >(current, neighbor, weight);
+      const auto& steps = iter->steps;
+      if (steps.size() > index + 1 && std::equal(path.steps.begin(), path.steps.begin() + index + 1, steps.begin()))
+      {
+        bannedNext.push_back(steps[index + 1]);
+      }
+    }
+    std::size_t spur = path.steps[index];
+    std::vector< Entry > tail;
+    if (treeTail(spur, bannedNext, tail))
+    {
+      addCandidate(path, index, tail);
+      return;
+    }
+    tail.clear();
+    if (searchTail(spur, bannedNext, tail))
+    {
+      addCandidate(path, index, tail);
     }
   }
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  template< bool AC >
-  std::enable_if_t< AC >
-  Graph< Key, Hash, KeyEqual >::NPathsFinder< AllowCycles >::connectNeighbor(const Way& current,
-                                                                             const Key& neighbor, std::size_t weight)
+  auto Graph< Key, Hash, KeyEqual >::YenPathsFinder::operator()(std::size_t k) -> std::vector< Way >
   {
-    Way newPath = current;
-    newPath.steps_.push_back(neighbor);
-    newPath.length_ += weight;
-    candidates.push(newPath);
+    std::vector< Way > result;
+    if (k == 0 || toEnd_.distances[start_] == infinity)
+    {
+      return result;
+    }
+    Candidate first{ { start_ }, { 0 }, 0 };
+    std::vector< Entry > tail;
+    ++stamp_;
+    if (start_ != end_ && treeTail(start_, {}, tail))
+    {
+      addCandidate(first, 0, tail);
+    }
+    while (result.size() < k && !candidates_.empty())
+    {
+      Candidate current = candidates_.top();
+      candidates_.pop();
+      result.push_back(graph_.makeWay(current.steps, current.prefix.back()));
+      accepted_.push_back(current);
+      if (result.size() == k)
+      {
+        break;
+      }
+      for (std::size_t i = current.deviation; i + 1 < current.steps.size(); ++i)
+      {
+        spurFrom(current, i);
+      }
+    }
+    return result;
   }
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  struct Graph< Key, Hash, KeyEqual >::NPathsFinder< AllowCycles >::NeighborConnector
+  class Graph< Key, Hash, KeyEqual >::WalksFinder
   {
-    NPathsFinder& finder;
-    const Way& current;
+  public:
+    WalksFinder(const Graph& graph, std::size_t start, std::size_t end);
+    std::vector< Way > operator()(std::size_t k);
 
-    void operator()(const typename ConnectionMap::value_type& neighbor)
+  private:
+    struct Label
     {
-      finder.connectNeighbor< AllowCycles >(current, neighbor.first, neighbor.second);
-    }
+      std::size_t vertex;
+      std::size_t parent;
+      std::size_t length;
+    };
+    using Entry = std::pair< std::size_t, std::size_t >;
+
+    const Graph& graph_;
+    const Compact& compact_;
+    std::size_t start_;
+    std::size_t end_;
+    ShortestTree toEnd_;
+    std::vector< Label > labels_;
+
+    Way releaseWay(std::size_t label) const;
   };
 
   template< class Key, class Hash, class KeyEqual >
-  template< bool AllowCycles >
-  void Graph< Key, Hash, KeyEqual >::NPathsFinder< AllowCycles >::processNextPath()
+  Graph< Key, Hash, KeyEqual >::WalksFinder::WalksFinder(const Graph& graph, std::size_t start, std::size_t end):
+    graph_(graph),
+    compact_(graph.compact()),
+    start_(start),
+    end_(end),
+    toEnd_(compact_, end)
+  {}
+
+  template< class Key, class Hash, class KeyEqual >
+  auto Graph< Key, Hash, KeyEqual >::WalksFinder::releaseWay(std::size_t label) const -> Way
   {
-    Way current = candidates.top();
-    candidates.pop();
-    Key lastKey = current.steps_.back();
-    if (lastKey == end_)
+    std::vector< std::size_t > steps;
+    std::size_t length = labels_[label].length;
+    for (; label != infinity; label = labels_[label].parent)
     {
-      result.push_back(current);
-      return;
+      steps.push_back(labels_[label].vertex);
+    }
+    std::reverse(steps.begin(), steps.end());
+    return graph_.makeWay(steps, length);
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto Graph< Key, Hash, KeyEqual >::WalksFinder::operator()(std::size_t k) -> std::vector< Way >
+  {
+    std::vector< Way > result;
+    if (k == 0 || toEnd_.distances[start_] == infinity)
+    {
+      return result;
+    }
+    std::vector< std::size_t > pops(compact_.size(), 0);
+    std::priority_queue< Entry, std::vector< Entry >, std::greater< Entry > > queue;
+    labels_.push_back(Label{ start_, infinity, 0 });
+    queue.emplace(toEnd_.distances[start_], 0);
+    while (!queue.empty() && result.size() < k)
+    {
+      std::size_t label = queue.top().second;
+      queue.pop();
+      Label current = labels_[label];
+      if (pops[current.vertex]++ >= k)
+      {
+        continue;
+      }
+      if (current.vertex == end_)
+      {
+        result.push_back(releaseWay(label));
+        continue;
+      }
+      for (std::size_t e = compact_.offsets[current.vertex]; e < compact_.offsets[current.vertex + 1]; ++e)
+      {
+        std::size_t next = compact_.targets[e];
+        if (toEnd_.distances[next] == infinity)
+        {
+          continue;
+        }
+        std::size_t length = current.length + compact_.weights[e];
+        queue.emplace(length + toEnd_.distances[next], labels_.size());
+        labels_.push_back(Label{ next, label, length });
+      }
     }
-    const auto& neighbors = graph_.graph_.at(lastKey);
-    std::for_each(neighbors.begin(), neighbors.end(), NeighborConnector{ *this, current });
+    return result;
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto Graph< Key, Hash, KeyEqual >::kPaths(std::size_t start, std::size_t end, std::size_t k,
+                                            std::true_type) const -> std::vector< Way >
+  {
+    return WalksFinder{ *this, start, end }(k);
+  }
+
+  template< class Key, class Hash, class KeyEqual >
+  auto Graph< Key, Hash, KeyEqual >::kPaths(std::size_t start, std::size_t end, std::size_t k,
+                                            std::false_type) const -> std::vector< Way >
+  {
+    return YenPathsFinder{ *this, start, end }(k);
   }
 
   template< class Key, class Hash, class KeyEqual >
@@ -616,7 +1076,8 @@ namespace ohantsev
     {
       return {};
     }
-    return NPathsFinder< AllowCycles >{ *this, start, end }(k);
+    const Compact& graph = compact();
+    return kPaths(graph.ids.at(start), graph.ids.at(end), k, std::integral_constant< bool, AllowCycles >{});
   }
 }
 #endif
@@ -21,6 +21,7 @@ ohantsev::NetworkApp::NetworkApp(map_type& networks, std::istream& in, std::ostr
   add("remove_loops", std::bind(removeLoops, std::ref(networks), std::ref(in)));
   add("remove_loops_new", std::bind(removeLoopsNew, std::ref(networks), std::ref(in)));
   add("distance", std::bind(distance, std::cref(networks), std::ref(in), std::ref(out)));
+  add("landmarks", std::bind(landmarks, std::ref(networks), std::ref(in), std::ref(out)));
   add("top_paths", std::bind(topPathsWithCycles, std::cref(networks), std::ref(in), std::ref(out)));
   add("top_paths_nocycles", std::bind(topPathsNoCycles, std::cref(networks), std::ref(in), std::ref(out)));
   add("merge", std::bind(merge, std::ref(networks), std::ref(in)));
@@ -305,6 +306,23 @@ void ohantsev::NetworkApp::distance(const map_type& networks, std::istream& in,
   }
 }
 
+void ohantsev::NetworkApp::landmarks(map_type& networks, std::istream& in, std::ostream& out)
+{
+  std::string net;
+  std::size_t count;
+  if (!(in >> net >> count))
+  {
+    throw std::invalid_argument("Invalid arguments");
+  }
+  auto iter = networks.find(net);
+  if (iter == networks.end())
+  {
+    throw std::invalid_argument("Network " + net + " not found");
+  }
+  iter->second.prepareLandmarks(count);
+  out << iter->second.landmarks() << " landmarks prepared\n";
+}
+
 std::ostream& ohantsev::operator<<(std::ostream& out, const Graph< std::string >::Way& way)
 {
   out << way.length_ << '\t';
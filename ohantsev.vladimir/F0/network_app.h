@@ -45,6 +45,7 @@ namespace ohantsev
     static void removeLoops(map_type& networks, std::istream& in);
     static void removeLoopsNew(map_type& networks, std::istream& in);
     static void distance(const map_type& networks, std::istream& in, std::ostream& out);
+    static void landmarks(map_type& networks, std::istream& in, std::ostream& out);
     template < bool AllowCycles >
     static void topPaths(const map_type& networks, std::istream& in, std::ostream& out);
     static void topPathsWithCycles(const map_type& networks, std::istream& in, std::ostream& out);
@@ -37,6 +37,17 @@ void rychkov::CParser::clear_program()
   stack_.push(&program_[0]);
   type_parser_.clear();
 }
+void rychkov::CParser::restore_program(std::vector< entities::Expression > program)
+{
+  program_ = std::move(program);
+  if (program_.empty())
+  {
+    program_.emplace_back();
+  }
+  stack_ = {};
+  stack_.push(&program_.back());
+  type_parser_.clear();
+}
 void rychkov::CParser::push_back(entities::Expression expr)
 {
   program_.push_back(std::move(expr));
@@ -61,6 +61,7 @@ namespace rychkov
     const TypeParser& next() const;
     void prepare_type();
     void clear_program();
+    void restore_program(std::vector< entities::Expression > program);
     void push_back(entities::Expression expr);
 
     void append(CParseContext& context, char c);
@@ -0,0 +1,26 @@
+#include "include_cache.hpp"
+
+const rychkov::PreprocessedHeader* rychkov::IncludeCache::find(const std::string& path,
+    const std::string& macro_state, const std::string& text)
+{
+  decltype(entries_)::const_iterator entry_p = entries_.find({path, macro_state});
+  if ((entry_p == entries_.cend()) || (entry_p->second.text != text))
+  {
+    misses_++;
+    return nullptr;
+  }
+  hits_++;
+  return &entry_p->second;
+}
+void rychkov::IncludeCache::store(const std::string& path, std::string macro_state, PreprocessedHeader header)
+{
+  entries_[{path, std::move(macro_state)}] = std::move(header);
+}
+size_t rychkov::IncludeCache::hits() const noexcept
+{
+  return hits_;
+}
+size_t rychkov::IncludeCache::misses() const noexcept
+{
+  return misses_;
+}
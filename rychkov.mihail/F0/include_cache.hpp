@@ -0,0 +1,68 @@
+#ifndef INCLUDE_CACHE_HPP
+#define INCLUDE_CACHE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <utility>
+
+#include "content.hpp"
+#include "compare.hpp"
+
+namespace rychkov
+{
+  struct SourceFrame
+  {
+    std::string file;
+    bool macro_expansion;
+    size_t line, symbol;
+    std::string last_line;
+  };
+  struct PreprocessedToken
+  {
+    enum Kind
+    {
+      SYMBOL,
+      NAME,
+      NUMBER,
+      STRING_LITERAL,
+      CHAR_LITERAL
+    };
+    Kind kind;
+    std::string value;
+    size_t symbol, source;
+  };
+  struct PreprocessedDiagnostic
+  {
+    std::string message;
+    size_t symbol, source;
+    size_t position;
+  };
+  struct PreprocessedHeader
+  {
+    std::string text;
+    std::vector< std::vector< SourceFrame > > sources;
+    std::vector< PreprocessedToken > tokens;
+    std::vector< PreprocessedDiagnostic > diagnostics;
+    std::set< Macro, NameCompare > macros;
+    std::vector< Macro > undefined;
+    bool empty_line = false;
+  };
+  class IncludeCache
+  {
+  public:
+    const PreprocessedHeader* find(const std::string& path, const std::string& macro_state,
+        const std::string& text);
+    void store(const std::string& path, std::string macro_state, PreprocessedHeader header);
+    size_t hits() const noexcept;
+    size_t misses() const noexcept;
+
+  private:
+    std::map< std::pair< std::string, std::string >, PreprocessedHeader > entries_;
+    size_t hits_ = 0, misses_ = 0;
+  };
+}
+
+#endif
@@ -80,6 +80,20 @@ const std::set< std::vector< rychkov::Operator >, rychkov::NameCompare > rychkov
       {{rychkov::Operator::BINARY, rychkov::Operator::ASSIGN, "=", true, true, true, 14}}
     };
 
+const std::array< rychkov::Lexer::operator_value, 256 > rychkov::Lexer::single_char_cases_ = make_single_char_cases();
+
+std::array< rychkov::Lexer::operator_value, 256 > rychkov::Lexer::make_single_char_cases()
+{
+  std::array< operator_value, 256 > result{};
+  for (const std::vector< Operator >& oper: cases)
+  {
+    if (oper[0].token.length() == 1)
+    {
+      result[static_cast< unsigned char >(oper[0].token[0])] = &oper;
+    }
+  }
+  return result;
+}
 void rychkov::Lexer::append_name(CParseContext& context, std::string name)
 {
   flush(context);
@@ -92,6 +106,7 @@ void rychkov::Lexer::append_name(CParseContext& context, std::string name)
     }
     else
     {
+      StageTimer timer{timing, &StageTimes::cparser};
       next->append(context, type_keyword_p->second);
     }
     return;
@@ -105,6 +120,7 @@ void rychkov::Lexer::append_name(CParseContext& context, std::string name)
     }
     else
     {
+      StageTimer timer{timing, &StageTimes::cparser};
       ((*next).*(keyword_p->second))(context);
     }
     return;
@@ -116,6 +132,7 @@ void rychkov::Lexer::append_name(CParseContext& context, std::string name)
   }
   else
   {
+    StageTimer timer{timing, &StageTimes::cparser};
     next->append(context, std::move(name));
   }
 }
@@ -201,6 +218,7 @@ void rychkov::Lexer::append_number(CParseContext& context, std::string name)
   }
   else
   {
+    StageTimer timer{timing, &StageTimes::cparser};
     next->append(context, lit);
   }
 }
@@ -236,6 +254,7 @@ void rychkov::Lexer::flush(CParseContext& context)
     }
     else
     {
+      StageTimer timer{timing, &StageTimes::cparser};
       next->append(context, lit);
     }
   }
@@ -247,6 +266,7 @@ void rychkov::Lexer::flush(CParseContext& context)
     }
     else
     {
+      StageTimer timer{timing, &StageTimes::cparser};
       next->append(context, *boost::variant2::get< operator_value >(buf_));
     }
   }
@@ -264,18 +284,23 @@ void rychkov::Lexer::append(CParseContext& context, char c)
 }
 void rychkov::Lexer::append_new(CParseContext& context, char c)
 {
-  decltype(cases)::const_iterator oper_p = cases.find(std::string{c});
-  if (oper_p != cases.end())
+  if (std::isspace(static_cast< unsigned char >(c)))
   {
-    buf_ = &*oper_p;
+    return;
   }
-  else if (!std::isspace(c))
+  operator_value oper = single_char_cases_[static_cast< unsigned char >(c)];
+  if (oper != nullptr)
+  {
+    buf_ = oper;
+  }
+  else
   {
     if (next == nullptr)
     {
       context.out << "<spec> " << c << '\n';
       return;
     }
+    StageTimer timer{timing, &StageTimes::cparser};
     next->append(context, c);
   }
 }
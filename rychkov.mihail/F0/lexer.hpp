@@ -6,12 +6,14 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <array>
 #include <boost/variant2.hpp>
 
 #include "content.hpp"
 #include "compare.hpp"
 #include "log.hpp"
 #include "cparser.hpp"
+#include "timing.hpp"
 
 namespace rychkov
 {
@@ -20,6 +22,7 @@ namespace rychkov
   public:
     static const std::set< std::vector< Operator >, NameCompare > cases;
     std::unique_ptr< CParser > next;
+    StageTimes* timing = nullptr;
 
     Lexer(std::unique_ptr< CParser > cparser = nullptr);
 
@@ -32,6 +35,9 @@ namespace rychkov
 
   private:
     using operator_value = const std::vector< Operator >*;
+    static const std::array< operator_value, 256 > single_char_cases_;
+
+    static std::array< operator_value, 256 > make_single_char_cases();
 
     const std::map< std::string, CParser::TypeKeyword > type_keywords_;
     const std::map< std::string, void(CParser::*)(CParseContext&) > keywords_;
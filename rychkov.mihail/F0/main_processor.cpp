@@ -6,6 +6,7 @@
 #include <cctype>
 #include <utility>
 #include <algorithm>
+#include <iterator>
 
 rychkov::Parser::map_type< rychkov::ParserContext, rychkov::MainProcessor > rychkov::MainProcessor::call_map = {
       {"save", &rychkov::MainProcessor::save},
@@ -26,20 +27,38 @@ rychkov::Parser::map_type< rychkov::ParserContext, rychkov::MainProcessor > rych
     };
 
 rychkov::ParseCell::ParseCell(CParseContext context, Stage last_stage,
-    std::vector< std::string > include_dirs):
+    std::vector< std::string > include_dirs, std::shared_ptr< IncludeCache > include_cache):
   base_context{std::move(context)},
   preproc{std::unique_ptr< Lexer >{last_stage == PREPROCESSOR ? nullptr : new Lexer
         {std::unique_ptr< CParser >{last_stage != CPARSER ? nullptr : new CParser{}}}},
       std::move(include_dirs)}
-{}
-bool rychkov::ParseCell::parse(std::istream& in)
 {
-  std::stringstream cache_stream;
-  cache_stream << in.rdbuf();
-  cache = cache_stream.str();
-  preproc.parse(base_context, cache_stream);
+  preproc.include_cache = std::move(include_cache);
+}
+bool rychkov::ParseCell::parse(std::istream& in, StageTimes* times)
+{
+  cache.assign(std::istreambuf_iterator< char >{in}, std::istreambuf_iterator< char >{});
+  preproc.timing = times;
+  if (preproc.next != nullptr)
+  {
+    preproc.next->timing = times;
+  }
+  {
+    StageTimer timer{times, &StageTimes::total};
+    preproc.parse(base_context, cache);
+  }
+  preproc.timing = nullptr;
+  if (preproc.next != nullptr)
+  {
+    preproc.next->timing = nullptr;
+  }
   return base_context.nerrors == 0;
 }
+void rychkov::MainProcessor::print_times(std::ostream& out, const StageTimes& times) const
+{
+  out << "<--TIME: " << times << "; includes: " << include_cache_->hits() << " cached, ";
+  out << include_cache_->misses() << " parsed-->\n";
+}
 
 bool rychkov::MainProcessor::parse(ParserContext& context)
 {
@@ -54,14 +73,16 @@ bool rychkov::MainProcessor::parse(ParserContext& context)
     context.err << "failed to open file\n";
     return true;
   }
-  ParseCell cell = {{context.out, context.err, filename}, last_stage_, include_dirs_};
+  ParseCell cell = {{context.out, context.err, filename}, last_stage_, include_dirs_, include_cache_};
   context.out << "<--PARSE: \"" << filename << "\"-->\n";
-  if (!cell.parse(in))
+  StageTimes times;
+  if (!cell.parse(in, &times))
   {
     context.err << "failed to parse file \"" << filename << "\" - stopping\n";
     return true;
   }
   context.out << "<--DONE-->\n";
+  print_times(context.out, times);
   parsed_.erase(filename);
   parsed_.emplace(filename, std::move(cell));
   return true;
@@ -73,6 +94,7 @@ bool rychkov::MainProcessor::reload(ParserContext& context)
     return false;
   }
   std::map< std::string, ParseCell > new_parsed;
+  StageTimes times;
   for (const std::pair< const std::string, ParseCell >& file: parsed_)
   {
     if (!file.second.real_file)
@@ -85,11 +107,11 @@ bool rychkov::MainProcessor::reload(ParserContext& context)
       context.err << "failed to reopen source file: \"" << file.first << "\"\n";
     }
     std::pair< decltype(new_parsed)::iterator, bool > cell_p = new_parsed.emplace(file.first,
-          ParseCell{{context.out, context.err, file.first}, last_stage_, include_dirs_});
+          ParseCell{{context.out, context.err, file.first}, last_stage_, include_dirs_, include_cache_});
     if (cell_p.second)
     {
       context.out << "<--PARSE: \"" << file.first << "\"-->\n";
-      if (!cell_p.first->second.parse(in))
+      if (!cell_p.first->second.parse(in, &times))
       {
         context.err << "failed to parse file \"" << file.first << "\" - stopping\n";
         return true;
@@ -97,6 +119,7 @@ bool rychkov::MainProcessor::reload(ParserContext& context)
     }
   }
   context.out << "<--DONE-->\n";
+  print_times(context.out, times);
   parsed_ = std::move(new_parsed);
   generated_files = 0;
   return true;
@@ -104,7 +127,7 @@ bool rychkov::MainProcessor::reload(ParserContext& context)
 bool rychkov::MainProcessor::parse_after(ParserContext& context)
 {
   std::string generated_name = "untitled_" + std::to_string(generated_files + 1);
-  ParseCell cell = {{context.out, context.err, generated_name}, last_stage_, include_dirs_};
+  ParseCell cell = {{context.out, context.err, generated_name}, last_stage_, include_dirs_, include_cache_};
   cell.real_file = false;
   if (!eol(context.in))
   {
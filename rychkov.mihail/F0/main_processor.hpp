@@ -5,11 +5,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 #include <parser.hpp>
 
 #include "log.hpp"
 #include "preprocessor.hpp"
+#include "include_cache.hpp"
+#include "timing.hpp"
 
 namespace rychkov
 {
@@ -21,8 +24,9 @@ namespace rychkov
   };
   struct ParseCell
   {
-    ParseCell(CParseContext context, Stage last_stage, std::vector< std::string > include_dirs);
-    bool parse(std::istream& in);
+    ParseCell(CParseContext context, Stage last_stage, std::vector< std::string > include_dirs,
+        std::shared_ptr< IncludeCache > include_cache = nullptr);
+    bool parse(std::istream& in, StageTimes* times = nullptr);
     CParseContext base_context;
     Preprocessor preproc;
     bool real_file = true;
@@ -41,6 +45,7 @@ namespace rychkov
     bool save(std::ostream& err, std::string filename) const;
 
     bool init(ParserContext& context, int argc, char** argv);
+    void print_times(std::ostream& out, const StageTimes& times) const;
     bool save(ParserContext& context);
     bool load(ParserContext& context);
     bool reload(ParserContext& context);
@@ -63,8 +68,14 @@ namespace rychkov
     Stage last_stage_ = CPARSER;
     std::vector< std::string > include_dirs_;
     std::map< std::string, ParseCell > parsed_;
-    std::string save_file_ = "save.json";
+    std::shared_ptr< IncludeCache > include_cache_ = std::make_shared< IncludeCache >();
+    std::string save_file_ = "save.snap";
     size_t generated_files = 0;
+
+    bool save_json(std::ostream& out) const;
+    bool save_snapshot(std::ostream& out) const;
+    bool load_json(std::ostream& out, std::ostream& err, std::istream& in);
+    bool load_snapshot(std::ostream& out, std::ostream& err, std::istream& in);
   };
 }
 
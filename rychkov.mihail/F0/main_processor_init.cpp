@@ -133,7 +133,7 @@ bool rychkov::MainProcessor::parse(CParseContext file_context, bool overwrite)
     parsed_.erase(file_context.file);
   }
   std::pair< decltype(parsed_)::iterator, bool > cell = parsed_.emplace(file_context.file,
-    ParseCell{file_context, last_stage_, include_dirs_});
+    ParseCell{file_context, last_stage_, include_dirs_, include_cache_});
   if (!cell.second)
   {
     return true;
@@ -1,7 +1,6 @@
 #include "main_processor.hpp"
 
 #include <iostream>
-#include <fstream>
 #include <sstream>
 #include <iterator>
 #include <utility>
@@ -38,15 +37,11 @@ namespace rychkov
   };
 }
 
-bool rychkov::MainProcessor::load(std::ostream& out, std::ostream& err, std::string filename)
+bool rychkov::MainProcessor::load_json(std::ostream& out, std::ostream& err, std::istream& in)
 {
-  std::ifstream in(filename);
-  if (!in)
-  {
-    err << "failed to open save file on read - \"" << filename << "\"\n";
-    return false;
-  }
+  StageTimes::clock::time_point start = StageTimes::clock::now();
   boost::json::value doc = boost::json::parse(in);
+  StageTimes::clock::time_point read = StageTimes::clock::now();
   std::map< std::string, ParseCell > new_parsed;
   size_t ngenerated = 0;
   for (const boost::json::object::value_type& file: doc.as_object())
@@ -85,6 +80,9 @@ bool rychkov::MainProcessor::load(std::ostream& out, std::ostream& err, std::str
   }
   parsed_ = std::move(new_parsed);
   generated_files = ngenerated;
+  StageTimes::clock::time_point restored = StageTimes::clock::now();
+  out << "<--TIME: read " << milliseconds(read - start) << " ms, ";
+  out << "restore " << milliseconds(restored - read) << " ms-->\n";
   return true;
 }
 rychkov::Macro rychkov::Loader::as_macro(const boost::json::value& val)
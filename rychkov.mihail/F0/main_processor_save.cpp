@@ -1,6 +1,6 @@
 #include "main_processor.hpp"
 
-#include <fstream>
+#include <ostream>
 #include <sstream>
 #include <algorithm>
 #include <iterator>
@@ -32,14 +32,8 @@ namespace rychkov
   };
 }
 
-bool rychkov::MainProcessor::save(std::ostream& err, std::string filename) const
+bool rychkov::MainProcessor::save_json(std::ostream& out) const
 {
-  std::ofstream out(filename);
-  if (!out)
-  {
-    err << "failed to open save file on write - \"" << filename << "\"\n";
-    return false;
-  }
   boost::json::object doc;
   for (const std::pair< const std::string, ParseCell >& file: parsed_)
   {
@@ -0,0 +1,75 @@
+#include "main_processor.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include "snapshot.hpp"
+
+namespace
+{
+  bool is_json_name(const std::string& filename)
+  {
+    static const std::string ext = ".json";
+    return (filename.size() >= ext.size()) && (filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0);
+  }
+}
+
+bool rychkov::MainProcessor::save(std::ostream& err, std::string filename) const
+{
+  bool json = is_json_name(filename);
+  std::ofstream out(filename, json ? std::ios::out : std::ios::out | std::ios::binary);
+  if (!out)
+  {
+    err << "failed to open save file on write - \"" << filename << "\"\n";
+    return false;
+  }
+  return json ? save_json(out) : save_snapshot(out);
+}
+bool rychkov::MainProcessor::load(std::ostream& out, std::ostream& err, std::string filename)
+{
+  std::ifstream in(filename, std::ios::in | std::ios::binary);
+  if (!in)
+  {
+    err << "failed to open save file on read - \"" << filename << "\"\n";
+    return false;
+  }
+  return SnapshotReader::is_snapshot(in) ? load_snapshot(out, err, in) : load_json(out, err, in);
+}
+
+bool rychkov::MainProcessor::save_snapshot(std::ostream& out) const
+{
+  SnapshotWriter writer;
+  for (const std::pair< const std::string, ParseCell >& file: parsed_)
+  {
+    writer.add_file(file.first, file.second);
+  }
+  writer.write(out);
+  return out.good();
+}
+bool rychkov::MainProcessor::load_snapshot(std::ostream& out, std::ostream& err, std::istream& in)
+{
+  StageTimes::clock::time_point start = StageTimes::clock::now();
+  SnapshotReader reader{std::string{std::istreambuf_iterator< char >{in}, std::istreambuf_iterator< char >{}}};
+  StageTimes::clock::time_point read = StageTimes::clock::now();
+  std::map< std::string, ParseCell > new_parsed;
+  size_t ngenerated = 0;
+  for (size_t i = 0; i < reader.size(); i++)
+  {
+    const std::string& filename = reader.filename(i);
+    std::pair< decltype(new_parsed)::iterator, bool > cell_p = new_parsed.emplace(filename,
+          ParseCell{{out, err, filename}, last_stage_, include_dirs_, include_cache_});
+    if (cell_p.second)
+    {
+      out << "<--LOAD: \"" << filename << "\"-->\n";
+      reader.read_file(i, cell_p.first->second);
+      ngenerated += !cell_p.first->second.real_file;
+    }
+  }
+  parsed_ = std::move(new_parsed);
+  generated_files = ngenerated;
+  StageTimes::clock::time_point restored = StageTimes::clock::now();
+  out << "<--TIME: read " << milliseconds(read - start) << " ms, ";
+  out << "restore " << milliseconds(restored - read) << " ms-->\n";
+  return true;
+}
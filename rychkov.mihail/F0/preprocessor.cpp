@@ -4,6 +4,8 @@
 #include <sstream>
 #include <cctype>
 #include <utility>
+#include <iterator>
+#include <algorithm>
 #include "lexer.hpp"
 
 rychkov::Preprocessor::Preprocessor():
@@ -47,15 +49,48 @@ void rychkov::Preprocessor::flush(CParseContext& context, char c)
   }
   else if (!skip_all())
   {
-    if (next == nullptr)
-    {
-      context.out << c;
-    }
-    else
-    {
-      next->append(context, c);
-    }
+    deliver(context, PreprocessedToken::SYMBOL, std::string(1, c));
+  }
+}
+void rychkov::Preprocessor::deliver(CParseContext& context, PreprocessedToken::Kind kind, std::string value)
+{
+  for (Recording* recording: recordings_)
+  {
+    recording->header.tokens.push_back({kind, value, context.symbol, recording->source(context)});
+  }
+  if (next == nullptr)
+  {
+    context.out << value;
+    return;
   }
+  StageTimer timer{timing, &StageTimes::lexer};
+  switch (kind)
+  {
+  case PreprocessedToken::SYMBOL:
+    next->append(context, value.front());
+    break;
+  case PreprocessedToken::NAME:
+    next->append_name(context, std::move(value));
+    break;
+  case PreprocessedToken::NUMBER:
+    next->append_number(context, std::move(value));
+    break;
+  case PreprocessedToken::STRING_LITERAL:
+    next->append_string_literal(context, std::move(value));
+    break;
+  case PreprocessedToken::CHAR_LITERAL:
+    next->append_char_literal(context, std::move(value));
+    break;
+  }
+}
+void rychkov::Preprocessor::log(CParseContext& context, std::string message)
+{
+  for (Recording* recording: recordings_)
+  {
+    PreprocessedHeader& header = recording->header;
+    header.diagnostics.push_back({message, context.symbol, recording->source(context), header.tokens.size()});
+  }
+  rychkov::log(context, std::move(message));
 }
 void rychkov::Preprocessor::flush_buf(CParseContext& context)
 {
@@ -122,36 +157,26 @@ void rychkov::Preprocessor::flush_buf(CParseContext& context)
       }
       if (!skip_all())
       {
-        if (next == nullptr)
+        switch (prev)
         {
+        case rychkov::Preprocessor::STRING_LITERAL:
+          deliver(context, PreprocessedToken::STRING_LITERAL, buf_);
+          break;
+        case rychkov::Preprocessor::CHAR_LITERAL:
+          deliver(context, PreprocessedToken::CHAR_LITERAL, buf_);
+          break;
+        case rychkov::Preprocessor::NAME:
+          deliver(context, PreprocessedToken::NAME, buf_);
+          break;
+        case rychkov::Preprocessor::NUMBER:
+          deliver(context, PreprocessedToken::NUMBER, buf_);
+          break;
+        default:
           for (char c: buf_)
           {
             flush(context, c);
           }
-        }
-        else
-        {
-          switch (prev)
-          {
-          case rychkov::Preprocessor::STRING_LITERAL:
-            next->append_string_literal(context, buf_);
-            break;
-          case rychkov::Preprocessor::CHAR_LITERAL:
-            next->append_char_literal(context, buf_);
-            break;
-          case rychkov::Preprocessor::NAME:
-            next->append_name(context, buf_);
-            break;
-          case rychkov::Preprocessor::NUMBER:
-            next->append_number(context, buf_);
-            break;
-          default:
-            for (char c: buf_)
-            {
-              flush(context, c);
-            }
-            break;
-          }
+          break;
         }
       }
     }
@@ -165,6 +190,7 @@ void rychkov::Preprocessor::flush(CParseContext& context)
   flush_buf(context);
   if (next != nullptr)
   {
+    StageTimer timer{timing, &StageTimes::lexer};
     next->flush(context);
   }
   if (!conditional_pairs_.empty())
@@ -174,28 +200,117 @@ void rychkov::Preprocessor::flush(CParseContext& context)
 }
 void rychkov::Preprocessor::parse(CParseContext& context, std::istream& in, bool need_flush)
 {
-  bool not_first_line = false;
-  while (in.good())
+  parse(context, std::string{std::istreambuf_iterator< char >{in}, std::istreambuf_iterator< char >{}}, need_flush);
+}
+void rychkov::Preprocessor::parse(CParseContext& context, const std::string& text, bool need_flush)
+{
+  std::string::size_type from = 0;
+  while (true)
   {
-    if (not_first_line)
-    {
-      append(context, '\n');
-      context.line++;
-    }
-    not_first_line = true;
+    std::string::size_type to = text.find('\n', from);
     context.symbol = 0;
-    std::getline(in, context.last_line);
-    for (char c: context.last_line)
+    context.last_line.assign(text, from, to == std::string::npos ? std::string::npos : to - from);
+    append_line(context);
+    if (to == std::string::npos)
     {
-      append(context, c);
-      context.symbol++;
+      break;
     }
+    append(context, '\n');
+    context.line++;
+    from = to + 1;
   }
   if (need_flush)
   {
     flush(context);
   }
 }
+void rychkov::Preprocessor::append_line(CParseContext& context)
+{
+  const std::string& line = context.last_line;
+  std::string::size_type pos = 0;
+  while (pos < line.length())
+  {
+    size_t run = append_run(line, pos);
+    if (run == 0)
+    {
+      append(context, line[pos]);
+      run = 1;
+    }
+    pos += run;
+    context.symbol += run;
+  }
+}
+size_t rychkov::Preprocessor::append_run(const std::string& line, std::string::size_type pos)
+{
+  struct is_name_char
+  {
+    bool operator()(unsigned char c) const
+    {
+      return (c == '_') || std::isalnum(c);
+    }
+  };
+  struct is_number_char
+  {
+    bool operator()(unsigned char c) const
+    {
+      return (c == '_') || (c == '.') || (c == '\'') || std::isalnum(c);
+    }
+  };
+  struct ends_literal
+  {
+    char quote;
+    bool operator()(char c) const
+    {
+      return (c == quote) || (c == '\\');
+    }
+  };
+  struct may_end_comment
+  {
+    bool operator()(char c) const
+    {
+      return (c == '*') || (c == '/') || (c == '\\');
+    }
+  };
+
+  if (screened_)
+  {
+    return 0;
+  }
+  std::string::const_iterator from = line.cbegin() + pos;
+  std::string::const_iterator to = from;
+  switch (state_)
+  {
+  case NAME:
+    to = std::find_if_not(from, line.cend(), is_name_char{});
+    buf_.append(from, to);
+    break;
+  case NUMBER:
+    to = std::find_if_not(from, line.cend(), is_number_char{});
+    buf_.append(from, to);
+    break;
+  case STRING_LITERAL:
+    to = std::find_if(from, line.cend(), ends_literal{'"'});
+    buf_.append(from, to);
+    break;
+  case CHAR_LITERAL:
+    to = std::find_if(from, line.cend(), ends_literal{'\''});
+    buf_.append(from, to);
+    break;
+  case SINGLE_LINE_COMMENT:
+    to = std::find(from, line.cend(), '\\');
+    break;
+  case MULTI_LINE_COMMENT:
+    to = std::find_if(from, line.cend(), may_end_comment{});
+    if (to != from)
+    {
+      prev_ = *(to - 1);
+    }
+    break;
+  default:
+    break;
+  }
+  return to - from;
+}
 void rychkov::Preprocessor::expanse_macro(CParseContext& context)
 {
   const Macro* macro_p = std::exchange(expansion_, nullptr);
@@ -230,8 +345,123 @@ void rychkov::Preprocessor::expanse_macro(CParseContext& context)
     expansion_list_.clear();
   }
   buf_.clear();
-  std::istringstream in(body);
   CParseContext expanse_context = {context.out, context.err, macro_p->name, &context, true};
-  parse(expanse_context, in, false);
+  parse(expanse_context, body, false);
   context.nerrors += expanse_context.nerrors;
 }
+bool rychkov::Preprocessor::clean_state() const noexcept
+{
+  return (state_ == NO_STATE) && (prev_state_ == NO_STATE) && (prev_ == '\0') && !screened_
+      && buf_.empty() && (expansion_ == nullptr) && !skip_all();
+}
+std::string rychkov::Preprocessor::macro_state() const
+{
+  std::string result{empty_line_ ? '1' : '0'};
+  for (const Macro& macro: macros)
+  {
+    result += '\n';
+    result += macro.name;
+    result += (macro.func_style ? '(' : ' ');
+    for (const std::string& parameter: macro.parameters)
+    {
+      result += parameter;
+      result += ',';
+    }
+    result += '\0';
+    result += macro.body;
+  }
+  return result;
+}
+size_t rychkov::Preprocessor::Recording::source(const CParseContext& from)
+{
+  std::vector< std::vector< SourceFrame > >& sources = header.sources;
+  if (sources.empty() || !continues(sources.back(), from))
+  {
+    std::vector< SourceFrame > chain;
+    for (const CParseContext* frame = &from; ; frame = frame->base)
+    {
+      size_t symbol = (frame == &from ? 0 : frame->symbol);
+      chain.push_back({frame->file, frame->macro_expansion, frame->line, symbol, frame->last_line});
+      if (frame == context)
+      {
+        break;
+      }
+    }
+    sources.push_back(std::move(chain));
+  }
+  return sources.size() - 1;
+}
+bool rychkov::Preprocessor::Recording::continues(const std::vector< SourceFrame >& chain,
+    const CParseContext& from) const
+{
+  const CParseContext* frame = &from;
+  for (std::vector< SourceFrame >::const_iterator i = chain.cbegin(); i != chain.cend(); ++i, frame = frame->base)
+  {
+    if ((frame == nullptr) || (i->line != frame->line) || ((frame != &from) && (i->symbol != frame->symbol))
+        || (i->macro_expansion != frame->macro_expansion) || (i->file != frame->file)
+        || (i->last_line != frame->last_line))
+    {
+      return false;
+    }
+  }
+  return frame == context->base;
+}
+rychkov::CParseContext& rychkov::Preprocessor::restore(CParseContext& context, std::deque< CParseContext >& frames,
+    const std::vector< SourceFrame >& chain)
+{
+  for (const CParseContext& frame: frames)
+  {
+    context.nerrors += frame.nerrors;
+  }
+  frames.clear();
+  const SourceFrame& header_frame = chain.back();
+  context.line = header_frame.line;
+  context.symbol = header_frame.symbol;
+  context.last_line = header_frame.last_line;
+  CParseContext* base = &context;
+  for (std::vector< SourceFrame >::const_reverse_iterator i = chain.crbegin() + 1; i != chain.crend(); ++i)
+  {
+    frames.push_back({context.out, context.err, i->file, base, i->macro_expansion, i->line, i->symbol, i->last_line});
+    base = &frames.back();
+  }
+  return *base;
+}
+void rychkov::Preprocessor::replay(CParseContext& context, const PreprocessedHeader& header)
+{
+  std::deque< CParseContext > frames;
+  CParseContext* current = &context;
+  size_t source = header.sources.size();
+  std::vector< PreprocessedDiagnostic >::const_iterator diagnostic = header.diagnostics.cbegin();
+  for (size_t i = 0; i <= header.tokens.size(); i++)
+  {
+    for (; (diagnostic != header.diagnostics.cend()) && (diagnostic->position == i); ++diagnostic)
+    {
+      if (diagnostic->source != source)
+      {
+        source = diagnostic->source;
+        current = &restore(context, frames, header.sources[source]);
+      }
+      current->symbol = diagnostic->symbol;
+      log(*current, diagnostic->message);
+    }
+    if (i == header.tokens.size())
+    {
+      break;
+    }
+    const PreprocessedToken& token = header.tokens[i];
+    if (token.source != source)
+    {
+      source = token.source;
+      current = &restore(context, frames, header.sources[source]);
+    }
+    current->symbol = token.symbol;
+    deliver(*current, token.kind, token.value);
+  }
+  for (const CParseContext& frame: frames)
+  {
+    context.nerrors += frame.nerrors;
+  }
+  macros = header.macros;
+  legacy_macros.insert(header.undefined.begin(), header.undefined.end());
+  empty_line_ = header.empty_line;
+}
@@ -5,6 +5,7 @@
 #include <iosfwd>
 #include <string>
 #include <vector>
+#include <deque>
 #include <stack>
 #include <set>
 #include <map>
@@ -14,6 +15,8 @@
 #include "content.hpp"
 #include "compare.hpp"
 #include "lexer.hpp"
+#include "include_cache.hpp"
+#include "timing.hpp"
 
 namespace rychkov
 {
@@ -24,12 +27,15 @@ namespace rychkov
     std::unique_ptr< Lexer > next;
     std::set< Macro, NameCompare > macros;
     std::multiset< Macro, NameCompare > legacy_macros;
+    std::shared_ptr< IncludeCache > include_cache;
+    StageTimes* timing = nullptr;
 
     Preprocessor();
     Preprocessor(std::unique_ptr< Lexer > lexer, std::vector< std::string > search_dirs);
 
     static std::string get_name(std::istream& in);
     void parse(CParseContext& context, std::istream& in, bool need_flush = true);
+    void parse(CParseContext& context, const std::string& text, bool need_flush = true);
     void append(CParseContext& context, char c);
     void flush(CParseContext& context);
     void flush(CParseContext& context, char c);
@@ -54,6 +60,14 @@ namespace rychkov
       ELSE_BODY,
       SKIP_ELSE
     };
+    struct Recording
+    {
+      PreprocessedHeader header;
+      const CParseContext* context;
+
+      size_t source(const CParseContext& from);
+      bool continues(const std::vector< SourceFrame >& chain, const CParseContext& from) const;
+    };
 
     const std::map< std::string, void(Preprocessor::*)(std::istream&, CParseContext&) > directives_ = {
           {"include", &rychkov::Preprocessor::include},
@@ -78,11 +92,22 @@ namespace rychkov
 
     std::string buf_;
     std::stack< IfStage > conditional_pairs_;
+    std::vector< Recording* > recordings_;
 
     static void remove_whitespaces(std::string& str);
     bool skip_all() const noexcept;
     void flush_buf(CParseContext& context);
     void expanse_macro(CParseContext& context);
+    void append_line(CParseContext& context);
+    size_t append_run(const std::string& line, std::string::size_type pos);
+    void deliver(CParseContext& context, PreprocessedToken::Kind kind, std::string value);
+    void log(CParseContext& context, std::string message);
+
+    bool clean_state() const noexcept;
+    std::string macro_state() const;
+    void replay(CParseContext& context, const PreprocessedHeader& header);
+    static CParseContext& restore(CParseContext& context, std::deque< CParseContext >& frames,
+        const std::vector< SourceFrame >& chain);
 
     void include(std::istream& in, CParseContext& context);
     void define(std::istream& in, CParseContext& context);
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <utility>
 #include <cctype>
+#include <iterator>
 #include <parser.hpp>
 
 void rychkov::Preprocessor::include(std::istream& in, CParseContext& context)
@@ -55,9 +56,36 @@ void rychkov::Preprocessor::include(std::istream& in, CParseContext& context)
     log(context, "failed to open file");
     return;
   }
+  std::string text{std::istreambuf_iterator< char >{file}, std::istreambuf_iterator< char >{}};
   CParseContext file_context = {context.out, context.err, filename, &context};
-  parse(file_context, file, false);
+  if ((include_cache == nullptr) || !clean_state())
+  {
+    parse(file_context, text, false);
+    context.nerrors += file_context.nerrors;
+    return;
+  }
+
+  std::string key = macro_state();
+  const PreprocessedHeader* cached = include_cache->find(filename, key, text);
+  if (cached != nullptr)
+  {
+    replay(file_context, *cached);
+    context.nerrors += file_context.nerrors;
+    return;
+  }
+  Recording recording{{}, &file_context};
+  std::stack< IfStage > conditional_pairs = conditional_pairs_;
+  recordings_.push_back(&recording);
+  parse(file_context, text, false);
+  recordings_.pop_back();
   context.nerrors += file_context.nerrors;
+  if (clean_state() && (conditional_pairs == conditional_pairs_))
+  {
+    recording.header.text = std::move(text);
+    recording.header.macros = macros;
+    recording.header.empty_line = empty_line_;
+    include_cache->store(filename, std::move(key), std::move(recording.header));
+  }
 }
 void rychkov::Preprocessor::define(std::istream& in, CParseContext& context)
 {
@@ -118,6 +146,10 @@ void rychkov::Preprocessor::undef(std::istream& in, CParseContext& context)
     decltype(macros)::iterator temp = macros.find(name);
     if (temp != macros.end())
     {
+      for (Recording* recording: recordings_)
+      {
+        recording->header.undefined.push_back(*temp);
+      }
       legacy_macros.insert(*temp);
       macros.erase(temp);
     }
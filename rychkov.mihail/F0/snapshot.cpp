@@ -0,0 +1,754 @@
+#include "snapshot.hpp"
+
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "lexer.hpp"
+#include "cparser.hpp"
+
+namespace
+{
+  enum TypeFlags
+  {
+    CONST_FLAG = 1,
+    VOLATILE_FLAG = 2,
+    SIGNED_FLAG = 4,
+    UNSIGNED_FLAG = 8,
+    ARRAY_LENGTH_FLAG = 16
+  };
+
+  const rychkov::Operator* find_operator(const std::string& token, rychkov::Operator::Type type, bool right_align)
+  {
+    decltype(rychkov::Lexer::cases)::const_iterator cases = rychkov::Lexer::cases.find(token);
+    if (cases != rychkov::Lexer::cases.end())
+    {
+      for (const rychkov::Operator& i: *cases)
+      {
+        if ((i.right_align == right_align) && (i.type == type))
+        {
+          return &i;
+        }
+      }
+      return nullptr;
+    }
+    const rychkov::Operator* specials[] = {&rychkov::CParser::parentheses, &rychkov::CParser::brackets,
+          &rychkov::CParser::comma, &rychkov::CParser::inline_if};
+    for (const rychkov::Operator* i: specials)
+    {
+      if (i->token == token)
+      {
+        return i;
+      }
+    }
+    return nullptr;
+  }
+  rychkov::CParser& get_cparser(const rychkov::ParseCell& cell)
+  {
+    if ((cell.preproc.next == nullptr) || (cell.preproc.next->next == nullptr))
+    {
+      throw std::invalid_argument{"snapshot requires full parsing stage"};
+    }
+    return *cell.preproc.next->next;
+  }
+}
+
+constexpr const char* rychkov::SnapshotWriter::magic;
+constexpr size_t rychkov::SnapshotWriter::magic_size;
+constexpr size_t rychkov::SnapshotWriter::version;
+
+void rychkov::SnapshotWriter::put(std::string& out, unsigned long long value)
+{
+  while (value >= 0x80)
+  {
+    out += static_cast< char >((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast< char >(value);
+}
+void rychkov::SnapshotWriter::put_signed(std::string& out, long long value)
+{
+  unsigned long long sign = value < 0 ? ~0ULL : 0ULL;
+  put(out, (static_cast< unsigned long long >(value) << 1) ^ sign);
+}
+size_t rychkov::SnapshotWriter::intern(const std::string& str)
+{
+  std::pair< decltype(string_ids_)::iterator, bool > found = string_ids_.emplace(str, strings_.size());
+  if (found.second)
+  {
+    strings_.push_back(&found.first->first);
+  }
+  return found.first->second;
+}
+size_t rychkov::SnapshotWriter::intern(const typing::Type& type)
+{
+  std::string record;
+  put(record, intern(type.name));
+  put(record, type.category);
+  put(record, type.base != nullptr ? intern(*type.base) + 1 : 0);
+  put(record, (type.is_const ? CONST_FLAG : 0) | (type.is_volatile ? VOLATILE_FLAG : 0)
+        | (type.is_signed ? SIGNED_FLAG : 0) | (type.is_unsigned ? UNSIGNED_FLAG : 0)
+        | (type.array_has_length ? ARRAY_LENGTH_FLAG : 0));
+  put(record, type.length_category);
+  put(record, type.array_length);
+  put(record, type.function_parameters.size());
+  for (const typing::Type& parameter: type.function_parameters)
+  {
+    put(record, intern(parameter));
+  }
+  std::pair< decltype(type_ids_)::iterator, bool > found = type_ids_.emplace(std::move(record), types_.size());
+  if (found.second)
+  {
+    types_.push_back(&found.first->first);
+  }
+  return found.first->second;
+}
+void rychkov::SnapshotWriter::put_string(const std::string& str)
+{
+  put(block_, intern(str));
+}
+void rychkov::SnapshotWriter::put_type(const typing::Type& type)
+{
+  put(block_, intern(type));
+}
+void rychkov::SnapshotWriter::put_operator(const Operator* oper)
+{
+  put(block_, oper != nullptr);
+  if (oper != nullptr)
+  {
+    put_string(oper->token);
+    put_signed(block_, oper->type);
+    put(block_, oper->right_align);
+  }
+}
+
+void rychkov::SnapshotWriter::add_file(const std::string& name, const ParseCell& cell)
+{
+  const Preprocessor& preproc = cell.preproc;
+  const CParser& parser = get_cparser(cell);
+  block_.clear();
+  put(block_, cell.real_file);
+  put_string(cell.cache);
+
+  put(block_, preproc.macros.size());
+  std::for_each(preproc.macros.begin(), preproc.macros.end(), std::ref(*this));
+  put(block_, preproc.legacy_macros.size());
+  std::for_each(preproc.legacy_macros.begin(), preproc.legacy_macros.end(), std::ref(*this));
+  put(block_, parser.end() - parser.begin());
+  std::for_each(parser.begin(), parser.end(), std::ref(*this));
+
+  put(block_, parser.aliases.size());
+  std::for_each(parser.aliases.begin(), parser.aliases.end(), std::ref(*this));
+  put(block_, parser.variables.size());
+  for (const std::pair< entities::Variable, size_t >& var: parser.variables)
+  {
+    operator()(var.first);
+    put(block_, var.second);
+  }
+  put(block_, parser.defined_functions.size());
+  std::for_each(parser.defined_functions.begin(), parser.defined_functions.end(), std::ref(*this));
+  put(block_, parser.structs.size());
+  for (const std::pair< entities::Struct, size_t >& structure: parser.structs)
+  {
+    operator()(structure.first);
+    put(block_, structure.second);
+  }
+  put(block_, parser.unions.size());
+  for (const std::pair< entities::Union, size_t >& structure: parser.unions)
+  {
+    operator()(structure.first);
+    put(block_, structure.second);
+  }
+  put(block_, parser.enums.size());
+  for (const std::pair< entities::Enum, size_t >& structure: parser.enums)
+  {
+    operator()(structure.first);
+    put(block_, structure.second);
+  }
+  put(block_, parser.base_types.size());
+  for (const std::pair< typing::Type, size_t >& type: parser.base_types)
+  {
+    put_type(type.first);
+    put(block_, type.second);
+  }
+  files_.emplace_back(intern(name), std::move(block_));
+}
+void rychkov::SnapshotWriter::write(std::ostream& out) const
+{
+  std::string header(magic, magic_size);
+  put(header, version);
+  put(header, strings_.size());
+  for (const std::string* str: strings_)
+  {
+    put(header, str->size());
+    header += *str;
+  }
+  put(header, types_.size());
+  for (const std::string* type: types_)
+  {
+    put(header, type->size());
+    header += *type;
+  }
+  put(header, files_.size());
+  for (const std::pair< size_t, std::string >& file: files_)
+  {
+    put(header, file.first);
+    put(header, file.second.size());
+  }
+  out.write(header.data(), header.size());
+  for (const std::pair< size_t, std::string >& file: files_)
+  {
+    out.write(file.second.data(), file.second.size());
+  }
+}
+
+void rychkov::SnapshotWriter::operator()(const Macro& macro)
+{
+  put_string(macro.name);
+  put_string(macro.body);
+  put(block_, macro.func_style);
+  put(block_, macro.parameters.size());
+  for (const std::string& parameter: macro.parameters)
+  {
+    put_string(parameter);
+  }
+}
+void rychkov::SnapshotWriter::operator()(const entities::Variable& var)
+{
+  put_type(var.type);
+  put_string(var.name);
+}
+void rychkov::SnapshotWriter::operator()(const entities::Function& func)
+{
+  put_type(func.type);
+  put_string(func.name);
+  put(block_, func.parameters.size());
+  for (const std::string& parameter: func.parameters)
+  {
+    put_string(parameter);
+  }
+}
+void rychkov::SnapshotWriter::operator()(const entities::Body& body)
+{
+  put(block_, body.data.size());
+  std::for_each(body.data.begin(), body.data.end(), std::ref(*this));
+}
+void rychkov::SnapshotWriter::operator()(const entities::Statement& statement)
+{
+  put(block_, statement.type);
+  put(block_, statement.conditions.size());
+  std::for_each(statement.conditions.begin(), statement.conditions.end(), std::ref(*this));
+}
+void rychkov::SnapshotWriter::operator()(const entities::Struct& structure)
+{
+  put_string(structure.name);
+  put(block_, structure.fields.size());
+  std::for_each(structure.fields.begin(), structure.fields.end(), std::ref(*this));
+}
+void rychkov::SnapshotWriter::operator()(const entities::Enum& structure)
+{
+  put_string(structure.name);
+  put(block_, structure.fields.size());
+  for (const std::pair< const std::string, int >& field: structure.fields)
+  {
+    put_string(field.first);
+    put_signed(block_, field.second);
+  }
+}
+void rychkov::SnapshotWriter::operator()(const entities::Union& structure)
+{
+  put_string(structure.name);
+  put(block_, structure.fields.size());
+  std::for_each(structure.fields.begin(), structure.fields.end(), std::ref(*this));
+}
+void rychkov::SnapshotWriter::operator()(const entities::Alias& alias)
+{
+  put_type(alias.type);
+  put_string(alias.name);
+}
+void rychkov::SnapshotWriter::operator()(const entities::Declaration& decl)
+{
+  put(block_, decl.data.index());
+  boost::variant2::visit(*this, decl.data);
+  operator()(decl.value);
+  put(block_, decl.scope);
+}
+void rychkov::SnapshotWriter::operator()(const entities::Literal& literal)
+{
+  put_string(literal.literal);
+  put_string(literal.suffix);
+  put(block_, literal.type);
+  put_type(literal.result_type);
+}
+void rychkov::SnapshotWriter::operator()(const entities::CastOperation& cast)
+{
+  put_type(cast.to);
+  put(block_, cast.is_explicit);
+  operator()(cast.expr);
+}
+void rychkov::SnapshotWriter::operator()(const DynMemWrapper< entities::Expression >& ptr)
+{
+  put(block_, ptr != nullptr);
+  if (ptr != nullptr)
+  {
+    operator()(*ptr);
+  }
+}
+void rychkov::SnapshotWriter::operator()(const entities::Expression& expr)
+{
+  put_operator(expr.operation);
+  put_type(expr.result_type);
+  put(block_, expr.operands.size());
+  std::for_each(expr.operands.begin(), expr.operands.end(), std::ref(*this));
+}
+void rychkov::SnapshotWriter::operator()(const entities::Expression::operand& operand)
+{
+  put(block_, operand.index());
+  boost::variant2::visit(*this, operand);
+}
+
+bool rychkov::SnapshotReader::is_snapshot(std::istream& in)
+{
+  char buf[SnapshotWriter::magic_size] = {};
+  in.read(buf, SnapshotWriter::magic_size);
+  bool result = in && std::equal(buf, buf + SnapshotWriter::magic_size, SnapshotWriter::magic);
+  in.clear();
+  in.seekg(0);
+  return result;
+}
+rychkov::SnapshotReader::SnapshotReader(std::string data):
+  data_(std::move(data)),
+  pos_(0),
+  end_(data_.size())
+{
+  if ((data_.size() < SnapshotWriter::magic_size)
+      || !std::equal(data_.begin(), data_.begin() + SnapshotWriter::magic_size, SnapshotWriter::magic))
+  {
+    throw std::invalid_argument{"not a snapshot file"};
+  }
+  pos_ = SnapshotWriter::magic_size;
+  if (get() != SnapshotWriter::version)
+  {
+    throw std::invalid_argument{"unsupported snapshot version"};
+  }
+  strings_.resize(get_size());
+  for (std::string& str: strings_)
+  {
+    size_t length = get_size();
+    if (length > end_ - pos_)
+    {
+      throw std::invalid_argument{"snapshot is truncated"};
+    }
+    str.assign(data_, pos_, length);
+    pos_ += length;
+  }
+  size_t ntypes = get_size();
+  types_.reserve(ntypes);
+  for (size_t i = 0; i < ntypes; i++)
+  {
+    size_t length = get_size();
+    size_t record_end = pos_ + length;
+    types_.push_back(get_type_record());
+    if (pos_ != record_end)
+    {
+      throw std::invalid_argument{"broken type record"};
+    }
+  }
+  files_.resize(get_size());
+  for (FileEntry& file: files_)
+  {
+    file.name = get_size();
+    file.size = get_size();
+    if (file.name >= strings_.size())
+    {
+      throw std::invalid_argument{"wrong string id"};
+    }
+  }
+  size_t offset = pos_;
+  for (FileEntry& file: files_)
+  {
+    file.offset = offset;
+    if (file.size > end_ - offset)
+    {
+      throw std::invalid_argument{"snapshot is truncated"};
+    }
+    offset += file.size;
+  }
+}
+size_t rychkov::SnapshotReader::size() const noexcept
+{
+  return files_.size();
+}
+const std::string& rychkov::SnapshotReader::filename(size_t i) const
+{
+  return strings_[files_.at(i).name];
+}
+void rychkov::SnapshotReader::read_file(size_t i, ParseCell& cell)
+{
+  const FileEntry& file = files_.at(i);
+  pos_ = file.offset;
+  end_ = file.offset + file.size;
+  Preprocessor& preproc = cell.preproc;
+  CParser& parser = get_cparser(cell);
+
+  cell.real_file = get_flag();
+  cell.cache = get_string();
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    preproc.macros.insert(preproc.macros.end(), get_macro());
+  }
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    preproc.legacy_macros.insert(preproc.legacy_macros.end(), get_macro());
+  }
+  std::vector< entities::Expression > program;
+  size_t count = get_size();
+  program.reserve(count);
+  for (size_t n = count; n > 0; n--)
+  {
+    program.push_back(get_expression());
+  }
+  parser.restore_program(std::move(program));
+
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    parser.aliases.insert(parser.aliases.end(), get_alias());
+  }
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    entities::Variable var = get_variable();
+    parser.variables.emplace_hint(parser.variables.end(), std::move(var), get());
+  }
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    parser.defined_functions.insert(parser.defined_functions.end(), get_variable());
+  }
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    entities::Struct structure = get_struct();
+    parser.structs.emplace_hint(parser.structs.end(), std::move(structure), get());
+  }
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    entities::Union structure = get_union();
+    parser.unions.emplace_hint(parser.unions.end(), std::move(structure), get());
+  }
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    entities::Enum structure = get_enum();
+    parser.enums.emplace_hint(parser.enums.end(), std::move(structure), get());
+  }
+  parser.base_types.clear();
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    const typing::Type& type = get_type();
+    parser.base_types.emplace_hint(parser.base_types.end(), type, get());
+  }
+  if (pos_ != end_)
+  {
+    throw std::invalid_argument{"broken file block"};
+  }
+}
+
+unsigned long long rychkov::SnapshotReader::get()
+{
+  unsigned long long result = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7)
+  {
+    if (pos_ >= end_)
+    {
+      throw std::invalid_argument{"snapshot is truncated"};
+    }
+    unsigned char byte = data_[pos_++];
+    result |= static_cast< unsigned long long >(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+    {
+      return result;
+    }
+  }
+  throw std::invalid_argument{"wrong number encoding"};
+}
+long long rychkov::SnapshotReader::get_signed()
+{
+  unsigned long long value = get();
+  return static_cast< long long >(value >> 1) ^ -static_cast< long long >(value & 1);
+}
+bool rychkov::SnapshotReader::get_flag()
+{
+  unsigned long long value = get();
+  if (value > 1)
+  {
+    throw std::invalid_argument{"wrong flag value"};
+  }
+  return value == 1;
+}
+size_t rychkov::SnapshotReader::get_size()
+{
+  unsigned long long value = get();
+  if (value > end_ - pos_)
+  {
+    throw std::invalid_argument{"wrong size value"};
+  }
+  return value;
+}
+const std::string& rychkov::SnapshotReader::get_string()
+{
+  unsigned long long id = get();
+  if (id >= strings_.size())
+  {
+    throw std::invalid_argument{"wrong string id"};
+  }
+  return strings_[id];
+}
+const rychkov::typing::Type& rychkov::SnapshotReader::get_type()
+{
+  unsigned long long id = get();
+  if (id >= types_.size())
+  {
+    throw std::invalid_argument{"wrong type id"};
+  }
+  return types_[id];
+}
+rychkov::typing::Type rychkov::SnapshotReader::get_type_record()
+{
+  typing::Type result;
+  result.name = get_string();
+  unsigned long long category = get();
+  if (category > typing::COMBINATION)
+  {
+    throw std::invalid_argument{"wrong type category"};
+  }
+  result.category = static_cast< typing::Category >(category);
+  unsigned long long base = get();
+  if (base > types_.size())
+  {
+    throw std::invalid_argument{"wrong type id"};
+  }
+  if (base != 0)
+  {
+    result.base = types_[base - 1];
+  }
+  unsigned long long flags = get();
+  result.is_const = flags & CONST_FLAG;
+  result.is_volatile = flags & VOLATILE_FLAG;
+  result.is_signed = flags & SIGNED_FLAG;
+  result.is_unsigned = flags & UNSIGNED_FLAG;
+  result.array_has_length = flags & ARRAY_LENGTH_FLAG;
+  unsigned long long length = get();
+  if (length > typing::LONG_LONG)
+  {
+    throw std::invalid_argument{"wrong length category"};
+  }
+  result.length_category = static_cast< typing::LengthCategory >(length);
+  result.array_length = get();
+  size_t count = get_size();
+  result.function_parameters.reserve(count);
+  for (size_t n = count; n > 0; n--)
+  {
+    result.function_parameters.push_back(get_type());
+  }
+  return result;
+}
+const rychkov::Operator* rychkov::SnapshotReader::get_operator()
+{
+  if (!get_flag())
+  {
+    return nullptr;
+  }
+  const std::string& token = get_string();
+  long long type = get_signed();
+  if ((type != Operator::MULTIPLE) && ((type > 3) || (type <= 0)))
+  {
+    throw std::invalid_argument{"wrong operator size"};
+  }
+  const Operator* result = find_operator(token, static_cast< Operator::Type >(type), get_flag());
+  if (result == nullptr)
+  {
+    throw std::invalid_argument{"unknown operator"};
+  }
+  return result;
+}
+
+rychkov::Macro rychkov::SnapshotReader::get_macro()
+{
+  Macro result;
+  result.name = get_string();
+  result.body = get_string();
+  result.func_style = get_flag();
+  result.parameters.resize(get_size());
+  for (std::string& parameter: result.parameters)
+  {
+    parameter = get_string();
+  }
+  return result;
+}
+rychkov::entities::Variable rychkov::SnapshotReader::get_variable()
+{
+  const typing::Type& type = get_type();
+  return {type, get_string()};
+}
+rychkov::entities::Function rychkov::SnapshotReader::get_function()
+{
+  const typing::Type& type = get_type();
+  entities::Function result{type, get_string()};
+  result.parameters.resize(get_size());
+  for (std::string& parameter: result.parameters)
+  {
+    parameter = get_string();
+  }
+  return result;
+}
+rychkov::entities::Body rychkov::SnapshotReader::get_body()
+{
+  entities::Body result;
+  result.data.clear();
+  size_t count = get_size();
+  result.data.reserve(count);
+  for (size_t n = count; n > 0; n--)
+  {
+    result.data.push_back(get_expression());
+  }
+  return result;
+}
+rychkov::entities::Statement rychkov::SnapshotReader::get_statement()
+{
+  unsigned long long type = get();
+  if (type >= entities::Statement::TYPE_LAST)
+  {
+    throw std::invalid_argument{"wrong statement type"};
+  }
+  entities::Statement result{static_cast< entities::Statement::Type >(type)};
+  size_t count = get_size();
+  result.conditions.reserve(count);
+  for (size_t n = count; n > 0; n--)
+  {
+    result.conditions.push_back(get_expression());
+  }
+  return result;
+}
+rychkov::entities::Struct rychkov::SnapshotReader::get_struct()
+{
+  entities::Struct result{get_string()};
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    result.fields.insert(result.fields.end(), get_variable());
+  }
+  return result;
+}
+rychkov::entities::Enum rychkov::SnapshotReader::get_enum()
+{
+  entities::Enum result{get_string()};
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    const std::string& name = get_string();
+    result.fields.emplace_hint(result.fields.end(), name, static_cast< int >(get_signed()));
+  }
+  return result;
+}
+rychkov::entities::Union rychkov::SnapshotReader::get_union()
+{
+  entities::Union result{get_string()};
+  for (size_t n = get_size(); n > 0; n--)
+  {
+    result.fields.insert(result.fields.end(), get_variable());
+  }
+  return result;
+}
+rychkov::entities::Alias rychkov::SnapshotReader::get_alias()
+{
+  const typing::Type& type = get_type();
+  return {type, get_string()};
+}
+rychkov::entities::Declaration rychkov::SnapshotReader::get_declaration()
+{
+  entities::Declaration::declared data = get_declared();
+  DynMemWrapper< entities::Expression > value = get_expression_ptr();
+  unsigned long long scope = get();
+  if (scope > entities::UNSPECIFIED)
+  {
+    throw std::invalid_argument{"wrong scope type"};
+  }
+  return {std::move(data), std::move(value), static_cast< entities::ScopeType >(scope)};
+}
+rychkov::entities::Declaration::declared rychkov::SnapshotReader::get_declared()
+{
+  switch (get())
+  {
+  case 0:
+    return get_variable();
+  case 1:
+    return get_struct();
+  case 2:
+    return get_enum();
+  case 3:
+    return get_union();
+  case 4:
+    return get_alias();
+  case 5:
+    return get_function();
+  case 6:
+    return get_statement();
+  }
+  throw std::invalid_argument{"unknown declared"};
+}
+rychkov::entities::Literal rychkov::SnapshotReader::get_literal()
+{
+  entities::Literal result;
+  result.literal = get_string();
+  result.suffix = get_string();
+  unsigned long long type = get();
+  if (type > entities::Literal::Number)
+  {
+    throw std::invalid_argument{"wrong literal type"};
+  }
+  result.type = static_cast< entities::Literal::Type >(type);
+  result.result_type = get_type();
+  return result;
+}
+rychkov::entities::CastOperation rychkov::SnapshotReader::get_cast()
+{
+  const typing::Type& to = get_type();
+  bool is_explicit = get_flag();
+  return {to, is_explicit, get_expression_ptr()};
+}
+rychkov::DynMemWrapper< rychkov::entities::Expression > rychkov::SnapshotReader::get_expression_ptr()
+{
+  if (!get_flag())
+  {
+    return nullptr;
+  }
+  return DynMemWrapper< entities::Expression >(new entities::Expression(get_expression()));
+}
+rychkov::entities::Expression rychkov::SnapshotReader::get_expression()
+{
+  entities::Expression result;
+  result.operation = get_operator();
+  result.result_type = get_type();
+  size_t count = get_size();
+  result.operands.reserve(count);
+  for (size_t n = count; n > 0; n--)
+  {
+    result.operands.push_back(get_operand());
+  }
+  return result;
+}
+rychkov::entities::Expression::operand rychkov::SnapshotReader::get_operand()
+{
+  switch (get())
+  {
+  case 0:
+    return get_expression_ptr();
+  case 1:
+    return get_variable();
+  case 2:
+    return get_declaration();
+  case 3:
+    return get_literal();
+  case 4:
+    return get_cast();
+  case 5:
+    return get_body();
+  }
+  throw std::invalid_argument{"unknown expression operand"};
+}
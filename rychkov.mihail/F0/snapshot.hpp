@@ -0,0 +1,117 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+#include "content.hpp"
+#include "main_processor.hpp"
+
+namespace rychkov
+{
+  // binary layout (all integers are LEB128 varints, signed ones are zigzag-encoded):
+  //   magic, version,
+  //   string table (every name, body and source text is stored once),
+  //   type table (children always precede their parents),
+  //   file directory (name, block size), file blocks
+  // each file block holds macros, program and all the parser tables, so loading
+  // does not have to reparse anything
+  class SnapshotWriter
+  {
+  public:
+    static constexpr const char* magic = "RYCHSNAP";
+    static constexpr size_t magic_size = 8;
+    static constexpr size_t version = 1;
+
+    void add_file(const std::string& name, const ParseCell& cell);
+    void write(std::ostream& out) const;
+
+    void operator()(const Macro& macro);
+    void operator()(const entities::Variable& var);
+    void operator()(const entities::Function& func);
+    void operator()(const entities::Body& body);
+    void operator()(const entities::Statement& statement);
+    void operator()(const entities::Struct& structure);
+    void operator()(const entities::Enum& structure);
+    void operator()(const entities::Union& structure);
+    void operator()(const entities::Alias& alias);
+    void operator()(const entities::Declaration& decl);
+    void operator()(const entities::Literal& literal);
+    void operator()(const entities::CastOperation& cast);
+    void operator()(const DynMemWrapper< entities::Expression >& ptr);
+    void operator()(const entities::Expression& expr);
+    void operator()(const entities::Expression::operand& operand);
+
+  private:
+    std::unordered_map< std::string, size_t > string_ids_;
+    std::vector< const std::string* > strings_;
+    std::unordered_map< std::string, size_t > type_ids_;
+    std::vector< const std::string* > types_;
+    std::vector< std::pair< size_t, std::string > > files_;
+    std::string block_;
+
+    static void put(std::string& out, unsigned long long value);
+    static void put_signed(std::string& out, long long value);
+    size_t intern(const std::string& str);
+    size_t intern(const typing::Type& type);
+    void put_string(const std::string& str);
+    void put_type(const typing::Type& type);
+    void put_operator(const Operator* oper);
+  };
+  class SnapshotReader
+  {
+  public:
+    static bool is_snapshot(std::istream& in);
+
+    explicit SnapshotReader(std::string data);
+    size_t size() const noexcept;
+    const std::string& filename(size_t i) const;
+    void read_file(size_t i, ParseCell& cell);
+
+  private:
+    struct FileEntry
+    {
+      size_t name;
+      size_t offset;
+      size_t size;
+    };
+    std::string data_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    std::vector< std::string > strings_;
+    std::vector< typing::Type > types_;
+    std::vector< FileEntry > files_;
+
+    unsigned long long get();
+    long long get_signed();
+    bool get_flag();
+    size_t get_size();
+    const std::string& get_string();
+    const typing::Type& get_type();
+    typing::Type get_type_record();
+    const Operator* get_operator();
+
+    Macro get_macro();
+    entities::Variable get_variable();
+    entities::Function get_function();
+    entities::Body get_body();
+    entities::Statement get_statement();
+    entities::Struct get_struct();
+    entities::Enum get_enum();
+    entities::Union get_union();
+    entities::Alias get_alias();
+    entities::Declaration get_declaration();
+    entities::Declaration::declared get_declared();
+    entities::Literal get_literal();
+    entities::CastOperation get_cast();
+    DynMemWrapper< entities::Expression > get_expression_ptr();
+    entities::Expression get_expression();
+    entities::Expression::operand get_operand();
+  };
+}
+
+#endif
@@ -0,0 +1,37 @@
+#include "timing.hpp"
+
+#include <iostream>
+#include <fmtguard.hpp>
+
+rychkov::StageTimes& rychkov::StageTimes::operator+=(const StageTimes& rhs)
+{
+  total += rhs.total;
+  lexer += rhs.lexer;
+  cparser += rhs.cparser;
+  return *this;
+}
+rychkov::StageTimer::StageTimer(StageTimes* times, StageTimes::clock::duration StageTimes::* stage):
+  times_{times},
+  stage_{stage},
+  start_{times == nullptr ? StageTimes::clock::time_point{} : StageTimes::clock::now()}
+{}
+rychkov::StageTimer::~StageTimer()
+{
+  if (times_ != nullptr)
+  {
+    times_->*stage_ += StageTimes::clock::now() - start_;
+  }
+}
+double rychkov::milliseconds(StageTimes::clock::duration duration)
+{
+  return std::chrono::duration< double, std::milli >(duration).count();
+}
+std::ostream& rychkov::operator<<(std::ostream& out, const StageTimes& times)
+{
+  fmtguard guard{out};
+  out << std::fixed;
+  out.precision(2);
+  out << "preprocessor " << milliseconds(times.total - times.lexer) << " ms, ";
+  out << "lexer " << milliseconds(times.lexer - times.cparser) << " ms, ";
+  return out << "cparser " << milliseconds(times.cparser) << " ms";
+}
@@ -0,0 +1,36 @@
+#ifndef TIMING_HPP
+#define TIMING_HPP
+
+#include <chrono>
+#include <iosfwd>
+
+namespace rychkov
+{
+  struct StageTimes
+  {
+    using clock = std::chrono::steady_clock;
+    // stages are nested (preprocessor calls lexer calls cparser), so every field
+    // includes the time of all the stages below it
+    clock::duration total{};
+    clock::duration lexer{};
+    clock::duration cparser{};
+
+    StageTimes& operator+=(const StageTimes& rhs);
+  };
+  class StageTimer
+  {
+  public:
+    StageTimer(StageTimes* times, StageTimes::clock::duration StageTimes::* stage);
+    StageTimer(const StageTimer&) = delete;
+    ~StageTimer();
+
+  private:
+    StageTimes* times_;
+    StageTimes::clock::duration StageTimes::* stage_;
+    StageTimes::clock::time_point start_;
+  };
+  double milliseconds(StageTimes::clock::duration duration);
+  std::ostream& operator<<(std::ostream& out, const StageTimes& times);
+}
+
+#endif
@@ -1,7 +1,10 @@
 #include "project-cmds.hpp"
+#include <chrono>
+#include <thread>
 #include <fstream>
 #include <algorithm>
 #include <functional>
+#include <unordered_map>
 #include <shape-utils.hpp>
 #include "renderer.hpp"
 #include "file-system.hpp"
@@ -588,8 +591,59 @@ void savintsev::render(std::istream & in, std::ostream & out, Projects & projs)
 
   auto & proj = projs.at(proj_name);
 
-  Renderer rend;
+  Renderer rend(std::thread::hardware_concurrency());
   rend.render_project(proj, image_name, width, height);
 
   out << "Project \"" << proj_name << "\" rendered successfully to \"" << image_name << ".bmp\"\n";
 }
+
+namespace
+{
+  double time_render(savintsev::Renderer & rend, gil::rgb8_view_t & view, const savintsev::Project & proj)
+  {
+    const std::mt19937::result_type bench_seed = 20250501;
+    rend.seed(bench_seed);
+    auto start = std::chrono::steady_clock::now();
+    rend.rasterize(view, proj);
+    std::chrono::duration< double, std::milli > elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+}
+
+void savintsev::render_bench(std::istream & in, std::ostream & out, Projects & projs)
+{
+  std::string proj_name;
+  int width, height;
+  in >> proj_name >> width >> height;
+  if (!in || width <= 0 || height <= 0)
+  {
+    throw std::runtime_error("Invalid render_bench arguments");
+  }
+
+  const Project & proj = projs.at(proj_name);
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+  gil::rgb8_image_t naive_image(width, height);
+  gil::rgb8_image_t scan_image(width, height);
+  gil::rgb8_image_t par_image(width, height);
+  auto naive_view = gil::view(naive_image);
+  auto scan_view = gil::view(scan_image);
+  auto par_view = gil::view(par_image);
+
+  Renderer naive(1, RenderMode::NAIVE);
+  Renderer scanline(1, RenderMode::SCANLINE);
+  Renderer parallel(threads, RenderMode::SCANLINE);
+
+  double naive_ms = time_render(naive, naive_view, proj);
+  double scan_ms = time_render(scanline, scan_view, proj);
+  double par_ms = time_render(parallel, par_view, proj);
+
+  bool same = gil::equal_pixels(naive_view, scan_view) && gil::equal_pixels(naive_view, par_view);
+
+  out << "=== Render benchmark: " << proj_name << " (" << proj.size() << " layers, ";
+  out << width << "x" << height << ") ===\n";
+  out << "Per-pixel   " << naive_ms << " ms\n";
+  out << "Scanline    " << scan_ms << " ms\n";
+  out << "Scanline x" << threads << " " << par_ms << " ms\n";
+  out << "Images " << (same ? "are identical" : "DIFFER") << '\n';
+}
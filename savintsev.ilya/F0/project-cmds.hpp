@@ -13,6 +13,7 @@ namespace savintsev
   void save(std::istream & in, std::ostream & out, Projects & projs);
   void save_as(std::istream & in, std::ostream & out, Projects & projs);
   void render(std::istream & in, std::ostream & out, Projects & projs);
+  void render_bench(std::istream & in, std::ostream & out, Projects & projs);
   void merge(std::istream & in, std::ostream & out, Projects & projs);
   void save_all(std::ostream & out, Projects & projs);
 
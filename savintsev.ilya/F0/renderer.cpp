@@ -0,0 +1,290 @@
+#include "renderer.hpp"
+#include <cmath>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+  int clamp_to(double value, int lo, int hi)
+  {
+    if (!(value > lo))
+    {
+      return lo;
+    }
+    if (value > hi)
+    {
+      return hi;
+    }
+    return static_cast< int >(value);
+  }
+
+  int first_column(double edge_x, double half_w, int lo, int hi)
+  {
+    int x = clamp_to(std::ceil(edge_x + half_w - 0.5), lo, hi);
+    while (x > lo && (x - 1 - half_w) + 0.5 >= edge_x)
+    {
+      --x;
+    }
+    while (x < hi && (x - half_w) + 0.5 < edge_x)
+    {
+      ++x;
+    }
+    return x;
+  }
+
+  template< typename Edge >
+  struct EdgeBefore
+  {
+    bool operator()(const Edge & a, const Edge & b) const
+    {
+      return a.first_row < b.first_row;
+    }
+  };
+
+  template< typename Edge >
+  struct EdgeFinished
+  {
+    int row;
+    bool operator()(const Edge * e) const
+    {
+      return e->last_row < row;
+    }
+  };
+
+  struct BandWorker
+  {
+    std::function< void(int, int) > fill;
+    int row_begin;
+    int row_end;
+    void operator()() const
+    {
+      fill(row_begin, row_end);
+    }
+  };
+}
+
+savintsev::Renderer::Renderer(unsigned threads, RenderMode mode):
+  threads_(threads ? threads : 1),
+  mode_(mode),
+  rng_(std::random_device{}())
+{}
+
+void savintsev::Renderer::seed(std::mt19937::result_type value)
+{
+  rng_.seed(value);
+}
+
+void savintsev::Renderer::rasterize(gil::rgb8_view_t & view, const savintsev::Project & proj)
+{
+  gil::fill_pixels(view, gil::rgb8_pixel_t(255, 255, 255));
+  for (auto it = proj.begin(); it != proj.end(); ++it)
+  {
+    render_shape(view, it->second);
+  }
+}
+
+void savintsev::Renderer::render_project(const savintsev::Project & proj, const std::string & name, int w, int h)
+{
+  gil::rgb8_image_t image(w, h);
+  auto view = gil::view(image);
+  rasterize(view, proj);
+  gil::write_view(name + ".bmp", view, gil::bmp_tag{});
+}
+
+gil::rgb8_pixel_t savintsev::Renderer::next_color()
+{
+  std::uniform_int_distribution< int > dist(50, 240);
+  uint8_t r = static_cast< uint8_t >(dist(rng_));
+  uint8_t g = static_cast< uint8_t >(dist(rng_));
+  uint8_t b = static_cast< uint8_t >(dist(rng_));
+  return gil::rgb8_pixel_t(r, g, b);
+}
+
+void savintsev::Renderer::render_shape(gil::rgb8_view_t & view, const savintsev::Shape * shape)
+{
+  gil::rgb8_pixel_t color = next_color();
+
+  savintsev::point_t points[4];
+  size_t point_count = shape->get_all_points(points);
+
+  if (point_count == 2)
+  {
+    savintsev::point_t rect_points[4];
+    rect_points[0] = {points[0].x, points[0].y};
+    rect_points[1] = {points[1].x, points[0].y};
+    rect_points[2] = {points[1].x, points[1].y};
+    rect_points[3] = {points[0].x, points[1].y};
+    std::copy(rect_points, rect_points + 4, points);
+    point_count = 4;
+  }
+
+  if (mode_ == RenderMode::NAIVE)
+  {
+    fill_shape_naive(view, points, point_count, color);
+  }
+  else
+  {
+    fill_shape_scanline(view, points, point_count, shape->get_frame_rect(), color);
+  }
+}
+
+void savintsev::Renderer::fill_shape_naive(gil::rgb8_view_t & view, const point_t * points, size_t count,
+  gil::rgb8_pixel_t c)
+{
+  if (count < 3)
+  {
+    return;
+  }
+
+  int width = view.width();
+  int height = view.height();
+
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      double fx = x - width / 2.0;
+      double fy = height / 2.0 - y;
+
+      if (is_point_in_polygon(points, count, fx + 0.5, fy + 0.5))
+      {
+        view(x, y) = c;
+      }
+    }
+  }
+}
+
+bool savintsev::Renderer::is_point_in_polygon(const point_t * points, size_t point_count, double x, double y) const
+{
+  bool inside = false;
+  for (size_t i = 0, j = point_count - 1; i < point_count; j = i++)
+  {
+    double xi = points[i].x, yi = points[i].y;
+    double xj = points[j].x, yj = points[j].y;
+
+    bool intersect = ((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi + 1e-15) + xi);
+    if (intersect)
+    {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+void savintsev::Renderer::fill_shape_scanline(gil::rgb8_view_t & view, const point_t * points, size_t count,
+  const rectangle_t & frame, gil::rgb8_pixel_t c)
+{
+  if (count < 3)
+  {
+    return;
+  }
+
+  int width = view.width();
+  int height = view.height();
+  double half_w = width / 2.0;
+  double half_h = height / 2.0;
+
+  double left = frame.pos.x - std::fabs(frame.width) / 2.0;
+  double right = frame.pos.x + std::fabs(frame.width) / 2.0;
+  double bottom = frame.pos.y - std::fabs(frame.height) / 2.0;
+  double top = frame.pos.y + std::fabs(frame.height) / 2.0;
+
+  int row_begin = clamp_to(std::floor(half_h + 0.5 - top) - 1, 0, height);
+  int row_end = clamp_to(std::ceil(half_h + 0.5 - bottom) + 2, 0, height);
+  int col_begin = clamp_to(std::floor(left + half_w - 0.5) - 1, 0, width);
+  int col_end = clamp_to(std::ceil(right + half_w - 0.5) + 2, 0, width);
+  if (row_begin >= row_end || col_begin >= col_end)
+  {
+    return;
+  }
+
+  std::vector< Edge > edges;
+  edges.reserve(count);
+  for (size_t i = 0, j = count - 1; i < count; j = i++)
+  {
+    Edge e{points[i].x, points[i].y, points[j].x, points[j].y, 0, 0};
+    if (e.yi == e.yj)
+    {
+      continue;
+    }
+    double y_max = std::max(e.yi, e.yj);
+    double y_min = std::min(e.yi, e.yj);
+    e.first_row = clamp_to(std::floor(half_h + 0.5 - y_max) - 1, -1, height);
+    e.last_row = clamp_to(std::ceil(half_h + 0.5 - y_min) + 1, -1, height);
+    edges.push_back(e);
+  }
+  std::sort(edges.begin(), edges.end(), EdgeBefore< Edge >{});
+
+  using namespace std::placeholders;
+  auto fill = std::bind(fill_rows, std::ref(view), std::cref(edges), _1, _2, col_begin, col_end, c);
+
+  int rows = row_end - row_begin;
+  int bands = static_cast< int >(std::min< unsigned >(threads_, static_cast< unsigned >(rows / 64 + 1)));
+  if (bands <= 1)
+  {
+    fill(row_begin, row_end);
+    return;
+  }
+
+  std::vector< std::thread > workers;
+  workers.reserve(bands - 1);
+  int band_rows = (rows + bands - 1) / bands;
+  for (int b = 1; b < bands; ++b)
+  {
+    int from = row_begin + b * band_rows;
+    int to = std::min(row_end, from + band_rows);
+    if (from < to)
+    {
+      workers.emplace_back(BandWorker{fill, from, to});
+    }
+  }
+  fill(row_begin, std::min(row_end, row_begin + band_rows));
+  std::for_each(workers.begin(), workers.end(), std::mem_fn(&std::thread::join));
+}
+
+void savintsev::Renderer::fill_rows(gil::rgb8_view_t & view, const std::vector< Edge > & edges,
+  int row_begin, int row_end, int col_begin, int col_end, gil::rgb8_pixel_t c)
+{
+  double half_w = view.width() / 2.0;
+  double half_h = view.height() / 2.0;
+
+  std::vector< const Edge * > active;
+  std::vector< double > crossings;
+  active.reserve(edges.size());
+  crossings.reserve(edges.size());
+
+  size_t next = 0;
+  for (int y = row_begin; y < row_end; ++y)
+  {
+    for (; next < edges.size() && edges[next].first_row <= y; ++next)
+    {
+      active.push_back(std::addressof(edges[next]));
+    }
+    active.erase(std::remove_if(active.begin(), active.end(), EdgeFinished< Edge >{y}), active.end());
+
+    double fy = half_h - y;
+    double py = fy + 0.5;
+    crossings.clear();
+    for (auto it = active.begin(); it != active.end(); ++it)
+    {
+      const Edge & e = **it;
+      if ((e.yi > py) != (e.yj > py))
+      {
+        crossings.push_back((e.xj - e.xi) * (py - e.yi) / (e.yj - e.yi + 1e-15) + e.xi);
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+
+    auto row = view.row_begin(y);
+    for (size_t k = 0; k + 1 < crossings.size(); k += 2)
+    {
+      int from = first_column(crossings[k], half_w, col_begin, col_end);
+      int to = first_column(crossings[k + 1], half_w, col_begin, col_end);
+      if (from < to)
+      {
+        std::fill(row + from, row + to, c);
+      }
+    }
+  }
+}
@@ -83,16 +83,6 @@ namespace shchadilov
     std::transform(set.cbegin(), set.cend(), std::ostream_iterator< std::string >(out, "\n"), ExtractKey{});
   }
 
-  struct WordAdder
-  {
-    FrequencyDictionary& dict_;
-
-    void operator()(const std::string& word) const
-    {
-      ++dict_[word];
-    }
-  };
-
   void build(DictionarySet& set, std::istream& in)
   {
     std::string dictName = "";
@@ -114,15 +104,8 @@ namespace shchadilov
       set[dictName];
     }
 
-    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-    std::vector< std::string > words = extractWords(content);
-    WordAdder adder
-    {
-      set.at(dictName)
-    };
-    std::for_each(words.begin(), words.end(), adder);
-    std::cout << "Dictionary '" << dictName << "' built. Added " << words.size() << " words.\n";
+    std::size_t added = countFileWords(fileName, set.at(dictName));
+    std::cout << "Dictionary '" << dictName << "' built. Added " << added << " words.\n";
   }
 
   struct PairToString
@@ -1,8 +1,16 @@
 #include "text_processor.hpp"
 #include <algorithm>
 #include <cctype>
+#include <exception>
+#include <fstream>
 #include <iterator>
-#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace shchadilov
 {
@@ -23,61 +31,232 @@ namespace shchadilov
     }
   };
 
-  std::string cleanWord(const std::string& word)
+  namespace
   {
-    std::string cleaned = "";;
-    std::remove_copy_if(word.begin(), word.end(), std::back_inserter(cleaned), IsPunctuation{});
-    std::transform(cleaned.begin(), cleaned.end(), cleaned.begin(), ToLower{});
-    return cleaned;
-  }
-
-  class WordAccumulator
-  {
-  public:
-    explicit WordAccumulator(std::vector<std::string>& words):
-      words_(words)
-    {}
+    const std::size_t minBytesPerWorker = 1 << 22;
 
-    void operator()(char c)
+    class DelimiterTable
     {
-      if (std::isspace(c) || isPunctuation_(c))
+    public:
+      DelimiterTable()
       {
-        if (!currentWord_.empty())
+        IsPunctuation isPunctuation;
+        for (int c = 0; c < 256; ++c)
         {
-          words_.push_back(cleanWord(currentWord_));
-          currentWord_.clear();
+          isDelimiter_[c] = std::isspace(c) || isPunctuation(static_cast< char >(c));
+          isSpace_[c] = std::isspace(c);
         }
       }
-      else
+
+      bool isDelimiter(char c) const
+      {
+        return isDelimiter_[static_cast< unsigned char >(c)];
+      }
+
+      bool isSpace(char c) const
       {
-        currentWord_ += c;
+        return isSpace_[static_cast< unsigned char >(c)];
       }
+
+    private:
+      bool isDelimiter_[256];
+      bool isSpace_[256];
+    };
+
+    const DelimiterTable& delimiters()
+    {
+      static const DelimiterTable table;
+      return table;
     }
 
-    void finish()
+    bool isDelimiter(char c)
     {
-      if (!currentWord_.empty())
+      return delimiters().isDelimiter(c);
+    }
+
+    bool isSpace(char c)
+    {
+      return delimiters().isSpace(c);
+    }
+
+    // read-only view of a whole file: mapped when possible, read into memory otherwise
+    class FileView
+    {
+    public:
+      explicit FileView(const std::string& fileName):
+        data_(nullptr),
+        size_(0),
+        mapped_(false)
+      {
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd != -1 && ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+          size_ = static_cast< std::size_t >(info.st_size);
+          void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (addr != MAP_FAILED)
+          {
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast< const char* >(addr);
+            mapped_ = true;
+          }
+        }
+        if (fd != -1)
+        {
+          ::close(fd);
+        }
+        if (!mapped_)
+        {
+          std::ifstream file(fileName, std::ios::binary);
+          if (!file.is_open())
+          {
+            throw std::logic_error("<INVALID FILE>\n");
+          }
+          buffer_.assign(std::istreambuf_iterator< char >(file), std::istreambuf_iterator< char >());
+          data_ = buffer_.data();
+          size_ = buffer_.size();
+        }
+      }
+
+      FileView(const FileView&) = delete;
+      FileView& operator=(const FileView&) = delete;
+
+      ~FileView()
       {
-        words_.push_back(cleanWord(currentWord_));
+        if (mapped_)
+        {
+          ::munmap(const_cast< char* >(data_), size_);
+        }
       }
-    }
 
-  private:
-    std::vector< std::string >& words_;
-    std::string currentWord_ = "";;
-    IsPunctuation isPunctuation_;
-  };
+      const char* begin() const
+      {
+        return data_;
+      }
+
+      const char* end() const
+      {
+        return data_ + size_;
+      }
+
+      std::size_t size() const
+      {
+        return size_;
+      }
 
-  std::vector< std::string > extractWords(const std::string& text)
+    private:
+      const char* data_;
+      std::size_t size_;
+      bool mapped_;
+      std::vector< char > buffer_;
+    };
+
+    struct RangeCounter
+    {
+      const char* first_;
+      const char* last_;
+      std::unordered_map< std::string, std::size_t >& frequencies_;
+      std::size_t& words_;
+      std::exception_ptr& error_;
+
+      void operator()() const
+      {
+        try
+        {
+          std::string word;
+          const char* cur = std::find_if_not(first_, last_, isDelimiter);
+          while (cur != last_)
+          {
+            const char* wordEnd = std::find_if(cur, last_, isDelimiter);
+            word.assign(cur, wordEnd);
+            std::transform(word.begin(), word.end(), word.begin(), ToLower{});
+            ++frequencies_[word];
+            ++words_;
+            cur = std::find_if_not(wordEnd, last_, isDelimiter);
+          }
+        }
+        catch (...)
+        {
+          error_ = std::current_exception();
+        }
+      }
+    };
+
+    // joins whatever workers were started, also when starting another one throws
+    class ThreadJoiner
+    {
+    public:
+      explicit ThreadJoiner(std::vector< std::thread >& threads):
+        threads_(threads)
+      {}
+
+      ThreadJoiner(const ThreadJoiner&) = delete;
+      ThreadJoiner& operator=(const ThreadJoiner&) = delete;
+
+      ~ThreadJoiner()
+      {
+        for (std::thread& thread: threads_)
+        {
+          if (thread.joinable())
+          {
+            thread.join();
+          }
+        }
+      }
+
+    private:
+      std::vector< std::thread >& threads_;
+    };
+  }
+
+  std::size_t countFileWords(const std::string& fileName, std::unordered_map< std::string, std::size_t >& frequencies)
   {
-    std::vector< std::string > words;
-    if (text.empty())
+    FileView view(fileName);
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t workers = std::max< std::size_t >(1, std::min(hardware, view.size() / minBytesPerWorker));
+
+    std::vector< const char* > bounds;
+    bounds.push_back(view.begin());
+    for (std::size_t k = 1; k < workers; ++k)
+    {
+      const char* cut = std::max(bounds.back(), view.begin() + view.size() / workers * k);
+      bounds.push_back(std::find_if(cut, view.end(), isSpace));
+    }
+    bounds.push_back(view.end());
+
+    std::vector< std::unordered_map< std::string, std::size_t > > tables(workers - 1);
+    std::vector< std::size_t > counts(workers, 0);
+    std::vector< std::exception_ptr > errors(workers);
+    {
+      std::vector< std::thread > threads;
+      ThreadJoiner joiner(threads);
+      threads.reserve(workers - 1);
+      for (std::size_t k = 1; k < workers; ++k)
+      {
+        threads.emplace_back(RangeCounter{ bounds[k], bounds[k + 1], tables[k - 1], counts[k], errors[k] });
+      }
+      RangeCounter{ bounds[0], bounds[1], frequencies, counts[0], errors[0] }();
+    }
+    for (const std::exception_ptr& error: errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    for (const std::unordered_map< std::string, std::size_t >& table: tables)
+    {
+      for (const std::pair< const std::string, std::size_t >& entry: table)
+      {
+        frequencies[entry.first] += entry.second;
+      }
+    }
+    std::size_t total = 0;
+    for (std::size_t count: counts)
     {
-      return words;
+      total += count;
     }
-    WordAccumulator accumulator(words);
-    std::for_each(text.begin(), text.end(), std::ref(accumulator));
-    accumulator.finish();
-    return words;
+    return total;
   }
 }
@@ -2,13 +2,12 @@
 #define TEXT_PROCESSOR_H
 
 #include <string>
-#include <vector>
+#include <unordered_map>
 
 
 namespace shchadilov
 {
-  std::string cleanWord(const std::string& word);
-  std::vector< std::string > extractWords(const std::string& text);
+  std::size_t countFileWords(const std::string& fileName, std::unordered_map< std::string, std::size_t >& frequencies);
 }
 
 #endif
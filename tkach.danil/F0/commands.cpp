@@ -36,28 +36,120 @@ namespace
     return translations;
   }
 
-  class MergeWordsInDict
+  struct DictCursor
+  {
+    tree_of_words::const_iterator current;
+    tree_of_words::const_iterator end;
+    size_t index;
+  };
+
+  class CursorGreater
+  {
+  public:
+    bool operator()(const DictCursor& lhs, const DictCursor& rhs) const
+    {
+      return lhs.current->first > rhs.current->first;
+    }
+  };
+
+  using word_sources = std::vector< std::pair< size_t, const std::list< std::string >* > >;
+
+  template< class Handler >
+  void forEachWordOfDicts(const std::vector< const tree_of_words* >& dicts, Handler handler)
+  {
+    std::vector< DictCursor > heap;
+    for (size_t i = 0; i < dicts.size(); ++i)
+    {
+      if (!dicts[i]->empty())
+      {
+        heap.push_back(DictCursor{dicts[i]->cbegin(), dicts[i]->cend(), i});
+      }
+    }
+    std::make_heap(heap.begin(), heap.end(), CursorGreater{});
+    word_sources sources;
+    while (!heap.empty())
+    {
+      const std::string& word = heap.front().current->first;
+      sources.clear();
+      while (!heap.empty() && heap.front().current->first == word)
+      {
+        std::pop_heap(heap.begin(), heap.end(), CursorGreater{});
+        DictCursor& cursor = heap.back();
+        sources.emplace_back(cursor.index, &cursor.current->second);
+        if (++cursor.current == cursor.end)
+        {
+          heap.pop_back();
+        }
+        else
+        {
+          std::push_heap(heap.begin(), heap.end(), CursorGreater{});
+        }
+      }
+      handler(word, sources);
+    }
+  }
+
+  std::list< std::string > mergeSortedTranslations(const word_sources& sources)
+  {
+    std::vector< std::string > merged;
+    for (const auto& source: sources)
+    {
+      size_t middle = merged.size();
+      merged.insert(merged.end(), source.second->cbegin(), source.second->cend());
+      std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end());
+    }
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    return std::list< std::string >(std::make_move_iterator(merged.begin()), std::make_move_iterator(merged.end()));
+  }
+
+  class MergeSources
   {
   public:
-    MergeWordsInDict(tree_of_words& temp):
-      temp_dict_(&temp)
+    MergeSources(tree_of_words& result):
+      result_(&result)
     {}
-    void operator()(const std::pair< const std::string, std::list< std::string > >& pair) const
+    void operator()(const std::string& word, const word_sources& sources) const
     {
-      (*temp_dict_)[pair.first] = mergeTranslations((*temp_dict_)[pair.first], pair.second);
+      result_->emplace_hint(result_->end(), word, mergeSortedTranslations(sources));
     }
   private:
-    tree_of_words* temp_dict_;
+    tree_of_words* result_;
   };
 
-  class AccumulateDicts
+  class CommonSources
   {
   public:
-    tree_of_words operator()(tree_of_words acc_dict, const tree_of_words* next_dict) const
+    CommonSources(tree_of_words& result, size_t dicts_count):
+      result_(&result),
+      dicts_count_(dicts_count)
+    {}
+    void operator()(const std::string& word, const word_sources& sources) const
     {
-      std::for_each(next_dict->cbegin(), next_dict->cend(), MergeWordsInDict{acc_dict});
-      return acc_dict;
+      if (sources.size() == dicts_count_)
+      {
+        result_->emplace_hint(result_->end(), word, mergeSortedTranslations(sources));
+      }
     }
+  private:
+    tree_of_words* result_;
+    size_t dicts_count_;
+  };
+
+  class SubtractSources
+  {
+  public:
+    SubtractSources(tree_of_words& result):
+      result_(&result)
+    {}
+    void operator()(const std::string& word, const word_sources& sources) const
+    {
+      if (sources.size() == 1 && sources.front().first == 0)
+      {
+        result_->emplace_hint(result_->end(), word, *sources.front().second);
+      }
+    }
+  private:
+    tree_of_words* result_;
   };
 
   class PushBackToList
@@ -163,13 +255,12 @@ namespace
     std::for_each(dict.cbegin(), dict.cend(), WriteWordEntry{out});
   }
 
-  std::map< std::string, std::list< std::string > > mergeDicts(const std::list< const tree_of_words* >& source_dicts)
+  // translation lists are kept sorted and unique by mergeTranslations, so sources merge in one pass
+  tree_of_words mergeDicts(const std::vector< const tree_of_words* >& source_dicts)
   {
-    if (source_dicts.empty())
-    {
-      return tree_of_words{};
-    }
-    return std::accumulate(source_dicts.cbegin(), source_dicts.cend(), tree_of_words{}, AccumulateDicts{});
+    tree_of_words result;
+    forEachWordOfDicts(source_dicts, MergeSources{result});
+    return result;
   }
 
   class CheckDictExists
@@ -360,34 +451,6 @@ namespace
     const std::string& translation_;
   };
 
-  class EraseWordFromTargetDict
-  {
-  public:
-    EraseWordFromTargetDict(tree_of_words& target_dict):
-      target_dict_(&target_dict)
-    {}
-    void operator()(const std::pair< const std::string, const std::list< std::string > >& pair) const
-    {
-      target_dict_->erase(pair.first);
-    }
-  private:
-    tree_of_words* target_dict_;
-  };
-
-  class SubstractWordsFromDict
-  {
-  public:
-    SubstractWordsFromDict(tree_of_words& target_dict):
-      target_dict_(&target_dict)
-    {}
-    void operator()(const tree_of_words* dict_to_subtract) const
-    {
-      std::for_each(dict_to_subtract->cbegin(), dict_to_subtract->cend(), EraseWordFromTargetDict{*target_dict_});
-    }
-  private:
-    tree_of_words* target_dict_;
-  };
-
   class FindDictAndGetPtr
   {
   public:
@@ -439,37 +502,6 @@ namespace
     const std::string& eng_word_;
   };
 
-  class FindCommonPart
-  {
-  public:
-    tree_of_words operator()(const tree_of_words& dict1, const tree_of_words* dict2) const
-    {
-      tree_of_words common_dict;
-      std::for_each(dict1.cbegin(), dict1.cend(), FillCommonDict{dict2, common_dict});
-      return common_dict;
-    }
-  private:
-    class FillCommonDict
-    {
-    public:
-      FillCommonDict(const tree_of_words* other_dict, tree_of_words& common):
-        other_dict_(other_dict),
-        common_dict_(&common)
-      {}
-      void operator()(const std::pair< const std::string, const std::list< std::string > >& entry) const
-      {
-        auto it_find = other_dict_->find(entry.first);
-        if (it_find != other_dict_->cend())
-        {
-          (*common_dict_)[entry.first] = mergeTranslations(entry.second, it_find->second);
-        }
-      }
-    private:
-        const tree_of_words* other_dict_;
-        tree_of_words* common_dict_;
-    };
-  };
-
   class ProcessWordForCommonTranslations
   {
   public:
@@ -1007,14 +1039,11 @@ void tkach::substructDicts(std::istream& in, tree_of_dict& avltree)
   {
     throw std::logic_error("<INVALID ARGUMENTS>");
   }
-  std::vector< tree_of_words* > source_dicts;
+  std::vector< const tree_of_words* > source_dicts;
   std::transform(dict_names.cbegin(), dict_names.cend(), std::back_inserter(source_dicts), FindDictAndGetPtr{avltree});
-  tree_of_words result_dict(*source_dicts[0]);
-  if (source_dicts.size() > 1)
-  {
-    std::for_each(source_dicts.begin() + 1, source_dicts.end(), SubstractWordsFromDict{result_dict});
-  }
-  avltree[new_dict_name] = result_dict;
+  tree_of_words result_dict;
+  forEachWordOfDicts(source_dicts, SubtractSources{result_dict});
+  avltree[new_dict_name] = std::move(result_dict);
 }
 
 void tkach::mergeNumberDicts(std::istream& in, tree_of_dict& avltree)
@@ -1039,10 +1068,9 @@ void tkach::mergeNumberDicts(std::istream& in, tree_of_dict& avltree)
   {
     throw std::logic_error("<INVALID ARGUMENTS>");
   }
-  std::list< const tree_of_words* > source_dicts;
+  std::vector< const tree_of_words* > source_dicts;
   std::transform(dict_names.cbegin(), dict_names.cend(), std::back_inserter(source_dicts), FindDictAndGetPtr{avltree});
-  tree_of_words result_dict = mergeDicts(source_dicts);
-  avltree[new_dict_name] = result_dict;
+  avltree[new_dict_name] = mergeDicts(source_dicts);
 }
 
 void tkach::doCommonPartDicts(std::istream& in, tree_of_dict& avltree)
@@ -1067,14 +1095,11 @@ void tkach::doCommonPartDicts(std::istream& in, tree_of_dict& avltree)
   {
     throw std::logic_error("<INVALID ARGUMENTS>");
   }
-  std::vector< tree_of_words* > source_dicts;
+  std::vector< const tree_of_words* > source_dicts;
   std::transform(dict_names.cbegin(), dict_names.cend(), std::back_inserter(source_dicts), FindDictAndGetPtr{avltree});
-  tree_of_words result_dict(*source_dicts[0]);
-  if (source_dicts.size() > 1)
-  {
-    result_dict = std::accumulate(std::next(source_dicts.cbegin()), source_dicts.cend(), result_dict, FindCommonPart{});
-  }
-  avltree[new_dict_name] = result_dict;
+  tree_of_words result_dict;
+  forEachWordOfDicts(source_dicts, CommonSources{result_dict, source_dicts.size()});
+  avltree[new_dict_name] = std::move(result_dict);
 }
 
 void tkach::copyTranslations(std::istream& in, tree_of_dict& avltree)
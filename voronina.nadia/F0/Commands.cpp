@@ -1,4 +1,5 @@
 ﻿#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <functional>
 #include <iomanip>
@@ -52,6 +53,18 @@ namespace
     }
   };
 
+  using Clock = std::chrono::steady_clock;
+
+  double megabytesPerSecond(std::streamsize bytes, Clock::time_point start)
+  {
+    std::chrono::duration< double > elapsed = Clock::now() - start;
+    if (elapsed.count() <= 0.0)
+    {
+      return 0.0;
+    }
+    return bytes / (1024.0 * 1024.0) / elapsed.count();
+  }
+
   struct CanEncodeTransformer
   {
     const std::string& text;
@@ -343,17 +356,22 @@ namespace voronina
       throw std::invalid_argument("Имя файла для записи не может быть пустым");
     }
 
-    std::string text = readFileContents(fileToRead);
+    std::ifstream input = openForReading(fileToRead);
     ShannonFanoTable fanoTable;
-    fanoTable.generateShannonFanoCodes(text, fileToRead);
+    fanoTable.generateShannonFanoCodes(input, fileToRead);
     vectorOfTables.emplace_back(std::move(fanoTable));
     out << "Кодировка успешно построена. Номер кодировки в таблице - ";
     out << vectorOfTables.size() << '\n';
 
-    std::string encodedText = "";
-    int amountOfSignificantBits = vectorOfTables.back().encode(text, encodedText);
-    writeInFile(fileToWrite, encodedText);
+    input.clear();
+    input.seekg(0);
+    std::ofstream output = openForWriting(fileToWrite);
+    auto start = Clock::now();
+    int amountOfSignificantBits = vectorOfTables.back().encode(input, output);
+    output.close();
+    double speed = megabytesPerSecond(getFileSize(fileToRead), start);
     out << "Файл успешно закодирован\n";
+    out << "Скорость кодирования: " << speed << " МБ/с\n";
     out << "Результат кодирования записан в файл: " << fileToWrite << '\n';
     out << "Количество значащих бит в последнем байте: " << amountOfSignificantBits << '\n';
 
@@ -418,10 +436,14 @@ namespace voronina
 
     std::size_t encodingIndex = encodingNumber - 1;
 
-    std::string encodedText = readFileContents(fileToRead);
-    std::string decodedText = vectorOfTables[encodingIndex].decode(encodedText, bits % 8);
-    writeInFile(fileToWrite, decodedText);
+    std::ifstream input = openForReading(fileToRead);
+    std::ofstream output = openForWriting(fileToWrite);
+    auto start = Clock::now();
+    vectorOfTables[encodingIndex].decode(input, output, bits % 8);
+    output.close();
+    double speed = megabytesPerSecond(getFileSize(fileToRead), start);
     out << "Файл " << fileToRead << " успешно декодирован\n";
+    out << "Скорость декодирования: " << speed << " МБ/с\n";
     out << "Результат декодирования записан в файл: " << fileToWrite << '\n';
   }
 
@@ -573,8 +595,8 @@ namespace voronina
     std::transform(begin, end, std::back_inserter(chosenTables), tableChooser);
 
     CodeInfoFunctor functor;
-    auto inserter = std::back_inserter(codes);
-    std::transform(chosenTables.begin(), chosenTables.end(), inserter, functor);
+    auto codesInserter = std::back_inserter(codes);
+    std::transform(chosenTables.begin(), chosenTables.end(), codesInserter, functor);
     out << CodeInfoHeader{};
     std::copy(codes.begin(), codes.end(), std::ostream_iterator< CodeInfo >(out, "\n"));
   }
@@ -695,10 +717,9 @@ namespace voronina
       throw std::invalid_argument("Неверный номер кодировки");
     }
     std::size_t encodingIndex = encodingNumber - 1;
-    std::string text = readFileContents(fileToRead);
-    std::string encodedText = "";
-    int amountOfSignificantBits = vectorOfTables[encodingIndex].encode(text, encodedText);
-    writeInFile(fileToWrite, encodedText);
+    std::ifstream input = openForReading(fileToRead);
+    std::ofstream output = openForWriting(fileToWrite);
+    int amountOfSignificantBits = vectorOfTables[encodingIndex].encode(input, output);
     out << "Файл успешно закодирован\n";
     out << "Результат кодирования записан в файл: " << fileToWrite << '\n';
     out << "Количество значащих бит в последнем байте: " << amountOfSignificantBits << '\n';
@@ -43,4 +43,26 @@ namespace voronina
     }
     return file.tellg();
   }
+
+  std::ifstream openForReading(std::string const& filename)
+  {
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open())
+    {
+      static const char* prefix = "Ошибка при открытии файла: ";
+      static const char* postfix = ". Проверьте существование такого файла";
+      throw std::invalid_argument(prefix + filename + postfix);
+    }
+    return ifs;
+  }
+
+  std::ofstream openForWriting(std::string const& filename)
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs.is_open())
+    {
+      throw std::invalid_argument("Ошибка при открытии файла для записи: " + filename);
+    }
+    return ofs;
+  }
 }
@@ -1,6 +1,7 @@
 #ifndef FILE_UTILITIES
 #define FILE_UTILITIES
 
+#include <fstream>
 #include <string>
 
 namespace voronina
@@ -8,6 +9,8 @@ namespace voronina
   std::string readFileContents(std::string const& filename);
   void writeInFile(const std::string& filename, const std::string& text);
   std::streamsize getFileSize(const std::string& fileName);
+  std::ifstream openForReading(const std::string& filename);
+  std::ofstream openForWriting(const std::string& filename);
 }
 
 #endif
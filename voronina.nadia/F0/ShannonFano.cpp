@@ -4,6 +4,7 @@
 #include <iomanip>
 #include <iterator>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 #include "IOFmtguard.h"
@@ -13,208 +14,70 @@ namespace
 {
   using namespace voronina;
 
-  template < class T >
-  T staticCast(const T& value);
-
-  struct BitExtractor
-  {
-    int j = 7;
-    unsigned char byte;
-
-    BitExtractor(unsigned char b);
-    char operator()();
-  };
-
-  std::string byteToString(unsigned char byte);
-
-  struct ByteGenerator
-  {
-    const std::string& bitMask;
-    int bitMaskLength;
-    int i = 0;
-
-    ByteGenerator(const std::string& bitMask, int bitMaskLength);
-    std::string operator()();
-  };
-
-  struct BitToDecimalAccumulator
-  {
-    int degree = 7;
-    int operator()(int sum, char bit);
-  };
-
-  struct ByteMaskToCharTransformer
-  {
-    char operator()(const std::string& byte) const;
-  };
+  constexpr std::size_t ioChunkSize = 1 << 16;
+  constexpr unsigned maxPackedCodeLength = 56;
 
   struct SymbolToSymbolMapEntry
   {
     std::pair< char, Symbol > operator()(const Symbol& symbol) const;
   };
 
-  struct SymbolToCodeMapEntry
-  {
-    std::pair< std::string, Symbol > operator()(const Symbol& symbol) const;
-  };
-
-  struct SymbolToCodeTransformer
-  {
-    using SymbolMap = std::unordered_map< char, Symbol >;
-    const SymbolMap& symbolMap;
-
-    SymbolToCodeTransformer(const SymbolMap& symbolMap);
-    std::string operator()(const std::string& acc, char symbol) const;
-  };
-
   struct FrequencySetter
   {
-    const std::string& text;
-    FrequencySetter(const std::string& text);
+    double total;
+    const std::array< std::size_t, 256 >& counts;
     Symbol operator()(Symbol symbol) const;
   };
 
-  struct ByteToCharFunctor
-  {
-    ByteGenerator& generator;
-    ByteMaskToCharTransformer& transformer;
-
-    ByteToCharFunctor(ByteGenerator& gen, ByteMaskToCharTransformer& trans);
-
-    char operator()();
-  };
-
-  struct BitMaskExtractor
-  {
-    const std::string& bitMask;
-    int& i;
-    BitMaskExtractor(const std::string& bitMask, int& i);
-    char operator()();
-  };
-
-  int encodeBitMaskToDestination(const std::string& bitMask, std::string& destination);
-
   double logFrequencyAccumulator(double sum, const Symbol& symb);
 
-  template < class T >
-  T staticCast(const T& value)
-  {
-    return value;
-  }
-
-  BitExtractor::BitExtractor(unsigned char b):
-    byte(b)
-  {}
-
-  char BitExtractor::operator()()
-  {
-    return ((byte >> j--) & 1) + '0';
-  }
-
-  std::string byteToString(unsigned char byte)
-  {
-    std::string result;
-    BitExtractor extractor(byte);
-    std::generate_n(std::back_inserter(result), 8, extractor);
-    return result;
-  }
-
-  ByteGenerator::ByteGenerator(const std::string& bitMask, int bitMaskLength):
-    bitMask(bitMask), bitMaskLength(bitMaskLength)
-  {}
-
-  std::string ByteGenerator::operator()()
-  {
-    std::string byte;
-    int bitsToExtract = std::min(8, bitMaskLength - i);
-    auto extractor = BitMaskExtractor(bitMask, i);
-    std::generate_n(std::back_inserter(byte), bitsToExtract, extractor);
-    return byte;
-  }
-
-  int BitToDecimalAccumulator::operator()(int sum, char bit)
-  {
-    sum += (bit - '0') << degree--;
-    return sum;
-  }
-
-  char ByteMaskToCharTransformer::operator()(const std::string& byte) const
-  {
-    auto accumulator = BitToDecimalAccumulator{};
-    return std::accumulate(byte.begin(), byte.end(), 0, accumulator);
-  }
-
   std::pair< char, Symbol > SymbolToSymbolMapEntry::operator()(const Symbol& symbol) const
   {
     return { symbol.symbol, symbol };
   }
 
-  std::pair< std::string, Symbol > SymbolToCodeMapEntry::operator()(const Symbol& symbol) const
+  Symbol FrequencySetter::operator()(Symbol symbol) const
   {
-    return { symbol.code, symbol };
+    symbol.frequency = counts[static_cast< unsigned char >(symbol.symbol)] / total;
+    return symbol;
   }
 
-  SymbolToCodeTransformer::SymbolToCodeTransformer(const SymbolMap& symbolMap):
-    symbolMap(symbolMap)
-  {}
-
-  std::string SymbolToCodeTransformer::operator()(const std::string& acc, char symbol) const
+  void countBytes(std::array< std::size_t, 256 >& counts, const char* begin, const char* end)
   {
-    auto it = symbolMap.find(symbol);
-    if (it != symbolMap.end())
+    for (; begin != end; ++begin)
     {
-      return acc + it->second.code;
+      ++counts[static_cast< unsigned char >(*begin)];
     }
-    return acc;
-  }
-
-  FrequencySetter::FrequencySetter(const std::string& text):
-    text(text)
-  {}
-
-  Symbol FrequencySetter::operator()(Symbol symbol) const
-  {
-    auto size = static_cast< double >(text.size());
-    auto count = std::count(text.begin(), text.end(), symbol.symbol);
-    symbol.frequency = count / size;
-    return symbol;
   }
 
-  ByteToCharFunctor::ByteToCharFunctor(ByteGenerator& gen, ByteMaskToCharTransformer& trans):
-    generator(gen), transformer(trans)
-  {}
-
-  char ByteToCharFunctor::operator()()
+  std::uint64_t codeToBits(const std::string& code, std::size_t from, std::size_t length)
   {
-    return transformer(generator());
+    std::uint64_t bits = 0;
+    for (std::size_t i = from; i < from + length; ++i)
+    {
+      bits = (bits << 1) | static_cast< std::uint64_t >(code[i] == '1');
+    }
+    return bits;
   }
 
-  BitMaskExtractor::BitMaskExtractor(const std::string& bitMask, int& i):
-    bitMask(bitMask), i(i)
-  {}
-
-  char BitMaskExtractor::operator()()
+  void putBits(std::uint64_t& acc, unsigned& accBits, std::uint64_t bits, unsigned length, std::string& out)
   {
-    return bitMask[i++];
+    acc = (acc << length) | bits;
+    accBits += length;
+    while (accBits >= 8)
+    {
+      accBits -= 8;
+      out.push_back(static_cast< char >((acc >> accBits) & 0xFF));
+    }
   }
 
-  int encodeBitMaskToDestination(const std::string& bitMask, std::string& destination)
+  void flushIfFull(std::string& buffer, std::ostream& out)
   {
-    int bitMaskLength = bitMask.length();
-    int fullBytes = bitMaskLength / 8;
-    int remainingBits = bitMaskLength % 8;
-
-    ByteGenerator generator(bitMask, bitMaskLength);
-    ByteMaskToCharTransformer transformer;
-    ByteToCharFunctor byteToCharFunctor(generator, transformer);
-    std::generate_n(std::back_inserter(destination), fullBytes, byteToCharFunctor);
-    if (remainingBits)
+    if (buffer.size() >= ioChunkSize)
     {
-      std::string lastByte = bitMask.substr(fullBytes * 8, remainingBits);
-      lastByte.append(8 - remainingBits, '0');
-      destination += transformer(lastByte);
+      out.write(buffer.data(), buffer.size());
+      buffer.clear();
     }
-    return remainingBits;
   }
 
   double logFrequencyAccumulator(double sum, const Symbol& symb)
@@ -244,18 +107,24 @@ namespace voronina
     return originFile_;
   }
 
-  void ShannonFanoTable::initializeSymbolFrequencies(const std::string& text)
+  void ShannonFanoTable::initializeSymbolFrequencies(const ByteCounts& counts, std::size_t total)
   {
-    std::string sortedText = text;
-    std::sort(sortedText.begin(), sortedText.end());
-    auto uniqueEnd = std::unique(sortedText.begin(), sortedText.end());
+    std::string presentSymbols;
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+      if (counts[i])
+      {
+        presentSymbols.push_back(static_cast< char >(i));
+      }
+    }
+    std::sort(presentSymbols.begin(), presentSymbols.end());
     symbols_.clear();
 
     auto inserter = std::back_inserter(symbols_);
-    std::transform(sortedText.begin(), uniqueEnd, inserter, SymbolCreator{});
+    std::transform(presentSymbols.begin(), presentSymbols.end(), inserter, SymbolCreator{});
     auto begin = symbols_.begin();
     auto end = symbols_.end();
-    std::transform(begin, end, begin, FrequencySetter(text));
+    std::transform(begin, end, begin, FrequencySetter{ static_cast< double >(total), counts });
     std::sort(begin, end, FrequencyComparator{});
   }
 
@@ -291,22 +160,156 @@ namespace voronina
   void ShannonFanoTable::generateShannonFanoCodes(const std::string& text,
                                                   const std::string originFile)
   {
-    if (text.empty())
+    ByteCounts counts{};
+    countBytes(counts, text.data(), text.data() + text.size());
+    generateFromCounts(counts, text.size(), originFile);
+  }
+
+  void ShannonFanoTable::generateShannonFanoCodes(std::istream& in, const std::string originFile)
+  {
+    ByteCounts counts{};
+    std::size_t total = 0;
+    std::vector< char > buffer(ioChunkSize);
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0)
+    {
+      std::size_t got = static_cast< std::size_t >(in.gcount());
+      countBytes(counts, buffer.data(), buffer.data() + got);
+      total += got;
+    }
+    generateFromCounts(counts, total, originFile);
+  }
+
+  void ShannonFanoTable::generateFromCounts(const ByteCounts& counts, std::size_t total,
+                                            const std::string& originFile)
+  {
+    if (total == 0)
     {
       static auto errMessage = "Невозможно создать кодировку Шеннона-Фано из пустой строки";
       throw std::invalid_argument(errMessage);
     }
 
     originFile_ = originFile;
-    initializeSymbolFrequencies(text);
+    initializeSymbolFrequencies(counts, total);
     shannonFanoRecursion(symbols_.begin(), symbols_.end() - 1);
 
+    symbolMap_.clear();
     auto symbolInserter = std::inserter(symbolMap_, symbolMap_.end());
     auto transformer = SymbolToSymbolMapEntry();
     std::transform(symbols_.begin(), symbols_.end(), symbolInserter, transformer);
 
-    auto codeMapInserter = std::inserter(codeMap_, codeMap_.end());
-    std::transform(symbols_.begin(), symbols_.end(), codeMapInserter, SymbolToCodeMapEntry());
+    buildCodeTables();
+  }
+
+  void ShannonFanoTable::buildCodeTables()
+  {
+    codeBits_.fill(0);
+    codeLengths_.fill(0);
+    decodeTable_.assign(256, DecodeEntry{ 0, 0, 0 });
+
+    for (auto it = symbols_.begin(); it != symbols_.end(); ++it)
+    {
+      const std::string& code = it->code;
+      unsigned char symbol = static_cast< unsigned char >(it->symbol);
+      if (code.empty())
+      {
+        continue;
+      }
+      codeLengths_[symbol] = static_cast< unsigned char >(code.size());
+      if (code.size() <= maxPackedCodeLength)
+      {
+        codeBits_[symbol] = codeToBits(code, 0, code.size());
+      }
+
+      std::size_t table = 0;
+      std::size_t pos = 0;
+      for (; code.size() - pos > 8; pos += 8)
+      {
+        std::size_t slot = table * 256 + codeToBits(code, pos, 8);
+        if (decodeTable_[slot].next == 0)
+        {
+          decodeTable_[slot].next = static_cast< std::uint16_t >(decodeTable_.size() / 256);
+          decodeTable_.resize(decodeTable_.size() + 256, DecodeEntry{ 0, 0, 0 });
+        }
+        table = decodeTable_[slot].next;
+      }
+
+      unsigned rest = code.size() - pos;
+      std::size_t first = table * 256 + (codeToBits(code, pos, rest) << (8 - rest));
+      DecodeEntry leaf{ 0, symbol, static_cast< unsigned char >(rest) };
+      std::fill_n(decodeTable_.begin() + first, std::size_t(1) << (8 - rest), leaf);
+    }
+  }
+
+  void ShannonFanoTable::encodeChunk(BitState& state, const char* begin, const char* end,
+                                     std::string& out) const
+  {
+    for (; begin != end; ++begin)
+    {
+      unsigned char symbol = static_cast< unsigned char >(*begin);
+      unsigned length = codeLengths_[symbol];
+      if (length <= maxPackedCodeLength)
+      {
+        putBits(state.acc, state.bits, codeBits_[symbol], length, out);
+        continue;
+      }
+      const std::string& code = symbolMap_.at(*begin).code;
+      for (std::size_t pos = 0; pos < code.size(); pos += 8)
+      {
+        unsigned part = std::min< std::size_t >(8, code.size() - pos);
+        putBits(state.acc, state.bits, codeToBits(code, pos, part), part, out);
+      }
+    }
+  }
+
+  int ShannonFanoTable::finishEncoding(BitState& state, std::string& out) const
+  {
+    int remainingBits = state.bits;
+    if (remainingBits)
+    {
+      putBits(state.acc, state.bits, 0, 8 - remainingBits, out);
+    }
+    return remainingBits;
+  }
+
+  void ShannonFanoTable::decodeByte(BitState& state, unsigned char byte, unsigned bits,
+                                    std::string& out) const
+  {
+    state.acc = (state.acc << bits) | (byte >> (8 - bits));
+    state.bits += bits;
+    while (state.bits >= 8)
+    {
+      const DecodeEntry& entry = decodeTable_[state.table * 256 + ((state.acc >> (state.bits - 8)) & 0xFF)];
+      if (entry.length)
+      {
+        out.push_back(static_cast< char >(entry.symbol));
+        state.bits -= entry.length;
+        state.table = 0;
+      }
+      else if (entry.next)
+      {
+        state.bits -= 8;
+        state.table = entry.next;
+      }
+      else
+      {
+        throw std::runtime_error("Последовательность битов не соответствует кодировке");
+      }
+    }
+  }
+
+  void ShannonFanoTable::finishDecoding(BitState& state, std::string& out) const
+  {
+    while (state.bits > 0)
+    {
+      const DecodeEntry& entry = decodeTable_[state.table * 256 + ((state.acc << (8 - state.bits)) & 0xFF)];
+      if (entry.length == 0 || entry.length > state.bits)
+      {
+        return;
+      }
+      out.push_back(static_cast< char >(entry.symbol));
+      state.bits -= entry.length;
+      state.table = 0;
+    }
   }
 
   int ShannonFanoTable::encode(const std::string& text, std::string& destination) const
@@ -317,11 +320,31 @@ namespace voronina
           "Contract violation: symbolMap_ must be initialized before encoding. "
           "Call generateShannonFanoCodes() first.");
     }
-    auto transformer = SymbolToCodeTransformer(symbolMap_);
-    auto begin = text.begin();
-    auto end = text.end();
-    std::string bitMask = std::accumulate(begin, end, std::string{}, transformer);
-    return encodeBitMaskToDestination(bitMask, destination);
+    BitState state;
+    encodeChunk(state, text.data(), text.data() + text.size(), destination);
+    return finishEncoding(state, destination);
+  }
+
+  int ShannonFanoTable::encode(std::istream& in, std::ostream& out) const
+  {
+    if (symbolMap_.empty())
+    {
+      throw std::logic_error(
+          "Contract violation: symbolMap_ must be initialized before encoding. "
+          "Call generateShannonFanoCodes() first.");
+    }
+    BitState state;
+    std::vector< char > buffer(ioChunkSize);
+    std::string encoded;
+    encoded.reserve(ioChunkSize * 2);
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0)
+    {
+      encodeChunk(state, buffer.data(), buffer.data() + in.gcount(), encoded);
+      flushIfFull(encoded, out);
+    }
+    int remainingBits = finishEncoding(state, encoded);
+    out.write(encoded.data(), encoded.size());
+    return remainingBits;
   }
 
   std::string ShannonFanoTable::decode(const std::string& text,
@@ -333,43 +356,73 @@ namespace voronina
       throw std::logic_error(errorMessage);
     }
 
-    if (significantBitsInLastByte > 7)
+    if (significantBitsInLastByte < 0 || significantBitsInLastByte > 7)
     {
       throw std::invalid_argument("Количество значимых битов в последнем байте "
                                   "должно быть в диапазоне от 0 до 7");
     }
 
-    std::vector< unsigned char > bytes;
-    bytes.reserve(text.size());
-
-    using namespace std::placeholders;
-    auto toUnsignedChar = std::bind(staticCast< unsigned char >, _1);
-    std::transform(text.begin(), text.end(), std::back_inserter(bytes), toUnsignedChar);
-
-    std::vector< std::string > bitMasks;
-    std::transform(bytes.begin(), bytes.end(), std::back_inserter(bitMasks), byteToString);
-    std::string bitMask = std::accumulate(bitMasks.begin(), bitMasks.end(), std::string{});
+    std::string destination;
+    if (text.empty())
+    {
+      return destination;
+    }
+    destination.reserve(text.size() * 2);
+    BitState state;
+    for (auto it = text.begin(); it != text.end() - 1; ++it)
+    {
+      decodeByte(state, static_cast< unsigned char >(*it), 8, destination);
+    }
+    unsigned lastBits = significantBitsInLastByte ? significantBitsInLastByte : 8;
+    decodeByte(state, static_cast< unsigned char >(text.back()), lastBits, destination);
+    finishDecoding(state, destination);
+    return destination;
+  }
 
-    std::size_t bitMaskLength = bitMask.length();
-    if (significantBitsInLastByte != 0)
+  void ShannonFanoTable::decode(std::istream& in, std::ostream& out,
+                                int significantBitsInLastByte) const
+  {
+    if (symbolMap_.empty())
     {
-      bitMaskLength = bitMaskLength - 8 + significantBitsInLastByte;
+      auto errorMessage = "Contract violation: symbolMap_ must be initialized before decoding";
+      throw std::logic_error(errorMessage);
     }
 
-    std::string buffer;
-    std::string destination;
-    for (std::size_t i = 0; i < bitMaskLength; ++i)
+    if (significantBitsInLastByte < 0 || significantBitsInLastByte > 7)
     {
-      buffer += bitMask[i];
+      throw std::invalid_argument("Количество значимых битов в последнем байте "
+                                  "должно быть в диапазоне от 0 до 7");
+    }
 
-      auto it = codeMap_.find(buffer);
-      if (it != codeMap_.end())
+    BitState state;
+    std::vector< char > buffer(ioChunkSize);
+    std::string decoded;
+    decoded.reserve(ioChunkSize * 2);
+    bool hasPending = false;
+    char pending = 0;
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0)
+    {
+      const char* begin = buffer.data();
+      const char* last = begin + in.gcount() - 1;
+      if (hasPending)
       {
-        destination += it->second.symbol;
-        buffer.clear();
+        decodeByte(state, static_cast< unsigned char >(pending), 8, decoded);
       }
+      for (; begin != last; ++begin)
+      {
+        decodeByte(state, static_cast< unsigned char >(*begin), 8, decoded);
+      }
+      pending = *last;
+      hasPending = true;
+      flushIfFull(decoded, out);
     }
-    return destination;
+    if (hasPending)
+    {
+      unsigned lastBits = significantBitsInLastByte ? significantBitsInLastByte : 8;
+      decodeByte(state, static_cast< unsigned char >(pending), lastBits, decoded);
+      finishDecoding(state, decoded);
+    }
+    out.write(decoded.data(), decoded.size());
   }
 
   double ShannonFanoTable::calculateEntropy()
@@ -1,7 +1,9 @@
 #ifndef SHANNON_FANO_H
 #define SHANNON_FANO_H
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -15,8 +17,11 @@ namespace voronina
   {
   public:
     void generateShannonFanoCodes(const std::string& text, const std::string originFile = "");
+    void generateShannonFanoCodes(std::istream& in, const std::string originFile = "");
     int encode(const std::string& text, std::string& destination) const;
+    int encode(std::istream& in, std::ostream& out) const;
     std::string decode(const std::string& text, int amountOfSignificantBitsInLastByte) const;
+    void decode(std::istream& in, std::ostream& out, int amountOfSignificantBitsInLastByte) const;
     double calculateEntropy();
     const std::vector< Symbol >& symbols() const;
     int size() const;
@@ -26,14 +31,38 @@ namespace voronina
 
   private:
     using SymbIter = std::vector< Symbol >::iterator;
+    using ByteCounts = std::array< std::size_t, 256 >;
+
+    struct DecodeEntry
+    {
+      std::uint16_t next;
+      unsigned char symbol;
+      unsigned char length;
+    };
+
+    struct BitState
+    {
+      std::uint64_t acc = 0;
+      unsigned bits = 0;
+      std::size_t table = 0;
+    };
 
     std::string originFile_;
     std::vector< Symbol > symbols_;
     std::unordered_map< char, Symbol > symbolMap_;
-    std::unordered_map< std::string, Symbol > codeMap_;
+    std::array< std::uint64_t, 256 > codeBits_;
+    std::array< unsigned char, 256 > codeLengths_;
+    std::vector< DecodeEntry > decodeTable_;
 
-    void initializeSymbolFrequencies(const std::string& text);
+    void initializeSymbolFrequencies(const ByteCounts& counts, std::size_t total);
     void shannonFanoRecursion(const SymbIter& begin, const SymbIter& end);
+    void generateFromCounts(const ByteCounts& counts, std::size_t total, const std::string& originFile);
+    void buildCodeTables();
+
+    void encodeChunk(BitState& state, const char* begin, const char* end, std::string& out) const;
+    int finishEncoding(BitState& state, std::string& out) const;
+    void decodeByte(BitState& state, unsigned char byte, unsigned bits, std::string& out) const;
+    void finishDecoding(BitState& state, std::string& out) const;
   };
 }
 